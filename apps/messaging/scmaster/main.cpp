@@ -90,6 +90,11 @@ bool Master::init() {
 	if ( !Application::init() )
 		return false;
 
+	if ( global.http.metrics ) {
+		// Must be enabled before queues and groups are created
+		Broker::Metrics::Enable();
+	}
+
 	_server = new Broker::Server;
 
 	for ( auto &queue : global.queues ) {
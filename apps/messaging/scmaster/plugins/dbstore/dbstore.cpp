@@ -35,6 +35,8 @@
 
 #include <seiscomp/broker/message.h>
 #include <seiscomp/broker/messageprocessor.h>
+#include <seiscomp/broker/metrics.h>
+#include <seiscomp/broker/queue.h>
 
 
 using namespace std;
@@ -341,6 +343,19 @@ class DBStore : public Messaging::Broker::MessageProcessor {
 		void dropConnection(Messaging::Broker::Client *) override {}
 
 
+		bool attach(Messaging::Broker::Queue *queue) override {
+			if ( auto metrics = Messaging::Broker::Metrics::Instance() ) {
+				_commitLatency = metrics->histogram(
+					"scmaster_dbstore_commit_seconds",
+					"Time to write the notifiers of a message to the database",
+					{{"queue", queue->name()}}
+				);
+			}
+
+			return MessageProcessor::attach(queue);
+		}
+
+
 		bool process(Messaging::Broker::Message *tmsg) override {
 			SEISCOMP_DEBUG("Writing message to database");
 
@@ -363,6 +378,8 @@ class DBStore : public Messaging::Broker::MessageProcessor {
 				return true;
 			}
 
+			auto start = _commitLatency ? Util::LatencyMonitor::Now() : 0;
+
 			// int error = 0;
 			for ( auto it = msg->iter(); *it; ++it ) {
 				auto notifier = DataModel::Notifier::Cast(*it);
@@ -429,6 +446,10 @@ class DBStore : public Messaging::Broker::MessageProcessor {
 				}
 			}
 
+			if ( _commitLatency ) {
+				_commitLatency->record(Util::LatencyMonitor::Now() - start);
+			}
+
 			// For now we return true otherwise the master will stop because
 			// e.g. an erroneous module sends the same notifier twice or more
 			//return (error < 0) ? false : true;
@@ -562,6 +583,7 @@ class DBStore : public Messaging::Broker::MessageProcessor {
 
 		mutable Util::StopWatch       _stopWatch;
 		mutable Statistics            _statistics;
+		Messaging::Broker::Metrics::HistogramPtr _commitLatency;
 
 };
 
@@ -27,6 +27,7 @@
 #include <seiscomp/broker/protocol.h>
 #include <seiscomp/broker/queue.h>
 #include <seiscomp/broker/utils/utils.h>
+#include <seiscomp/core/strings.h>
 #include <seiscomp/core/version.h>
 #include <seiscomp/datamodel/version.h>
 #include <seiscomp/io/archive/binarchive.h>
@@ -70,6 +71,7 @@ enum ErrorCodes {
 	ERR_WS_CMD_UNKNOWN,
 	ERR_NAME_TOO_LONG,
 	ERR_CLIENT_INACTIVITY,
+	ERR_INVALID_FILTER,
 	ERR_QUEUE_ERRORS,
 	ERR_QUANTITY
 };
@@ -98,6 +100,7 @@ string ErrorStrings[ERR_QUANTITY + Seiscomp::Messaging::Broker::Queue::Result::Q
 	"400 Unknown command",
 	"407 Clientname exceeds 128 characters",
 	"408 Inactivity",
+	"400 The subscription filter is invalid",
 	/* Start of queue error strings */
 	"200 QUEUE_OK",
 	"500 Internal queue error",
@@ -239,6 +242,9 @@ BrokerHandler::~BrokerHandler() {
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void BrokerHandler::welcome() {
 	if ( !_initialSubscriptions.empty() ) {
+		auto filters = std::move(_initialFilters);
+		_initialFilters.clear();
+
 		string_view group;
 		string_view input = _initialSubscriptions;
 		while ( (group = tokenize2(input, ",")).data() ) {
@@ -247,7 +253,11 @@ void BrokerHandler::welcome() {
 				continue;
 			}
 
-			Broker::Queue::Result r = _queue->subscribe(this, string(group));
+			string groupName(group);
+			auto it = filters.find(groupName);
+			Broker::Queue::Result r = _queue->subscribe(
+				this, groupName, it != filters.end() ? it->second.get() : nullptr
+			);
 			if ( r) {
 				replyWithError(str(ERR_QUEUE_ERRORS + r));
 				return;
@@ -350,6 +360,7 @@ void BrokerHandler::buffersFlushed() {
 	}
 	else {
 		_continueWithSeqNo = Core::None;
+		updateOutboxMetrics();
 	}
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -398,6 +409,7 @@ size_t BrokerHandler::publish(Broker::Client *sender, Broker::Message *msg) {
 	if ( msg->sequenceNumber != INVALID_SEQUENCE_NUMBER ) {
 		if ( _continueWithSeqNo ) {
 			++_messageBacklog;
+			updateOutboxMetrics();
 			return 0;
 		}
 		else if ( _session->outputBufferSize() ) {
@@ -406,6 +418,7 @@ size_t BrokerHandler::publish(Broker::Client *sender, Broker::Message *msg) {
 			// bytes
 			_continueWithSeqNo = msg->sequenceNumber;
 			++_messageBacklog;
+			updateOutboxMetrics();
 			return 0;
 		}
 	}
@@ -591,6 +604,12 @@ size_t BrokerHandler::sendMessage(Broker::Message *msg) {
 	size_t frameLength = msg->encodingWebSocket->data.size();
 	frameLength += msg->encodingWebSocket->header.size();
 
+	if ( _sendLatency && (msg->sequenceNumber != INVALID_SEQUENCE_NUMBER) ) {
+		_sendLatency->record((Core::Time::UTC() - msg->timestamp).count());
+	}
+
+	updateOutboxMetrics();
+
 	/*
 	if ( inAvail() > 1024 )
 		std::cerr << "Buffer watermark exceeded with " << inAvail() << std::endl;
@@ -613,6 +632,18 @@ size_t BrokerHandler::sendMessage(Broker::Message *msg) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void BrokerHandler::updateOutboxMetrics() {
+	if ( _outboxMessages ) {
+		_outboxMessages->set(_messageBacklog);
+		_outboxBytes->set(static_cast<int64_t>(_session->outputBufferSize()));
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void BrokerHandler::replyWithError(const char *msg, size_t len) {
 	if ( _queue ) {
@@ -747,6 +778,15 @@ void BrokerHandler::commandCONNECT(char *frame, size_t len) {
 				setStatusOnly(false);
 			}
 		}
+		else if ( headers.nameEquals(SCMP_PROTO_CMD_CONNECT_HEADER_COMPACT_BINARY_VERSION) ) {
+			uint32_t version;
+			if ( !Core::fromString(version, string_view(headers.val_start, headers.val_len)) ) {
+				replyWithError(str(ERR_INVALID_HEADER_PAIR));
+				return;
+			}
+
+			setCompactBinaryVersion(version);
+		}
 		else if ( headers.nameEquals(SCMP_PROTO_CMD_CONNECT_HEADER_ACK_WINDOW) ) {
 			char *end;
 			headers.val_start[headers.val_len] = '\0';
@@ -757,6 +797,27 @@ void BrokerHandler::commandCONNECT(char *frame, size_t len) {
 			headers.val_start[headers.val_len] = '\0';
 			seqNo = static_cast<Broker::SequenceNumber>(strtol(headers.val_start, &end, 10));
 		}
+		else if ( headers.nameEquals(SCMP_PROTO_CMD_CONNECT_HEADER_SUBSCRIPTION_FILTER) ) {
+			// Filters must be set with the initial subscriptions, otherwise
+			// the replay of missed messages would not be filtered
+			string_view value(headers.val_start, headers.val_len);
+			size_t sep = value.find(':');
+			if ( sep == string_view::npos ) {
+				replyWithError(str(ERR_INVALID_FILTER));
+				return;
+			}
+
+			string_view group = trim(value.substr(0, sep));
+			auto filter = Broker::SubscriptionFilter::Create(
+				string(trim(value.substr(sep + 1)))
+			);
+			if ( group.empty() || !filter ) {
+				replyWithError(str(ERR_INVALID_FILTER));
+				return;
+			}
+
+			_initialFilters[string(group)] = filter;
+		}
 		else if ( headers.nameEquals(SCMP_PROTO_CMD_CONNECT_HEADER_SUBSCRIPTIONS) ) {
 			// Handle subscription requests
 			_initialSubscriptions = string_view(headers.val_start, headers.val_len);
@@ -787,6 +848,25 @@ void BrokerHandler::commandCONNECT(char *frame, size_t len) {
 	_session->frame()->setMaxPayloadSize(_queue->maxPayloadSize());
 	setAcknowledgeWindow(ackWindow);
 
+	if ( auto metrics = Broker::Metrics::Instance() ) {
+		Broker::Metrics::Labels labels = {{"queue", _queue->name()}, {"client", name()}};
+		_outboxMessages = metrics->gauge(
+			"scmaster_client_outbox_messages",
+			"Messages queued for a client while its output buffer is not flushed",
+			labels
+		);
+		_outboxBytes = metrics->gauge(
+			"scmaster_client_outbox_bytes",
+			"Bytes in the output buffer of a client",
+			labels
+		);
+
+		auto item = _session->server()->getQueue(_queue->name());
+		if ( item ) {
+			_sendLatency = item->sendLatency;
+		}
+	}
+
 	// Send the first welcome message. Actually that should be done
 	// by the queue during connect!
 	BufferPtr welcomeBuffer = new Buffer;
@@ -801,6 +881,7 @@ void BrokerHandler::commandCONNECT(char *frame, size_t len) {
 		   << SCMP_PROTO_REPLY_CONNECT_HEADER_FRAMEWORK_VERSION ":" << CurrentVersion.toString() << "\n"
 		   << SCMP_PROTO_REPLY_CONNECT_HEADER_SCHEMA_VERSION ":" << SchemaVersion << "\n"
 		   << SCMP_PROTO_REPLY_CONNECT_HEADER_BINARY_VERSION ":" << IO::VBinaryArchive::Version << "\n"
+		   << SCMP_PROTO_REPLY_CONNECT_HEADER_COMPACT_BINARY_VERSION ":" << IO::CompactBinaryArchive::Version << "\n"
 		   << SCMP_PROTO_REPLY_CONNECT_HEADER_CLIENT_NAME ":" << name() << "\n"
 		   << SCMP_PROTO_REPLY_CONNECT_HEADER_ACK_WINDOW ":" << ackWindow << "\n"
 		   << SCMP_PROTO_REPLY_CONNECT_HEADER_GROUPS ":";
@@ -920,6 +1001,7 @@ void BrokerHandler::commandSUBSCRIBE(char *frame, size_t len) {
 	FrameHeaders headers(frame, len);
 	const char *groupList = nullptr;
 	size_t groupListLen = 0;
+	Broker::SubscriptionFilterPtr filter;
 
 	while ( headers.next() ) {
 		if ( !headers.name_len ) break;
@@ -933,6 +1015,15 @@ void BrokerHandler::commandSUBSCRIBE(char *frame, size_t len) {
 			groupList = headers.val_start;
 			groupListLen = headers.val_len;
 		}
+		else if ( headers.nameEquals(SCMP_PROTO_CMD_SUBSCRIBE_HEADER_FILTER) ) {
+			filter = Broker::SubscriptionFilter::Create(
+				string(headers.val_start, headers.val_len)
+			);
+			if ( !filter ) {
+				replyWithError(str(ERR_INVALID_FILTER));
+				return;
+			}
+		}
 	}
 
 	if ( headers.empty() ) {
@@ -951,7 +1042,7 @@ void BrokerHandler::commandSUBSCRIBE(char *frame, size_t len) {
 		trim(group, group_len);
 		if ( group_len == 0 ) continue;
 		string groupName(group, group_len);
-		Broker::Queue::Result r = _queue->subscribe(this, groupName);
+		Broker::Queue::Result r = _queue->subscribe(this, groupName, filter.get());
 		if ( r ) {
 			replyWithError(str(ERR_QUEUE_ERRORS + r));
 			return;
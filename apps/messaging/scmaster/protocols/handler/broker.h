@@ -27,6 +27,8 @@
 
 #include "../websocket.h"
 
+#include <map>
+
 
 namespace Seiscomp {
 namespace Messaging {
@@ -79,6 +81,7 @@ class BrokerHandler : public WebsocketHandler, Broker::Client {
 		void commandSTATE(char *frame, size_t len, bool service);
 
 		size_t sendMessage(Broker::Message *msg);
+		void updateOutboxMetrics();
 
 		void replyWithError(const char *msg, size_t len);
 		void replyWithError(const std::string &msg);
@@ -88,6 +91,12 @@ class BrokerHandler : public WebsocketHandler, Broker::Client {
 		int                         _messageBacklog{0};
 		std::string                 _requestQueue;
 		std::string                 _initialSubscriptions;
+		std::map<std::string, Broker::SubscriptionFilterPtr> _initialFilters;
+
+		// Only set if metrics are enabled
+		Broker::Metrics::GaugePtr     _outboxMessages;
+		Broker::Metrics::GaugePtr     _outboxBytes;
+		Broker::Metrics::HistogramPtr _sendLatency;
 };
 
 
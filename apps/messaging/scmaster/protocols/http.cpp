@@ -174,6 +174,18 @@ bool HttpSession::handleGETRequest(Wired::HttpRequest &req) {
 				sendResponse(response.get(), Wired::HTTP_200, "application/json");
 				return true;
 			}
+			else if ( path == "metrics" ) {
+				auto metrics = Broker::Metrics::Instance();
+				if ( metrics ) {
+					Wired::BufferPtr response = new Wired::Buffer;
+					{
+						boost::iostreams::stream<Core::ContainerSink<string>> os(response->data);
+						metrics->write(os);
+					}
+					sendResponse(response.get(), Wired::HTTP_200, "text/plain; version=0.0.4");
+					return true;
+				}
+			}
 		}
 
 		sendResponse(Wired::HTTP_404);
@@ -24,6 +24,7 @@
 #define SEISCOMP_COMPONENT MASTER
 
 #include <seiscomp/logging/log.h>
+#include <seiscomp/io/archive/binarchive.h>
 
 #include "client.h"
 #include "queue.h"
@@ -84,6 +85,18 @@ bool Client::setStatusOnly(bool enable) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool Client::setCompactBinaryVersion(uint32_t version) {
+	// Messages are forwarded in the version written by the sender which
+	// is at most the version of the server
+	_acceptsCompactBinary = version >= IO::CompactBinaryArchive::Version;
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void Client::setAcknowledgeWindow(SequenceNumber numberOfMessages) {
 	_acknowledgeWindow = numberOfMessages;
@@ -27,7 +27,9 @@
 
 #include <seiscomp/wired/devices/socket.h>
 #include <string>
+#include <vector>
 
+#include <seiscomp/broker/filter.h>
 #include <seiscomp/broker/message.h>
 
 
@@ -116,6 +118,17 @@ class SC_BROKER_API Client {
 		bool setStatusOnly(bool enable);
 		bool statusOnly() const;
 
+		/**
+		 * @brief Sets the highest version of the compact binary format
+		 *        the client can decode. The default is 0 which means
+		 *        that compact binary messages are converted to the binary
+		 *        format before they are sent to the client.
+		 * @param version The version announced by the client
+		 * @return Success flag
+		 */
+		bool setCompactBinaryVersion(uint32_t version);
+		bool acceptsCompactBinary() const;
+
 		/**
 		 * @brief Sets the number of messages required to send back an
 		 *        acknoledgement.
@@ -123,6 +136,14 @@ class SC_BROKER_API Client {
 		 */
 		void setAcknowledgeWindow(SequenceNumber numberOfMessages);
 
+		/**
+		 * @brief Returns the filter attached to the subscription of a group.
+		 * @param group The group
+		 * @return The filter or nullptr if all messages of the group are
+		 *         forwarded.
+		 */
+		const SubscriptionFilter *subscriptionFilter(const Group *group) const;
+
 		/**
 		 * @brief Returns the IP address connected to the client socket.
 		 *        If the underlying transport does not implement IP socket
@@ -174,6 +195,8 @@ class SC_BROKER_API Client {
 	//  Protected members
 	// ----------------------------------------------------------------------
 	protected:
+		using SubscriptionFilters = std::vector<std::pair<const Group*, SubscriptionFilterPtr>>;
+
 		Queue          *_queue{nullptr};
 		Core::Time      _created;
 		Core::Time      _lastSOHReceived;
@@ -181,12 +204,14 @@ class SC_BROKER_API Client {
 		bool            _wantsMembershipInformation{false};
 		bool            _discardSelf{false};
 		bool            _statusOnly{false};
+		bool            _acceptsCompactBinary{false};
 		SequenceNumber  _sequenceNumber{0};
 		SequenceNumber  _acknowledgeWindow{20};
 		SequenceNumber  _acknowledgeCounter{20};
 		OPT(Core::Time) _ackInitiated;
 		int             _inactivityCounter{0}; // The number of seconds
 		                                       // of inactivity
+		SubscriptionFilters _subscriptionFilters;
 
 
 	// ----------------------------------------------------------------------
@@ -212,6 +237,20 @@ inline bool Client::statusOnly() const {
 	return _statusOnly;
 }
 
+inline bool Client::acceptsCompactBinary() const {
+	return _acceptsCompactBinary;
+}
+
+inline const SubscriptionFilter *Client::subscriptionFilter(const Group *group) const {
+	for ( const auto &item : _subscriptionFilters ) {
+		if ( item.first == group ) {
+			return item.second.get();
+		}
+	}
+
+	return nullptr;
+}
+
 inline void *Client::memory(int offset) {
 	return _heap + offset;
 }
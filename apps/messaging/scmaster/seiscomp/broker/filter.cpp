@@ -0,0 +1,332 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#define SEISCOMP_COMPONENT MASTER
+
+#include <seiscomp/logging/log.h>
+#include <seiscomp/core/strings.h>
+#include <seiscomp/datamodel/creationinfo.h>
+#include <seiscomp/datamodel/network.h>
+#include <seiscomp/datamodel/station.h>
+#include <seiscomp/datamodel/waveformstreamid.h>
+
+#include "filter.h"
+#include "message.h"
+
+
+using namespace std;
+
+
+namespace Seiscomp {
+namespace Messaging {
+namespace Broker {
+
+
+namespace {
+
+
+const char *KeyNames[SubscriptionFilter::KeyQuantity] = {
+	"class",
+	"network",
+	"station",
+	"agency",
+	"operation"
+};
+
+
+const string WaveformIDProperty = "waveformID";
+const string CreationInfoProperty = "creationInfo";
+
+
+// Returns the value of a class property or nullptr if the object does not
+// have such a property or the optional value is not set.
+const Core::BaseObject *readObject(const Core::BaseObject *object,
+                                   const string &name) {
+	const Core::MetaObject *meta = object->meta();
+	if ( !meta ) {
+		return nullptr;
+	}
+
+	const Core::MetaProperty *prop = meta->property(name);
+	if ( !prop || !prop->isClass() ) {
+		return nullptr;
+	}
+
+	try {
+		return boost::any_cast<Core::BaseObject*>(prop->read(object));
+	}
+	catch ( ... ) {
+		return nullptr;
+	}
+}
+
+
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+SubscriptionFilter *SubscriptionFilter::Create(const std::string &expression) {
+	vector<string> patterns[KeyQuantity];
+	vector<string> criteria;
+
+	Core::split(criteria, expression, ";");
+
+	for ( auto &criterion : criteria ) {
+		size_t p = criterion.find('=');
+		if ( p == string::npos ) {
+			if ( Core::trim(criterion).empty() ) {
+				continue;
+			}
+
+			SEISCOMP_WARNING("Filter: expected key=patterns, got '%s'",
+			                 criterion.c_str());
+			return nullptr;
+		}
+
+		string name = criterion.substr(0, p);
+		Core::trim(name);
+
+		int key = 0;
+		while ( key < KeyQuantity && name != KeyNames[key] ) {
+			++key;
+		}
+
+		if ( key == KeyQuantity ) {
+			SEISCOMP_WARNING("Filter: unknown key '%s'", name.c_str());
+			return nullptr;
+		}
+
+		if ( !patterns[key].empty() ) {
+			SEISCOMP_WARNING("Filter: duplicate key '%s'", name.c_str());
+			return nullptr;
+		}
+
+		vector<string> values;
+		Core::split(values, criterion.c_str() + p + 1, ",");
+		for ( auto &value : values ) {
+			Core::trim(value);
+			if ( !value.empty() ) {
+				patterns[key].push_back(value);
+			}
+		}
+
+		if ( patterns[key].empty() ) {
+			SEISCOMP_WARNING("Filter: no patterns for key '%s'", name.c_str());
+			return nullptr;
+		}
+	}
+
+	SubscriptionFilter *filter = new SubscriptionFilter;
+
+	for ( int key = 0; key < KeyQuantity; ++key ) {
+		if ( patterns[key].empty() ) {
+			continue;
+		}
+
+		if ( !filter->_expression.empty() ) {
+			filter->_expression += ';';
+		}
+
+		filter->_expression += KeyNames[key];
+		filter->_expression += '=';
+
+		for ( size_t i = 0; i < patterns[key].size(); ++i ) {
+			if ( i ) {
+				filter->_expression += ',';
+			}
+			filter->_expression += patterns[key][i];
+			filter->_patterns[key].add(patterns[key][i]);
+		}
+
+		filter->_patterns[key].compile();
+	}
+
+	if ( filter->_expression.empty() ) {
+		delete filter;
+		return nullptr;
+	}
+
+	return filter;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool SubscriptionFilter::matches(Key key, const std::string &value) const {
+	return _patterns[key].empty() || _patterns[key].matches(value);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool SubscriptionFilter::matches(const DataModel::Notifier *notifier) const {
+	const DataModel::Object *object = notifier->object();
+	if ( !object ) {
+		return false;
+	}
+
+	if ( !matches(Operation, notifier->operation().toString())
+	  || !matches(Class, object->className()) ) {
+		return false;
+	}
+
+	if ( !_patterns[Network].empty() || !_patterns[Station].empty() ) {
+		auto wid = static_cast<const DataModel::WaveformStreamID*>(
+			readObject(object, WaveformIDProperty)
+		);
+
+		if ( wid ) {
+			if ( !matches(Network, wid->networkCode())
+			  || !matches(Station, wid->stationCode()) ) {
+				return false;
+			}
+		}
+		else if ( auto net = DataModel::Network::ConstCast(object) ) {
+			if ( !matches(Network, net->code()) ) {
+				return false;
+			}
+		}
+		else if ( auto sta = DataModel::Station::ConstCast(object) ) {
+			if ( !matches(Station, sta->code()) ) {
+				return false;
+			}
+		}
+	}
+
+	if ( !_patterns[Agency].empty() ) {
+		auto ci = static_cast<const DataModel::CreationInfo*>(
+			readObject(object, CreationInfoProperty)
+		);
+
+		if ( ci && !matches(Agency, ci->agencyID()) ) {
+			return false;
+		}
+	}
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Message *SubscriptionFilter::apply(Message *msg) const {
+	if ( msg->type != Message::Type::Regular ) {
+		return msg;
+	}
+
+	for ( const auto &result : msg->filterResults ) {
+		if ( result.expression == _expression ) {
+			if ( !result.passes ) {
+				return nullptr;
+			}
+
+			return result.message ? result.message.get() : msg;
+		}
+	}
+
+	size_t passed = 0;
+	Message *reduced = reduce(msg, passed);
+
+	msg->filterResults.push_back({_expression, reduced, passed > 0});
+
+	if ( !passed ) {
+		return nullptr;
+	}
+
+	return reduced ? reduced : msg;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Message *SubscriptionFilter::reduce(Message *msg, size_t &passed) const {
+	// Messages which cannot be decoded or do not carry notifiers are not
+	// subject to filtering.
+	passed = 1;
+
+	if ( !msg->decode() ) {
+		return nullptr;
+	}
+
+	auto nm = DataModel::NotifierMessage::Cast(msg->object);
+	if ( !nm ) {
+		return nullptr;
+	}
+
+	DataModel::NotifierMessagePtr subset = new DataModel::NotifierMessage;
+	size_t total = 0;
+
+	for ( auto &n : *nm ) {
+		++total;
+		if ( matches(n.get()) ) {
+			subset->attach(n);
+		}
+	}
+
+	passed = static_cast<size_t>(subset->size());
+
+	if ( !passed || passed == total ) {
+		return nullptr;
+	}
+
+	Message *copy = new Message;
+	copy->sender = msg->sender;
+	copy->target = msg->target;
+	copy->encoding = msg->encoding;
+	copy->mimeType = msg->mimeType;
+	copy->object = subset;
+	copy->schemaVersion = msg->schemaVersion;
+	copy->timestamp = msg->timestamp;
+	copy->type = msg->type;
+	copy->selfDiscard = msg->selfDiscard;
+	copy->processed = msg->processed;
+	copy->sequenceNumber = msg->sequenceNumber;
+	copy->_internalGroupPtr = msg->_internalGroupPtr;
+
+	if ( !copy->encode() ) {
+		SEISCOMP_WARNING("Filter: failed to encode reduced message, "
+		                 "forward the complete message");
+		delete copy;
+		passed = total;
+		return nullptr;
+	}
+
+	return copy;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+}
+}
+}
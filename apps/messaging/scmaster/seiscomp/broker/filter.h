@@ -0,0 +1,145 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#ifndef SEISCOMP_BROKER_FILTER_H__
+#define SEISCOMP_BROKER_FILTER_H__
+
+
+#include <seiscomp/core/baseobject.h>
+#include <seiscomp/datamodel/notifier.h>
+#include <seiscomp/utils/wildcardset.h>
+
+#include <seiscomp/broker/api.h>
+
+#include <string>
+
+
+namespace Seiscomp {
+namespace Messaging {
+namespace Broker {
+
+
+class Message;
+
+
+DEFINE_SMARTPOINTER(SubscriptionFilter);
+
+/**
+ * @brief The SubscriptionFilter class restricts the messages a client
+ *        receives from a group it has subscribed to.
+ *
+ * A filter is created from an expression which is a semicolon separated
+ * list of criteria. Each criterion is a key and a comma separated list of
+ * wildcard patterns, e.g.
+ *
+ * ```
+ * class=Pick,Amplitude;network=GE,CX;operation=add
+ * ```
+ *
+ * Supported keys are
+ *
+ * - class: the class name of the notifier object
+ * - network: the network code of the waveform id, network or station code
+ * - station: the station code of the waveform id or station
+ * - agency: the agency id of the creation info
+ * - operation: the notifier operation (add, update, remove)
+ *
+ * A notifier passes if each criterion matches at least one of its patterns.
+ * Criteria which refer to an attribute the object does not have, e.g. the
+ * network code of an origin, are not evaluated for that object.
+ *
+ * Filters apply to regular messages carrying notifiers only. All other
+ * messages are forwarded unchanged.
+ */
+class SC_BROKER_API SubscriptionFilter : public Core::BaseObject {
+	// ----------------------------------------------------------------------
+	//  Public types
+	// ----------------------------------------------------------------------
+	public:
+		enum Key {
+			Class,
+			Network,
+			Station,
+			Agency,
+			Operation,
+			KeyQuantity
+		};
+
+
+	// ----------------------------------------------------------------------
+	//  X'truction
+	// ----------------------------------------------------------------------
+	public:
+		/**
+		 * @brief Creates a filter from an expression.
+		 * @param expression The filter expression
+		 * @return The filter instance or nullptr if the expression is invalid
+		 *         or empty.
+		 */
+		static SubscriptionFilter *Create(const std::string &expression);
+
+
+	// ----------------------------------------------------------------------
+	//  Public interface
+	// ----------------------------------------------------------------------
+	public:
+		/**
+		 * @brief Returns the normalized expression. Two filters with the
+		 *        same normalized expression pass the same notifiers.
+		 */
+		const std::string &expression() const { return _expression; }
+
+		//! Returns whether a notifier passes the filter.
+		bool matches(const DataModel::Notifier *notifier) const;
+
+		/**
+		 * @brief Applies the filter to a message.
+		 *
+		 * The message is decoded on demand. The result is cached in the
+		 * message by the normalized expression, so each message is
+		 * evaluated only once for all clients sharing the same filter.
+		 * @param msg The message
+		 * @return The message itself if all notifiers pass, a reduced copy
+		 *         which is owned by msg if only some notifiers pass or
+		 *         nullptr if no notifier passes.
+		 */
+		Message *apply(Message *msg) const;
+
+
+	// ----------------------------------------------------------------------
+	//  Private members
+	// ----------------------------------------------------------------------
+	private:
+		SubscriptionFilter() = default;
+
+		bool matches(Key key, const std::string &value) const;
+		Message *reduce(Message *msg, size_t &passed) const;
+
+		std::string       _expression;
+		Util::WildcardSet _patterns[KeyQuantity];
+};
+
+
+}
+}
+}
+
+
+#endif
@@ -29,6 +29,7 @@
 #include <string>
 
 #include <seiscomp/broker/hashset.h>
+#include <seiscomp/broker/metrics.h>
 #include <seiscomp/broker/statistics.h>
 
 
@@ -109,11 +110,12 @@ class SC_BROKER_API Group : public Core::BaseObject {
 	//  Private members
 	// ----------------------------------------------------------------------
 	private:
-		std::string _name;
-		Members     _members;
-		mutable Tx  _txMessages;
-		mutable Tx  _txBytes;
-		mutable Tx  _txPayload;
+		std::string       _name;
+		Members           _members;
+		mutable Tx        _txMessages;
+		mutable Tx        _txBytes;
+		mutable Tx        _txPayload;
+		Metrics::Transfer _transfer;
 
 
 	friend class Queue;
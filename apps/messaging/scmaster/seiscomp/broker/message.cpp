@@ -191,6 +191,9 @@ bool Message::decode() {
 			case IMPORTED_XML:
 				schemaVersion = parse<ImportXMLArchive>(object, payload, ce);
 				break;
+			case CompactBinary:
+				schemaVersion = parse<IO::CompactBinaryArchive>(object, payload, ce);
+				break;
 			default:
 				break;
 		}
@@ -238,6 +241,8 @@ bool Message::encode() {
 			return write<IO::XMLArchive>(payload, object.get(), ce, schemaVersion);
 		case IMPORTED_XML:
 			return write<ImportXMLArchive>(payload, object.get(), ce, schemaVersion);
+		case CompactBinary:
+			return write<IO::CompactBinaryArchive>(payload, object.get(), ce, schemaVersion);
 		default:
 			break;
 	}
@@ -249,6 +254,50 @@ bool Message::encode() {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Message *Message::binaryFallback() {
+	if ( mimeType != MimeType(CompactBinary).toString() ) {
+		return this;
+	}
+
+	if ( binaryCopy ) {
+		return binaryCopy.get();
+	}
+
+	if ( !decode() || !object ) {
+		SEISCOMP_WARNING("Failed to decode compact binary message from %s",
+		                 sender.c_str());
+		return nullptr;
+	}
+
+	MessagePtr copy = new Message;
+	copy->sender = sender;
+	copy->target = target;
+	copy->encoding = encoding;
+	copy->mimeType = MimeType(Binary).toString();
+	copy->object = object;
+	copy->schemaVersion = schemaVersion;
+	copy->timestamp = timestamp;
+	copy->type = type;
+	copy->selfDiscard = selfDiscard;
+	copy->processed = processed;
+	copy->sequenceNumber = sequenceNumber;
+	copy->_internalGroupPtr = _internalGroupPtr;
+
+	if ( !copy->encode() ) {
+		SEISCOMP_WARNING("Failed to encode compact binary message from %s "
+		                 "as binary", sender.c_str());
+		return nullptr;
+	}
+
+	binaryCopy = copy;
+	return binaryCopy.get();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 }
 }
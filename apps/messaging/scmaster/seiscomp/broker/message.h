@@ -26,6 +26,7 @@
 
 
 #include <string>
+#include <vector>
 #include <stdint.h>
 
 #include <seiscomp/core/enumeration.h>
@@ -69,14 +70,16 @@ MAKEENUM(
 		JSON,
 		XML,
 		IMPORTED_XML,
-		Text
+		Text,
+		CompactBinary
 	),
 	ENAMES(
 		"application/x-sc-bin",
 		"text/json",
 		"application/x-sc-xml",
 		"text/xml",
-		"text/plain"
+		"text/plain",
+		"application/x-sc-cbin"
 	)
 );
 
@@ -120,6 +123,17 @@ class SC_BROKER_API Message : public Seiscomp::Core::BaseObject {
 		 */
 		bool encode();
 
+		/**
+		 * @brief Returns the message to be sent to a client which does not
+		 *        support the compact binary format.
+		 *
+		 * A compact binary message is decoded and encoded as binary once
+		 * and the copy is cached. Messages in any other format are
+		 * returned unchanged.
+		 * @return The message or nullptr if it could not be converted
+		 */
+		Message *binaryFallback();
+
 
 	// ----------------------------------------------------------------------
 	//  Members
@@ -132,6 +146,14 @@ class SC_BROKER_API Message : public Seiscomp::Core::BaseObject {
 			Status
 		};
 
+		//! The cached result of a subscription filter, see SubscriptionFilter
+		struct FilterResult {
+			std::string expression; //!< The normalized filter expression
+			MessagePtr  message;    //!< The reduced copy if only some
+			                        //!< notifiers pass
+			bool        passes;     //!< Whether anything passes at all
+		};
+
 		std::string                   sender;      //!< The sender
 		std::string                   target;      //!< The target group/topic
 		std::string                   encoding;    //!< The encoding of the data
@@ -149,6 +171,12 @@ class SC_BROKER_API Message : public Seiscomp::Core::BaseObject {
 		/** Cached encoded version for different protocols */
 		Wired::BufferPtr              encodingWebSocket;
 
+		/** Cached results of subscription filters */
+		std::vector<FilterResult>     filterResults;
+
+		/** Cached binary copy of a compact binary message */
+		MessagePtr                    binaryCopy;
+
 		/** Cache of the target group */
 		Group                         *_internalGroupPtr;
 };
@@ -0,0 +1,348 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#define SEISCOMP_COMPONENT MASTER
+
+#include <seiscomp/logging/log.h>
+
+#include "metrics.h"
+
+#include <algorithm>
+
+
+using namespace std;
+
+
+namespace Seiscomp {
+namespace Messaging {
+namespace Broker {
+
+
+namespace {
+
+
+mutex enableMutex;
+
+// Upper bounds in seconds of the exported histogram buckets
+const double HistogramBounds[] = {
+	0.0001, 0.00025, 0.0005,
+	0.001, 0.0025, 0.005,
+	0.01, 0.025, 0.05,
+	0.1, 0.25, 0.5,
+	1, 2.5, 5, 10
+};
+
+
+const char *typeName(Metrics::Type type) {
+	switch ( type ) {
+		case Metrics::Type::Counter:
+			return "counter";
+		case Metrics::Type::Gauge:
+			return "gauge";
+		case Metrics::Type::Histogram:
+			return "histogram";
+	}
+
+	return "untyped";
+}
+
+
+string renderLabels(const Metrics::Labels &labels) {
+	string rendered;
+
+	for ( const auto &[name, value] : labels ) {
+		if ( !rendered.empty() ) {
+			rendered += ',';
+		}
+
+		rendered += name;
+		rendered += "=\"";
+		for ( char c : value ) {
+			switch ( c ) {
+				case '\\':
+					rendered += "\\\\";
+					break;
+				case '"':
+					rendered += "\\\"";
+					break;
+				case '\n':
+					rendered += "\\n";
+					break;
+				default:
+					rendered += c;
+					break;
+			}
+		}
+		rendered += '"';
+	}
+
+	return rendered;
+}
+
+
+void writeLabels(ostream &os, const string &labels) {
+	if ( !labels.empty() ) {
+		os << '{' << labels << '}';
+	}
+}
+
+
+void writeHistogram(ostream &os, const string &name, const string &labels,
+                    const Util::LatencyHistogram &hist) {
+	auto snapshot = hist.snapshot();
+	string prefix = labels.empty() ? string() : labels + ",";
+	uint64_t cumulative = 0;
+	size_t bucket = 0;
+
+	// A histogram bucket is only accounted if it lies completely below
+	// the bound, so a value close to a bound might be reported in the
+	// next bucket.
+	for ( double bound : HistogramBounds ) {
+		auto limit = static_cast<uint64_t>(bound * 1E6);
+		while ( (bucket < Util::LatencyHistogram::BucketCount)
+		     && (Util::LatencyHistogram::upperBound(bucket) <= limit) ) {
+			cumulative += snapshot.counts[bucket];
+			++bucket;
+		}
+
+		os << name << "_bucket{" << prefix << "le=\"" << bound << "\"} "
+		   << cumulative << '\n';
+	}
+
+	os << name << "_bucket{" << prefix << "le=\"+Inf\"} "
+	   << snapshot.count << '\n';
+
+	os << name << "_sum";
+	writeLabels(os, labels);
+	os << ' ' << snapshot.sum * 1E-6 << '\n';
+
+	os << name << "_count";
+	writeLabels(os, labels);
+	os << ' ' << snapshot.count << '\n';
+}
+
+
+}
+
+
+std::atomic<Metrics*> Metrics::_instance{nullptr};
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Metrics::Metrics() {}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Metrics *Metrics::Enable() {
+	lock_guard<mutex> l(enableMutex);
+	Metrics *metrics = _instance.load(memory_order_acquire);
+	if ( !metrics ) {
+		// Never deleted: sessions and plugins may still hold metrics
+		// at exit
+		metrics = new Metrics;
+		_instance.store(metrics, memory_order_release);
+	}
+
+	return metrics;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+shared_ptr<void> Metrics::add(const string &name, const string &help,
+                              Type type, const Labels &labels,
+                              const function<shared_ptr<void>()> &create) {
+	string rendered = renderLabels(labels);
+
+	lock_guard<mutex> l(_mutex);
+
+	auto it = _families.find(name);
+	if ( it == _families.end() ) {
+		it = _families.emplace(name, Family{help, type, {}}).first;
+	}
+	else if ( it->second.type != type ) {
+		SEISCOMP_ERROR("Metric %s registered as %s and %s, the latter is "
+		               "not exported", name.c_str(),
+		               typeName(it->second.type), typeName(type));
+		return create();
+	}
+
+	auto &series = it->second.series;
+
+	// Drop series whose owner has gone and share an existing one
+	shared_ptr<void> object;
+	series.erase(
+		remove_if(series.begin(), series.end(), [&](const Series &s) {
+			if ( s.object.expired() ) {
+				return true;
+			}
+
+			if ( !object && (s.labels == rendered) ) {
+				object = s.object.lock();
+			}
+
+			return false;
+		}),
+		series.end()
+	);
+
+	if ( !object ) {
+		object = create();
+		series.push_back(Series{rendered, object});
+	}
+
+	return object;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Metrics::CounterPtr Metrics::counter(const string &name, const string &help,
+                                     const Labels &labels) {
+	return static_pointer_cast<Counter>(
+		add(name, help, Type::Counter, labels,
+		    []() { return make_shared<Counter>(); })
+	);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Metrics::GaugePtr Metrics::gauge(const string &name, const string &help,
+                                 const Labels &labels) {
+	return static_pointer_cast<Gauge>(
+		add(name, help, Type::Gauge, labels,
+		    []() { return make_shared<Gauge>(); })
+	);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Metrics::HistogramPtr Metrics::histogram(const string &name, const string &help,
+                                         const Labels &labels) {
+	return static_pointer_cast<Util::LatencyHistogram>(
+		add(name, help, Type::Histogram, labels,
+		    []() { return make_shared<Util::LatencyHistogram>(); })
+	);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Metrics::Transfer Metrics::transfer(const string &queue, const string &group) {
+	Labels labels = {{"queue", queue}, {"group", group}};
+	Transfer tx;
+
+	tx.receivedMessages = counter("scmaster_group_received_messages_total",
+	                              "Messages received for a group", labels);
+	tx.receivedBytes = counter("scmaster_group_received_bytes_total",
+	                           "Bytes received for a group", labels);
+	tx.sentMessages = counter("scmaster_group_sent_messages_total",
+	                          "Messages sent to the members of a group", labels);
+	tx.sentBytes = counter("scmaster_group_sent_bytes_total",
+	                       "Bytes sent to the members of a group", labels);
+
+	return tx;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void Metrics::write(ostream &os) {
+	lock_guard<mutex> l(_mutex);
+
+	for ( auto &[name, family] : _families ) {
+		bool header = false;
+
+		for ( const auto &series : family.series ) {
+			auto object = series.object.lock();
+			if ( !object ) {
+				continue;
+			}
+
+			if ( !header ) {
+				os << "# HELP " << name << ' ' << family.help << '\n'
+				   << "# TYPE " << name << ' ' << typeName(family.type) << '\n';
+				header = true;
+			}
+
+			switch ( family.type ) {
+				case Type::Counter:
+					os << name;
+					writeLabels(os, series.labels);
+					os << ' ' << static_cast<Counter*>(object.get())->value.load(memory_order_relaxed) << '\n';
+					break;
+				case Type::Gauge:
+					os << name;
+					writeLabels(os, series.labels);
+					os << ' ' << static_cast<Gauge*>(object.get())->value.load(memory_order_relaxed) << '\n';
+					break;
+				case Type::Histogram:
+					writeHistogram(os, name, series.labels,
+					               *static_cast<Util::LatencyHistogram*>(object.get()));
+					break;
+			}
+		}
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+size_t Metrics::seriesCount() const {
+	lock_guard<mutex> l(_mutex);
+
+	size_t count = 0;
+	for ( const auto &item : _families ) {
+		count += item.second.series.size();
+	}
+
+	return count;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+}
+}
+}
@@ -0,0 +1,206 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#ifndef SEISCOMP_BROKER_METRICS_H__
+#define SEISCOMP_BROKER_METRICS_H__
+
+
+#include <seiscomp/utils/latency.h>
+#include <seiscomp/broker/api.h>
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+namespace Seiscomp {
+namespace Messaging {
+namespace Broker {
+
+
+/**
+ * @brief The Metrics class is a registry of counters, gauges and latency
+ *        histograms which are exported in the Prometheus text format.
+ *
+ * Metrics are updated where the events happen. Exporting them neither walks
+ * the queues and clients nor locks the queue workers. Each metric is owned
+ * by the object that updates it, the registry only holds weak references
+ * and drops metrics whose owner has gone, e.g. a disconnected client.
+ *
+ * The process-wide registry is created with Enable() and returned by
+ * Instance() which returns nullptr as long as metrics are disabled.
+ */
+class SC_BROKER_API Metrics {
+	// ----------------------------------------------------------------------
+	//  Public types
+	// ----------------------------------------------------------------------
+	public:
+		enum struct Type {
+			Counter,
+			Gauge,
+			Histogram
+		};
+
+		struct Counter {
+			void add(uint64_t v = 1) {
+				value.fetch_add(v, std::memory_order_relaxed);
+			}
+
+			std::atomic<uint64_t> value{0};
+		};
+
+		struct Gauge {
+			void set(int64_t v) {
+				value.store(v, std::memory_order_relaxed);
+			}
+
+			std::atomic<int64_t> value{0};
+		};
+
+		using CounterPtr = std::shared_ptr<Counter>;
+		using GaugePtr = std::shared_ptr<Gauge>;
+		using HistogramPtr = std::shared_ptr<Util::LatencyHistogram>;
+
+		//! Label names and values of a series
+		using Labels = std::vector<std::pair<std::string, std::string>>;
+
+		//! Message and byte counters of a group. A default constructed
+		//! instance does nothing.
+		struct Transfer {
+			void received(size_t bytes);
+			void sent(size_t bytes);
+
+			CounterPtr receivedMessages;
+			CounterPtr receivedBytes;
+			CounterPtr sentMessages;
+			CounterPtr sentBytes;
+		};
+
+
+	// ----------------------------------------------------------------------
+	//  X'truction
+	// ----------------------------------------------------------------------
+	public:
+		Metrics();
+
+		Metrics(const Metrics &) = delete;
+		Metrics &operator=(const Metrics &) = delete;
+
+
+	// ----------------------------------------------------------------------
+	//  Public interface
+	// ----------------------------------------------------------------------
+	public:
+		//! Returns the process-wide registry or nullptr if disabled
+		static Metrics *Instance();
+
+		//! Creates the process-wide registry if not yet done and returns it
+		static Metrics *Enable();
+
+		/**
+		 * @brief Returns a metric of a family. If the series with the same
+		 *        labels exists already, it is shared.
+		 * @param name The metric name, e.g. scmaster_send_latency_seconds
+		 * @param help The description of the family
+		 * @param labels The labels of the series
+		 */
+		CounterPtr counter(const std::string &name, const std::string &help,
+		                   const Labels &labels = Labels());
+		GaugePtr gauge(const std::string &name, const std::string &help,
+		               const Labels &labels = Labels());
+		HistogramPtr histogram(const std::string &name, const std::string &help,
+		                       const Labels &labels = Labels());
+
+		//! Returns the transfer counters of a group of a queue
+		Transfer transfer(const std::string &queue, const std::string &group);
+
+		/**
+		 * @brief Writes all metrics in the Prometheus text exposition
+		 *        format. Histograms are recorded in microseconds and
+		 *        exported in seconds.
+		 */
+		void write(std::ostream &os);
+
+		//! Returns the number of registered series including those whose
+		//! owner has gone but which have not been dropped yet
+		size_t seriesCount() const;
+
+
+	// ----------------------------------------------------------------------
+	//  Private members
+	// ----------------------------------------------------------------------
+	private:
+		struct Series {
+			std::string         labels;
+			std::weak_ptr<void> object;
+		};
+
+		struct Family {
+			std::string         help;
+			Type                type;
+			std::vector<Series> series;
+		};
+
+		using Families = std::map<std::string, Family>;
+
+		std::shared_ptr<void> add(const std::string &name, const std::string &help,
+		                          Type type, const Labels &labels,
+		                          const std::function<std::shared_ptr<void>()> &create);
+
+		mutable std::mutex _mutex;
+		Families           _families;
+
+		static std::atomic<Metrics*> _instance;
+};
+
+
+inline Metrics *Metrics::Instance() {
+	return _instance.load(std::memory_order_acquire);
+}
+
+
+inline void Metrics::Transfer::received(size_t bytes) {
+	if ( receivedMessages ) {
+		receivedMessages->add();
+		receivedBytes->add(bytes);
+	}
+}
+
+
+inline void Metrics::Transfer::sent(size_t bytes) {
+	if ( sentMessages ) {
+		sentMessages->add();
+		sentBytes->add(bytes);
+	}
+}
+
+
+}
+}
+}
+
+
+#endif
@@ -48,13 +48,21 @@ namespace Protocol {
  * Queue: [name of queue]
  * Client-Name: [name of client]
  * Subscriptions: [list of groups]
+ * Subscription-Filter: [group]:[filter expression]
  * Seq-No: [last seen sequence number]
+ * Compact-Binary-Version: [highest supported compact binary version]
  *
  * ^@
  * ```
  *
  * The *Seq-No* header contains the last sequence number the client has seen from
- * that queue. That header is optional. If subscriptions are given then the
+ * that queue. That header is optional. The *Compact-Binary-Version* header
+ * announces that the client can decode messages in the compact binary format.
+ * Without it, compact binary messages are converted to the binary format
+ * before they are sent to the client. The *Subscription-Filter* header can be
+ * repeated and attaches a filter expression to one of the groups in
+ * *Subscriptions*, see **SUBSCRIBE**. The filters are applied before messages
+ * are replayed from *Seq-No*. If subscriptions are given then the
  * client will receive an **ENTER** frame for each group it subscribed to. If any
  * of the requested groups does not exist, an **ERROR** frame is sent and the
  * connection is closed.
@@ -78,6 +86,8 @@ namespace Protocol {
 #define SCMP_PROTO_CMD_CONNECT_HEADER_ACK_WINDOW      "Ack-Window"
 #define SCMP_PROTO_CMD_CONNECT_HEADER_SEQ_NUMBER      "Seq-No"
 #define SCMP_PROTO_CMD_CONNECT_HEADER_SUBSCRIPTIONS   "Subscriptions"
+#define SCMP_PROTO_CMD_CONNECT_HEADER_SUBSCRIPTION_FILTER "Subscription-Filter"
+#define SCMP_PROTO_CMD_CONNECT_HEADER_COMPACT_BINARY_VERSION "Compact-Binary-Version"
 
 /**
  * ```
@@ -97,14 +107,23 @@ namespace Protocol {
  * ```
  * SUBSCRIBE
  * Groups: [list of groups]
+ * Filter: [filter expression]
  *
  * ^@
  * ```
  * Subscribes to a specific group which must exist on the server. In response
  * either an **ENTER** or **ERROR** frame will be received.
+ *
+ * The optional *Filter* header applies to all groups of the frame and
+ * restricts the forwarded messages to those notifiers which match the
+ * expression, e.g. `class=Pick,Amplitude;network=GE`. Supported keys are
+ * *class*, *network*, *station*, *agency* and *operation*. Each key takes a
+ * comma separated list of wildcard patterns. Messages with only some
+ * matching notifiers are forwarded with the matching notifiers only.
  */
 #define SCMP_PROTO_CMD_SUBSCRIBE      "SUBSCRIBE"
 #define SCMP_PROTO_CMD_SUBSCRIBE_HEADER_GROUPS        "Groups"
+#define SCMP_PROTO_CMD_SUBSCRIBE_HEADER_FILTER        "Filter"
 
 /**
  * ```
@@ -191,6 +210,7 @@ namespace Protocol {
 #define SCMP_PROTO_REPLY_CONNECT_HEADER_FRAMEWORK_VERSION "Framework-Version"
 #define SCMP_PROTO_REPLY_CONNECT_HEADER_SCHEMA_VERSION    "Schema-Version"
 #define SCMP_PROTO_REPLY_CONNECT_HEADER_BINARY_VERSION    "Binary-Version"
+#define SCMP_PROTO_REPLY_CONNECT_HEADER_COMPACT_BINARY_VERSION "Compact-Binary-Version"
 #define SCMP_PROTO_REPLY_CONNECT_HEADER_QUEUE             SCMP_PROTO_CMD_CONNECT_HEADER_QUEUE
 #define SCMP_PROTO_REPLY_CONNECT_HEADER_CLIENT_NAME       SCMP_PROTO_CMD_CONNECT_HEADER_CLIENT_NAME
 #define SCMP_PROTO_REPLY_CONNECT_HEADER_ACK_WINDOW        SCMP_PROTO_CMD_CONNECT_HEADER_ACK_WINDOW
@@ -61,6 +61,12 @@ namespace {
 
 System::HostInfo HostInfo;
 
+
+// Returns the message in a format the client can decode
+Message *outgoing(const Client *client, Message *msg) {
+	return client->acceptsCompactBinary() ? msg : msg->binaryFallback();
+}
+
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -137,7 +143,12 @@ Queue::Result Queue::addGroup(const std::string &name) {
 	if ( _groups.find(name) != _groups.end() )
 		return GroupNameNotUnique;
 
-	_groups[name] = new Group(name.c_str());
+	auto group = new Group(name.c_str());
+	if ( auto metrics = Metrics::Instance() ) {
+		group->_transfer = metrics->transfer(_name, name);
+	}
+
+	_groups[name] = group;
 	_groupNames.push_back(name);
 	return Success;
 }
@@ -185,6 +196,7 @@ Queue::Result Queue::push(Client *sender, Message *msg, int packetSize) {
 		++git->second->_txMessages.received;
 		git->second->_txBytes.received += packetSize;
 		git->second->_txPayload.received += msg->payload.size();
+		git->second->_transfer.received(packetSize);
 	}
 
 	++_txMessages.received;
@@ -312,10 +324,14 @@ bool Queue::publish(Client *sender, Message *msg) {
 		if ( cit == _clients.end() )
 			return false;
 
-		cit.value()->publish(sender, msg);
+		Message *out = outgoing(cit.value(), msg);
+		if ( !out )
+			return false;
+
+		cit.value()->publish(sender, out);
 
 		++_txMessages.sent;
-		_txPayload.sent += msg->payload.size();
+		_txPayload.sent += out->payload.size();
 	}
 	else {
 		// Distribute to members
@@ -323,14 +339,32 @@ bool Queue::publish(Client *sender, Message *msg) {
 		msg->_internalGroupPtr = group;
 
 		for ( auto client : group->_members ) {
-			client->publish(sender, msg);
+			Message *out = msg;
+
+			auto filter = client->subscriptionFilter(group);
+			if ( filter ) {
+				// Evaluated once per message and filter expression, the
+				// result is cached in the message
+				out = filter->apply(msg);
+				if ( !out ) {
+					continue;
+				}
+			}
+
+			out = outgoing(client, out);
+			if ( !out ) {
+				continue;
+			}
+
+			client->publish(sender, out);
 			// Each message sent to a member of a particular group is tagged
 			// as sent.
 			++git->second->_txMessages.sent;
-			git->second->_txBytes.sent += msg->payload.size();
+			git->second->_txBytes.sent += out->payload.size();
+			git->second->_transfer.sent(out->payload.size());
 
 			++_txMessages.sent;
-			_txPayload.sent += msg->payload.size();
+			_txPayload.sent += out->payload.size();
 		}
 	}
 
@@ -342,7 +376,10 @@ bool Queue::publish(Client *sender, Message *msg) {
 
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
-Queue::Result Queue::subscribe(Client *client, const std::string &groupName) {
+Queue::Result Queue::subscribe(Client *client, const std::string &groupName,
+                               SubscriptionFilter *filter) {
+	SubscriptionFilterPtr guard(filter);
+
 	Groups::iterator it = _groups.find(groupName);
 	if ( it == _groups.end() )
 		// GROUP NOT FOUND
@@ -353,6 +390,13 @@ Queue::Result Queue::subscribe(Client *client, const std::string &groupName) {
 	if ( !group->addMember(client) )
 		return GroupAlreadySubscribed;
 
+	if ( filter ) {
+		SEISCOMP_DEBUG("Client '%s' subscribed to '%s' with filter '%s'",
+		               client->_name.c_str(), groupName.c_str(),
+		               filter->expression().c_str());
+		client->_subscriptionFilters.emplace_back(group, filter);
+	}
+
 	Message msg;
 
 	msg.sender = senderName();
@@ -386,6 +430,14 @@ Queue::Result Queue::unsubscribe(Client *client, const std::string &groupName) {
 	if ( !group->removeMember(client) )
 		return GroupNotSubscribed;
 
+	for ( auto fit = client->_subscriptionFilters.begin();
+	      fit != client->_subscriptionFilters.end(); ++fit ) {
+		if ( fit->first == group ) {
+			client->_subscriptionFilters.erase(fit);
+			break;
+		}
+	}
+
 	Message msg;
 
 	msg.sender = senderName();
@@ -436,9 +488,27 @@ Message *Queue::getMessage(SequenceNumber sequenceNumber,
 		Message *msg = _messages[idx].get();
 		// If the messages target group has client as member, return it
 		if ( msg->_internalGroupPtr->hasMember(client) ) {
+			auto filter = client->subscriptionFilter(msg->_internalGroupPtr);
+			if ( filter ) {
+				Message *out = filter->apply(msg);
+				if ( !out ) {
+					++idx;
+					continue;
+				}
+
+				msg = out;
+			}
+
+			msg = outgoing(client, msg);
+			if ( !msg ) {
+				++idx;
+				continue;
+			}
+
 			// Update statistics
 			++msg->_internalGroupPtr->_txMessages.sent;
 			msg->_internalGroupPtr->_txBytes.sent += msg->payload.size();
+			msg->_internalGroupPtr->_transfer.sent(msg->payload.size());
 
 			++_txMessages.sent;
 			_txBytes.sent += msg->payload.size();
@@ -446,6 +516,12 @@ Message *Queue::getMessage(SequenceNumber sequenceNumber,
 		}
 		// If the message is a private message for client, return it
 		if ( msg->target == client->name() ) {
+			msg = outgoing(client, msg);
+			if ( !msg ) {
+				++idx;
+				continue;
+			}
+
 			++_txMessages.sent;
 			_txBytes.sent += msg->payload.size();
 			return msg;
@@ -543,6 +619,8 @@ Queue::Result Queue::disconnect(Client *client) {
 		}
 	}
 
+	client->_subscriptionFilters.clear();
+
 	if ( !_connectionProcessors.empty() ) {
 		// Notify all client processor about the disconnect
 		MessageProcessors::iterator cit;
@@ -843,6 +921,7 @@ void Queue::timeout() {
 				++git->second->_txMessages.sent;
 				git->second->_txPayload.sent += lengthPayload;
 				git->second->_txBytes.sent += lengthMessage;
+				git->second->_transfer.sent(lengthMessage);
 
 				++_txMessages.sent;
 				_txPayload.sent += lengthPayload;
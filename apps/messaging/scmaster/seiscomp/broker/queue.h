@@ -29,6 +29,7 @@
 #include <seiscomp/core/message.h>
 
 #include <seiscomp/broker/messageprocessor.h>
+#include <seiscomp/broker/filter.h>
 #include <seiscomp/broker/hashset.h>
 #include <seiscomp/broker/group.h>
 #include <seiscomp/broker/message.h>
@@ -175,9 +176,13 @@ class SC_BROKER_API Queue {
 		 * @brief Subscribe a client to a particular group
 		 * @param client The client
 		 * @param group The name of the group
+		 * @param filter An optional filter which restricts the messages
+		 *               forwarded to the client. It is held by the client
+		 *               until it unsubscribes from the group.
 		 * @return The result code
 		 */
-		Result subscribe(Client *client, const std::string &group);
+		Result subscribe(Client *client, const std::string &group,
+		                 SubscriptionFilter *filter = nullptr);
 
 		/**
 		 * @brief Unsubscribes a client from a particular group
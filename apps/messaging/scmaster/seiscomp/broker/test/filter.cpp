@@ -0,0 +1,333 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#define SEISCOMP_TEST_MODULE SeisComP
+
+#include <seiscomp/unittest/unittests.h>
+
+#include <seiscomp/broker/client.h>
+#include <seiscomp/broker/filter.h>
+#include <seiscomp/broker/message.h>
+#include <seiscomp/broker/queue.h>
+#include <seiscomp/datamodel/amplitude.h>
+#include <seiscomp/datamodel/network.h>
+#include <seiscomp/datamodel/notifier.h>
+#include <seiscomp/datamodel/origin.h>
+#include <seiscomp/datamodel/pick.h>
+#include <seiscomp/datamodel/station.h>
+#include <seiscomp/datamodel/version.h>
+
+#include <vector>
+
+
+using namespace std;
+using namespace Seiscomp;
+using namespace Seiscomp::Messaging::Broker;
+
+
+namespace {
+
+
+class TestClient : public Client {
+	public:
+		TestClient(const string &name) { _name = name; }
+
+	public:
+		Wired::Socket::IPAddress IPAddress() const override {
+			return Wired::Socket::IPAddress();
+		}
+
+		size_t publish(Client *, Message *msg) override {
+			received.push_back(msg);
+			return msg->payload.size();
+		}
+
+		void enter(const Group *, const Client *, Message *) override {}
+		void leave(const Group *, const Client *, Message *) override {}
+		void disconnected(const Client *, Message *) override {}
+		void ack() override {}
+		void dispose() override {}
+
+	public:
+		vector<MessagePtr> received;
+};
+
+
+DataModel::NotifierPtr pickNotifier(const string &publicID, const string &net,
+                                    DataModel::Operation op = DataModel::OP_ADD) {
+	DataModel::PickPtr pick = DataModel::Pick::Create(publicID);
+	pick->setTime(Core::Time(2024, 1, 1));
+	pick->setWaveformID(DataModel::WaveformStreamID(net, "STA", "", "BHZ", ""));
+	DataModel::CreationInfo ci;
+	ci.setAgencyID("GFZ");
+	pick->setCreationInfo(ci);
+	return new DataModel::Notifier("EventParameters", op, pick.get());
+}
+
+
+// Creates an encoded message with a pick for each network
+MessagePtr createMessage(const vector<string> &networks) {
+	static int pickCount = 0;
+
+	DataModel::NotifierMessagePtr nm = new DataModel::NotifierMessage;
+	for ( auto &net : networks ) {
+		nm->attach(pickNotifier("Pick/" + net + "/" + Core::toString(++pickCount), net).get());
+	}
+
+	MessagePtr msg = new Message;
+	msg->type = Message::Type::Regular;
+	msg->target = "PICK";
+	msg->mimeType = MimeType(Binary).toString();
+	msg->schemaVersion = Core::Version(DataModel::Version::Major, DataModel::Version::Minor);
+	msg->object = nm;
+	BOOST_REQUIRE(msg->encode());
+	// Only the payload is transferred
+	msg->object = nullptr;
+
+	return msg;
+}
+
+
+// Returns the network codes of the picks of a message
+vector<string> decodeNetworks(const Message *received) {
+	Message msg;
+	msg.mimeType = received->mimeType;
+	msg.encoding = received->encoding;
+	msg.payload = received->payload;
+
+	vector<string> networks;
+	if ( !msg.decode() ) {
+		return networks;
+	}
+
+	auto nm = DataModel::NotifierMessage::Cast(msg.object);
+	if ( !nm ) {
+		return networks;
+	}
+
+	for ( auto &n : *nm ) {
+		auto pick = DataModel::Pick::Cast(n->object());
+		if ( pick ) {
+			networks.push_back(pick->waveformID().networkCode());
+		}
+	}
+
+	return networks;
+}
+
+
+bool matches(const string &expression, const DataModel::Notifier *n) {
+	SubscriptionFilterPtr filter = SubscriptionFilter::Create(expression);
+	BOOST_REQUIRE(filter);
+	return filter->matches(n);
+}
+
+
+}
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(CREATE) {
+	SubscriptionFilterPtr filter;
+
+	// Keys are ordered and patterns are trimmed
+	filter = SubscriptionFilter::Create(" network = GE , CX ; class=Pick;");
+	BOOST_REQUIRE(filter);
+	BOOST_CHECK_EQUAL(filter->expression(), "class=Pick;network=GE,CX");
+
+	filter = SubscriptionFilter::Create("operation=add;agency=GFZ;station=UGM");
+	BOOST_REQUIRE(filter);
+	BOOST_CHECK_EQUAL(filter->expression(), "station=UGM;agency=GFZ;operation=add");
+
+	// Malformed expressions
+	BOOST_CHECK(!SubscriptionFilterPtr(SubscriptionFilter::Create("")));
+	BOOST_CHECK(!SubscriptionFilterPtr(SubscriptionFilter::Create(" ; ;")));
+	BOOST_CHECK(!SubscriptionFilterPtr(SubscriptionFilter::Create("class")));
+	BOOST_CHECK(!SubscriptionFilterPtr(SubscriptionFilter::Create("class=")));
+	BOOST_CHECK(!SubscriptionFilterPtr(SubscriptionFilter::Create("class= , ")));
+	BOOST_CHECK(!SubscriptionFilterPtr(SubscriptionFilter::Create("type=Pick")));
+	BOOST_CHECK(!SubscriptionFilterPtr(SubscriptionFilter::Create("class=Pick;class=Origin")));
+	BOOST_CHECK(!SubscriptionFilterPtr(SubscriptionFilter::Create("class=Pick;network")));
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(MATCHES) {
+	auto pick = pickNotifier("Pick/1", "GE");
+
+	BOOST_CHECK(matches("class=Pick", pick.get()));
+	BOOST_CHECK(matches("class=P*,Amplitude", pick.get()));
+	BOOST_CHECK(!matches("class=Amplitude", pick.get()));
+	BOOST_CHECK(matches("network=G?;station=ST*", pick.get()));
+	BOOST_CHECK(!matches("network=CX", pick.get()));
+	BOOST_CHECK(!matches("class=Pick;station=UGM", pick.get()));
+	BOOST_CHECK(matches("agency=GFZ", pick.get()));
+	BOOST_CHECK(!matches("agency=USGS", pick.get()));
+	BOOST_CHECK(matches("operation=add", pick.get()));
+	BOOST_CHECK(!matches("operation=update,remove", pick.get()));
+
+	// The waveform id of amplitudes is evaluated as well
+	DataModel::AmplitudePtr amp = DataModel::Amplitude::Create("Amplitude/1");
+	amp->setWaveformID(DataModel::WaveformStreamID("CX", "PB01", "", "HHZ", ""));
+	DataModel::NotifierPtr ampNotifier = new DataModel::Notifier("EventParameters", DataModel::OP_ADD, amp.get());
+	BOOST_CHECK(matches("network=CX", ampNotifier.get()));
+	BOOST_CHECK(!matches("network=GE", ampNotifier.get()));
+	// Without creation info the agency is not evaluated
+	BOOST_CHECK(matches("agency=GFZ", ampNotifier.get()));
+
+	// Origins do not have a network code
+	DataModel::OriginPtr origin = DataModel::Origin::Create("Origin/1");
+	DataModel::NotifierPtr originNotifier = new DataModel::Notifier("EventParameters", DataModel::OP_UPDATE, origin.get());
+	BOOST_CHECK(matches("network=GE", originNotifier.get()));
+	BOOST_CHECK(!matches("network=GE;operation=add", originNotifier.get()));
+
+	// Inventory objects are matched by their codes
+	DataModel::NetworkPtr net = DataModel::Network::Create("Network/GE");
+	net->setCode("GE");
+	DataModel::NotifierPtr netNotifier = new DataModel::Notifier("Inventory", DataModel::OP_ADD, net.get());
+	BOOST_CHECK(matches("network=GE", netNotifier.get()));
+	BOOST_CHECK(!matches("network=CX", netNotifier.get()));
+
+	DataModel::StationPtr sta = DataModel::Station::Create("Station/GE/UGM");
+	sta->setCode("UGM");
+	DataModel::NotifierPtr staNotifier = new DataModel::Notifier("Network/GE", DataModel::OP_ADD, sta.get());
+	BOOST_CHECK(matches("station=UGM", staNotifier.get()));
+	BOOST_CHECK(!matches("station=MORC", staNotifier.get()));
+
+	// Notifiers without object never pass
+	DataModel::NotifierPtr empty = new DataModel::Notifier("EventParameters", DataModel::OP_ADD, nullptr);
+	BOOST_CHECK(!matches("class=*", empty.get()));
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(APPLY) {
+	MessagePtr msg = createMessage({"GE", "CX", "GE"});
+
+	// All notifiers pass, the message is forwarded unchanged
+	SubscriptionFilterPtr all = SubscriptionFilter::Create("network=GE,CX");
+	BOOST_CHECK(all->apply(msg.get()) == msg.get());
+
+	// No notifier passes
+	SubscriptionFilterPtr none = SubscriptionFilter::Create("network=XX");
+	BOOST_CHECK(none->apply(msg.get()) == nullptr);
+
+	// Some notifiers pass, a reduced copy is forwarded
+	SubscriptionFilterPtr ge = SubscriptionFilter::Create("network=GE");
+	Message *reduced = ge->apply(msg.get());
+	BOOST_REQUIRE(reduced != nullptr);
+	BOOST_CHECK(reduced != msg.get());
+	BOOST_CHECK_EQUAL(reduced->sequenceNumber, msg->sequenceNumber);
+	BOOST_CHECK_EQUAL(reduced->target, msg->target);
+	BOOST_CHECK(decodeNetworks(reduced) == vector<string>({"GE", "GE"}));
+	BOOST_CHECK(decodeNetworks(msg.get()) == vector<string>({"GE", "CX", "GE"}));
+
+	// The results are cached per normalized expression and shared by
+	// equivalent filters
+	BOOST_CHECK_EQUAL(msg->filterResults.size(), 3);
+	SubscriptionFilterPtr ge2 = SubscriptionFilter::Create(" network = GE ");
+	BOOST_CHECK(ge2->apply(msg.get()) == reduced);
+	BOOST_CHECK(none->apply(msg.get()) == nullptr);
+	BOOST_CHECK_EQUAL(msg->filterResults.size(), 3);
+
+	// Messages of other types are not filtered
+	MessagePtr status = new Message;
+	status->type = Message::Type::Status;
+	BOOST_CHECK(none->apply(status.get()) == status.get());
+
+	// Regular messages without notifiers are not filtered
+	MessagePtr garbage = new Message;
+	garbage->type = Message::Type::Regular;
+	garbage->mimeType = MimeType(Binary).toString();
+	garbage->payload = "garbage";
+	BOOST_CHECK(none->apply(garbage.get()) == garbage.get());
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(QUEUE_PUBLISH) {
+	Queue queue("test", 1024*1024);
+	queue.addGroup("PICK");
+
+	TestClient sender("sender"), plain("plain"), filtered("filtered");
+	for ( auto client : { &sender, &plain, &filtered } ) {
+		Queue::KeyValues outParams;
+		BOOST_REQUIRE_EQUAL(queue.connect(client, nullptr, 0, outParams), Queue::Success);
+	}
+
+	BOOST_REQUIRE_EQUAL(queue.subscribe(&plain, "PICK"), Queue::Success);
+	BOOST_REQUIRE_EQUAL(queue.subscribe(&filtered, "PICK", SubscriptionFilter::Create("network=GE")),
+	                    Queue::Success);
+
+	MessagePtr mixed = createMessage({"GE", "CX"});
+	MessagePtr other = createMessage({"CX"});
+	MessagePtr matching = createMessage({"GE"});
+
+	for ( auto &msg : { mixed, other, matching } ) {
+		BOOST_REQUIRE_EQUAL(queue.push(&sender, msg.get()), Queue::Success);
+	}
+
+	BOOST_REQUIRE_EQUAL(plain.received.size(), 3);
+	BOOST_CHECK(plain.received[0] == mixed);
+	BOOST_CHECK(plain.received[1] == other);
+	BOOST_CHECK(plain.received[2] == matching);
+
+	BOOST_REQUIRE_EQUAL(filtered.received.size(), 2);
+	BOOST_CHECK(filtered.received[0] != mixed);
+	BOOST_CHECK(decodeNetworks(filtered.received[0].get()) == vector<string>({"GE"}));
+	BOOST_CHECK(filtered.received[1] == matching);
+
+	// Replaying the backlog applies the filter as well
+	Message *queued = queue.getMessage(mixed->sequenceNumber, &filtered);
+	BOOST_REQUIRE(queued != nullptr);
+	BOOST_CHECK(queued == filtered.received[0].get());
+
+	queued = queue.getMessage(mixed->sequenceNumber + 1, &filtered);
+	BOOST_REQUIRE(queued != nullptr);
+	BOOST_CHECK(queued == matching.get());
+
+	queued = queue.getMessage(mixed->sequenceNumber + 1, &plain);
+	BOOST_REQUIRE(queued != nullptr);
+	BOOST_CHECK(queued == other.get());
+
+	// The filter is released with the subscription
+	BOOST_REQUIRE_EQUAL(queue.unsubscribe(&filtered, "PICK"), Queue::Success);
+	BOOST_REQUIRE_EQUAL(queue.subscribe(&filtered, "PICK"), Queue::Success);
+	filtered.received.clear();
+
+	BOOST_REQUIRE_EQUAL(queue.push(&sender, createMessage({"CX"}).get()), Queue::Success);
+	BOOST_CHECK_EQUAL(filtered.received.size(), 1);
+
+	for ( auto client : { &sender, &plain, &filtered } ) {
+		queue.disconnect(client);
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
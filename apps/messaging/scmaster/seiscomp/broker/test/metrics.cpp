@@ -0,0 +1,263 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#define SEISCOMP_TEST_MODULE SeisComP
+
+#include <seiscomp/unittest/unittests.h>
+
+#include <seiscomp/broker/metrics.h>
+
+#include <sstream>
+
+
+using namespace std;
+using namespace Seiscomp;
+using namespace Seiscomp::Messaging::Broker;
+
+
+namespace {
+
+
+string render(Metrics &metrics) {
+	ostringstream os;
+	metrics.write(os);
+	return os.str();
+}
+
+
+// Returns the value of the line which starts with the given series
+string value(const string &text, const string &series) {
+	istringstream is(text);
+	string line;
+
+	while ( getline(is, line) ) {
+		if ( line.compare(0, series.size() + 1, series + " ") == 0 ) {
+			return line.substr(series.size() + 1);
+		}
+	}
+
+	return string();
+}
+
+
+}
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(COUNTER_GAUGE) {
+	Metrics metrics;
+
+	auto a = metrics.counter("test_total", "Test", {{"queue", "production"}});
+	auto b = metrics.counter("test_total", "Test", {{"queue", "production"}});
+	auto c = metrics.counter("test_total", "Test", {{"queue", "playback"}});
+
+	// The same labels share the series
+	BOOST_CHECK(a == b);
+	BOOST_CHECK(a != c);
+
+	a->add();
+	b->add(4);
+	c->add(2);
+
+	auto gauge = metrics.gauge("test_clients", "Clients");
+	gauge->set(7);
+	gauge->set(-3);
+
+	string text = render(metrics);
+	BOOST_CHECK_EQUAL(value(text, "test_total{queue=\"production\"}"), "5");
+	BOOST_CHECK_EQUAL(value(text, "test_total{queue=\"playback\"}"), "2");
+	BOOST_CHECK_EQUAL(value(text, "test_clients"), "-3");
+
+	// Transfer counters are labeled by queue and group
+	auto tx = metrics.transfer("production", "PICK");
+	tx.received(100);
+	tx.received(50);
+	tx.sent(100);
+
+	text = render(metrics);
+	string labels = "{queue=\"production\",group=\"PICK\"}";
+	BOOST_CHECK_EQUAL(value(text, "scmaster_group_received_messages_total" + labels), "2");
+	BOOST_CHECK_EQUAL(value(text, "scmaster_group_received_bytes_total" + labels), "150");
+	BOOST_CHECK_EQUAL(value(text, "scmaster_group_sent_messages_total" + labels), "1");
+	BOOST_CHECK_EQUAL(value(text, "scmaster_group_sent_bytes_total" + labels), "100");
+
+	// A default constructed transfer does nothing
+	Metrics::Transfer disabled;
+	disabled.received(100);
+	disabled.sent(100);
+
+	// A name registered with another type is not exported
+	auto other = metrics.gauge("test_total", "Test", {{"queue", "other"}});
+	BOOST_REQUIRE(other);
+	other->set(1);
+	BOOST_CHECK_EQUAL(value(render(metrics), "test_total{queue=\"other\"}"), "");
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(HISTOGRAM_BUCKETS) {
+	Metrics metrics;
+
+	auto hist = metrics.histogram("test_latency_seconds", "Latency");
+
+	// Values in microseconds which are not close to a bucket bound
+	hist->record(50);
+	hist->record(150);
+	hist->record(700);
+	hist->record(3000);
+	hist->record(20000000);
+
+	string text = render(metrics);
+
+	const pair<const char*, const char*> buckets[] = {
+		{"0.0001", "1"}, {"0.00025", "2"}, {"0.0005", "2"},
+		{"0.001", "3"}, {"0.0025", "3"}, {"0.005", "4"},
+		{"0.01", "4"}, {"0.025", "4"}, {"0.05", "4"},
+		{"0.1", "4"}, {"0.25", "4"}, {"0.5", "4"},
+		{"1", "4"}, {"2.5", "4"}, {"5", "4"}, {"10", "4"},
+		{"+Inf", "5"}
+	};
+
+	for ( const auto &[bound, count] : buckets ) {
+		BOOST_CHECK_EQUAL(
+			value(text, string("test_latency_seconds_bucket{le=\"") + bound + "\"}"),
+			count
+		);
+	}
+
+	BOOST_CHECK_EQUAL(value(text, "test_latency_seconds_sum"), "20.0039");
+	BOOST_CHECK_EQUAL(value(text, "test_latency_seconds_count"), "5");
+
+	// A value is accounted in the first bucket whose bound is not below the
+	// upper bound of its histogram bucket, 100us is reported as 103us
+	hist->reset();
+	hist->record(100);
+	BOOST_CHECK_EQUAL(Util::LatencyHistogram::upperBound(Util::LatencyHistogram::bucket(100)), 103);
+	text = render(metrics);
+	BOOST_CHECK_EQUAL(value(text, "test_latency_seconds_bucket{le=\"0.0001\"}"), "0");
+	BOOST_CHECK_EQUAL(value(text, "test_latency_seconds_bucket{le=\"0.00025\"}"), "1");
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(PRUNE) {
+	Metrics metrics;
+
+	auto kept = metrics.counter("test_total", "Test", {{"client", "a"}});
+	auto gone = metrics.counter("test_total", "Test", {{"client", "b"}});
+	auto gauge = metrics.gauge("test_clients", "Clients");
+	BOOST_CHECK_EQUAL(metrics.seriesCount(), 3);
+
+	// Series whose owner has gone are not exported, a family without
+	// series is omitted completely
+	gone.reset();
+	gauge.reset();
+	string text = render(metrics);
+	BOOST_CHECK(text.find("client=\"b\"") == string::npos);
+	BOOST_CHECK(text.find("test_clients") == string::npos);
+	BOOST_CHECK(text.find("client=\"a\"") != string::npos);
+
+	// They are dropped when the family is accessed the next time
+	BOOST_CHECK_EQUAL(metrics.seriesCount(), 3);
+	auto other = metrics.counter("test_total", "Test", {{"client", "c"}});
+	BOOST_CHECK_EQUAL(metrics.seriesCount(), 3);
+
+	// A new owner of the same labels starts from scratch
+	kept->add(5);
+	auto again = metrics.counter("test_total", "Test", {{"client", "b"}});
+	BOOST_CHECK_EQUAL(again->value.load(), 0);
+	BOOST_CHECK(metrics.counter("test_total", "Test", {{"client", "a"}}) == kept);
+	BOOST_CHECK_EQUAL(metrics.seriesCount(), 4);
+
+	kept.reset();
+	other.reset();
+	again.reset();
+	metrics.counter("test_total", "Test", {{"client", "d"}});
+	BOOST_CHECK_EQUAL(metrics.seriesCount(), 2);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(EXPOSITION) {
+	// The process-wide registry is served at api/metrics
+	BOOST_CHECK(Metrics::Instance() == nullptr);
+	Metrics *metrics = Metrics::Enable();
+	BOOST_REQUIRE(metrics);
+	BOOST_CHECK(Metrics::Instance() == metrics);
+	BOOST_CHECK(Metrics::Enable() == metrics);
+
+	auto sent = metrics->counter("scmaster_test_sent_total", "Sent messages",
+	                             {{"queue", "production"}, {"group", "PICK"}});
+	auto clients = metrics->gauge("scmaster_test_clients", "Connected clients");
+	auto latency = metrics->histogram("scmaster_test_latency_seconds", "Send latency",
+	                                  {{"queue", "production"}});
+	auto escaped = metrics->counter("scmaster_test_escaped_total", "Escaped labels",
+	                                {{"name", "a\"b\\c\nd"}});
+
+	sent->add(3);
+	clients->set(7);
+	latency->record(50);
+	latency->record(3000);
+	escaped->add();
+
+	const char *expected =
+	"# HELP scmaster_test_clients Connected clients\n"
+	"# TYPE scmaster_test_clients gauge\n"
+	"scmaster_test_clients 7\n"
+	"# HELP scmaster_test_escaped_total Escaped labels\n"
+	"# TYPE scmaster_test_escaped_total counter\n"
+	"scmaster_test_escaped_total{name=\"a\\\"b\\\\c\\nd\"} 1\n"
+	"# HELP scmaster_test_latency_seconds Send latency\n"
+	"# TYPE scmaster_test_latency_seconds histogram\n"
+	"scmaster_test_latency_seconds_bucket{queue=\"production\",le=\"0.0001\"} 1\n"
+	"scmaster_test_latency_seconds_bucket{queue=\"production\",le=\"0.00025\"} 1\n"
+	"scmaster_test_latency_seconds_bucket{queue=\"production\",le=\"0.0005\"} 1\n"
+	"scmaster_test_latency_seconds_bucket{queue=\"production\",le=\"0.001\"} 1\n"
+	"scmaster_test_latency_seconds_bucket{queue=\"production\",le=\"0.0025\"} 1\n"
+	"scmaster_test_latency_seconds_bucket{queue=\"production\",le=\"0.005\"} 2\n"
+	"scmaster_test_latency_seconds_bucket{queue=\"production\",le=\"0.01\"} 2\n"
+	"scmaster_test_latency_seconds_bucket{queue=\"production\",le=\"0.025\"} 2\n"
+	"scmaster_test_latency_seconds_bucket{queue=\"production\",le=\"0.05\"} 2\n"
+	"scmaster_test_latency_seconds_bucket{queue=\"production\",le=\"0.1\"} 2\n"
+	"scmaster_test_latency_seconds_bucket{queue=\"production\",le=\"0.25\"} 2\n"
+	"scmaster_test_latency_seconds_bucket{queue=\"production\",le=\"0.5\"} 2\n"
+	"scmaster_test_latency_seconds_bucket{queue=\"production\",le=\"1\"} 2\n"
+	"scmaster_test_latency_seconds_bucket{queue=\"production\",le=\"2.5\"} 2\n"
+	"scmaster_test_latency_seconds_bucket{queue=\"production\",le=\"5\"} 2\n"
+	"scmaster_test_latency_seconds_bucket{queue=\"production\",le=\"10\"} 2\n"
+	"scmaster_test_latency_seconds_bucket{queue=\"production\",le=\"+Inf\"} 2\n"
+	"scmaster_test_latency_seconds_sum{queue=\"production\"} 0.00305\n"
+	"scmaster_test_latency_seconds_count{queue=\"production\"} 2\n"
+	"# HELP scmaster_test_sent_total Sent messages\n"
+	"# TYPE scmaster_test_sent_total counter\n"
+	"scmaster_test_sent_total{queue=\"production\",group=\"PICK\"} 3\n";
+
+	BOOST_CHECK_EQUAL(render(*metrics), expected);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -0,0 +1,213 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#define SEISCOMP_TEST_MODULE SeisComP
+
+#include <seiscomp/unittest/unittests.h>
+
+#include <seiscomp/broker/client.h>
+#include <seiscomp/broker/message.h>
+#include <seiscomp/broker/queue.h>
+#include <seiscomp/core/datamessage.h>
+#include <seiscomp/datamodel/notifier.h>
+#include <seiscomp/datamodel/pick.h>
+#include <seiscomp/io/archive/binarchive.h>
+
+#include <vector>
+
+
+using namespace std;
+using namespace Seiscomp;
+using namespace Seiscomp::Messaging::Broker;
+
+
+namespace {
+
+
+class TestClient : public Client {
+	public:
+		TestClient(const string &name) { _name = name; }
+
+	public:
+		Wired::Socket::IPAddress IPAddress() const override {
+			return Wired::Socket::IPAddress();
+		}
+
+		size_t publish(Client *, Message *msg) override {
+			received.push_back(msg);
+			return msg->payload.size();
+		}
+
+		void enter(const Group *, const Client *, Message *) override {}
+		void leave(const Group *, const Client *, Message *) override {}
+		void disconnected(const Client *, Message *) override {}
+		void ack() override {}
+		void dispose() override {}
+
+	public:
+		vector<MessagePtr> received;
+};
+
+
+MessagePtr createPickMessage(const string &publicID, MimeType mimeType) {
+	DataModel::PickPtr pick = DataModel::Pick::Create(publicID);
+	pick->setTime(Core::Time(2024, 1, 1));
+	pick->setWaveformID(DataModel::WaveformStreamID("GE", "UGM", "", "BHZ", ""));
+
+	DataModel::NotifierMessagePtr nm = new DataModel::NotifierMessage;
+	nm->attach(new DataModel::Notifier("EventParameters", DataModel::OP_ADD, pick.get()));
+
+	MessagePtr msg = new Message;
+	msg->type = Message::Type::Regular;
+	msg->target = "PICK";
+	msg->mimeType = mimeType.toString();
+	msg->object = nm;
+	BOOST_REQUIRE(msg->encode());
+	// Only the payload is transferred
+	msg->object = nullptr;
+
+	return msg;
+}
+
+
+string decodePickID(const Message *received) {
+	Message msg;
+	msg.mimeType = received->mimeType;
+	msg.encoding = received->encoding;
+	msg.payload = received->payload;
+
+	if ( !msg.decode() ) {
+		return string();
+	}
+
+	auto nm = DataModel::NotifierMessage::Cast(msg.object);
+	if ( !nm || nm->empty() ) {
+		return string();
+	}
+
+	auto pick = DataModel::Pick::Cast((*nm->begin())->object());
+	return pick ? pick->publicID() : string();
+}
+
+
+struct Fixture {
+	Fixture()
+	: queue("test", 1024*1024)
+	, sender("sender"), compact("compact"), legacy1("legacy1"), legacy2("legacy2") {
+		queue.addGroup("PICK");
+
+		compact.setCompactBinaryVersion(IO::CompactBinaryArchive::Version);
+
+		for ( auto client : { &sender, &compact, &legacy1, &legacy2 } ) {
+			Queue::KeyValues outParams;
+			BOOST_REQUIRE_EQUAL(queue.connect(client, nullptr, 0, outParams), Queue::Success);
+		}
+
+		for ( auto client : { &compact, &legacy1, &legacy2 } ) {
+			BOOST_REQUIRE_EQUAL(queue.subscribe(client, "PICK"), Queue::Success);
+		}
+	}
+
+	~Fixture() {
+		for ( auto client : { &sender, &compact, &legacy1, &legacy2 } ) {
+			queue.disconnect(client);
+		}
+	}
+
+	Queue      queue;
+	TestClient sender;
+	TestClient compact;
+	TestClient legacy1;
+	TestClient legacy2;
+};
+
+
+}
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(NEGOTIATION) {
+	TestClient client("client");
+	BOOST_CHECK(!client.acceptsCompactBinary());
+
+	// Version 0 means no support
+	client.setCompactBinaryVersion(0);
+	BOOST_CHECK(!client.acceptsCompactBinary());
+
+	client.setCompactBinaryVersion(IO::CompactBinaryArchive::Version);
+	BOOST_CHECK(client.acceptsCompactBinary());
+
+	// Newer clients can still decode what this broker forwards
+	client.setCompactBinaryVersion(IO::CompactBinaryArchive::Version + 1);
+	BOOST_CHECK(client.acceptsCompactBinary());
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_FIXTURE_TEST_CASE(FALLBACK, Fixture) {
+	MessagePtr msg = createPickMessage("Pick/compact", MimeType(CompactBinary));
+	BOOST_REQUIRE_EQUAL(queue.push(&sender, msg.get()), Queue::Success);
+
+	BOOST_REQUIRE_EQUAL(compact.received.size(), 1);
+	BOOST_REQUIRE_EQUAL(legacy1.received.size(), 1);
+	BOOST_REQUIRE_EQUAL(legacy2.received.size(), 1);
+
+	// The announcing client receives the message as it was sent
+	BOOST_CHECK(compact.received[0] == msg);
+	BOOST_CHECK_EQUAL(compact.received[0]->mimeType, MimeType(CompactBinary).toString());
+	BOOST_CHECK_EQUAL(decodePickID(compact.received[0].get()), "Pick/compact");
+
+	// All others receive the same binary copy
+	BOOST_CHECK(legacy1.received[0] != msg);
+	BOOST_CHECK(legacy1.received[0] == legacy2.received[0]);
+	BOOST_CHECK_EQUAL(legacy1.received[0]->mimeType, MimeType(Binary).toString());
+	BOOST_CHECK_EQUAL(legacy1.received[0]->sequenceNumber, msg->sequenceNumber);
+	BOOST_CHECK_EQUAL(decodePickID(legacy1.received[0].get()), "Pick/compact");
+
+	// Catching up from the queue applies the same conversion
+	Message *queued = queue.getMessage(msg->sequenceNumber - 1, &legacy1);
+	BOOST_REQUIRE(queued != nullptr);
+	BOOST_CHECK(queued == legacy1.received[0].get());
+
+	queued = queue.getMessage(msg->sequenceNumber - 1, &compact);
+	BOOST_REQUIRE(queued != nullptr);
+	BOOST_CHECK(queued == msg.get());
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_FIXTURE_TEST_CASE(BINARY_UNCHANGED, Fixture) {
+	MessagePtr msg = createPickMessage("Pick/binary", MimeType(Binary));
+	BOOST_REQUIRE_EQUAL(queue.push(&sender, msg.get()), Queue::Success);
+
+	for ( auto client : { &compact, &legacy1, &legacy2 } ) {
+		BOOST_REQUIRE_EQUAL(client->received.size(), 1);
+		BOOST_CHECK(client->received[0] == msg);
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
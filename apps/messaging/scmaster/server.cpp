@@ -46,7 +46,15 @@ namespace Broker {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 QueueWorker::QueueWorker(Queue *queue)
-: _queue(queue) {}
+: _queue(queue) {
+	if ( auto metrics = Metrics::Instance() ) {
+		_loopTime = metrics->histogram(
+			"scmaster_reactor_loop_seconds",
+			"Time a queue worker spends per loop iteration without waiting",
+			{{"queue", queue->name()}}
+		);
+	}
+}
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 
@@ -86,9 +94,18 @@ bool QueueWorker::addSession(Wired::Session *session) {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 Wired::Device *QueueWorker::wait() {
+	if ( _loopTime && _loopStart ) {
+		_loopTime->record(Util::LatencyMonitor::Now() - _loopStart);
+	}
+
 	unlock();
 	Wired::Device *dev = Reactor::wait();
 	lock();
+
+	if ( _loopTime ) {
+		_loopStart = Util::LatencyMonitor::Now();
+	}
+
 	return dev;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -200,6 +217,15 @@ Server::QueueItem *Server::addQueue(const std::string &name, uint64_t maxPayload
 	item.thread = nullptr;
 	item.queue->setMessageDispatcher(item.worker);
 
+	if ( auto metrics = Metrics::Instance() ) {
+		item.sendLatency = metrics->histogram(
+			"scmaster_send_latency_seconds",
+			"Time from the publication of a message until it is handed "
+			"to a client",
+			{{"queue", name}}
+		);
+	}
+
 	return &item;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
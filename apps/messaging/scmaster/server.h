@@ -29,6 +29,7 @@
 #include <seiscomp/broker/messagedispatcher.h>
 #include <seiscomp/broker/message.h>
 #include <seiscomp/broker/client.h>
+#include <seiscomp/broker/metrics.h>
 
 #include <seiscomp/wired/endpoint.h>
 #include <seiscomp/wired/server.h>
@@ -91,9 +92,11 @@ class QueueWorker : public Wired::Reactor, public MessageDispatcher {
 	private:
 		using ClientMessage = std::pair<Client*,Message*>;
 
-		Queue                     *_queue;
-		std::mutex                 _idleMutex;
-		std::deque<ClientMessage>  _messages;
+		Queue                          *_queue;
+		std::mutex                      _idleMutex;
+		std::deque<ClientMessage>       _messages;
+		Metrics::HistogramPtr           _loopTime;
+		Util::LatencyMonitor::Timestamp _loopStart{0};
 };
 
 
@@ -121,6 +124,9 @@ class Server : public Wired::Server {
 			QueueWorker    *worker{nullptr};
 			std::thread    *thread{nullptr};
 			size_t          index{0};
+			//! Time from the publication of a message until it is
+			//! handed to a client, only set if metrics are enabled
+			Metrics::HistogramPtr sendLatency;
 		};
 
 		struct DatabaseItem {
@@ -122,12 +122,14 @@ struct Settings : Seiscomp::System::Application::AbstractSettings {
 		std::string filebase;
 		std::string staticPath;
 		std::string brokerPath;
+		bool        metrics{false};
 
 		void accept(Seiscomp::System::Application::SettingsLinker &linker) {
 			linker
 			& cfgAsPath(filebase, "filebase")
 			& cfg(staticPath, "staticPath")
-			& cfg(brokerPath, "brokerPath");
+			& cfg(brokerPath, "brokerPath")
+			& cfg(metrics, "metrics");
 		}
 	} http;
 
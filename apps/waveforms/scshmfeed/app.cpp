@@ -0,0 +1,127 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#define SEISCOMP_COMPONENT SHMFEED
+#include <seiscomp/logging/log.h>
+#include <seiscomp/core/strings.h>
+
+#include "app.h"
+
+
+using namespace std;
+
+
+namespace Seiscomp {
+namespace Applications {
+namespace ShmFeed {
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Application::Application(int argc, char** argv)
+: Client::StreamApplication(argc, argv) {
+	setMessagingEnabled(false);
+	setDatabaseEnabled(false, false);
+	// Keep the received payload to publish it without encoding it again
+	setRecordInputHint(Record::SAVE_RAW);
+	bindSettings(&_settings);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool Application::init() {
+	if ( !Client::StreamApplication::init() ) {
+		return false;
+	}
+
+	if ( _settings.streams.empty() ) {
+		SEISCOMP_ERROR("No streams configured");
+		return false;
+	}
+
+	for ( const auto &id : _settings.streams ) {
+		vector<string> toks;
+		if ( Core::split(toks, id.c_str(), ".", false) != 4 ) {
+			SEISCOMP_ERROR("Invalid stream ID: %s, expected NET.STA.LOC.CHA",
+			               id.c_str());
+			return false;
+		}
+
+		if ( !recordStream()->addStream(toks[0], toks[1], toks[2], toks[3]) ) {
+			SEISCOMP_ERROR("Failed to subscribe to %s", id.c_str());
+			return false;
+		}
+	}
+
+	if ( (_settings.ring.slots <= 0) || (_settings.ring.slotSize <= 0)
+	  || (_settings.ring.streams <= 0) ) {
+		SEISCOMP_ERROR("Invalid ring geometry, slots, slotSize and streams "
+		               "must be positive");
+		return false;
+	}
+
+	if ( !_feeder.create(_settings.ring.name, _settings.ring.slots,
+	                     _settings.ring.slotSize, _settings.ring.streams) ) {
+		return false;
+	}
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void Application::done() {
+	Client::StreamApplication::done();
+
+	SEISCOMP_INFO("Published %lu records, dropped %lu",
+	              static_cast<unsigned long>(_published),
+	              static_cast<unsigned long>(_dropped));
+
+	// Keep the segment so that attached readers can drain it. It is
+	// replaced on the next start.
+	_feeder.close();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void Application::handleRecord(Record *rec) {
+	RecordPtr tmp(rec);
+
+	if ( _feeder.push(rec) ) {
+		++_published;
+	}
+	else {
+		++_dropped;
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+}
+}
+}
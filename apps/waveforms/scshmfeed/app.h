@@ -0,0 +1,96 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#ifndef SEISCOMP_APPS_SCSHMFEED_APP_H__
+#define SEISCOMP_APPS_SCSHMFEED_APP_H__
+
+
+#include <seiscomp/client/streamapplication.h>
+#include <seiscomp/io/recordstream/shm.h>
+
+#include "version.h"
+
+
+namespace Seiscomp {
+namespace Applications {
+namespace ShmFeed {
+
+
+/**
+ * @brief Reads records from the configured RecordStream and publishes them
+ *        into a shared memory ring. Modules on the same host read the ring
+ *        with the "shm" RecordStream instead of each connecting to the
+ *        data source.
+ */
+class Application : public Client::StreamApplication {
+	public:
+		Application(int argc, char** argv);
+
+
+	protected:
+		bool init() override;
+		void done() override;
+		void handleRecord(Record *rec) override;
+
+		const char *version() override {
+			return SCSHMFEED_VERSION_NAME;
+		}
+
+
+	private:
+		struct Settings : System::Application::AbstractSettings {
+			struct Ring {
+				std::string name{"seiscomp"};
+				int         slots{65536};
+				int         slotSize{512};
+				int         streams{8192};
+
+				void accept(System::Application::SettingsLinker &linker) {
+					linker
+					& cfg(name, "name")
+					& cli(name, "Ring", "ring",
+					      "The name of the shared memory ring", true)
+					& cfg(slots, "slots")
+					& cfg(slotSize, "slotSize")
+					& cfg(streams, "streams");
+				}
+			} ring;
+
+			std::vector<std::string> streams;
+
+			void accept(System::Application::SettingsLinker &linker) override {
+				linker
+				& cfg(ring, "ring")
+				& cfg(streams, "streams");
+			}
+		} _settings;
+
+		RecordStream::SharedMemoryFeeder _feeder;
+		size_t                           _published{0};
+		size_t                           _dropped{0};
+};
+
+
+}
+}
+}
+
+
+#endif
@@ -0,0 +1,494 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#ifndef SEISCOMP_BENCH_H
+#define SEISCOMP_BENCH_H
+
+
+/**
+ * A minimal benchmark runner. Each benchmark executable defines
+ * SEISCOMP_BENCH_MODULE before including this header and registers its
+ * benchmarks with SEISCOMP_BENCHMARK:
+ *
+ * ```
+ * SEISCOMP_BENCHMARK(fftDouble, "fft/double") {
+ *     std::vector<double> data = ...;  // Setup is not measured
+ *     while ( state.run() ) {
+ *         Math::fft(spec, data);
+ *         Bench::keep(spec);
+ *     }
+ *     state.setItems(data.size());
+ * }
+ * ```
+ *
+ * The runner calibrates the number of iterations per benchmark to reach
+ * --min-time seconds and repeats each measurement --repetitions times.
+ * Results are printed to stdout and optionally written to a JSON file with
+ * --json for comparison between commits.
+ */
+
+#ifndef SEISCOMP_BENCH_MODULE
+	#error SEISCOMP_BENCH_MODULE not defined
+#endif
+
+#include <seiscomp/core/datetime.h>
+#include <seiscomp/core/strings.h>
+#include <seiscomp/core/version.h>
+#include <seiscomp/system/pluginregistry.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+
+#ifdef WITH_GIT_REVISION
+extern SC_SYSTEM_CORE_API const char* git_revision();
+#endif
+
+
+#define SEISCOMP_BENCH_STR_(X) #X
+#define SEISCOMP_BENCH_STR(X) SEISCOMP_BENCH_STR_(X)
+
+
+namespace Seiscomp {
+namespace Bench {
+
+
+/**
+ * @brief The State class controls the iterations of a benchmark run.
+ *
+ * The time is measured from the first call of run() until it returns
+ * false. Code before the loop is not measured.
+ */
+class State {
+	public:
+		using Clock = std::chrono::steady_clock;
+
+	public:
+		explicit State(size_t iterations) : _iterations(iterations) {}
+
+	public:
+		//! Returns true as long as iterations are left
+		bool run() {
+			if ( !_current ) {
+				_start = Clock::now();
+			}
+
+			if ( _current == _iterations ) {
+				_elapsed += Clock::now() - _start;
+				_finished = true;
+				return false;
+			}
+
+			++_current;
+			return true;
+		}
+
+		//! Stops the clock, e.g. for setup code within the loop
+		void pause() {
+			_elapsed += Clock::now() - _start;
+		}
+
+		//! Restarts the clock after pause()
+		void resume() {
+			_start = Clock::now();
+		}
+
+		//! Sets the number of processed items per iteration
+		void setItems(size_t items) { _items = items; }
+
+		//! Sets the number of processed bytes per iteration
+		void setBytes(size_t bytes) { _bytes = bytes; }
+
+		//! Marks the benchmark as skipped, e.g. if data are not available
+		void skip(const std::string &reason) { _skipped = reason; }
+
+		size_t iterations() const { return _iterations; }
+		bool finished() const { return _finished; }
+		size_t items() const { return _items; }
+		size_t bytes() const { return _bytes; }
+		const std::string &skipped() const { return _skipped; }
+
+		double elapsed() const {
+			return std::chrono::duration<double>(_elapsed).count();
+		}
+
+	private:
+		size_t            _iterations;
+		size_t            _current{0};
+		size_t            _items{0};
+		size_t            _bytes{0};
+		bool              _finished{false};
+		std::string       _skipped;
+		Clock::time_point _start;
+		Clock::duration   _elapsed{0};
+};
+
+
+//! Prevents the compiler from optimizing away a computed value
+template <typename T>
+inline void keep(const T &value) {
+#if defined(__GNUC__)
+	asm volatile("" : : "r,m"(value) : "memory");
+#else
+	static const volatile void *sink;
+	sink = &value;
+#endif
+}
+
+
+using Function = std::function<void (State &)>;
+
+
+struct Benchmark {
+	std::string name;
+	Function    function;
+};
+
+
+inline std::vector<Benchmark> &registry() {
+	static std::vector<Benchmark> benchmarks;
+	return benchmarks;
+}
+
+
+struct Registrar {
+	Registrar(const char *name, Function function) {
+		registry().push_back({name, function});
+	}
+};
+
+
+struct Options {
+	std::string filter{"*"};
+	std::string jsonFile;
+	double      minTime{0.2};
+	size_t      repetitions{5};
+	bool        list{false};
+};
+
+
+struct Result {
+	std::string name;
+	std::string skipped;
+	size_t      iterations{0};
+	//! Seconds per iteration of each repetition
+	std::vector<double> times;
+	size_t      items{0};
+	size_t      bytes{0};
+
+	double min() const {
+		return *std::min_element(times.begin(), times.end());
+	}
+
+	double mean() const {
+		double sum = 0;
+		for ( auto t : times ) {
+			sum += t;
+		}
+		return sum / times.size();
+	}
+
+	double median() const {
+		auto sorted = times;
+		std::sort(sorted.begin(), sorted.end());
+		size_t n = sorted.size();
+		return n % 2 ? sorted[n/2] : (sorted[n/2-1] + sorted[n/2]) * 0.5;
+	}
+
+	double stddev() const {
+		if ( times.size() < 2 ) {
+			return 0;
+		}
+
+		double m = mean();
+		double sum = 0;
+		for ( auto t : times ) {
+			sum += (t - m) * (t - m);
+		}
+		return std::sqrt(sum / (times.size() - 1));
+	}
+};
+
+
+inline Result run(const Benchmark &benchmark, const Options &options) {
+	Result result;
+	result.name = benchmark.name;
+
+	try {
+		// Calibrate the number of iterations. The last calibration run
+		// serves as warmup.
+		size_t iterations = 1;
+		while ( true ) {
+			State state(iterations);
+			benchmark.function(state);
+
+			if ( !state.skipped().empty() ) {
+				result.skipped = state.skipped();
+				return result;
+			}
+
+			if ( !state.finished() ) {
+				result.skipped = "benchmark did not complete its iterations";
+				return result;
+			}
+
+			double elapsed = state.elapsed();
+			if ( elapsed >= options.minTime || iterations >= 1000000000 ) {
+				break;
+			}
+
+			double factor = elapsed > 0 ? 1.4 * options.minTime / elapsed : 10;
+			factor = std::min(std::max(factor, 1.5), 10.0);
+			iterations = std::max(static_cast<size_t>(iterations * factor), iterations + 1);
+		}
+
+		result.iterations = iterations;
+
+		for ( size_t i = 0; i < options.repetitions; ++i ) {
+			State state(iterations);
+			benchmark.function(state);
+			result.times.push_back(state.elapsed() / iterations);
+			result.items = state.items();
+			result.bytes = state.bytes();
+		}
+	}
+	catch ( std::exception &e ) {
+		result.skipped = std::string("error: ") + e.what();
+		result.times.clear();
+	}
+
+	return result;
+}
+
+
+inline std::string escape(const std::string &str) {
+	std::string out;
+	for ( auto c : str ) {
+		switch ( c ) {
+			case '"': out += "\\\""; break;
+			case '\\': out += "\\\\"; break;
+			case '\n': out += "\\n"; break;
+			case '\t': out += "\\t"; break;
+			default:
+				if ( static_cast<unsigned char>(c) < 0x20 ) {
+					char buf[8];
+					snprintf(buf, sizeof(buf), "\\u%04x", c);
+					out += buf;
+				}
+				else {
+					out += c;
+				}
+				break;
+		}
+	}
+	return out;
+}
+
+
+inline bool writeJSON(const std::string &filename, const Options &options,
+                      const std::vector<Result> &results) {
+	std::ofstream os(filename);
+	if ( !os ) {
+		return false;
+	}
+
+	os.precision(9);
+	os << "{\n"
+	   << "  \"context\": {\n"
+	   << "    \"module\": \"" << SEISCOMP_BENCH_STR(SEISCOMP_BENCH_MODULE) << "\",\n"
+	   << "    \"version\": \"" << escape(Core::CurrentVersion.toString()) << "\",\n"
+#ifdef WITH_GIT_REVISION
+	   << "    \"revision\": \"" << escape(git_revision()) << "\",\n"
+#endif
+	   << "    \"date\": \"" << Core::Time::UTC().iso() << "\",\n"
+	   << "    \"minTime\": " << options.minTime << ",\n"
+	   << "    \"repetitions\": " << options.repetitions << "\n"
+	   << "  },\n"
+	   << "  \"benchmarks\": [";
+
+	for ( size_t i = 0; i < results.size(); ++i ) {
+		const auto &r = results[i];
+		os << (i ? ",\n" : "\n") << "    {\"name\": \"" << escape(r.name) << "\"";
+
+		if ( !r.skipped.empty() ) {
+			os << ", \"skipped\": \"" << escape(r.skipped) << "\"}";
+			continue;
+		}
+
+		os << ", \"iterations\": " << r.iterations
+		   << ", \"min\": " << r.min()
+		   << ", \"median\": " << r.median()
+		   << ", \"mean\": " << r.mean()
+		   << ", \"stddev\": " << r.stddev();
+
+		if ( r.items ) {
+			os << ", \"itemsPerSecond\": " << r.items / r.median();
+		}
+
+		if ( r.bytes ) {
+			os << ", \"bytesPerSecond\": " << r.bytes / r.median();
+		}
+
+		os << "}";
+	}
+
+	os << "\n  ]\n}\n";
+	return os.good();
+}
+
+
+inline bool parseOptions(int argc, char **argv, Options &options) {
+	for ( int i = 1; i < argc; ++i ) {
+		std::string arg(argv[i]);
+		std::string value;
+		size_t p = arg.find('=');
+		if ( p != std::string::npos ) {
+			value = arg.substr(p+1);
+			arg.erase(p);
+		}
+
+		if ( arg == "--filter" ) {
+			options.filter = value;
+		}
+		else if ( arg == "--json" ) {
+			options.jsonFile = value;
+		}
+		else if ( arg == "--min-time" ) {
+			if ( !Core::fromString(options.minTime, value) || options.minTime < 0 ) {
+				std::cerr << "invalid --min-time: " << value << std::endl;
+				return false;
+			}
+		}
+		else if ( arg == "--repetitions" ) {
+			if ( !Core::fromString(options.repetitions, value) || !options.repetitions ) {
+				std::cerr << "invalid --repetitions: " << value << std::endl;
+				return false;
+			}
+		}
+		else if ( arg == "--plugins-dir" ) {
+			System::PluginRegistry::Instance()->addPluginPath(value);
+		}
+		else if ( arg == "--list" ) {
+			options.list = true;
+		}
+		else {
+			std::cerr << "Usage: " << argv[0] << " [options]" << std::endl
+			          << "  --filter=PATTERN    run benchmarks matching the wildcard pattern" << std::endl
+			          << "  --min-time=SECONDS  minimum measurement time per repetition (0.2)" << std::endl
+			          << "  --repetitions=N     number of measurements per benchmark (5)" << std::endl
+			          << "  --json=FILE         write the results as JSON to FILE" << std::endl
+			          << "  --plugins-dir=DIR   additional plugin search path" << std::endl
+			          << "  --list              list the available benchmarks" << std::endl;
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+inline std::string formatTime(double secs) {
+	char buf[32];
+	if ( secs < 1E-6 ) {
+		snprintf(buf, sizeof(buf), "%.1f ns", secs * 1E9);
+	}
+	else if ( secs < 1E-3 ) {
+		snprintf(buf, sizeof(buf), "%.2f us", secs * 1E6);
+	}
+	else if ( secs < 1 ) {
+		snprintf(buf, sizeof(buf), "%.2f ms", secs * 1E3);
+	}
+	else {
+		snprintf(buf, sizeof(buf), "%.3f s", secs);
+	}
+	return buf;
+}
+
+
+inline int main(int argc, char **argv) {
+	Options options;
+	if ( !parseOptions(argc, argv, options) ) {
+		return 1;
+	}
+
+	std::vector<Result> results;
+
+	for ( const auto &benchmark : registry() ) {
+		if ( !Core::wildcmp(options.filter, benchmark.name) ) {
+			continue;
+		}
+
+		if ( options.list ) {
+			std::cout << benchmark.name << std::endl;
+			continue;
+		}
+
+		auto result = run(benchmark, options);
+		if ( !result.skipped.empty() ) {
+			printf("%-40s skipped: %s\n", result.name.c_str(), result.skipped.c_str());
+		}
+		else {
+			printf("%-40s %12s %12s %12zu", result.name.c_str(),
+			       formatTime(result.median()).c_str(),
+			       formatTime(result.stddev()).c_str(), result.iterations);
+			if ( result.items ) {
+				printf(" %12.4g items/s", result.items / result.median());
+			}
+			printf("\n");
+		}
+		fflush(stdout);
+
+		results.push_back(result);
+	}
+
+	if ( !options.jsonFile.empty() && !writeJSON(options.jsonFile, options, results) ) {
+		std::cerr << "failed to write " << options.jsonFile << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
+
+
+}
+}
+
+
+#define SEISCOMP_BENCHMARK(id, name) \
+	static void id(Seiscomp::Bench::State &state); \
+	static Seiscomp::Bench::Registrar id##Registrar(name, id); \
+	static void id(Seiscomp::Bench::State &state)
+
+
+int main(int argc, char **argv) {
+	return Seiscomp::Bench::main(argc, argv);
+}
+
+
+#endif
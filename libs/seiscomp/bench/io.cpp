@@ -0,0 +1,365 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#define SEISCOMP_BENCH_MODULE io
+#include "bench.h"
+
+#include <seiscomp/core/genericrecord.h>
+#include <seiscomp/core/typedarray.h>
+#include <seiscomp/datamodel/databasereader.h>
+#include <seiscomp/datamodel/eventparameters_package.h>
+#include <seiscomp/io/archive/binarchive.h>
+#include <seiscomp/io/archive/jsonarchive.h>
+#include <seiscomp/io/archive/xmlarchive.h>
+#include <seiscomp/io/database.h>
+#include <seiscomp/io/recordfilter/mseedencoder.h>
+#include <seiscomp/io/recordfilter/resample.h>
+#include <seiscomp/io/records/mseedrecord.h>
+
+#include <filesystem>
+#include <random>
+#include <sstream>
+
+
+using namespace std;
+using namespace Seiscomp;
+
+namespace fs = std::filesystem;
+
+
+namespace {
+
+
+const char *MSeedFile = SOURCE_DIR "/libs/seiscomp/test/io/recordstream/archive/2018/FR/SALF/HHN.D/FR.SALF.00.HHN.D.2018.181";
+const char *EventsDir = SOURCE_DIR "/libs/seiscomp/seismology/locator/test/data/events";
+const char *SQLiteSchema = SOURCE_DIR "/libs/seiscomp/datamodel/share/sqlite3.sql";
+const size_t EventFiles = 50;
+
+
+string readFile(const char *filename) {
+	ifstream ifs(filename, ios::binary);
+	return string(istreambuf_iterator<char>(ifs), istreambuf_iterator<char>());
+}
+
+
+// Ten minutes of a 100 Hz random walk which compresses like real data
+vector<GenericRecordPtr> randomWalk(size_t records = 60, int samplesPerRecord = 1000) {
+	mt19937 rng(42);
+	uniform_int_distribution<int> step(-200, 200);
+	Core::Time time(2024, 1, 1, 0, 0, 0);
+	int value = 0;
+
+	vector<GenericRecordPtr> result;
+	for ( size_t i = 0; i < records; ++i ) {
+		GenericRecordPtr rec = new GenericRecord("XX", "BENCH", "", "HHZ", time, 100);
+		IntArrayPtr data = new IntArray(samplesPerRecord);
+		for ( int j = 0; j < samplesPerRecord; ++j ) {
+			value += step(rng);
+			(*data)[j] = value;
+		}
+		rec->setData(data.get());
+		time = rec->endTime();
+		result.push_back(rec);
+	}
+
+	return result;
+}
+
+
+// Merges the first bundled event parameter files into one instance
+DataModel::EventParametersPtr bundledEvents() {
+	DataModel::PublicObject::SetRegistrationEnabled(false);
+
+	vector<fs::path> files;
+	for ( const auto &entry : fs::directory_iterator(EventsDir) ) {
+		files.push_back(entry.path());
+	}
+
+	sort(files.begin(), files.end());
+	if ( files.size() > EventFiles ) {
+		files.resize(EventFiles);
+	}
+
+	DataModel::EventParametersPtr merged = new DataModel::EventParameters;
+
+	for ( const auto &file : files ) {
+		IO::XMLArchive ar;
+		if ( !ar.open(file.c_str()) ) {
+			continue;
+		}
+
+		DataModel::EventParametersPtr ep;
+		ar >> ep;
+		if ( !ep ) {
+			continue;
+		}
+
+		while ( ep->pickCount() ) {
+			DataModel::PickPtr obj = ep->pick(0);
+			ep->removePick(0);
+			merged->add(obj.get());
+		}
+
+		while ( ep->amplitudeCount() ) {
+			DataModel::AmplitudePtr obj = ep->amplitude(0);
+			ep->removeAmplitude(0);
+			merged->add(obj.get());
+		}
+
+		while ( ep->originCount() ) {
+			DataModel::OriginPtr obj = ep->origin(0);
+			ep->removeOrigin(0);
+			merged->add(obj.get());
+		}
+
+		while ( ep->eventCount() ) {
+			DataModel::EventPtr obj = ep->event(0);
+			ep->removeEvent(0);
+			merged->add(obj.get());
+		}
+	}
+
+	return merged;
+}
+
+
+template <typename Archive>
+size_t roundTrip(DataModel::EventParameters *ep) {
+	stringbuf out(ios_base::out);
+	{
+		Archive ar;
+		ar.create(&out);
+		ar << ep;
+		ar.close();
+	}
+
+	stringbuf in(out.str(), ios_base::in);
+	DataModel::EventParametersPtr copy;
+	{
+		Archive ar;
+		ar.open(&in);
+		ar >> copy;
+		ar.close();
+	}
+
+	if ( !copy ) {
+		throw runtime_error("failed to read back the event parameters");
+	}
+
+	return out.str().size();
+}
+
+
+template <typename Archive>
+void archiveRoundTrip(Bench::State &state) {
+	auto ep = bundledEvents();
+	if ( !ep->pickCount() ) {
+		state.skip("no bundled events found");
+		return;
+	}
+
+	size_t bytes = 0;
+	while ( state.run() ) {
+		bytes = roundTrip<Archive>(ep.get());
+	}
+
+	state.setItems(ep->pickCount() + ep->originCount());
+	state.setBytes(bytes);
+}
+
+
+void encode(Bench::State &state, bool steim1) {
+	auto records = randomWalk();
+	size_t samples = 0;
+	for ( const auto &rec : records ) {
+		samples += rec->sampleCount();
+	}
+
+	size_t bytes = 0;
+
+	while ( state.run() ) {
+		IO::MSeedEncoder encoder;
+		encoder.setRecordSize(9);
+		if ( steim1 ) {
+			encoder.setSteim1();
+		}
+		else {
+			encoder.setSteim2();
+		}
+
+		bytes = 0;
+		for ( const auto &rec : records ) {
+			RecordPtr out = encoder.feed(rec.get());
+			while ( out ) {
+				bytes += 512;
+				out = encoder.feed(nullptr);
+			}
+		}
+
+		RecordPtr out = encoder.flush();
+		while ( out ) {
+			bytes += 512;
+			out = encoder.feed(nullptr);
+		}
+	}
+
+	state.setItems(samples);
+	state.setBytes(bytes);
+}
+
+
+}
+
+
+SEISCOMP_BENCHMARK(mseedDecode, "mseed/decode") {
+	string data = readFile(MSeedFile);
+	if ( data.empty() ) {
+		state.skip(string("missing ") + MSeedFile);
+		return;
+	}
+
+	size_t samples = 0;
+
+	while ( state.run() ) {
+		istringstream is(data);
+		samples = 0;
+
+		while ( true ) {
+			IO::MSeedRecord rec(Array::INT);
+			try {
+				rec.read(is);
+			}
+			catch ( Core::EndOfStreamException & ) {
+				break;
+			}
+
+			if ( !is ) {
+				break;
+			}
+
+			// Data are decoded on demand
+			if ( rec.data() ) {
+				samples += rec.data()->size();
+			}
+		}
+	}
+
+	state.setItems(samples);
+	state.setBytes(data.size());
+}
+
+
+SEISCOMP_BENCHMARK(steim1Encode, "mseed/encode_steim1") {
+	encode(state, true);
+}
+
+
+SEISCOMP_BENCHMARK(steim2Encode, "mseed/encode_steim2") {
+	encode(state, false);
+}
+
+
+SEISCOMP_BENCHMARK(resample, "recordfilter/resample") {
+	auto records = randomWalk();
+	size_t samples = 0;
+	for ( const auto &rec : records ) {
+		samples += rec->sampleCount();
+	}
+
+	while ( state.run() ) {
+		IO::RecordResampler<double> resampler(20);
+		for ( const auto &rec : records ) {
+			RecordPtr out = resampler.feed(rec.get());
+			if ( out ) {
+				Bench::keep(out->sampleCount());
+			}
+		}
+	}
+
+	state.setItems(samples);
+}
+
+
+SEISCOMP_BENCHMARK(xmlRoundTrip, "archive/xml") {
+	archiveRoundTrip<IO::XMLArchive>(state);
+}
+
+
+SEISCOMP_BENCHMARK(binaryRoundTrip, "archive/binary") {
+	archiveRoundTrip<IO::VBinaryArchive>(state);
+}
+
+
+SEISCOMP_BENCHMARK(compactRoundTrip, "archive/compact") {
+	archiveRoundTrip<IO::CompactBinaryArchive>(state);
+}
+
+
+SEISCOMP_BENCHMARK(jsonRoundTrip, "archive/json") {
+	archiveRoundTrip<IO::JSONArchive>(state);
+}
+
+
+SEISCOMP_BENCHMARK(sqliteRead, "db/sqlite3_read") {
+	IO::DatabaseInterfacePtr db = IO::DatabaseInterface::Create("sqlite3");
+	if ( !db ) {
+		System::PluginRegistry::Instance()->addPluginName("dbsqlite3");
+		System::PluginRegistry::Instance()->loadPlugins();
+		db = IO::DatabaseInterface::Create("sqlite3");
+	}
+
+	if ( !db ) {
+		state.skip("sqlite3 database plugin not available, see --plugins-dir");
+		return;
+	}
+
+	string schema = readFile(SQLiteSchema);
+	if ( !db->connect(":memory:") || schema.empty() || !db->execute(schema.c_str()) ) {
+		state.skip("failed to set up the in-memory database");
+		return;
+	}
+
+	auto ep = bundledEvents();
+	{
+		DataModel::DatabaseArchive ar(db.get());
+		DataModel::DatabaseObjectWriter writer(ar);
+		db->start();
+		writer(ep.get());
+		db->commit();
+
+		if ( writer.errors() ) {
+			state.skip("failed to populate the database");
+			return;
+		}
+	}
+
+	DataModel::DatabaseReader reader(db.get());
+
+	while ( state.run() ) {
+		DataModel::EventParametersPtr loaded = reader.loadEventParameters();
+		if ( !loaded ) {
+			throw runtime_error("failed to load the event parameters");
+		}
+		reader.load(loaded.get());
+		Bench::keep(loaded->pickCount());
+	}
+
+	state.setItems(ep->pickCount() + ep->originCount());
+}
@@ -0,0 +1,106 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#define SEISCOMP_BENCH_MODULE math
+#include "bench.h"
+
+#include <seiscomp/math/fft.h>
+#include <seiscomp/math/filter/butterworth.h>
+#include <seiscomp/math/filter/stalta.h>
+
+#include <random>
+
+
+using namespace std;
+using namespace Seiscomp;
+
+
+namespace {
+
+
+// One hour of 100 Hz noise with a reproducible seed
+vector<double> noise(size_t n = 360000) {
+	mt19937 rng(42);
+	normal_distribution<double> value(0, 1000);
+	vector<double> data(n);
+	for ( auto &v : data ) {
+		v = value(rng);
+	}
+	return data;
+}
+
+
+}
+
+
+SEISCOMP_BENCHMARK(butterworthBandpass, "filter/butterworth_bandpass") {
+	auto input = noise();
+	vector<double> data(input.size());
+	Math::Filtering::IIR::ButterworthBandpass<double> filter(4, 0.7, 2.0, 100);
+
+	while ( state.run() ) {
+		copy(input.begin(), input.end(), data.begin());
+		filter.apply(static_cast<int>(data.size()), data.data());
+		Bench::keep(data.back());
+	}
+
+	state.setItems(data.size());
+}
+
+
+SEISCOMP_BENCHMARK(stalta, "filter/stalta") {
+	auto input = noise();
+	vector<double> data(input.size());
+	Math::Filtering::STALTA<double> filter(2, 50, 100);
+
+	while ( state.run() ) {
+		copy(input.begin(), input.end(), data.begin());
+		filter.apply(static_cast<int>(data.size()), data.data());
+		Bench::keep(data.back());
+	}
+
+	state.setItems(data.size());
+}
+
+
+SEISCOMP_BENCHMARK(fftPowerOfTwo, "fft/65536") {
+	auto data = noise(65536);
+	Math::ComplexArray spec;
+
+	while ( state.run() ) {
+		Math::fft(spec, data);
+		Bench::keep(spec.back());
+	}
+
+	state.setItems(data.size());
+}
+
+
+SEISCOMP_BENCHMARK(fftMixedRadix, "fft/60000") {
+	auto data = noise(60000);
+	Math::ComplexArray spec;
+
+	while ( state.run() ) {
+		Math::fft(spec, data);
+		Bench::keep(spec.back());
+	}
+
+	state.setItems(data.size());
+}
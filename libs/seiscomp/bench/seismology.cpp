@@ -0,0 +1,216 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#define SEISCOMP_BENCH_MODULE seismology
+#include "bench.h"
+
+#include <seiscomp/config/config.h>
+#include <seiscomp/datamodel/pick.h>
+#include <seiscomp/datamodel/sensorlocation.h>
+#include <seiscomp/math/geo.h>
+#include <seiscomp/seismology/locatorinterface.h>
+#include <seiscomp/seismology/ttt.h>
+
+#include <map>
+#include <random>
+
+
+using namespace std;
+using namespace Seiscomp;
+
+
+namespace {
+
+
+const double SourceLat = 45.0;
+const double SourceLon = 10.0;
+const double SourceDepth = 12.0;
+const Core::Time OriginTime(2024, 1, 1, 12, 0, 0);
+
+
+void setupTables() {
+	setenv("SEISCOMP_LIBTAU_TABLE_DIR", BUILD_DIR "/libs/3rd-party/tau/data/", 0);
+	setenv("SEISCOMP_LOCSAT_TABLE_DIR", SOURCE_DIR "/libs/3rd-party/locsat/data", 0);
+	DataModel::PublicObject::SetRegistrationEnabled(false);
+}
+
+
+void travelTimes(Bench::State &state, const char *type) {
+	setupTables();
+
+	TravelTimeTableInterfacePtr ttt = TravelTimeTableInterface::Create(type);
+	if ( !ttt || !ttt->setModel("iasp91") ) {
+		state.skip(string("travel time table ") + type + "/iasp91 not available");
+		return;
+	}
+
+	// Epicentral distances up to 100 degrees for three source depths
+	size_t queries = 0;
+	while ( state.run() ) {
+		queries = 0;
+		for ( double depth : {10.0, 100.0, 400.0} ) {
+			for ( int i = 1; i <= 100; ++i ) {
+				auto tt = ttt->computeFirst(0, 0, depth, 0, i, 0);
+				Bench::keep(tt.time);
+				++queries;
+			}
+		}
+	}
+
+	state.setItems(queries);
+}
+
+
+class SyntheticNetwork : public Seismology::SensorLocationDelegate {
+	public:
+		SyntheticNetwork() {
+			setupTables();
+
+			// Three rings of stations around the source
+			for ( int ring = 0; ring < 3; ++ring ) {
+				for ( int i = 0; i < 10; ++i ) {
+					double dist = 0.5 + ring * 1.5;
+					double azi = i * 36.0 + ring * 12.0;
+					double lat, lon;
+					Math::Geo::delandaz2coord(dist, azi, SourceLat, SourceLon, &lat, &lon);
+
+					string code = "S" + Core::toString(ring * 10 + i);
+					DataModel::SensorLocationPtr loc = DataModel::SensorLocation::Create();
+					loc->setLatitude(lat);
+					loc->setLongitude(lon);
+					loc->setElevation(0);
+					_locations[code] = loc;
+				}
+			}
+		}
+
+	public:
+		DataModel::SensorLocation *getSensorLocation(DataModel::Pick *pick) const override {
+			auto it = _locations.find(pick->waveformID().stationCode());
+			return it != _locations.end() ? it->second.get() : nullptr;
+		}
+
+		//! Creates P picks with a reproducible timing error
+		bool createPicks(Seismology::LocatorInterface::PickList &picks) const {
+			TravelTimeTableInterfacePtr ttt = TravelTimeTableInterface::Create("LOCSAT");
+			if ( !ttt || !ttt->setModel("iasp91") ) {
+				return false;
+			}
+
+			mt19937 rng(42);
+			normal_distribution<double> error(0, 0.05);
+
+			for ( const auto &item : _locations ) {
+				auto tt = ttt->compute("P", SourceLat, SourceLon, SourceDepth,
+				                       item.second->latitude(),
+				                       item.second->longitude(), 0);
+
+				DataModel::PickPtr pick = DataModel::Pick::Create();
+				pick->setWaveformID(DataModel::WaveformStreamID("XX", item.first, "", "HHZ", ""));
+				pick->setTime(OriginTime + Core::TimeSpan(tt.time + error(rng)));
+				pick->setPhaseHint(DataModel::Phase("P"));
+				pick->setEvaluationMode(DataModel::EvaluationMode(DataModel::AUTOMATIC));
+				picks.push_back(Seismology::LocatorInterface::PickItem(pick));
+			}
+
+			return true;
+		}
+
+	private:
+		map<string, DataModel::SensorLocationPtr> _locations;
+};
+
+
+void locate(Bench::State &state, Seismology::LocatorInterface *locator,
+            const char *profile) {
+	Config::Config config;
+	if ( !locator->init(config) ) {
+		state.skip("failed to initialize the locator");
+		return;
+	}
+
+	if ( profile ) {
+		locator->setProfile(profile);
+	}
+
+	Seismology::SensorLocationDelegatePtr network = new SyntheticNetwork;
+	locator->setSensorLocationDelegate(network.get());
+
+	Seismology::LocatorInterface::PickList picks;
+	if ( !static_cast<SyntheticNetwork*>(network.get())->createPicks(picks) ) {
+		state.skip("LOCSAT travel time tables not available");
+		return;
+	}
+
+	while ( state.run() ) {
+		DataModel::OriginPtr origin = locator->locate(picks);
+		if ( !origin ) {
+			throw runtime_error("no origin located");
+		}
+		Bench::keep(origin->latitude().value());
+	}
+
+	state.setItems(1);
+}
+
+
+}
+
+
+SEISCOMP_BENCHMARK(libtau, "ttt/libtau") {
+	travelTimes(state, "libtau");
+}
+
+
+SEISCOMP_BENCHMARK(locsatTables, "ttt/locsat") {
+	travelTimes(state, "LOCSAT");
+}
+
+
+SEISCOMP_BENCHMARK(locsat, "locator/locsat") {
+	setupTables();
+
+	Seismology::LocatorInterfacePtr locator = Seismology::LocatorInterface::Create("LOCSAT");
+	if ( !locator ) {
+		state.skip("LOCSAT locator not available");
+		return;
+	}
+
+	locate(state, locator.get(), "iasp91");
+}
+
+
+SEISCOMP_BENCHMARK(stdloc, "locator/stdloc") {
+	setupTables();
+
+	Seismology::LocatorInterfacePtr locator = Seismology::LocatorInterface::Create("StdLoc");
+	if ( !locator ) {
+		System::PluginRegistry::Instance()->addPluginName("stdloc");
+		System::PluginRegistry::Instance()->loadPlugins();
+		locator = Seismology::LocatorInterface::Create("StdLoc");
+	}
+
+	if ( !locator ) {
+		state.skip("StdLoc plugin not available, see --plugins-dir");
+		return;
+	}
+
+	locate(state, locator.get(), nullptr);
+}
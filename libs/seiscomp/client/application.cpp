@@ -58,10 +58,12 @@
 #include <seiscomp/utils/files.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cerrno>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <fstream>
 #include <functional>
 #include <sstream>
 
@@ -92,6 +94,25 @@ namespace {
 bool populateCreationInfoVersionAttribute = false;
 
 
+// Set by SIGUSR1 and handled by the latency timer
+std::atomic<bool> latencyReportRequested{false};
+
+void requestLatencyReport(int) {
+	latencyReportRequested = true;
+}
+
+
+// Records are classified by band and instrument code, messages by type
+string latencyClass(Core::BaseObject *obj) {
+	Record *rec = Record::Cast(obj);
+	if ( rec ) {
+		return "rec/" + rec->channelCode().substr(0, 2);
+	}
+
+	return string("msg/") + obj->className();
+}
+
+
 struct AppResolver : public Util::VariableResolver {
 	AppResolver(const std::string& name)
 	 : _name(name) {}
@@ -249,6 +270,7 @@ void Application::AppSettings::Messaging::accept(SettingsLinker &linker) {
 	& cfg(URL, "server")
 	& cfg(primaryGroup, "primaryGroup")
 	& cfg(subscriptions, "subscriptions")
+	& cfg(subscriptionFilters, "subscriptionFilters")
 	& cfg(encoding, "encoding")
 	& cfg(contentType, "contentType")
 	& cfg(timeout, "timeout")
@@ -278,7 +300,7 @@ void Application::AppSettings::Messaging::accept(SettingsLinker &linker) {
 	)
 	& cli(
 		contentType, "Messaging", "msg-content-type",
-		"Sets the message content type: binary, json, xml.",
+		"Sets the message content type: binary, json, xml, compact.",
 		true
 	)
 	& cli(
@@ -345,6 +367,12 @@ void Application::AppSettings::Database::accept(SettingsLinker &linker) {
 		inventoryDB, "Database", "inventory-db",
 		"Load the inventory from the given database or file, format: [service://]location."
 	)
+	& cli(
+		inventorySnapshot, "Database", "inventory-snapshot",
+		"Write the complete inventory without any filters applied to the "
+		"given file as binary snapshot and exit. The snapshot can be passed "
+		"to --inventory-db to speed up startup."
+	)
 	& cli(
 		configDB, "Database", "config-db",
 		"Load the configuration from the given database or file, format: [service://]location."
@@ -396,6 +424,33 @@ void Application::AppSettings::RecordStream::accept(SettingsLinker &linker) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void Application::AppSettings::SignatureValidation::accept(SettingsLinker &linker) {
+	linker
+	& cfg(threads, "threads")
+	& cfg(window, "window");
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void Application::AppSettings::Latency::accept(SettingsLinker &linker) {
+	linker
+	& cfg(enable, "enable")
+	& cfgAsPath(report, "report")
+	& cli(
+		enable, "Generic", "latency",
+		"Enables the latency instrumentation of record and message "
+		"processing.", true
+	);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void Application::AppSettings::Processing::accept(SettingsLinker &linker) {
 	linker
@@ -434,7 +489,8 @@ void Application::AppSettings::accept(SettingsLinker &linker) {
 	& cfg(processing.amplitudeAliases, "amplitudes.aliases")
 	& cfg(processing.magnitudeAliases, "magnitudes.aliases")
 	& cfg(soh.interval, "IntervalSOH") // For backwards compatibility
-	& cfg(soh, "soh");
+	& cfg(soh, "soh")
+	& cfg(latency, "latency");
 
 	if ( database.enable ) {
 		linker
@@ -455,7 +511,8 @@ void Application::AppSettings::accept(SettingsLinker &linker) {
 	if ( recordstream.enable ) {
 		linker
 		& cfg(recordstream.URI, "recordstream")
-		& cfg(recordstream, "recordstream");
+		& cfg(recordstream, "recordstream")
+		& cfg(signatureValidation, "signatureValidation");
 	}
 
 	if ( cities.enable ) {
@@ -1081,6 +1138,27 @@ bool Application::init() {
 		return false;
 	}
 
+	if ( _settings.latency.enable ) {
+		Util::LatencyMonitor::Enable();
+
+		if ( _settings.latency.report.empty() ) {
+			_settings.latency.report = Environment::Instance()->logDir() + "/" + name() + ".latency";
+		}
+
+#ifndef WIN32
+		struct sigaction sa;
+		sa.sa_handler = requestLatencyReport;
+		sa.sa_flags = SA_RESTART;
+		sigemptyset(&sa.sa_mask);
+		sigaction(SIGUSR1, &sa, nullptr);
+
+		SEISCOMP_INFO("Latency instrumentation enabled, send SIGUSR1 to "
+		              "write a report to %s", _settings.latency.report.c_str());
+#else
+		SEISCOMP_INFO("Latency instrumentation enabled");
+#endif
+	}
+
 	for ( string &item : _settings.processing.amplitudeAliases ) {
 		StringVector toks;
 		Core::split(toks, item, ":", false);
@@ -1180,6 +1258,14 @@ bool Application::init() {
 		}
 	}
 
+	if ( !_settings.database.inventorySnapshot.empty() ) {
+		// Like --dump-settings: Application::exit only sets the return code
+		// and stops the initialization, exec() still calls done() which
+		// closes the messaging and database connections.
+		exit(writeInventorySnapshot() ? 0 : 1);
+		return false;
+	}
+
 	if ( !reloadInventory() ) {
 		if ( !handleInitializationError(INVENTORY) ) {
 			return false;
@@ -1231,6 +1317,33 @@ void Application::stateOfHealthTimeout() {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void Application::latencyTimeout() {
+	if ( !latencyReportRequested.exchange(false) ) {
+		return;
+	}
+
+	Util::LatencyMonitor *latency = Util::LatencyMonitor::Instance();
+	if ( !latency ) {
+		return;
+	}
+
+	// The histograms are read without locking, the processing continues
+	ofstream ofs(_settings.latency.report.c_str());
+	if ( !ofs ) {
+		SEISCOMP_ERROR("Failed to write latency report to %s",
+		               _settings.latency.report.c_str());
+		return;
+	}
+
+	latency->dump(ofs);
+	SEISCOMP_INFO("Wrote latency report to %s", _settings.latency.report.c_str());
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void Application::sendNotification(const Notification &n) {
 	_queue.push(n);
@@ -1306,6 +1419,42 @@ bool Application::reloadInventory() {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool Application::writeInventorySnapshot() {
+	// A snapshot is shared by all modules, so it holds the complete
+	// inventory regardless of what this application would load and
+	// without the network and station type filters applied.
+	if ( !_settings.database.inventoryDB.empty() ) {
+		if ( !loadInventory(_settings.database.inventoryDB) ) {
+			return false;
+		}
+	}
+	else if ( _query ) {
+		SEISCOMP_INFO("Loading complete inventory");
+		showMessage("Loading inventory");
+		Inventory::Instance()->load(_query.get());
+		SEISCOMP_INFO("Finished loading complete inventory");
+	}
+	else {
+		SEISCOMP_ERROR("No inventory source for the snapshot, either "
+		               "--inventory-db or a database is required");
+		return false;
+	}
+
+	const char *fn = _settings.database.inventorySnapshot.c_str();
+	if ( !Inventory::Instance()->writeSnapshot(fn) ) {
+		SEISCOMP_ERROR("Failed to write inventory snapshot to %s", fn);
+		return false;
+	}
+
+	SEISCOMP_INFO("Wrote inventory snapshot to %s", fn);
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 bool Application::reloadBindings() {
 	_configModule = nullptr;
@@ -1374,6 +1523,12 @@ bool Application::run() {
 		_sohTimer.start();
 	}
 
+	if ( _settings.latency.enable ) {
+		_latencyTimer.setTimeout(1);
+		_latencyTimer.setCallback(bind(&Application::latencyTimeout, this));
+		_latencyTimer.start();
+	}
+
 	while ( !_exitRequested ) {
 		if ( !processEvent() ) break;
 		idle();
@@ -1399,7 +1554,14 @@ bool Application::processEvent() {
 				}
 
 				//SEISCOMP_DEBUG("Received object: %s, refCount: %d", obj->className(), obj->referenceCount());
-				if ( !dispatch(obj.get()) ) {
+				if ( evt.timestamp ) {
+					Util::LatencyMonitor::Scope scope(Util::LatencyMonitor::Instance(),
+					                                  evt.timestamp, latencyClass(obj.get()));
+					if ( !dispatch(obj.get()) ) {
+						SEISCOMP_WARNING("Could not dispatch objects");
+					}
+				}
+				else if ( !dispatch(obj.get()) ) {
 					SEISCOMP_WARNING("Could not dispatch objects");
 				}
 				break;
@@ -1538,6 +1700,10 @@ void Application::done() {
 		_sohTimer.disable();
 	}
 
+	if ( _latencyTimer.isActive() ) {
+		_latencyTimer.disable();
+	}
+
 	if ( _userTimer.isActive() ) {
 		SEISCOMP_INFO("Disable timer");
 		disableTimer();
@@ -1683,6 +1849,17 @@ bool Application::initMessaging() {
 				_connection->setCertificate(_settings.messaging.certificate);
 			}
 
+			for ( const auto &item : _settings.messaging.subscriptionFilters ) {
+				size_t p = item.find(':');
+				if ( p == string::npos ) {
+					SEISCOMP_WARNING("Invalid subscription filter '%s', "
+					                 "expected group:expression", item.c_str());
+					continue;
+				}
+
+				_connection->setSubscriptionFilter(item.substr(0, p), item.substr(p + 1));
+			}
+
 			status = _connection->connect(
 				_settings.messaging.user,
 				_settings.messaging.primaryGroup,
@@ -1752,6 +1929,8 @@ bool Application::initMessaging() {
 		_connection->setContentType(Protocol::JSON);
 	else if ( _settings.messaging.contentType == "xml" )
 		_connection->setContentType(Protocol::XML);
+	else if ( _settings.messaging.contentType == "compact" )
+		_connection->setContentType(Protocol::CompactBinary);
 	else if ( !_settings.messaging.contentType.empty() ) {
 		SEISCOMP_ERROR("Invalid message content type: %s",
 		               _settings.messaging.contentType.c_str());
@@ -2103,7 +2282,12 @@ bool Application::readMessages() {
 				return false;
 			}
 
-			if ( _queue.push(msg) ) {
+			Notification n(msg);
+			if ( Util::LatencyMonitor::Instance() ) {
+				n.timestamp = Util::LatencyMonitor::Now();
+			}
+
+			if ( _queue.push(n) ) {
 				return true;
 			}
 
@@ -2279,6 +2463,45 @@ void Application::monitorLog(const Core::Time &now, std::ostream &os) {
 		os << ",last:" << it->test->last().iso();
 		os << /*"utime:" << now.iso() <<*/ ")&";
 	}
+
+	if ( Util::LatencyMonitor::Instance() ) {
+		if ( first ) {
+			os << "&";
+		}
+
+		latencyLog(os);
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void Application::latencyLog(std::ostream &os) {
+	// Reports the latencies since the last call. Values are given in
+	// milliseconds.
+	for ( auto &entry : Util::LatencyMonitor::Instance()->snapshot() ) {
+		auto &last = _latencySnapshots[make_pair(entry.streamClass, static_cast<int>(entry.stage))];
+		auto delta = entry.snapshot;
+		delta -= last;
+		last = entry.snapshot;
+
+		if ( !delta.count ) {
+			continue;
+		}
+
+		os << "lat(";
+		os << "name:" << Util::LatencyMonitor::StageName(entry.stage) << ",";
+		os << "chan:" << entry.streamClass << ",";
+		os << "cnt:" << delta.count << ",";
+		os << "avg:" << delta.mean() * 1E-3 << ",";
+		os << "p50:" << delta.percentile(50) * 1E-3 << ",";
+		os << "p90:" << delta.percentile(90) * 1E-3 << ",";
+		os << "p99:" << delta.percentile(99) * 1E-3 << ",";
+		os << "max:" << delta.max() * 1E-3;
+		os << ")&";
+	}
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
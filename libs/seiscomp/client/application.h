@@ -39,9 +39,11 @@
 
 #include <seiscomp/messaging/connection.h>
 
+#include <seiscomp/utils/latency.h>
 #include <seiscomp/utils/timer.h>
 #include <seiscomp/utils/stringfirewall.h>
 
+#include <map>
 #include <set>
 #include <thread>
 #include <mutex>
@@ -114,13 +116,16 @@ struct SC_SYSTEM_CLIENT_API Notification {
 		StateOfHealth
 	};
 
-	Notification() : object(nullptr), type(Object) {}
-	Notification(Core::BaseObject * o) : object(o), type(Object) {}
-	Notification(int t) : object(nullptr), type(t) {}
-	Notification(int t, Core::BaseObject * o) : object(o), type(t) {}
+	Notification() : object(nullptr), type(Object), timestamp(0) {}
+	Notification(Core::BaseObject * o) : object(o), type(Object), timestamp(0) {}
+	Notification(int t) : object(nullptr), type(t), timestamp(0) {}
+	Notification(int t, Core::BaseObject * o) : object(o), type(t), timestamp(0) {}
 
 	Core::BaseObject *object;
 	int type;
+	//! Arrival time of the object if latency instrumentation is enabled,
+	//! see Util::LatencyMonitor
+	Util::LatencyMonitor::Timestamp timestamp;
 };
 
 
@@ -626,6 +631,7 @@ class SC_SYSTEM_CLIENT_API Application : public System::Application {
 
 		bool loadConfig(const std::string &configDB);
 		bool loadInventory(const std::string &inventoryDB);
+		bool writeInventorySnapshot();
 
 		void startMessageThread();
 		void runMessageThread();
@@ -634,8 +640,10 @@ class SC_SYSTEM_CLIENT_API Application : public System::Application {
 
 		void timeout();
 		void stateOfHealthTimeout();
+		void latencyTimeout();
 
 		void monitorLog(const Core::Time &timestamp, std::ostream &os);
+		void latencyLog(std::ostream &os);
 
 
 	// ----------------------------------------------------------------------
@@ -698,6 +706,7 @@ class SC_SYSTEM_CLIENT_API Application : public System::Application {
 				std::string URI;
 
 				std::string inventoryDB;
+				std::string inventorySnapshot;
 				std::string configDB;
 			}                    database;
 
@@ -726,6 +735,7 @@ class SC_SYSTEM_CLIENT_API Application : public System::Application {
 				std::string  certificate;
 
 				StringVector subscriptions;
+				StringVector subscriptionFilters;
 
 			}                    messaging;
 
@@ -749,6 +759,20 @@ class SC_SYSTEM_CLIENT_API Application : public System::Application {
 				std::string fileType;
 			}                    recordstream;
 
+			struct SignatureValidation {
+				void accept(SettingsLinker &linker);
+
+				unsigned int threads{0};
+				unsigned int window{1024};
+			}                    signatureValidation;
+
+			struct Latency {
+				void accept(SettingsLinker &linker);
+
+				bool        enable{false};
+				std::string report;
+			}                    latency;
+
 			struct Processing {
 				void accept(SettingsLinker &linker);
 
@@ -783,8 +807,13 @@ class SC_SYSTEM_CLIENT_API Application : public System::Application {
 		Util::Timer                  _userTimer;
 		Util::Timer                  _sohTimer;
 		OPT(Core::Time)              _sohLastUpdate;
+		Util::Timer                  _latencyTimer;
 
 		std::mutex                   _objectLogMutex;
+
+		using LatencySnapshots = std::map<std::pair<std::string, int>,
+		                                  Util::LatencyHistogram::Snapshot>;
+		LatencySnapshots             _latencySnapshots;
 };
 
 
@@ -18,13 +18,21 @@
  ***************************************************************************/
 
 
+#define SEISCOMP_COMPONENT Inventory
+
 #include <seiscomp/client/inventory.h>
+#include <seiscomp/io/archive/binarchive.h>
 #include <seiscomp/io/archive/xmlarchive.h>
+#include <seiscomp/logging/log.h>
 #include <seiscomp/datamodel/responsefap.h>
 #include <seiscomp/datamodel/inventory_package.h>
 
-#include <set>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
 #include <iostream>
+#include <set>
 
 
 namespace Seiscomp {
@@ -89,6 +97,36 @@ void Inventory::Reset(){
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void Inventory::load(const char *filename) {
+	if ( strcmp(filename, "-") ) {
+		// Binary snapshots are compact binary archives starting with SCCB
+		char magic[4];
+		std::ifstream ifs(filename, std::ios::binary);
+		if ( ifs.read(magic, sizeof(magic)) && !strncmp(magic, "SCCB", sizeof(magic)) ) {
+			ifs.close();
+
+			IO::CompactBinaryArchive ar;
+			if ( !ar.open(filename) ) {
+				throw Core::GeneralException(std::string(filename) + ": " + ar.errorMsg());
+			}
+
+			DataModel::InventoryPtr inv;
+			ar >> inv;
+			bool success = ar.success();
+			ar.close();
+
+			if ( !success ) {
+				throw Core::GeneralException(std::string(filename) + ": invalid inventory snapshot");
+			}
+
+			if ( !inv ) {
+				throw Core::GeneralException(std::string(filename) + " does not have inventory information");
+			}
+
+			_inventory = inv;
+			return;
+		}
+	}
+
 	IO::XMLArchive ar;
 
 	if ( !ar.open(filename) )
@@ -106,6 +144,40 @@ void Inventory::load(const char *filename) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool Inventory::writeSnapshot(const char *filename) const {
+	if ( !_inventory ) {
+		return false;
+	}
+
+	std::string tmpFile = std::string(filename) + ".tmp";
+
+	{
+		IO::CompactBinaryArchive ar;
+		if ( !ar.create(tmpFile.c_str()) ) {
+			SEISCOMP_ERROR("Unable to create %s", tmpFile.c_str());
+			return false;
+		}
+
+		DataModel::InventoryPtr inv = _inventory;
+		ar << inv;
+		ar.close();
+	}
+
+	if ( rename(tmpFile.c_str(), filename) != 0 ) {
+		SEISCOMP_ERROR("Unable to rename %s to %s: %s",
+		               tmpFile.c_str(), filename, strerror(errno));
+		remove(tmpFile.c_str());
+		return false;
+	}
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void Inventory::load(DataModel::DatabaseReader* reader) {
 	if ( !reader ) return;
@@ -66,8 +66,28 @@ class SC_SYSTEM_CLIENT_API Inventory {
 		static Inventory* Instance();
 		static void Reset();
 
+		/**
+		 * @brief Loads the inventory from a file.
+		 * The file is either an SCML (XML) document or a binary snapshot
+		 * written with writeSnapshot. Snapshots are detected by their
+		 * header. They are only a faster load path: all objects including
+		 * responses are decoded into the heap of each process.
+		 * @param filename The file name, '-' refers to stdin (XML only)
+		 */
 		void load(const char *filename);
 		void load(DataModel::DatabaseReader*);
+
+		/**
+		 * @brief Writes the current inventory as binary snapshot.
+		 * The snapshot is a CompactBinaryArchive which is versioned and
+		 * stores each distinct string once. The inventory is written as
+		 * it is, so it should be loaded completely and without filters
+		 * before. It is written to a temporary file which is renamed
+		 * afterwards so that concurrent readers never see partial files.
+		 * @param filename The output file
+		 * @return Success flag
+		 */
+		bool writeSnapshot(const char *filename) const;
 		void setInventory(DataModel::Inventory*);
 
 		int filter(const Util::StringFirewall *networkTypeFW,
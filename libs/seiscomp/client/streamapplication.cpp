@@ -22,9 +22,13 @@
 
 #include <seiscomp/logging/log.h>
 #include <seiscomp/io/recordinput.h>
+#include <seiscomp/io/records/mseedrecord.h>
+#include <seiscomp/io/records/signaturevalidator.h>
+#include <seiscomp/utils/certstore.h>
 #include <seiscomp/client/streamapplication.h>
 
 #include <functional>
+#include <memory>
 
 
 using namespace Seiscomp;
@@ -344,6 +348,23 @@ void StreamApplication::closeStream() {
 void StreamApplication::readRecords(bool sendEndNotification) {
 	SEISCOMP_INFO("Starting record acquisition");
 
+	// Validate record signatures in a worker pool rather than while reading.
+	// Deferral only applies to records read by this thread.
+	std::unique_ptr<IO::SignatureValidator> validator;
+	if ( _settings.signatureValidation.threads > 0
+	  && Util::CertificateStore::global().isValid() ) {
+		IO::MSeedRecord::SetDeferredAuthentication(true);
+		validator.reset(
+			new IO::SignatureValidator(
+				[this](Record *rec) { return storeRecord(rec); },
+				_settings.signatureValidation.threads,
+				_settings.signatureValidation.window
+			)
+		);
+		SEISCOMP_INFO("Validating record signatures with %d threads",
+		              static_cast<int>(validator->threads()));
+	}
+
 	IO::RecordInput recInput(_recordStream.get(), _recordDatatype, _recordInputHint);
 	try {
 		for ( IO::RecordIterator it = recInput.begin(); it != recInput.end(); ++it ) {
@@ -351,7 +372,14 @@ void StreamApplication::readRecords(bool sendEndNotification) {
 			if ( rec ) {
 				try {
 					rec->endTime();
-					if ( !storeRecord(rec) ) {
+					if ( validator ) {
+						if ( !validator->push(rec) ) {
+							validator->close();
+							IO::MSeedRecord::SetDeferredAuthentication(false);
+							return;
+						}
+					}
+					else if ( !storeRecord(rec) ) {
 						delete rec;
 						return;
 					}
@@ -373,6 +401,14 @@ void StreamApplication::readRecords(bool sendEndNotification) {
 		SEISCOMP_ERROR("Exception in acquisition: '%s'", e.what());
 	}
 
+	if ( validator ) {
+		validator->close();
+		IO::MSeedRecord::SetDeferredAuthentication(false);
+		SEISCOMP_INFO("Record signatures validated: %lu, failed: %lu",
+		              static_cast<unsigned long>(Util::CertificateStore::global().validatedCount()),
+		              static_cast<unsigned long>(Util::CertificateStore::global().failedCount()));
+	}
+
 	if ( sendEndNotification )
 		sendNotification(Notification::AcquisitionFinished);
 
@@ -398,7 +434,20 @@ void StreamApplication::acquisitionFinished() {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 bool StreamApplication::storeRecord(Record *rec) {
-	return _queue.push(rec);
+	Util::LatencyMonitor *latency = Util::LatencyMonitor::Instance();
+	if ( !latency ) {
+		return _queue.push(rec);
+	}
+
+	Notification n(rec);
+	n.timestamp = Util::LatencyMonitor::Now();
+
+	// The end time has been validated already by readRecords
+	latency->record(Util::LatencyMonitor::Feed,
+	                "rec/" + rec->channelCode().substr(0, 2),
+	                (Core::Time::UTC() - rec->endTime()).count());
+
+	return _queue.push(n);
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
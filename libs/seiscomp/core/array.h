@@ -58,6 +58,10 @@ class SC_SYSTEM_CORE_API Array : public Seiscomp::Core::BaseObject {
 	public:
 		//! Destructor
 		virtual ~Array();
+
+		//! Arrays are allocated from Core::MemoryPool
+		static void *operator new(size_t size);
+		static void operator delete(void *ptr, size_t size);
 	
 		//! Returns the data type of the array
 		DataType dataType() const { return _datatype; }
@@ -100,6 +104,16 @@ class SC_SYSTEM_CORE_API Array : public Seiscomp::Core::BaseObject {
 		DataType _datatype;
 };
 
+
+//! Arrays use atomic reference counting as records do, see Record
+inline void intrusive_ptr_add_ref(const Array *p) {
+	p->incrementReferenceCountAtomic();
+}
+
+inline void intrusive_ptr_release(const Array *p) {
+	p->decrementReferenceCountAtomic();
+}
+
 }
 
 #endif
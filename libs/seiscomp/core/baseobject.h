@@ -36,6 +36,7 @@ class BaseObject;
 #include <seiscomp/core/archive.h>
 #include <seiscomp/core/factory.h>
 #include <seiscomp/core.h>
+#include <atomic>
 
 
 #define DECLARE_CASTS(CLASS) \
@@ -201,6 +202,16 @@ class SC_SYSTEM_CORE_API BaseObject {
 		//! when reaching 0
 		void decrementReferenceCount() const;
 
+		/**
+		 * Atomic versions of increment- and decrementReferenceCount. The
+		 * reference counter is always modified atomically, so smart
+		 * pointers of any type may refer to an object which is shared
+		 * between threads. Record and Array call these methods directly
+		 * from their intrusive_ptr overloads.
+		 */
+		void incrementReferenceCountAtomic() const;
+		void decrementReferenceCountAtomic() const;
+
 		/**
 		 * Returns the number of references to this object when using smartpointers
 		 * @return current reference count
@@ -219,7 +230,7 @@ class SC_SYSTEM_CORE_API BaseObject {
 	//  Implementation
 	// ----------------------------------------------------------------------
 	private:
-		mutable volatile unsigned int _referenceCount;
+		mutable std::atomic<unsigned int> _referenceCount;
 		static  volatile unsigned int _objectCount;
 };
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
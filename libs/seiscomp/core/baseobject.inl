@@ -38,7 +38,7 @@ inline void intrusive_ptr_release(const BaseObject *p) {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 inline void BaseObject::incrementReferenceCount() const {
-	++_referenceCount;
+	incrementReferenceCountAtomic();
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -47,8 +47,29 @@ inline void BaseObject::incrementReferenceCount() const {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 inline void BaseObject::decrementReferenceCount() const {
-	if ( --_referenceCount == 0 )
+	decrementReferenceCountAtomic();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+inline void BaseObject::incrementReferenceCountAtomic() const {
+	_referenceCount.fetch_add(1, std::memory_order_relaxed);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+inline void BaseObject::decrementReferenceCountAtomic() const {
+	if ( _referenceCount.fetch_sub(1, std::memory_order_release) == 1 ) {
+		// Make all modifications of other threads visible before deleting
+		std::atomic_thread_fence(std::memory_order_acquire);
 		delete this;
+	}
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -57,7 +78,7 @@ inline void BaseObject::decrementReferenceCount() const {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 inline unsigned int BaseObject::referenceCount() const {
-	return _referenceCount;
+	return _referenceCount.load(std::memory_order_relaxed);
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -0,0 +1,521 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#include <seiscomp/core/continuoustrace.h>
+
+#include <algorithm>
+#include <cmath>
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+namespace Seiscomp {
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+template <typename T>
+Core::Time ContinuousTrace<T>::Span::endTime() const {
+	return _startTime + Core::TimeSpan(_count / _trace->_samplingFrequency);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+template <typename T>
+Core::TimeWindow ContinuousTrace<T>::Span::timeWindow() const {
+	return Core::TimeWindow(_startTime, endTime());
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+template <typename T>
+T ContinuousTrace<T>::Span::operator[](size_t i) const {
+	size_t n;
+	return *_trace->block(_offset + i, n);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+template <typename T>
+void ContinuousTrace<T>::Span::copy(T *out) const {
+	forEachBlock([&out](const T *data, size_t n) {
+		out = std::copy(data, data + n, out);
+	});
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+template <typename T>
+ContinuousTrace<T>::ContinuousTrace(size_t chunkSize, double tolerance)
+: _chunkSize(std::max(chunkSize, size_t(1)))
+, _tolerance(tolerance) {}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+template <typename T>
+bool ContinuousTrace<T>::feed(const Record *rec) {
+	const Array *data = rec->data();
+	if ( !data || data->size() <= 0 ) {
+		return false;
+	}
+
+	double fs = rec->samplingFrequency();
+	if ( fs <= 0 ) {
+		return false;
+	}
+
+	if ( _samplingFrequency == 0 ) {
+		_samplingFrequency = fs;
+		_networkCode = rec->networkCode();
+		_stationCode = rec->stationCode();
+		_locationCode = rec->locationCode();
+		_channelCode = rec->channelCode();
+	}
+	else if ( fs != _samplingFrequency ) {
+		return false;
+	}
+
+	size_t count = static_cast<size_t>(data->size());
+	size_t skip = 0;
+	bool newSegment = true;
+
+	if ( !_segments.empty() ) {
+		const Segment &last = _segments.back();
+		double diff = static_cast<double>(rec->startTime() - timeOf(last, last.count));
+		double tolerance = _tolerance / fs;
+
+		if ( diff < -tolerance ) {
+			// Overlap, skip the samples which are already stored
+			skip = static_cast<size_t>(-diff * fs + 0.5);
+			if ( skip >= count ) {
+				return false;
+			}
+			newSegment = false;
+		}
+		else if ( diff <= tolerance ) {
+			newSegment = false;
+		}
+	}
+
+	if ( newSegment ) {
+		_segments.push_back({rec->startTime(), _end, 0});
+	}
+
+	count -= skip;
+
+	switch ( data->dataType() ) {
+		case Array::CHAR:
+			append(static_cast<const CharArray*>(data)->typedData() + skip, count);
+			break;
+		case Array::INT:
+			append(static_cast<const IntArray*>(data)->typedData() + skip, count);
+			break;
+		case Array::FLOAT:
+			append(static_cast<const FloatArray*>(data)->typedData() + skip, count);
+			break;
+		case Array::DOUBLE:
+			append(static_cast<const DoubleArray*>(data)->typedData() + skip, count);
+			break;
+		default:
+		{
+			ArrayPtr converted = data->copy(TArray::ArrayType);
+			if ( !converted ) {
+				if ( newSegment ) {
+					_segments.pop_back();
+				}
+				return false;
+			}
+			append(static_cast<const TArray*>(converted.get())->typedData() + skip, count);
+			break;
+		}
+	}
+
+	_segments.back().count += count;
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+template <typename T>
+size_t ContinuousTrace<T>::feed(const RecordSequence &seq) {
+	size_t fed = 0;
+
+	for ( const auto &rec : seq ) {
+		if ( feed(rec.get()) ) {
+			++fed;
+		}
+	}
+
+	return fed;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+template <typename T>
+void ContinuousTrace<T>::clear() {
+	_chunks.clear();
+	_segments.clear();
+	_base = _end = 0;
+	_samplingFrequency = 0;
+	_networkCode.clear();
+	_stationCode.clear();
+	_locationCode.clear();
+	_channelCode.clear();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+template <typename T>
+void ContinuousTrace<T>::trimFront(const Core::Time &t) {
+	while ( !_segments.empty() ) {
+		Segment &seg = _segments.front();
+		if ( timeOf(seg, seg.count) <= t ) {
+			_segments.pop_front();
+			continue;
+		}
+
+		if ( seg.startTime < t ) {
+			size_t k = static_cast<size_t>(static_cast<double>(t - seg.startTime) * _samplingFrequency);
+			seg.startTime = timeOf(seg, k);
+			seg.offset += k;
+			seg.count -= k;
+		}
+
+		break;
+	}
+
+	if ( _segments.empty() ) {
+		_chunks.clear();
+		_base = _end = 0;
+		return;
+	}
+
+	size_t first = _segments.front().offset;
+	while ( !_chunks.empty() && _base + _chunkSize <= first ) {
+		_chunks.pop_front();
+		_base += _chunkSize;
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+template <typename T>
+size_t ContinuousTrace<T>::sampleCount() const {
+	size_t count = 0;
+	for ( const auto &seg : _segments ) {
+		count += seg.count;
+	}
+	return count;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+template <typename T>
+Core::TimeWindow ContinuousTrace<T>::timeWindow() const {
+	if ( _segments.empty() ) {
+		return Core::TimeWindow();
+	}
+
+	const Segment &last = _segments.back();
+	return Core::TimeWindow(_segments.front().startTime, timeOf(last, last.count));
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+template <typename T>
+RecordSequence::TimeWindowArray ContinuousTrace<T>::gaps() const {
+	RecordSequence::TimeWindowArray gaps;
+
+	for ( size_t i = 1; i < _segments.size(); ++i ) {
+		const Segment &prev = _segments[i-1];
+		gaps.push_back(Core::TimeWindow(timeOf(prev, prev.count),
+		                                _segments[i].startTime));
+	}
+
+	return gaps;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+template <typename T>
+double ContinuousTrace<T>::availability(const Core::TimeWindow &tw) const {
+	double required = static_cast<double>(tw.length());
+	if ( required <= 0 ) {
+		return 0.0;
+	}
+
+	double available = 0;
+	for ( const auto &span : spans(tw) ) {
+		available += static_cast<double>(span.timeWindow().overlapped(tw).length());
+	}
+
+	return 100.0 * std::min(available / required, 1.0);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+template <typename T>
+typename ContinuousTrace<T>::Spans
+ContinuousTrace<T>::spans(const Core::TimeWindow &tw) const {
+	Spans spans;
+
+	// Segments are sorted by time, find the first which ends after the
+	// start of the window
+	auto it = std::lower_bound(_segments.begin(), _segments.end(), tw.startTime(),
+	                           [this](const Segment &seg, const Core::Time &t) {
+		return timeOf(seg, seg.count) <= t;
+	});
+
+	for ( ; it != _segments.end() && it->startTime < tw.endTime(); ++it ) {
+		Span span = clip(*it, tw);
+		if ( !span.empty() ) {
+			spans.push_back(span);
+		}
+	}
+
+	return spans;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+template <typename T>
+typename ContinuousTrace<T>::Spans ContinuousTrace<T>::spans() const {
+	Spans spans;
+
+	for ( const auto &seg : _segments ) {
+		spans.push_back(Span(this, seg.startTime, seg.offset, seg.count));
+	}
+
+	return spans;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+template <typename T>
+GenericRecord *ContinuousTrace<T>::contiguousRecord(const Core::TimeWindow *tw,
+                                                    bool interpolate) const {
+	Spans parts = tw ? spans(*tw) : spans();
+	if ( parts.empty() ) {
+		return nullptr;
+	}
+
+	// Collect the number of samples including the interpolated gaps first
+	// to fill the output array in one go
+	size_t count = parts[0].size();
+	size_t used = 1;
+	std::vector<size_t> gapSamples(parts.size(), 0);
+
+	if ( interpolate ) {
+		for ( ; used < parts.size(); ++used ) {
+			double gap = static_cast<double>(parts[used].startTime() - parts[used-1].endTime());
+			gapSamples[used] = gap > 0 ? static_cast<size_t>(gap * _samplingFrequency + 0.5) : 0;
+			count += gapSamples[used] + parts[used].size();
+		}
+	}
+
+	Core::SmartPointer<TArray> data = new TArray(static_cast<int>(count));
+	T *out = data->typedData();
+
+	for ( size_t i = 0; i < used; ++i ) {
+		if ( gapSamples[i] ) {
+			T lastSample = parts[i-1][parts[i-1].size()-1];
+			T nextSample = parts[i][0];
+			double dt = 1.0 / (gapSamples[i]+1);
+			double t = dt;
+
+			for ( size_t j = 0; j < gapSamples[i]; ++j, t += dt ) {
+				*out++ = lastSample*(1-t) + nextSample*t;
+			}
+		}
+
+		parts[i].copy(out);
+		out += parts[i].size();
+	}
+
+	GenericRecord *rec = new GenericRecord(_networkCode, _stationCode,
+	                                       _locationCode, _channelCode,
+	                                       parts[0].startTime(),
+	                                       _samplingFrequency);
+	rec->setData(data.get());
+
+	return rec;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+template <typename T>
+size_t ContinuousTrace<T>::toSequence(RecordSequence &seq,
+                                      const Core::TimeWindow *tw) const {
+	size_t fed = 0;
+
+	for ( const auto &span : tw ? spans(*tw) : spans() ) {
+		Core::SmartPointer<TArray> data = new TArray(static_cast<int>(span.size()));
+		span.copy(data->typedData());
+
+		GenericRecordPtr rec = new GenericRecord(_networkCode, _stationCode,
+		                                         _locationCode, _channelCode,
+		                                         span.startTime(),
+		                                         _samplingFrequency);
+		rec->setData(data.get());
+
+		if ( seq.feed(rec.get()) ) {
+			++fed;
+		}
+	}
+
+	return fed;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+template <typename T>
+template <typename S>
+void ContinuousTrace<T>::append(const S *data, size_t n) {
+	while ( n ) {
+		size_t pos = (_end - _base) % _chunkSize;
+		if ( !pos && _end - _base == _chunks.size() * _chunkSize ) {
+			_chunks.emplace_back(new T[_chunkSize]);
+		}
+
+		size_t m = std::min(n, _chunkSize - pos);
+		T *out = _chunks[(_end - _base) / _chunkSize].get() + pos;
+		for ( size_t i = 0; i < m; ++i ) {
+			out[i] = static_cast<T>(data[i]);
+		}
+
+		data += m;
+		n -= m;
+		_end += m;
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+template <typename T>
+const T *ContinuousTrace<T>::block(size_t offset, size_t &n) const {
+	size_t rel = offset - _base;
+	size_t pos = rel % _chunkSize;
+	n = _chunkSize - pos;
+	return _chunks[rel / _chunkSize].get() + pos;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+template <typename T>
+Core::Time ContinuousTrace<T>::timeOf(const Segment &seg, size_t index) const {
+	return seg.startTime + Core::TimeSpan(index / _samplingFrequency);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+template <typename T>
+typename ContinuousTrace<T>::Span
+ContinuousTrace<T>::clip(const Segment &seg, const Core::TimeWindow &tw) const {
+	// A sample is included if its sampling interval intersects the window
+	double from = std::floor(static_cast<double>(tw.startTime() - seg.startTime) * _samplingFrequency);
+	double to = std::ceil(static_cast<double>(tw.endTime() - seg.startTime) * _samplingFrequency);
+
+	size_t first = from > 0 ? static_cast<size_t>(from) : 0;
+	size_t last = to > 0 ? std::min(static_cast<size_t>(to), seg.count) : 0;
+
+	if ( first >= last ) {
+		return Span();
+	}
+
+	return Span(this, timeOf(seg, first), seg.offset + first, last - first);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+template class SC_SYSTEM_CORE_API ContinuousTrace<int>;
+template class SC_SYSTEM_CORE_API ContinuousTrace<float>;
+template class SC_SYSTEM_CORE_API ContinuousTrace<double>;
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
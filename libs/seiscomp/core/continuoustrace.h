@@ -0,0 +1,272 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#ifndef SEISCOMP_CORE_CONTINUOUSTRACE_H
+#define SEISCOMP_CORE_CONTINUOUSTRACE_H
+
+
+#include <seiscomp/core/genericrecord.h>
+#include <seiscomp/core/recordsequence.h>
+#include <seiscomp/core/timewindow.h>
+#include <seiscomp/core/typedarray.h>
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+
+namespace Seiscomp {
+
+
+/**
+ * @brief The ContinuousTrace class stores the samples of a single stream in
+ *        large fixed size chunks.
+ *
+ * In contrast to RecordSequence which keeps each record with its own data
+ * array, the samples of all fed records are copied into chunks of
+ * chunkSize samples. Records only allocate memory if a new chunk is
+ * started. A side index holds the contiguous segments, everything between
+ * two segments is a gap.
+ *
+ * Records must be fed in time order. Overlapping samples are skipped,
+ * records which start before the end of the trace by more than their
+ * length and records with a different sampling frequency are rejected.
+ *
+ * Compiled in is support for int, float and double samples.
+ */
+template <typename T>
+class ContinuousTrace {
+	// ----------------------------------------------------------------------
+	//  Public types
+	// ----------------------------------------------------------------------
+	public:
+		using TArray = NumericArray<T>;
+
+		//! A contiguous run of samples
+		struct Segment {
+			Core::Time startTime;
+			//! The absolute index of the first sample
+			size_t     offset;
+			size_t     count;
+		};
+
+		using Segments = std::deque<Segment>;
+
+		/**
+		 * @brief A read-only view of contiguous samples which may span
+		 *        several chunks. A span is invalidated if the trace is
+		 *        trimmed or cleared.
+		 */
+		class Span {
+			public:
+				Span() = default;
+
+			public:
+				bool empty() const { return _count == 0; }
+				size_t size() const { return _count; }
+
+				const Core::Time &startTime() const { return _startTime; }
+				Core::Time endTime() const;
+				Core::TimeWindow timeWindow() const;
+
+				//! Returns the sample at index i, no range check is done
+				T operator[](size_t i) const;
+
+				/**
+				 * @brief Calls func(const T *data, size_t n) for each block
+				 *        of samples stored contiguously in memory.
+				 */
+				template <typename F>
+				void forEachBlock(F func) const;
+
+				//! Copies all samples to out which must hold size() samples
+				void copy(T *out) const;
+
+			private:
+				Span(const ContinuousTrace *trace, const Core::Time &startTime,
+				     size_t offset, size_t count)
+				: _trace(trace), _startTime(startTime)
+				, _offset(offset), _count(count) {}
+
+			private:
+				const ContinuousTrace *_trace{nullptr};
+				Core::Time             _startTime;
+				size_t                 _offset{0};
+				size_t                 _count{0};
+
+			friend class ContinuousTrace;
+		};
+
+		using Spans = std::vector<Span>;
+
+
+	// ----------------------------------------------------------------------
+	//  X'truction
+	// ----------------------------------------------------------------------
+	public:
+		/**
+		 * @brief Constructs an empty trace.
+		 * @param chunkSize The number of samples per chunk
+		 * @param tolerance The maximum gap or overlap in samples which does
+		 *                  not break a segment, see RecordSequence.
+		 */
+		explicit ContinuousTrace(size_t chunkSize = 65536, double tolerance = 0.5);
+
+		ContinuousTrace(const ContinuousTrace &) = delete;
+		ContinuousTrace &operator=(const ContinuousTrace &) = delete;
+
+
+	// ----------------------------------------------------------------------
+	//  Public interface
+	// ----------------------------------------------------------------------
+	public:
+		//! Appends the samples of a record. Returns true if at least one
+		//! sample was added.
+		bool feed(const Record *rec);
+
+		//! Feeds all records of a sequence and returns the number of
+		//! accepted records.
+		size_t feed(const RecordSequence &seq);
+
+		//! Removes all samples and resets the stream information
+		void clear();
+
+		/**
+		 * @brief Removes all samples before a given time. Chunks which do
+		 *        not hold any sample anymore are released.
+		 */
+		void trimFront(const Core::Time &t);
+
+		bool empty() const { return _segments.empty(); }
+		size_t chunkSize() const { return _chunkSize; }
+		double tolerance() const { return _tolerance; }
+		double samplingFrequency() const { return _samplingFrequency; }
+
+		//! The number of samples stored
+		size_t sampleCount() const;
+
+		const std::string &networkCode() const { return _networkCode; }
+		const std::string &stationCode() const { return _stationCode; }
+		const std::string &locationCode() const { return _locationCode; }
+		const std::string &channelCode() const { return _channelCode; }
+
+		const Segments &segments() const { return _segments; }
+
+		//! Time window of the trace, irrespective of gaps
+		Core::TimeWindow timeWindow() const;
+
+		//! Returns the gaps between segments
+		RecordSequence::TimeWindowArray gaps() const;
+
+		//! Returns the data availability in a time window in percent
+		double availability(const Core::TimeWindow &tw) const;
+
+		//! Returns one span per segment which intersects a time window
+		Spans spans(const Core::TimeWindow &tw) const;
+
+		//! Returns one span per segment
+		Spans spans() const;
+
+		/**
+		 * @brief Returns the samples as one contiguous record like
+		 *        RecordSequence::contiguousRecord does. The record starts
+		 *        with the first segment which intersects the optional time
+		 *        window and is clipped to it. If interpolation is enabled
+		 *        gaps will be linearly interpolated between the last and
+		 *        the next sample, otherwise the record ends at the first gap.
+		 */
+		GenericRecord *contiguousRecord(const Core::TimeWindow *tw = nullptr,
+		                                bool interpolate = false) const;
+
+		/**
+		 * @brief Appends one record per segment which intersects the
+		 *        optional time window to a record sequence. This allows to
+		 *        pass the trace to code which expects a RecordSequence.
+		 * @return The number of records fed
+		 */
+		size_t toSequence(RecordSequence &seq,
+		                  const Core::TimeWindow *tw = nullptr) const;
+
+
+	// ----------------------------------------------------------------------
+	//  Private methods
+	// ----------------------------------------------------------------------
+	private:
+		template <typename S>
+		void append(const S *data, size_t n);
+
+		const T *block(size_t offset, size_t &n) const;
+		Core::Time timeOf(const Segment &seg, size_t index) const;
+		Span clip(const Segment &seg, const Core::TimeWindow &tw) const;
+
+
+	// ----------------------------------------------------------------------
+	//  Private members
+	// ----------------------------------------------------------------------
+	private:
+		using Chunk = std::unique_ptr<T[]>;
+
+		size_t            _chunkSize;
+		double            _tolerance;
+		double            _samplingFrequency{0};
+
+		std::string       _networkCode;
+		std::string       _stationCode;
+		std::string       _locationCode;
+		std::string       _channelCode;
+
+		std::deque<Chunk> _chunks;
+		//! The absolute index of the first sample of the first chunk
+		size_t            _base{0};
+		//! The absolute index of the next sample to be written
+		size_t            _end{0};
+		Segments          _segments;
+};
+
+
+template <typename T>
+template <typename F>
+inline void ContinuousTrace<T>::Span::forEachBlock(F func) const {
+	size_t offset = _offset;
+	size_t remaining = _count;
+
+	while ( remaining ) {
+		size_t n;
+		const T *data = _trace->block(offset, n);
+		if ( n > remaining ) {
+			n = remaining;
+		}
+
+		func(data, n);
+		offset += n;
+		remaining -= n;
+	}
+}
+
+
+using IntContinuousTrace = ContinuousTrace<int>;
+using FloatContinuousTrace = ContinuousTrace<float>;
+using DoubleContinuousTrace = ContinuousTrace<double>;
+
+
+}
+
+
+#endif
@@ -61,6 +61,24 @@ GreensFunction::~GreensFunction() {}
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+GreensFunction *GreensFunction::clone() const {
+	GreensFunction *gf = new GreensFunction(_model, _distance, _depth,
+	                                        _samplingFrequency, _timeOffset);
+	gf->_id = _id;
+
+	for ( int i = 0; i < GreensFunctionComponent::Quantity; ++i ) {
+		if ( _components[i] )
+			gf->_components[i] = _components[i]->clone();
+	}
+
+	return gf;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void GreensFunction::setId(const std::string &id) {
 	_id = id;
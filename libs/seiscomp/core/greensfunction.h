@@ -78,6 +78,9 @@ class SC_SYSTEM_CORE_API GreensFunction : public Core::BaseObject {
 
 		virtual ~GreensFunction();
 
+		//! Returns a deep copy including all component arrays
+		GreensFunction *clone() const override;
+
 	// ------------------------------------------------------------------
 	//  Public interface
 	// ------------------------------------------------------------------
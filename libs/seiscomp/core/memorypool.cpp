@@ -0,0 +1,243 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+
+#include <seiscomp/core/memorypool.h>
+
+#include <atomic>
+#include <mutex>
+#include <new>
+
+
+namespace Seiscomp {
+namespace Core {
+
+
+namespace {
+
+
+constexpr size_t MinBlockShift = 5;
+constexpr size_t SizeClasses = 8;
+// Number of blocks cached per thread and size class before half of them
+// are moved to the shared list
+constexpr size_t ThreadCacheBlocks = 64;
+
+static_assert((size_t(1) << (MinBlockShift + SizeClasses - 1)) == MemoryPool::MaxBlockSize,
+              "Size classes do not match the maximum block size");
+
+
+struct FreeBlock {
+	FreeBlock *next;
+};
+
+
+struct SharedList {
+	std::mutex  mutex;
+	FreeBlock  *head{nullptr};
+	size_t      count{0};
+};
+
+
+std::atomic<bool>   poolEnabled{true};
+std::atomic<size_t> poolCapacity{8 * 1024 * 1024};
+
+
+inline size_t sizeClass(size_t size) {
+	size_t cls = 0;
+	while ( (size_t(1) << (cls + MinBlockShift)) < size ) {
+		++cls;
+	}
+	return cls;
+}
+
+
+inline size_t blockSize(size_t cls) {
+	return size_t(1) << (cls + MinBlockShift);
+}
+
+
+SharedList *sharedLists() {
+	// Never destroyed as thread caches might be flushed during static
+	// destruction
+	static SharedList *lists = new SharedList[SizeClasses];
+	return lists;
+}
+
+
+struct ThreadCache {
+	~ThreadCache() {
+		for ( size_t cls = 0; cls < SizeClasses; ++cls ) {
+			flush(cls, count[cls]);
+		}
+		destroyed = true;
+	}
+
+	// Moves n blocks to the shared list or releases them if the shared
+	// list is full
+	void flush(size_t cls, size_t n) {
+		if ( !n ) {
+			return;
+		}
+
+		FreeBlock *first = head[cls];
+		FreeBlock *last = first;
+		for ( size_t i = 1; i < n; ++i ) {
+			last = last->next;
+		}
+
+		head[cls] = last->next;
+		count[cls] -= n;
+
+		size_t maxBlocks = poolEnabled ? poolCapacity / blockSize(cls) : 0;
+		auto &shared = sharedLists()[cls];
+
+		{
+			std::lock_guard<std::mutex> lock(shared.mutex);
+			if ( shared.count + n <= maxBlocks ) {
+				last->next = shared.head;
+				shared.head = first;
+				shared.count += n;
+				return;
+			}
+		}
+
+		last->next = nullptr;
+		while ( first ) {
+			FreeBlock *next = first->next;
+			::operator delete(first);
+			first = next;
+		}
+	}
+
+	// Takes up to n blocks from the shared list
+	void refill(size_t cls, size_t n) {
+		auto &shared = sharedLists()[cls];
+		std::lock_guard<std::mutex> lock(shared.mutex);
+
+		while ( n-- && shared.head ) {
+			FreeBlock *block = shared.head;
+			shared.head = block->next;
+			--shared.count;
+
+			block->next = head[cls];
+			head[cls] = block;
+			++count[cls];
+		}
+	}
+
+	FreeBlock     *head[SizeClasses]{};
+	size_t         count[SizeClasses]{};
+	static thread_local bool destroyed;
+};
+
+
+thread_local bool ThreadCache::destroyed = false;
+thread_local ThreadCache threadCache;
+
+
+}
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void *MemoryPool::Allocate(size_t size) {
+	if ( size > MaxBlockSize ) {
+		return ::operator new(size);
+	}
+
+	// Blocks are always allocated with the size of their class to allow
+	// enabling the pool at any time
+	size_t cls = sizeClass(size);
+
+	if ( poolEnabled && !ThreadCache::destroyed ) {
+		auto &cache = threadCache;
+		if ( !cache.head[cls] ) {
+			cache.refill(cls, ThreadCacheBlocks / 2);
+		}
+
+		FreeBlock *block = cache.head[cls];
+		if ( block ) {
+			cache.head[cls] = block->next;
+			--cache.count[cls];
+			return block;
+		}
+	}
+
+	return ::operator new(blockSize(cls));
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void MemoryPool::Release(void *block, size_t size) {
+	if ( !block ) {
+		return;
+	}
+
+	if ( (size > MaxBlockSize) || !poolEnabled || ThreadCache::destroyed ) {
+		::operator delete(block);
+		return;
+	}
+
+	size_t cls = sizeClass(size);
+	auto &cache = threadCache;
+
+	auto freeBlock = static_cast<FreeBlock*>(block);
+	freeBlock->next = cache.head[cls];
+	cache.head[cls] = freeBlock;
+
+	if ( ++cache.count[cls] > ThreadCacheBlocks ) {
+		cache.flush(cls, ThreadCacheBlocks / 2);
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void MemoryPool::SetEnabled(bool enable) {
+	poolEnabled = enable;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool MemoryPool::IsEnabled() {
+	return poolEnabled;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void MemoryPool::SetCapacity(size_t bytes) {
+	poolCapacity = bytes;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+}
+}
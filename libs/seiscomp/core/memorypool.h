@@ -0,0 +1,96 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+
+#ifndef SEISCOMP_CORE_MEMORYPOOL_H
+#define SEISCOMP_CORE_MEMORYPOOL_H
+
+
+#include <seiscomp/core.h>
+
+#include <cstddef>
+
+
+namespace Seiscomp {
+namespace Core {
+
+
+/**
+ * @brief Process wide pool of small memory blocks grouped in size classes.
+ *
+ * Requested sizes are rounded up to the next power of two starting with
+ * 32 bytes. Released blocks are kept in a small per thread cache and
+ * exchanged in batches with a shared free list per size class, so that
+ * objects allocated in one thread and released in another, e.g. records
+ * passed from acquisition to processing threads, do not have to go
+ * through the system allocator each time. Blocks larger than MaxBlockSize
+ * are passed to the system allocator directly. All methods are
+ * thread-safe.
+ */
+class SC_SYSTEM_CORE_API MemoryPool {
+	// ----------------------------------------------------------------------
+	//  Public types
+	// ----------------------------------------------------------------------
+	public:
+		//! The size of the largest block which is pooled
+		static constexpr size_t MaxBlockSize = 4096;
+
+
+	// ----------------------------------------------------------------------
+	//  Public interface
+	// ----------------------------------------------------------------------
+	public:
+		/**
+		 * @brief Allocates a block of at least the given size.
+		 * @throw std::bad_alloc if the system allocator fails
+		 */
+		static void *Allocate(size_t size);
+
+		/**
+		 * @brief Releases a block returned by Allocate.
+		 * @param block The block, may be nullptr
+		 * @param size The size passed to Allocate
+		 */
+		static void Release(void *block, size_t size);
+
+		/**
+		 * @brief Enables or disables reusing released blocks. Blocks
+		 *        allocated in either state can be released in the other
+		 *        one. The pool is enabled by default.
+		 */
+		static void SetEnabled(bool enable);
+		static bool IsEnabled();
+
+		/**
+		 * @brief Sets the number of bytes which are kept at most in the
+		 *        shared free list of each size class. Blocks exceeding
+		 *        the capacity are returned to the system allocator. The
+		 *        default is 8 MiB.
+		 */
+		static void SetCapacity(size_t bytes);
+};
+
+
+}
+}
+
+
+#endif
@@ -22,6 +22,7 @@
 #include <cmath>
 #include <seiscomp/core/record.h>
 #include <seiscomp/core/exceptions.h>
+#include <seiscomp/core/memorypool.h>
 #include <seiscomp/core/interfacefactory.ipp>
 
 
@@ -64,7 +65,8 @@ Record::Record(const Record &rec)
 , _hint(rec._hint), _nsamp(rec.sampleCount())
 , _fsamp(rec.samplingFrequency()), _timequal(rec.timingQuality())
 , _authenticationStatus(rec._authenticationStatus)
-, _authority(rec._authority) {}
+, _authority(rec._authority)
+, _streamEntry(rec._streamEntry.load(std::memory_order_acquire)) {}
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 
@@ -77,6 +79,24 @@ Record::~Record () {}
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void *Record::operator new(size_t size) {
+	return Core::MemoryPool::Allocate(size);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void Record::operator delete(void *ptr, size_t size) {
+	Core::MemoryPool::Release(ptr, size);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 Record& Record::operator=(const Record &rec) {
 	if ( &rec != this ) {
@@ -92,6 +112,8 @@ Record& Record::operator=(const Record &rec) {
 		_timequal = rec.timingQuality();
 		_authenticationStatus = rec._authenticationStatus;
 		_authority = rec._authority;
+		_streamEntry.store(rec._streamEntry.load(std::memory_order_acquire),
+		                   std::memory_order_release);
 	}
 
 	return *this;
@@ -263,6 +285,23 @@ std::string Record::streamID() const {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Core::StreamHandle Record::streamHandle() const {
+	auto entry = _streamEntry.load(std::memory_order_acquire);
+	if ( !entry || !entry->matches(_net, _sta, _loc, _cha) ) {
+		// Entries are immutable and never released, concurrent callers
+		// store the same pointer
+		entry = Core::StreamIDTable::Intern(_net, _sta, _loc, _cha);
+		_streamEntry.store(entry, std::memory_order_release);
+	}
+
+	return entry->handle;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 Array::DataType Record::dataType() const {
 	return _datatype;
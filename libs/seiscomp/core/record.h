@@ -22,6 +22,7 @@
 #define SEISCOMP_CORE_RECORD_H
 
 
+#include <atomic>
 #include <string>
 #include <time.h>
 #include <iostream>
@@ -31,6 +32,7 @@
 #include <seiscomp/core/timewindow.h>
 #include <seiscomp/core/array.h>
 #include <seiscomp/core/exceptions.h>
+#include <seiscomp/core/streamid.h>
 
 
 
@@ -89,6 +91,15 @@ class SC_SYSTEM_CORE_API Record : public Seiscomp::Core::BaseObject {
 		//! Destructor
 		virtual ~Record();
 
+
+	// ----------------------------------------------------------------------
+	//  Memory management
+	// ----------------------------------------------------------------------
+	public:
+		//! Records and derived classes are allocated from Core::MemoryPool
+		static void *operator new(size_t size);
+		static void operator delete(void *ptr, size_t size);
+
 	
 	// ----------------------------------------------------------------------
 	//  Operators
@@ -153,6 +164,14 @@ class SC_SYSTEM_CORE_API Record : public Seiscomp::Core::BaseObject {
 		//! Returns the so called stream ID: <net>.<sta>.<loc>.<cha>
 		std::string streamID() const;
 
+		/**
+		 * @brief Returns the interned handle of the stream ID.
+		 * The handle is unique for each stream within the process and
+		 * is meant as cheap key for routing records to their consumers.
+		 * @return The handle, see Core::StreamIDTable
+		 */
+		Core::StreamHandle streamHandle() const;
+
 		//! Returns the data type specified for the data sample requests
 		Array::DataType dataType() const;
 
@@ -163,6 +182,9 @@ class SC_SYSTEM_CORE_API Record : public Seiscomp::Core::BaseObject {
 		//! Sets the hint used for data operations
 		void setHint(Hint h);
 
+		//! Returns the hint used for data operations
+		Hint hint() const;
+
 		/**
 		 * @brief Sets the authentication state.
 		 * This function was introduced with API 13.
@@ -232,9 +254,28 @@ class SC_SYSTEM_CORE_API Record : public Seiscomp::Core::BaseObject {
 		int             _timequal{-1};
 		Authentication  _authenticationStatus{NOT_SIGNED};
 		std::string     _authority;
+
+	private:
+		// Cached stream table entry, validated against the codes on access
+		// as derived classes may set them directly. It is updated from the
+		// const accessor while the record might be shared between threads.
+		mutable std::atomic<const Core::StreamIDTable::Entry*> _streamEntry{nullptr};
 };
 
 
+/**
+ * Records are passed between acquisition and processing threads and use
+ * atomic reference counting.
+ */
+inline void intrusive_ptr_add_ref(const Record *p) {
+	p->incrementReferenceCountAtomic();
+}
+
+inline void intrusive_ptr_release(const Record *p) {
+	p->decrementReferenceCountAtomic();
+}
+
+
 DEFINE_INTERFACE_FACTORY(Record);
 
 #define REGISTER_RECORD_VAR(Class, Service) \
@@ -244,6 +285,10 @@ Seiscomp::Core::Generic::InterfaceFactory<Seiscomp::Record, Class> __##Class##In
 static REGISTER_RECORD_VAR(Class, Service)
 
 
+inline Record::Hint Record::hint() const {
+	return _hint;
+}
+
 inline Record::Authentication Record::authentication() const {
 	return _authenticationStatus;
 }
@@ -66,6 +66,16 @@ RecordSequence::RecordSequence(double tolerance)
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+RecordSequence::RecordSequence(const RecordSequence &other)
+: std::deque<RecordCPtr>(other)
+, _tolerance(other._tolerance)
+{}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 RecordSequence::~RecordSequence() {}
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -73,6 +83,18 @@ RecordSequence::~RecordSequence() {}
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+RecordSequence &RecordSequence::operator=(const RecordSequence &other) {
+	std::deque<RecordCPtr>::operator=(other);
+	_tolerance = other._tolerance;
+	_index = nullptr;
+	return *this;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 Core::TimeWindow RecordSequence::timeWindow() const {
 	Core::TimeWindow tw;
@@ -153,60 +175,556 @@ bool updateRange(RecordSequence::Range &range, const Array &arr, int start, int
 }
 
 
+void mergeRange(RecordSequence::Range &range, bool &foundRecords,
+                const RecordSequence::Range &other) {
+	if ( !foundRecords ) {
+		range = other;
+		foundRecords = true;
+	}
+	else {
+		if ( other.first < range.first )
+			range.first = other.first;
+		if ( other.second > range.second )
+			range.second = other.second;
+	}
 }
 
 
-RecordSequence::Range RecordSequence::amplitudeRange(const Core::TimeWindow *tw) const {
-	Range range(0.0,0.0);
-	bool foundRecords = false;
-
-	for ( const_iterator it = begin(); it != end(); ++it) {
-		const Record *rec = it->get();
-		const Array *data = rec->data();
+void recordRange(RecordSequence::Range &range, bool &foundRecords,
+                 const Record *rec, const Core::TimeWindow *tw) {
+	const Array *data = rec->data();
 
-		// Skip empty records
-		if ( data == nullptr ) continue;
-		if ( data->size() == 0 ) continue;
+	// Skip empty records
+	if ( data == nullptr ) return;
+	if ( data->size() == 0 ) return;
 
-		int imin = 0, imax = 0;
+	int imin = 0, imax = 0;
 
-		if ( tw != nullptr ) { // limit search for min/max to specified time window
-			try {
-				const Core::TimeWindow &rtw = rec->timeWindow();
+	if ( tw != nullptr ) { // limit search for min/max to specified time window
+		try {
+			const Core::TimeWindow &rtw = rec->timeWindow();
 
-				if ( tw->overlaps(rtw) ) {
-					double fs = rec->samplingFrequency();
-					double dt = static_cast<double>(tw->startTime() - rec->startTime());
+			if ( tw->overlaps(rtw) ) {
+				double fs = rec->samplingFrequency();
+				double dt = static_cast<double>(tw->startTime() - rec->startTime());
 
-					if ( dt > 0 ) {
-						imin = int(dt*fs);
-					}
+				if ( dt > 0 ) {
+					imin = int(dt*fs);
+				}
 
-					dt = static_cast<double>(rec->endTime() - tw->endTime());
-					imax = data->size();
-					if ( dt > 0 ) {
-						imax -= int(dt*fs);
-					}
+				dt = static_cast<double>(rec->endTime() - tw->endTime());
+				imax = data->size();
+				if ( dt > 0 ) {
+					imax -= int(dt*fs);
 				}
-				else
-					continue;
-			}
-			catch ( ... ) {
-				continue;
 			}
+			else
+				return;
+		}
+		catch ( ... ) {
+			return;
+		}
+	}
+	else // no time window specified -> search over whole record
+		imax = data->size();
+
+	if ( imax <= imin ) return;
+
+	// The first record contributing to the range?
+	if ( !foundRecords ) {
+		if ( getRange(range, *data, imin, imax) )
+			foundRecords = true;
+	}
+	else
+		updateRange(range, *data, imin, imax);
+}
+
+
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+// A segment tree over the summaries of all records. The leaves are stored
+// at absolute positions [first, first+count) so that appending and
+// removing the first record only update the path to the root. The tree is
+// compacted or grown if the end of the capacity is reached.
+struct RecordSequence::Index {
+	struct Leaf {
+		const Record    *record{nullptr};
+		Core::Time       startTime;
+		Core::Time       endTime;
+		double           fs{0};
+		Range            range;
+		// Whether the range has been computed, it is not for records which
+		// decode their data only on demand
+		bool             summarized{false};
+		bool             hasRange{false};
+		// Whether the time window could not be computed
+		bool             invalid{false};
+		// Whether the time window is empty
+		bool             degenerate{false};
+		// Relation to the previous record
+		bool             gap{false};
+		bool             unsorted{false};
+	};
+
+	struct Node {
+		size_t           count{0};
+		Range            range;
+		bool             hasRange{false};
+		size_t           unsummarized{0};
+		size_t           invalid{0};
+		size_t           irregular{0};
+		size_t           gaps{0};
+		Core::TimeSpan   gapLength{0, 0};
+		// The minimum start time and maximum end time of all records with
+		// a valid time window
+		bool             hasTime{false};
+		Core::Time       startTime;
+		Core::Time       endTime;
+	};
+
+	bool matches(const RecordSequence &seq) const;
+	const Node &root() const { return nodes[1]; }
+
+	void assign(const RecordSequence &seq);
+	void insert(size_t pos, const Record *rec);
+	void removeFront();
+
+	void amplitudeRange(size_t node, const Core::TimeWindow *tw,
+	                    Range &range, bool &foundRecords) const;
+	void gapPositions(size_t node, std::vector<size_t> &positions) const;
+	Core::Time startTime(size_t from, size_t to) const;
+
+	static Leaf summarize(const Record *rec);
+	static void combine(Node &node, const Node &left, const Node &right);
+
+	void link(size_t pos);
+	void update(size_t pos);
+	void rebuild(size_t capacity);
+
+	double            tolerance{0};
+	size_t            capacity{0};
+	size_t            first{0};
+	size_t            count{0};
+	std::vector<Leaf> leaves;
+	std::vector<Node> nodes;
+};
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool RecordSequence::Index::matches(const RecordSequence &seq) const {
+	if ( count != seq.size() ) return false;
+	if ( !count ) return true;
+	return leaves[first].record == seq.front().get()
+	    && leaves[first+count-1].record == seq.back().get();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+RecordSequence::Index::Leaf RecordSequence::Index::summarize(const Record *rec) {
+	Leaf leaf;
+	leaf.record = rec;
+
+	try {
+		leaf.startTime = rec->startTime();
+		leaf.endTime = rec->endTime();
+		leaf.fs = rec->samplingFrequency();
+		leaf.degenerate = !rec->timeWindow();
+	}
+	catch ( ... ) {
+		leaf.invalid = true;
+	}
+
+	// Do not force records to decode their data which keep the raw data
+	// on purpose
+	if ( rec->hint() == Record::SAVE_RAW ) {
+		return leaf;
+	}
+
+	try {
+		const Array *data = rec->data();
+		if ( data && data->size() > 0 ) {
+			leaf.hasRange = getRange(leaf.range, *data, 0, data->size());
+		}
+		leaf.summarized = true;
+	}
+	catch ( ... ) {}
+
+	return leaf;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void RecordSequence::Index::combine(Node &node, const Node &left, const Node &right) {
+	if ( !left.count ) {
+		node = right;
+		return;
+	}
+
+	if ( !right.count ) {
+		node = left;
+		return;
+	}
+
+	node.count = left.count + right.count;
+	node.unsummarized = left.unsummarized + right.unsummarized;
+	node.invalid = left.invalid + right.invalid;
+	node.irregular = left.irregular + right.irregular;
+	node.gaps = left.gaps + right.gaps;
+	node.gapLength = left.gapLength + right.gapLength;
+
+	node.hasRange = false;
+	if ( left.hasRange ) mergeRange(node.range, node.hasRange, left.range);
+	if ( right.hasRange ) mergeRange(node.range, node.hasRange, right.range);
+
+	if ( left.hasTime && right.hasTime ) {
+		node.hasTime = true;
+		node.startTime = std::min(left.startTime, right.startTime);
+		node.endTime = std::max(left.endTime, right.endTime);
+	}
+	else if ( left.hasTime ) {
+		node.hasTime = true;
+		node.startTime = left.startTime;
+		node.endTime = left.endTime;
+	}
+	else {
+		node.hasTime = right.hasTime;
+		node.startTime = right.startTime;
+		node.endTime = right.endTime;
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void RecordSequence::Index::link(size_t pos) {
+	Leaf &leaf = leaves[pos];
+	leaf.gap = leaf.unsorted = false;
+
+	if ( pos == first ) return;
+
+	const Leaf &prev = leaves[pos-1];
+	if ( leaf.invalid || prev.invalid ) return;
+
+	// Same test as in gaps()
+	Core::TimeWindow prevTw(prev.startTime, prev.endTime);
+	Core::TimeWindow tw(leaf.startTime, leaf.endTime);
+	leaf.gap = !prevTw.contiguous(tw, tolerance/leaf.fs);
+	leaf.unsorted = leaf.endTime < prev.endTime;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void RecordSequence::Index::update(size_t pos) {
+	const Leaf &leaf = leaves[pos];
+	size_t n = capacity + pos;
+	Node &node = nodes[n];
+
+	node = Node();
+	if ( leaf.record ) {
+		node.count = 1;
+		node.range = leaf.range;
+		node.hasRange = leaf.hasRange;
+		node.unsummarized = leaf.summarized ? 0 : 1;
+		node.invalid = leaf.invalid ? 1 : 0;
+		node.irregular = (leaf.degenerate || leaf.unsorted) ? 1 : 0;
+		node.gaps = leaf.gap ? 1 : 0;
+		if ( leaf.gap ) {
+			node.gapLength = leaf.startTime - leaves[pos-1].endTime;
 		}
-		else // no time window specified -> search over whole record
-			imax = data->size();
+		node.hasTime = !leaf.invalid;
+		node.startTime = leaf.startTime;
+		node.endTime = leaf.endTime;
+	}
+
+	for ( n >>= 1; n > 0; n >>= 1 ) {
+		combine(nodes[n], nodes[2*n], nodes[2*n+1]);
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void RecordSequence::Index::rebuild(size_t newCapacity) {
+	// Move all leaves to the front of the new capacity
+	std::vector<Leaf> oldLeaves;
+	oldLeaves.swap(leaves);
+	leaves.resize(newCapacity);
+	std::copy(oldLeaves.begin() + first, oldLeaves.begin() + first + count,
+	          leaves.begin());
+
+	capacity = newCapacity;
+	first = 0;
+	nodes.assign(2 * capacity, Node());
+
+	for ( size_t i = 0; i < count; ++i ) {
+		link(i);
+		update(i);
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
 
-		if ( imax <= imin ) continue;
 
-		// The first record contributing to the range?
-		if ( !foundRecords ) {
-			if ( getRange(range, *data, imin, imax) )
-				foundRecords = true;
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void RecordSequence::Index::assign(const RecordSequence &seq) {
+	tolerance = seq._tolerance;
+
+	size_t newCapacity = 16;
+	while ( newCapacity < 2 * seq.size() ) {
+		newCapacity <<= 1;
+	}
+
+	leaves.clear();
+	leaves.reserve(newCapacity);
+	for ( const auto &rec : seq ) {
+		leaves.push_back(summarize(rec.get()));
+	}
+
+	first = 0;
+	count = leaves.size();
+	rebuild(newCapacity);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void RecordSequence::Index::insert(size_t pos, const Record *rec) {
+	Leaf leaf = summarize(rec);
+
+	// Prepend into free space
+	if ( pos == 0 && first > 0 ) {
+		--first;
+		++count;
+		leaves[first] = leaf;
+		link(first);
+		update(first);
+		if ( count > 1 ) {
+			link(first+1);
+			update(first+1);
 		}
-		else
-			updateRange(range, *data, imin, imax);
+		return;
+	}
+
+	if ( first + count == capacity ) {
+		rebuild(2 * count > capacity ? 2 * capacity : capacity);
+	}
+
+	size_t at = first + pos;
+
+	// Append, the common case
+	if ( pos == count ) {
+		++count;
+		leaves[at] = leaf;
+		link(at);
+		update(at);
+		return;
+	}
+
+	// Insert in between
+	std::move_backward(leaves.begin() + at, leaves.begin() + first + count,
+	                   leaves.begin() + first + count + 1);
+	leaves[at] = leaf;
+	++count;
+
+	for ( size_t i = at; i < first + count; ++i ) {
+		link(i);
+		update(i);
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void RecordSequence::Index::removeFront() {
+	leaves[first] = Leaf();
+	update(first);
+	++first;
+	--count;
+
+	if ( count ) {
+		link(first);
+		update(first);
+	}
+	else {
+		first = 0;
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void RecordSequence::Index::amplitudeRange(size_t n, const Core::TimeWindow *tw,
+                                           Range &range, bool &foundRecords) const {
+	const Node &node = nodes[n];
+	if ( !node.count ) return;
+
+	bool inside = true;
+
+	if ( tw ) {
+		// The records do not overlap with the time window
+		if ( node.endTime < tw->startTime() || node.startTime > tw->endTime() ) {
+			return;
+		}
+
+		inside = node.startTime >= tw->startTime() && node.endTime <= tw->endTime();
+	}
+
+	// All records are completely covered by the time window, the cached
+	// ranges of all samples apply
+	if ( inside && !node.unsummarized ) {
+		if ( node.hasRange ) {
+			mergeRange(range, foundRecords, node.range);
+		}
+		return;
+	}
+
+	if ( n >= capacity ) {
+		recordRange(range, foundRecords, leaves[n - capacity].record, tw);
+		return;
+	}
+
+	amplitudeRange(2*n, tw, range, foundRecords);
+	amplitudeRange(2*n+1, tw, range, foundRecords);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void RecordSequence::Index::gapPositions(size_t n, std::vector<size_t> &positions) const {
+	if ( !nodes[n].gaps ) return;
+
+	if ( n >= capacity ) {
+		positions.push_back(n - capacity);
+		return;
+	}
+
+	gapPositions(2*n, positions);
+	gapPositions(2*n+1, positions);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Core::Time RecordSequence::Index::startTime(size_t from, size_t to) const {
+	// Bottom-up query of the minimum start time in [from, to)
+	Core::Time result = leaves[from].startTime;
+
+	for ( from += capacity, to += capacity; from < to; from >>= 1, to >>= 1 ) {
+		if ( from & 1 ) {
+			result = std::min(result, nodes[from++].startTime);
+		}
+		if ( to & 1 ) {
+			result = std::min(result, nodes[--to].startTime);
+		}
+	}
+
+	return result;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+const RecordSequence::Index *RecordSequence::index(bool timesRequired) const {
+	if ( !_index || !_index->matches(*this) ) {
+		return nullptr;
+	}
+
+	if ( timesRequired && _index->root().invalid ) {
+		return nullptr;
+	}
+
+	return _index.get();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void RecordSequence::insertRecord(iterator it, const Record *rec) {
+	size_t pos = it - begin();
+	bool valid = _index && _index->matches(*this) && _index->tolerance == _tolerance;
+
+	insert(it, rec);
+
+	if ( valid ) {
+		_index->insert(pos, rec);
+	}
+	else {
+		if ( !_index ) {
+			_index.reset(new Index);
+		}
+		_index->assign(*this);
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void RecordSequence::removeFront() {
+	bool valid = _index && _index->matches(*this);
+
+	pop_front();
+
+	if ( valid ) {
+		_index->removeFront();
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+RecordSequence::Range RecordSequence::amplitudeRange(const Core::TimeWindow *tw) const {
+	Range range(0.0,0.0);
+	bool foundRecords = false;
+
+	// The pruning of the index requires a valid time window
+	auto idx = index(tw != nullptr);
+	if ( idx && (!tw || tw->startTime() <= tw->endTime()) ) {
+		idx->amplitudeRange(1, tw, range, foundRecords);
+		return range;
+	}
+
+	for ( const_iterator it = begin(); it != end(); ++it) {
+		recordRange(range, foundRecords, it->get(), tw);
 	}
 
 	return range;
@@ -245,6 +763,24 @@ RecordSequence::TimeWindowArray RecordSequence::windows() const {
 	if ( recordCount() == 0 )
 		return win;
 
+	// The windows can be derived from the gaps if the records are sorted
+	// and not empty
+	auto idx = index(true);
+	if ( idx && idx->tolerance == _tolerance && !idx->root().irregular ) {
+		std::vector<size_t> positions;
+		idx->gapPositions(1, positions);
+		positions.push_back(idx->first + idx->count);
+
+		size_t from = idx->first;
+		for ( auto to : positions ) {
+			win.push_back(Core::TimeWindow(idx->startTime(from, to),
+			                               idx->leaves[to-1].endTime));
+			from = to;
+		}
+
+		return win;
+	}
+
 	Core::TimeWindow current;
 
 	for ( const_iterator it = begin(); it != end(); ++it ) {
@@ -279,6 +815,17 @@ RecordSequence::TimeWindowArray RecordSequence::gaps() const {
 
 	if ( empty() ) return gaps;
 
+	auto idx = index(true);
+	if ( idx && idx->tolerance == _tolerance ) {
+		std::vector<size_t> positions;
+		idx->gapPositions(1, positions);
+		for ( auto pos : positions ) {
+			gaps.push_back(Core::TimeWindow(idx->leaves[pos-1].endTime,
+			                                idx->leaves[pos].startTime));
+		}
+		return gaps;
+	}
+
 	Core::TimeWindow current;
 
 	for ( const_iterator it = begin(); it != end(); ++it ) {
@@ -319,18 +866,25 @@ double RecordSequence::availability(const Core::TimeWindow &tw) const {
 		missingData += lastRec->startTime() - tw.startTime();
 	}
 
-	for ( ; it != end(); ++it ) {
-		RecordCPtr rec = *it;
-		Core::TimeWindow tw = rec->timeWindow();
+	auto idx = index(true);
+	if ( idx && idx->tolerance == _tolerance ) {
+		missingData += idx->root().gapLength;
+		lastRec = back();
+	}
+	else {
+		for ( ; it != end(); ++it ) {
+			RecordCPtr rec = *it;
+			Core::TimeWindow tw = rec->timeWindow();
 
-		double fs = rec->samplingFrequency();
+			double fs = rec->samplingFrequency();
 
-		if ( !lastTw.contiguous(tw, _tolerance/fs) ) {
-			missingData += tw.startTime() - lastTw.endTime();
-		}
+			if ( !lastTw.contiguous(tw, _tolerance/fs) ) {
+				missingData += tw.startTime() - lastTw.endTime();
+			}
 
-		lastTw = tw;
-		lastRec = rec;
+			lastTw = tw;
+			lastRec = rec;
+		}
 	}
 
 	if ( lastRec->endTime() < tw.endTime() ) {
@@ -543,7 +1097,7 @@ bool TimeWindowBuffer::feed(const Record *rec) {
 		return false;
 	}
 
-	insert(it, rec);
+	insertRecord(it, rec);
 
 	return true;
 }
@@ -611,7 +1165,7 @@ bool RingBuffer::feed(const Record *rec) {
 		return false;
 	}
 
-	insert(it, rec);
+	insertRecord(it, rec);
 
 	if( ! recordCount()) {
 		return true;
@@ -619,13 +1173,13 @@ bool RingBuffer::feed(const Record *rec) {
 
 	if ( _nmax ) {
 		while( recordCount() > _nmax ) {
-			pop_front();
+			removeFront();
 		}
 	}
 	else if ( _span ) {
 		Core::Time tmin = back()->endTime() - _span;
 		while ( front()->endTime() <= tmin ) {
-			pop_front();
+			removeFront();
 		}
 	}
 
@@ -26,6 +26,7 @@
 #include <seiscomp/core/timewindow.h>
 
 #include <deque>
+#include <memory>
 
 
 namespace Seiscomp {
@@ -54,9 +55,14 @@ class SC_SYSTEM_CORE_API RecordSequence : public std::deque<RecordCPtr> {
 		//! C'tor
 		RecordSequence(double tolerance=0.5);
 
+		//! Copies the records, the summary index is rebuilt on demand
+		RecordSequence(const RecordSequence &other);
+
 		//! D'tor
 		virtual ~RecordSequence();
 
+		RecordSequence &operator=(const RecordSequence &other);
+
 
 	// ----------------------------------------------------------------------
 	//  Public interface
@@ -142,12 +148,44 @@ class SC_SYSTEM_CORE_API RecordSequence : public std::deque<RecordCPtr> {
 		bool alreadyHasRecord(const Record*) const;
 		bool findInsertPosition(const Record*, iterator*);
 
+		/**
+		 * @brief Inserts a record and updates the summary index. Derived
+		 *        classes should use this function and removeFront()
+		 *        rather than modifying the container directly.
+		 *
+		 * The summary index caches the amplitude range and the time window
+		 * of each record in a segment tree and answers amplitudeRange,
+		 * windows, gaps and availability in logarithmic time. If the
+		 * container has been modified otherwise, the index is detected to
+		 * be out of date and the records are scanned as before until the
+		 * next record is inserted.
+		 */
+		void insertRecord(iterator it, const Record *rec);
+
+		//! Removes the first record and updates the summary index
+		void removeFront();
+
+
+	// ----------------------------------------------------------------------
+	//  Private interface
+	// ----------------------------------------------------------------------
+	private:
+		struct Index;
+
+		//! Returns the index if it reflects the current content. With
+		//! timesRequired the index must not contain records with invalid
+		//! time windows.
+		const Index *index(bool timesRequired) const;
+
 
 	// ----------------------------------------------------------------------
 	//  Members
 	// ----------------------------------------------------------------------
 	protected:
 		double _tolerance;
+
+	private:
+		std::unique_ptr<Index> _index;
 };
 
 
@@ -0,0 +1,189 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#include <seiscomp/core/streamid.h>
+
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+
+namespace Seiscomp {
+namespace Core {
+
+
+namespace {
+
+
+size_t hashCodes(const std::string &net, const std::string &sta,
+                 const std::string &loc, const std::string &cha) {
+	std::hash<std::string> h;
+	size_t seed = h(net);
+	seed ^= h(sta) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+	seed ^= h(loc) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+	seed ^= h(cha) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+	return seed;
+}
+
+
+struct Table {
+	// Lookups compare the codes of the entries with equal hash and
+	// therefore do not need to allocate a key
+	using Index = std::unordered_multimap<size_t, const StreamIDTable::Entry*>;
+
+	const StreamIDTable::Entry *find(size_t hash,
+	                                 const std::string &net, const std::string &sta,
+	                                 const std::string &loc, const std::string &cha) const {
+		auto range = index.equal_range(hash);
+		for ( auto it = range.first; it != range.second; ++it ) {
+			if ( it->second->matches(net, sta, loc, cha) ) {
+				return it->second;
+			}
+		}
+
+		return nullptr;
+	}
+
+	mutable std::shared_mutex        mutex;
+	// A deque keeps references to its elements stable on push_back
+	std::deque<StreamIDTable::Entry> entries;
+	Index                            index;
+};
+
+
+Table &table() {
+	static Table instance;
+	return instance;
+}
+
+
+}
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+const StreamIDTable::Entry *StreamIDTable::Intern(const std::string &net,
+                                                  const std::string &sta,
+                                                  const std::string &loc,
+                                                  const std::string &cha) {
+	auto &t = table();
+	auto hash = hashCodes(net, sta, loc, cha);
+
+	{
+		std::shared_lock<std::shared_mutex> lock(t.mutex);
+		auto entry = t.find(hash, net, sta, loc, cha);
+		if ( entry ) {
+			return entry;
+		}
+	}
+
+	std::unique_lock<std::shared_mutex> lock(t.mutex);
+
+	// Another thread might have added the stream in the meantime
+	auto entry = t.find(hash, net, sta, loc, cha);
+	if ( entry ) {
+		return entry;
+	}
+
+	t.entries.push_back({
+		static_cast<Handle>(t.entries.size() + 1),
+		net, sta, loc, cha,
+		net + "." + sta + "." + loc + "." + cha
+	});
+
+	entry = &t.entries.back();
+	t.index.emplace(hash, entry);
+
+	return entry;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+const StreamIDTable::Entry *StreamIDTable::Find(const std::string &net,
+                                                const std::string &sta,
+                                                const std::string &loc,
+                                                const std::string &cha) {
+	auto &t = table();
+	auto hash = hashCodes(net, sta, loc, cha);
+	std::shared_lock<std::shared_mutex> lock(t.mutex);
+	return t.find(hash, net, sta, loc, cha);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+const StreamIDTable::Entry *StreamIDTable::Find(const std::string &streamID) {
+	std::string codes[4];
+	size_t start = 0;
+
+	for ( int i = 0; i < 3; ++i ) {
+		auto pos = streamID.find('.', start);
+		if ( pos == std::string::npos ) {
+			return nullptr;
+		}
+
+		codes[i] = streamID.substr(start, pos - start);
+		start = pos + 1;
+	}
+
+	codes[3] = streamID.substr(start);
+	if ( codes[3].find('.') != std::string::npos ) {
+		return nullptr;
+	}
+
+	return Find(codes[0], codes[1], codes[2], codes[3]);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+const StreamIDTable::Entry *StreamIDTable::Get(Handle handle) {
+	auto &t = table();
+	std::shared_lock<std::shared_mutex> lock(t.mutex);
+	if ( (handle == InvalidHandle) || (handle > t.entries.size()) ) {
+		return nullptr;
+	}
+
+	return &t.entries[handle - 1];
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+size_t StreamIDTable::Size() {
+	auto &t = table();
+	std::shared_lock<std::shared_mutex> lock(t.mutex);
+	return t.entries.size();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+}
+}
@@ -0,0 +1,116 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#ifndef SEISCOMP_CORE_STREAMID_H
+#define SEISCOMP_CORE_STREAMID_H
+
+
+#include <seiscomp/core.h>
+
+#include <cstdint>
+#include <string>
+
+
+namespace Seiscomp {
+namespace Core {
+
+
+/**
+ * @brief Process wide table of interned stream identifiers.
+ *
+ * Each distinct combination of network, station, location and channel code
+ * is assigned a compact integer handle on first use. Handles are never
+ * released and stay valid for the lifetime of the process, so they can be
+ * used as keys of hash maps instead of the concatenated stream id string.
+ * All methods are thread-safe.
+ */
+class SC_SYSTEM_CORE_API StreamIDTable {
+	// ----------------------------------------------------------------------
+	//  Public types
+	// ----------------------------------------------------------------------
+	public:
+		using Handle = uint32_t;
+
+		//! Handle which is never assigned to a stream
+		static constexpr Handle InvalidHandle = 0;
+
+		//! An immutable entry of the table
+		struct Entry {
+			Handle      handle;
+			std::string networkCode;
+			std::string stationCode;
+			std::string locationCode;
+			std::string channelCode;
+			//! The stream id in the form NET.STA.LOC.CHA
+			std::string streamID;
+
+			bool matches(const std::string &net, const std::string &sta,
+			             const std::string &loc, const std::string &cha) const {
+				return channelCode == cha && stationCode == sta
+				    && networkCode == net && locationCode == loc;
+			}
+		};
+
+
+	// ----------------------------------------------------------------------
+	//  Public interface
+	// ----------------------------------------------------------------------
+	public:
+		/**
+		 * @brief Returns the entry of a stream and adds it to the table if
+		 *        it does not exist yet.
+		 * @return The entry which is valid for the lifetime of the process
+		 */
+		static const Entry *Intern(const std::string &net, const std::string &sta,
+		                           const std::string &loc, const std::string &cha);
+
+		/**
+		 * @brief Returns the entry of a stream without adding it.
+		 * @return The entry or nullptr if the stream has not been interned
+		 */
+		static const Entry *Find(const std::string &net, const std::string &sta,
+		                         const std::string &loc, const std::string &cha);
+
+		/**
+		 * @brief Returns the entry of a stream id without adding it.
+		 * @param streamID The stream id in the form NET.STA.LOC.CHA
+		 * @return The entry or nullptr if the stream has not been interned
+		 */
+		static const Entry *Find(const std::string &streamID);
+
+		/**
+		 * @brief Returns the entry of a handle.
+		 * @return The entry or nullptr if the handle is invalid
+		 */
+		static const Entry *Get(Handle handle);
+
+		//! Returns the number of interned streams
+		static size_t Size();
+};
+
+
+using StreamHandle = StreamIDTable::Handle;
+
+
+}
+}
+
+
+#endif
@@ -54,6 +54,45 @@ namespace Core {
    - Added Seiscomp::Gui::Ruler::setSelectionHandleTitle
    - Removed Seiscomp::Gui::StationMagnitudeModel
    - Change Seiscomp::IO::VBinaryArchive::VBinaryArchive prototype
+   - Changed Seiscomp::DataModel::PublicObject::Iterator
+   - Changed Seiscomp::DataModel::PublicObject::PublicObjectMap
+   - Added Seiscomp::DataModel::PublicObject::Find(std::string_view)
+   - Added Seiscomp::IO::CompactBinaryArchive
+   - Added Seiscomp::Client::Protocol::CompactBinary content type
+   - Added Seiscomp::Core::GreensFunction::clone
+   - Added Seiscomp::IO::GFArchive::setDistanceInterpolation
+   - Added Seiscomp::IO::GFCache
+   - Added Seiscomp::Util::LRUCache
+   - Added Seiscomp::IO::TravelTimeGrid
+   - Added Seiscomp::Util::WildcardSet
+   - Added Seiscomp::Record::hint
+   - Added Seiscomp::RecordSequence::insertRecord
+   - Added Seiscomp::RecordSequence::removeFront
+   - Added Seiscomp::IO::SignatureValidator
+   - Added Seiscomp::IO::MSeedRecord::SetDeferredAuthentication
+   - Added Seiscomp::IO::MSeedRecord::ValidateAuthentication
+   - Added Seiscomp::IO::MSeedRecord::hasPendingAuthentication
+   - Added Seiscomp::Util::CertificateStore::validate(Signature*, size_t)
+   - Added Seiscomp::Util::CertificateStore::validatedCount
+   - Added Seiscomp::Util::CertificateStore::failedCount
+   - Added Seiscomp::Client::Protocol::setSubscriptionFilter
+   - Added Seiscomp::Client::Protocol::subscriptionFilter
+   - Added Seiscomp::Client::Connection::setSubscriptionFilter
+   - Added Seiscomp::ContinuousTrace
+   - Added Seiscomp::Util::LatencyHistogram
+   - Added Seiscomp::Util::LatencyMonitor
+   - Added Seiscomp::Client::Notification::timestamp
+   - Added Seiscomp::IO::MSeedEncoder::encode
+   - Added Seiscomp::IO::MSeedEncoder::flush(std::vector<RecordPtr>&)
+   - Added virtual Seiscomp::Processing::Response::fingerprint
+   - Added Seiscomp::Processing::ResponsePAZ::fingerprint
+   - Added Seiscomp::Processing::ResponseFAP::fingerprint
+   - Added Seiscomp::Processing::ResponseSpectrumCache
+   - Added Seiscomp::Math::Restitution::deconvolutionSpectrum
+   - Added Seiscomp::Math::Restitution::transformFFT(int, T*, double, const std::vector<Complex>&, double)
+   - Added Seiscomp::Gui::RecordFilterJob
+   - Added Seiscomp::Client::Inventory::writeSnapshot
+   - Added Seiscomp::Util::MappedFile
 
  "17.4.0"   0x110400
    - Added Seiscomp::DataModel::PublicObjectRegistrationGuard<T>
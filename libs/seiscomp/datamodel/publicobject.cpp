@@ -24,12 +24,35 @@
 #include <seiscomp/core/strings.h>
 #include <seiscomp/logging/log.h>
 #include <seiscomp/datamodel/publicobject.h>
+#include <functional>
 #include <mutex>
 
 
 namespace {
 
-std::mutex cacheMutex;
+
+using Seiscomp::DataModel::PublicObject;
+
+
+// The registration map is split into shards with their own locks. Objects
+// are assigned to shards by the hash of their publicID.
+constexpr size_t RegistryShards = 64;
+
+
+struct alignas(64) Shard {
+	std::mutex                    mutex;
+	PublicObject::PublicObjectMap objects;
+};
+
+
+Shard registry[RegistryShards];
+std::atomic<size_t> registeredObjects{0};
+
+
+inline Shard &shardOf(std::string_view publicID) {
+	return registry[std::hash<std::string_view>()(publicID) % RegistryShards];
+}
+
 
 }
 
@@ -52,7 +75,7 @@ bool PublicIDPatternResolver::resolve(std::string &variable) const {
 		variable = _po->className();
 	}
 	else if ( variable == "id" ) {
-		variable = Core::toString(PublicObject::_publicObjectId);
+		variable = Core::toString(PublicObject::_publicObjectId.load());
 	}
 	else if ( variable == "globalid" ) {
 		variable = Core::toString(Core::BaseObject::ObjectCount());
@@ -83,16 +106,82 @@ IMPLEMENT_SC_ABSTRACT_CLASS_DERIVED(PublicObject,
                                     Object,
                                     "PublicObject");
 
-PublicObject::PublicObjectMap PublicObject::_publicObjects;
 bool PublicObject::_generateIds = false;
 std::string PublicObject::_idPattern = "@classname@/@time/%Y%m%d%H%M%S.%f@.@id@";
-unsigned long PublicObject::_publicObjectId = 0;
+std::atomic<unsigned long> PublicObject::_publicObjectId{0};
 boost::thread_specific_ptr<bool> PublicObject::_registerObjects;
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+PublicObject::Iterator::Iterator(size_t shard, PublicObjectMap::const_iterator it)
+: _shard(shard), _it(it) {
+	skipEmptyShards();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void PublicObject::Iterator::skipEmptyShards() {
+	while ( (_shard < RegistryShards) && (_it == registry[_shard].objects.end()) ) {
+		if ( ++_shard < RegistryShards ) {
+			_it = registry[_shard].objects.begin();
+		}
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+PublicObject::Iterator &PublicObject::Iterator::operator++() {
+	++_it;
+	skipEmptyShards();
+	return *this;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+PublicObject::Iterator PublicObject::Iterator::operator++(int) {
+	Iterator tmp(*this);
+	++*this;
+	return tmp;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool PublicObject::Iterator::operator==(const Iterator &other) const {
+	if ( _shard != other._shard ) {
+		return false;
+	}
+
+	return (_shard >= RegistryShards) || (_it == other._it);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool PublicObject::Iterator::operator!=(const Iterator &other) const {
+	return !(*this == other);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 PublicObject::PublicObject()
  : _registered(false) {
@@ -164,12 +253,14 @@ bool PublicObject::registerMe() {
 		return false;
 	}
 
-	std::lock_guard<std::mutex> lk(cacheMutex);
+	auto &shard = shardOf(_publicID);
+	std::lock_guard<std::mutex> lk(shard.mutex);
 
-	auto it = _publicObjects.find(_publicID);
-	if ( it == _publicObjects.end() ) {
-		_publicObjects[_publicID] = this;
+	// The key refers to the publicID of this instance which is not
+	// changed without deregistering first
+	if ( shard.objects.emplace(_publicID, this).second ) {
 		_registered = true;
+		++registeredObjects;
 		return true;
 	}
 
@@ -189,12 +280,14 @@ bool PublicObject::deregisterMe() {
 		return false;
 	}
 
-	std::lock_guard<std::mutex> lk(cacheMutex);
+	auto &shard = shardOf(_publicID);
+	std::lock_guard<std::mutex> lk(shard.mutex);
 
-	auto it = _publicObjects.find(_publicID);
-	if ( it != _publicObjects.end() ) {
-		_publicObjects.erase(it);
+	auto it = shard.objects.find(_publicID);
+	if ( it != shard.objects.end() ) {
+		shard.objects.erase(it);
 		_registered = false;
+		--registeredObjects;
 		return true;
 	}
 
@@ -245,10 +338,20 @@ bool PublicObject::validId() const {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 PublicObject *PublicObject::Find(const std::string &publicID) {
-	std::lock_guard<std::mutex> lk(cacheMutex);
+	return Find(std::string_view(publicID));
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+PublicObject *PublicObject::Find(std::string_view publicID) {
+	auto &shard = shardOf(publicID);
+	std::lock_guard<std::mutex> lk(shard.mutex);
 
-	auto it = _publicObjects.find(publicID);
-	if ( it == _publicObjects.end() ) {
+	auto it = shard.objects.find(publicID);
+	if ( it == shard.objects.end() ) {
 		return nullptr;
 	}
 
@@ -259,9 +362,18 @@ PublicObject *PublicObject::Find(const std::string &publicID) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+PublicObject *PublicObject::Find(const char *publicID) {
+	return Find(std::string_view(publicID));
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 size_t PublicObject::ObjectCount() {
-	return _publicObjects.size();
+	return registeredObjects;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -270,7 +382,7 @@ size_t PublicObject::ObjectCount() {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 PublicObject::Iterator PublicObject::Begin() {
-	return _publicObjects.begin();
+	return Iterator(0, registry[0].objects.begin());
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -279,7 +391,7 @@ PublicObject::Iterator PublicObject::Begin() {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 PublicObject::Iterator PublicObject::End() {
-	return _publicObjects.end();
+	return Iterator(RegistryShards, PublicObjectMap::const_iterator());
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -288,7 +400,10 @@ PublicObject::Iterator PublicObject::End() {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void PublicObject::Lock() {
-	cacheMutex.lock();
+	// Always lock in the same order to prevent deadlocks
+	for ( auto &shard : registry ) {
+		shard.mutex.lock();
+	}
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -297,7 +412,9 @@ void PublicObject::Lock() {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void PublicObject::Unlock() {
-	cacheMutex.unlock();
+	for ( size_t i = RegistryShards; i > 0; --i ) {
+		registry[i-1].mutex.unlock();
+	}
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
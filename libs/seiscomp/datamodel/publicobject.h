@@ -26,8 +26,11 @@
 #include <seiscomp/datamodel/object.h>
 #include <seiscomp/utils/replace.h>
 #include <boost/thread/tss.hpp>
+#include <atomic>
+#include <iterator>
 #include <string>
-#include <map>
+#include <string_view>
+#include <unordered_map>
 
 
 namespace Seiscomp {
@@ -45,8 +48,48 @@ class SC_SYSTEM_CORE_API PublicObject : public Object {
 	//  Public types
 	// ------------------------------------------------------------------
 	public:
-		typedef std::map<std::string, PublicObject*> PublicObjectMap;
-		typedef PublicObjectMap::const_iterator Iterator;
+		/**
+		 * The registration map of a single shard. The keys refer to the
+		 * publicID of the registered object and remain valid as long as
+		 * the object is registered.
+		 */
+		typedef std::unordered_map<std::string_view, PublicObject*> PublicObjectMap;
+
+		/**
+		 * Iterates over all shards of the registration map. The order of
+		 * the objects is unspecified.
+		 */
+		class SC_SYSTEM_CORE_API Iterator {
+			public:
+				using iterator_category = std::forward_iterator_tag;
+				using value_type = PublicObjectMap::value_type;
+				using difference_type = std::ptrdiff_t;
+				using pointer = const value_type*;
+				using reference = const value_type&;
+
+			public:
+				Iterator() = default;
+
+			public:
+				reference operator*() const { return *_it; }
+				pointer operator->() const { return &*_it; }
+
+				Iterator &operator++();
+				Iterator operator++(int);
+
+				bool operator==(const Iterator &other) const;
+				bool operator!=(const Iterator &other) const;
+
+			private:
+				Iterator(size_t shard, PublicObjectMap::const_iterator it);
+				void skipEmptyShards();
+
+			private:
+				size_t                          _shard{0};
+				PublicObjectMap::const_iterator _it;
+
+			friend class PublicObject;
+		};
 
 
 	// ------------------------------------------------------------------
@@ -134,6 +177,13 @@ class SC_SYSTEM_CORE_API PublicObject : public Object {
 		 */
 		static PublicObject* Find(const std::string& publicID);
 
+		/**
+		 * Same as Find(const std::string&) but does not require the
+		 * publicID to be held in a std::string.
+		 */
+		static PublicObject* Find(std::string_view publicID);
+		static PublicObject* Find(const char *publicID);
+
 		/**
 		 * Returns the size of the static PublicObject registration map
 		 */
@@ -153,7 +203,9 @@ class SC_SYSTEM_CORE_API PublicObject : public Object {
 
 		/**
 		 * Locks registration of PublicObjects and allows syncrhonized access
-		 * to Begin() and End() iterators.
+		 * to Begin() and End() iterators. The registration map is split
+		 * into several shards with their own locks to allow concurrent
+		 * registration and lookups. This method locks all of them.
 		 */
 		static void Lock();
 
@@ -242,11 +294,9 @@ class SC_SYSTEM_CORE_API PublicObject : public Object {
 		std::string _publicID;
 		bool _registered;
 
-		static PublicObjectMap _publicObjects;
-
 		static bool _generateIds;
 		static std::string _idPattern;
-		static unsigned long _publicObjectId;
+		static std::atomic<unsigned long> _publicObjectId;
 
 		//static bool _registerObjects;
 		static boost::thread_specific_ptr<bool> _registerObjects;
@@ -1483,6 +1483,9 @@ void Application::createConnection(QString host, QString user,
 		else if ( Client::Application::_settings.messaging.contentType == "xml" ) {
 			_connection->setContentType(Client::Protocol::XML);
 		}
+		else if ( Client::Application::_settings.messaging.contentType == "compact" ) {
+			_connection->setContentType(Client::Protocol::CompactBinary);
+		}
 		else if ( !Client::Application::_settings.messaging.contentType.empty() ) {
 			SEISCOMP_ERROR("Invalid message content type: %s",
 			               Client::Application::_settings.messaging.contentType.c_str());
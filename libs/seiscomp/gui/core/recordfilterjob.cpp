@@ -0,0 +1,168 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#define SEISCOMP_COMPONENT Gui::RecordFilterJob
+
+#include <seiscomp/core/genericrecord.h>
+#include <seiscomp/core/typedarray.h>
+#include <seiscomp/logging/log.h>
+#include <seiscomp/gui/core/recordfilterjob.h>
+
+#include <cmath>
+
+
+namespace Seiscomp {
+namespace Gui {
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+RecordFilterJob::~RecordFilterJob() {
+	delete filter;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void RecordFilterJob::run() {
+	GenericRecordPtr segment;
+	DoubleArrayPtr samples;
+	Core::Time lastEndTime;
+	double lastFs = 0;
+	bool first = true;
+	bool reset = false;
+
+	auto flush = [&]() {
+		if ( segment ) {
+			if ( samples->size() > 0 ) {
+				segment->setData(samples.get());
+				results.push_back(segment);
+			}
+			segment = nullptr;
+			samples = nullptr;
+		}
+	};
+
+	for ( const auto &rec : records ) {
+		if ( cancelled ) {
+			return;
+		}
+
+		const Array *data = rec->data();
+		if ( !data ) {
+			continue;
+		}
+
+		double fs = rec->samplingFrequency();
+		bool gap = reset;
+
+		try {
+			rec->endTime();
+		}
+		catch ( ... ) {
+			SEISCOMP_ERROR("Filtered record has invalid endtime -> skipping");
+			continue;
+		}
+
+		if ( !first && !gap ) {
+			double diff;
+
+			try {
+				diff = fabs(static_cast<double>(rec->startTime() - lastEndTime));
+			}
+			catch ( ... ) {
+				diff = tolerance * 2 / fs;
+			}
+
+			gap = (fs != lastFs) || (diff > tolerance / fs);
+		}
+
+		if ( gap ) {
+			Filter *tmp = filter;
+			filter = filter->clone();
+			delete tmp;
+
+			try {
+				filter->setSamplingFrequency(fs);
+				filter->setStartTime(rec->startTime());
+				filter->setStreamID(rec->networkCode(), rec->stationCode(),
+				                    rec->locationCode(), rec->channelCode());
+			}
+			catch ( std::exception &e ) {
+				error = e.what();
+				SEISCOMP_ERROR("%s: filter: %s", rec->streamID().c_str(), e.what());
+				flush();
+				reset = true;
+				continue;
+			}
+		}
+
+		first = false;
+		reset = false;
+
+		int n = data->size();
+
+		if ( gap || !segment || (samples->size() + n > MaxSamples) ) {
+			flush();
+			segment = new GenericRecord(*rec);
+			samples = new DoubleArray;
+		}
+
+		int offset = samples->size();
+
+		if ( data->dataType() == Array::DOUBLE ) {
+			samples->append(n, static_cast<const DoubleArray*>(data)->typedData());
+		}
+		else {
+			DoubleArrayPtr tmp = static_cast<DoubleArray*>(data->copy(Array::DOUBLE));
+			samples->append(n, tmp->typedData());
+		}
+
+		try {
+			filter->apply(n, samples->typedData() + offset);
+		}
+		catch ( std::exception &e ) {
+			// Drop the record, keep what has been filtered so far and
+			// restart the filter with the next record
+			error = e.what();
+			SEISCOMP_ERROR("%s: filter: %s", rec->streamID().c_str(), e.what());
+			samples->resize(offset);
+			flush();
+			reset = true;
+			continue;
+		}
+
+		lastEndTime = rec->endTime();
+		lastFs = fs;
+	}
+
+	flush();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+}
+}
@@ -0,0 +1,102 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#ifndef SEISCOMP_GUI_CORE_RECORDFILTERJOB_H
+#define SEISCOMP_GUI_CORE_RECORDFILTERJOB_H
+
+
+#ifndef Q_MOC_RUN
+#include <seiscomp/core/record.h>
+#include <seiscomp/math/filter.h>
+#endif
+#include <seiscomp/gui/qt.h>
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+
+namespace Seiscomp {
+namespace Gui {
+
+
+/**
+ * @brief Filters a snapshot of records into gap-free segments.
+ *
+ * The job does not depend on a widget and can run in any thread. It owns
+ * its filter instance which is cloned, i.e. reset, at each gap. Contiguous
+ * filtered samples are collected into records of at most MaxSamples
+ * samples. Filter errors are reported in error and restart the filter
+ * with the next record.
+ */
+class SC_GUI_API RecordFilterJob {
+	// ----------------------------------------------------------------------
+	//  Public types
+	// ----------------------------------------------------------------------
+	public:
+		using Filter = Math::Filtering::InPlaceFilter<double>;
+
+		//! The maximum number of samples of a filtered record. That keeps
+		//! the number of records low but still allows ring buffers to
+		//! release old data.
+		static constexpr int MaxSamples = 65536;
+
+
+	// ----------------------------------------------------------------------
+	//  X'truction
+	// ----------------------------------------------------------------------
+	public:
+		RecordFilterJob() = default;
+		RecordFilterJob(const RecordFilterJob &) = delete;
+		RecordFilterJob &operator=(const RecordFilterJob &) = delete;
+		virtual ~RecordFilterJob();
+
+
+	// ----------------------------------------------------------------------
+	//  Public interface
+	// ----------------------------------------------------------------------
+	public:
+		//! Filters all records into results. Returns early if the job has
+		//! been cancelled.
+		void run();
+
+
+	// ----------------------------------------------------------------------
+	//  Public members
+	// ----------------------------------------------------------------------
+	public:
+		std::vector<RecordCPtr>  records;
+		//! The filter, owned by the job
+		Filter                  *filter{nullptr};
+		double                   tolerance{0.5};
+		std::atomic<bool>        cancelled{false};
+
+		std::vector<RecordPtr>   results;
+		//! The last filter error, if any
+		std::string              error;
+};
+
+
+}
+}
+
+
+#endif
@@ -1494,6 +1494,8 @@ bool RecordView::addItem(RecordViewItem* item) {
 	item->setParent(_scrollArea->widget());
 	item->setSelected(false);
 
+	// Filter changes must not block the user interface for many traces
+	item->widget()->setBackgroundFilteringEnabled(true);
 	item->widget()->setFilter(_filter);
 	item->widget()->setGridSpacing(_timeScaleWidget->dA(), _timeScaleWidget->dT(), _timeScaleWidget->dOfs());
 	item->widget()->setAlignment(_alignment);
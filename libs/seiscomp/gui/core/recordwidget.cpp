@@ -19,6 +19,8 @@
 
 
 #include <QPainter>
+#include <QRunnable>
+#include <QThreadPool>
 #include <QToolTip>
 
 #define SEISCOMP_COMPONENT Gui::RecordWidget
@@ -29,8 +31,12 @@
 #include <seiscomp/math/filter/butterworth.h>
 #include <seiscomp/gui/core/application.h>
 #include <seiscomp/gui/core/compat.h>
+#include <seiscomp/gui/core/recordfilterjob.h>
 #include <seiscomp/gui/core/utils.h>
 
+#include <atomic>
+#include <mutex>
+
 using namespace std;
 using namespace Seiscomp;
 
@@ -454,6 +460,31 @@ bool isNegative(const T *v) {
 }
 
 
+// Shared by all widgets so that the number of concurrent filter jobs is
+// bound by the number of cores and not by the number of traces.
+QThreadPool &filterPool() {
+	static QThreadPool pool;
+	return pool;
+}
+
+
+template <typename Job>
+class JobRunner : public QRunnable {
+	public:
+		JobRunner(std::shared_ptr<Job> job) : _job(std::move(job)) {}
+
+		void run() override {
+			if ( !_job->cancelled ) {
+				_job->run();
+			}
+			_job->finish();
+		}
+
+	private:
+		std::shared_ptr<Job> _job;
+};
+
+
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -900,6 +931,49 @@ RecordWidgetDecorator::RecordWidgetDecorator(QObject *parent)
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+// A filter job works on a snapshot of the raw records and its own filter
+// instance. The results are only accessed by the widget after the job has
+// finished. The receiver must only be accessed with the mutex locked.
+struct RecordWidget::FilterJob : RecordFilterJob {
+	void finish();
+	void cancel();
+
+	std::atomic<bool>        finished{false};
+
+	std::mutex               mutex;
+	QObject                 *receiver{nullptr};
+};
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void RecordWidget::FilterJob::finish() {
+	std::lock_guard<std::mutex> lock(mutex);
+	finished = true;
+	if ( receiver ) {
+		QMetaObject::invokeMethod(receiver, "collectFilterResults",
+		                          Qt::QueuedConnection);
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void RecordWidget::FilterJob::cancel() {
+	std::lock_guard<std::mutex> lock(mutex);
+	cancelled = true;
+	receiver = nullptr;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 static int StreamCount = 0;
 static int RecordWidgetCount = 0;
@@ -959,6 +1033,8 @@ void RecordWidget::Stream::setDirty(bool includingData) {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void RecordWidget::Stream::free() {
+	cancelFilterJob();
+
 	if ( records[0] && ownRawRecords ) {
 		delete records[0];
 	}
@@ -986,6 +1062,20 @@ void RecordWidget::Stream::free() {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void RecordWidget::Stream::cancelFilterJob() {
+	if ( filterJob ) {
+		filterJob->cancel();
+		filterJob = nullptr;
+	}
+
+	pendingRecords.clear();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 RecordWidget::RecordWidget(QWidget *parent)
 : QWidget(parent) {
@@ -1241,6 +1331,8 @@ bool RecordWidget::setFilteredRecords(int slot, RecordSequence *s, bool owner) {
 		return false;
 	}
 
+	stream->cancelFilterJob();
+
 	if ( stream->ownFilteredRecords && stream->records[Stream::Filtered] ) {
 		delete stream->records[Stream::Filtered];
 	}
@@ -1283,6 +1375,8 @@ bool RecordWidget::setRecordFilter(int slot, const Filter *filter) {
 		return true;
 	}
 
+	stream->cancelFilterJob();
+
 	if ( stream->filter ) {
 		delete stream->filter;
 	}
@@ -2978,6 +3072,24 @@ bool RecordWidget::isGlobalOffsetEnabled() const {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void RecordWidget::setBackgroundFilteringEnabled(bool enable) {
+	_backgroundFiltering = enable;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool RecordWidget::isBackgroundFilteringEnabled() const {
+	return _backgroundFiltering;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 bool RecordWidget::event(QEvent *event) {
 	/*
@@ -4555,6 +4667,11 @@ bool RecordWidget::createFilter(int slot) {
 		return true;
 	}
 
+	// Still filtering in the background
+	if ( s->filterJob ) {
+		return false;
+	}
+
 	s->traces[Stream::Filtered].status = QString();
 
 	if (s->records[Stream::Raw] && !s->records[Stream::Raw]->empty()) {
@@ -4608,26 +4725,120 @@ void RecordWidget::setFilter(Filter *filter) {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void RecordWidget::filterRecords(Stream *s) {
+	s->cancelFilterJob();
+
 	s->records[Stream::Filtered] = s->records[Stream::Raw]->clone();
 	s->traces[Stream::Filtered].dirtyData = true;
 
-	RecordPtr lastRec;
-	for ( RecordSequence::const_iterator it = s->records[Stream::Raw]->begin();
-	      it != s->records[Stream::Raw]->end(); ++it) {
-		try {
-			RecordPtr rec = filteredRecord(s->filter, (*it).get(), lastRec.get(),
-			                               s->records[Stream::Filtered]->tolerance());
-			if ( rec ) {
-				s->records[Stream::Filtered]->feed(rec.get());
-				s->traces[Stream::Filtered].dirty = true;
-				lastRec = rec;
-			}
+	auto job = std::make_shared<FilterJob>();
+	job->records.assign(s->records[Stream::Raw]->begin(),
+	                    s->records[Stream::Raw]->end());
+	job->tolerance = s->records[Stream::Filtered]->tolerance();
+	// The job continues with the configured filter, the stream holds a
+	// fresh copy until the results have been taken over.
+	job->filter = s->filter;
+	s->filter = s->filter->clone();
+
+	if ( !_backgroundFiltering ) {
+		job->run();
+		takeFilterResults(s, *job);
+		return;
+	}
+
+	// Records may decode their data on first access which must not
+	// happen concurrently with the paint event.
+	for ( const auto &rec : job->records ) {
+		rec->data();
+	}
+
+	job->receiver = this;
+	s->filterJob = job;
+	filterPool().start(new JobRunner<FilterJob>(job));
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void RecordWidget::takeFilterResults(Stream *s, FilterJob &job) {
+	delete s->filter;
+	s->filter = job.filter;
+	job.filter = nullptr;
+
+	for ( const auto &rec : job.results ) {
+		s->records[Stream::Filtered]->feed(rec.get());
+	}
+
+	if ( !job.error.empty() ) {
+		s->traces[Stream::Filtered].status = QString::fromStdString(job.error);
+	}
+
+	s->traces[Stream::Filtered].dirty = true;
+	s->traces[Stream::Filtered].dirtyData = true;
+
+	// Continue with the records fed while the job was running
+	std::vector<RecordCPtr> pending;
+	pending.swap(s->pendingRecords);
+	for ( const auto &rec : pending ) {
+		feedFilteredRecord(s, rec.get());
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void RecordWidget::collectFilterResults() {
+	bool changed = false;
+
+	for ( Stream *s : as_const(_streams) ) {
+		if ( !s || !s->filterJob || !s->filterJob->finished ) {
+			continue;
 		}
-		catch ( std::exception &e ) {
-			s->traces[Stream::Filtered].status = e.what();
-			SEISCOMP_ERROR("%s: filter: %s", (*it).get()->streamID().c_str(), e.what());
+
+		auto job = s->filterJob;
+		s->filterJob = nullptr;
+		takeFilterResults(s, *job);
+		changed = true;
+	}
+
+	if ( !changed ) {
+		return;
+	}
+
+	_drawRecords = true;
+
+	if ( _shadowWidget && (_shadowWidget->_shadowWidgetFlags & Filtered) ) {
+		_shadowWidget->setDirty();
+		_shadowWidget->update();
+	}
+
+	update();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void RecordWidget::feedFilteredRecord(Stream *s, const Record *rec) {
+	try {
+		RecordPtr frec = filteredRecord(s->filter, rec,
+		                                s->records[Stream::Filtered]->empty() ?
+		                                nullptr : s->records[Stream::Filtered]->back().get(),
+		                                s->records[Stream::Filtered]->tolerance());
+		if ( frec ) {
+			s->records[Stream::Filtered]->feed(frec.get());
+			s->traces[Stream::Filtered].dirty = true;
+			s->traces[Stream::Filtered].dirtyData = true;
 		}
 	}
+	catch ( std::exception &e ) {
+		s->traces[Stream::Filtered].status = e.what();
+		SEISCOMP_ERROR("%s: filter: %s", rec->streamID().c_str(), e.what());
+	}
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -4850,23 +5061,17 @@ void RecordWidget::fed(int slot, const Seiscomp::Record *rec) {
 		return;
 	}
 
-	if ( !newlyCreated ) {
-		try {
-			RecordPtr frec = filteredRecord(s->filter, rec,
-			                                s->records[Stream::Filtered]->empty() ?
-			                                nullptr : s->records[Stream::Filtered]->back().get(),
-			                                s->records[Stream::Filtered]->tolerance());
-			if ( frec ) {
-				s->records[Stream::Filtered]->feed(frec.get());
-				s->traces[Stream::Filtered].dirty = true;
-				s->traces[Stream::Filtered].dirtyData = true;
-			}
-		}
-		catch ( std::exception &e ) {
-			s->traces[Stream::Filtered].status = e.what();
-			SEISCOMP_ERROR("%s: filter: %s", rec->streamID().c_str(), e.what());
-		}
+	if ( newlyCreated ) {
+		return;
 	}
+
+	if ( s->filterJob ) {
+		// Filtered as soon as the background job has finished
+		s->pendingRecords.push_back(rec);
+		return;
+	}
+
+	feedFilteredRecord(s, rec);
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -30,6 +30,9 @@
 #include <QScrollBar>
 #include <QHBoxLayout>
 
+#include <memory>
+#include <vector>
+
 #ifndef Q_MOC_RUN
 #include <seiscomp/core/record.h>
 #include <seiscomp/datamodel/waveformstreamid.h>
@@ -526,6 +529,13 @@ class SC_GUI_API RecordWidget : public QWidget {
 		bool isFilteringEnabled() const;
 		bool isGlobalOffsetEnabled() const;
 
+		//! Filters the records of all slots in a thread pool instead of
+		//! the calling thread. Each slot is redrawn as soon as its
+		//! filtered trace is available. Records fed in the meantime are
+		//! filtered afterwards. The default is false.
+		void setBackgroundFilteringEnabled(bool enable);
+		bool isBackgroundFilteringEnabled() const;
+
 		//! Maps a time to a position relative to the widget
 		int mapTime(const Core::Time&) const;
 
@@ -604,6 +614,7 @@ class SC_GUI_API RecordWidget : public QWidget {
 
 	private slots:
 		void scroll(int);
+		void collectFilterResults();
 
 
 	signals:
@@ -684,6 +695,8 @@ class SC_GUI_API RecordWidget : public QWidget {
 
 
 	protected:
+		struct FilterJob;
+
 		struct Stream {
 			enum Index {
 				Raw = 0,
@@ -695,6 +708,7 @@ class SC_GUI_API RecordWidget : public QWidget {
 
 			void setDirty(bool includingData = false);
 			void free();
+			void cancelFilterJob();
 
 			RecordSequence *records[2];
 			Trace           traces[2];
@@ -726,6 +740,11 @@ class SC_GUI_API RecordWidget : public QWidget {
 			QVariant        userData;
 
 			Filter         *filter;
+
+			// The running background filter and the records fed since it
+			// has been started
+			std::shared_ptr<FilterJob> filterJob;
+			std::vector<RecordCPtr>    pendingRecords;
 		};
 
 
@@ -740,6 +759,8 @@ class SC_GUI_API RecordWidget : public QWidget {
 		Record* filteredRecord(Filter *&filter,
 		                       const Record*, const Record*,
 		                       double tolerance) const;
+		void feedFilteredRecord(Stream *s, const Record *rec);
+		void takeFilterResults(Stream *s, FilterJob &job);
 
 		void drawTrace(QPainter &painter,
 		               const Trace *trace,
@@ -791,6 +812,7 @@ class SC_GUI_API RecordWidget : public QWidget {
 
 		bool                 _active{false};
 		bool                 _filtering{false};
+		bool                 _backgroundFiltering{false};
 		bool                 _showScaledValues{false};
 		bool                 _showEngineeringValues{true};
 
@@ -0,0 +1,175 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#ifndef SEISCOMP_GUI_CORE_SPECTROGRAMCOLUMNCACHE_H
+#define SEISCOMP_GUI_CORE_SPECTROGRAMCOLUMNCACHE_H
+
+
+#include <seiscomp/core/datetime.h>
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <vector>
+
+
+namespace Seiscomp {
+namespace Gui {
+
+
+/**
+ * @brief Caches the columns of a spectrogram by their aligned start time.
+ *
+ * With aligned windows the spectralizer computes each column from the
+ * samples of [t, t+windowLength] where t is a multiple of the time step.
+ * A column therefore does not depend on the records that delivered the
+ * samples and can be reused when the records are set again, e.g. while
+ * scrolling. The cache must only hold columns of one stream computed
+ * with the same options.
+ *
+ * The number of columns is bound. If the bound is exceeded then the
+ * columns farthest away from the last inserted column are removed.
+ */
+template <typename T>
+class SpectrogramColumnCache {
+	// ----------------------------------------------------------------------
+	//  X'truction
+	// ----------------------------------------------------------------------
+	public:
+		SpectrogramColumnCache(double windowLength, double timeStep,
+		                       size_t maxColumns)
+		: _windowLength(windowLength), _timeStep(timeStep)
+		, _maxColumns(maxColumns) {}
+
+
+	// ----------------------------------------------------------------------
+	//  Public interface
+	// ----------------------------------------------------------------------
+	public:
+		//! Returns the index of the column which starts at the given time
+		int64_t index(const Core::Time &time) const {
+			return static_cast<int64_t>(std::llround(time.epoch() / _timeStep));
+		}
+
+		//! Returns the start time of the column with the given index
+		Core::Time startTime(int64_t index) const {
+			return Core::Time(index * _timeStep);
+		}
+
+		//! Adds a column unless a column with the same start time is
+		//! cached already
+		void insert(const Core::Time &time, const T &column) {
+			int64_t idx = index(time);
+			_columns.emplace(idx, column);
+
+			while ( _columns.size() > _maxColumns ) {
+				if ( idx - _columns.begin()->first > _columns.rbegin()->first - idx ) {
+					_columns.erase(_columns.begin());
+				}
+				else {
+					_columns.erase(std::prev(_columns.end()));
+				}
+			}
+		}
+
+		//! Returns whether the column which starts at the given time is
+		//! cached
+		bool contains(const Core::Time &time) const {
+			return _columns.find(index(time)) != _columns.end();
+		}
+
+		/**
+		 * @brief Returns all cached columns whose window intersects the
+		 *        time window [from, to) ordered by time.
+		 */
+		std::vector<T> columns(const Core::Time &from,
+		                       const Core::Time &to) const {
+			std::vector<T> result;
+			auto it = _columns.lower_bound(firstIndex(from));
+			for ( ; it != _columns.end(); ++it ) {
+				if ( startTime(it->first) >= to ) {
+					break;
+				}
+				result.push_back(it->second);
+			}
+
+			return result;
+		}
+
+		/**
+		 * @brief Returns whether the samples of [from, to) must be pushed
+		 *        to the spectralizer to compute the missing columns.
+		 *
+		 * A record is required if a missing column overlaps the record or
+		 * starts less than one window length after it. The latter makes
+		 * sure that the spectralizer has filled its buffer and settled the
+		 * optional filter when it reaches a missing column after cached
+		 * records have been skipped.
+		 */
+		bool isRequired(const Core::Time &from, const Core::Time &to) const {
+			int64_t first = firstIndex(from);
+			int64_t last = static_cast<int64_t>(
+				std::ceil((to.epoch() + _windowLength) / _timeStep)
+			) - 1;
+
+			for ( int64_t idx = first; idx <= last; ++idx ) {
+				if ( _columns.find(idx) == _columns.end() ) {
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		size_t size() const { return _columns.size(); }
+		void clear() { _columns.clear(); }
+
+
+	// ----------------------------------------------------------------------
+	//  Private methods
+	// ----------------------------------------------------------------------
+	private:
+		//! Returns the index of the first column whose window ends after
+		//! the given time
+		int64_t firstIndex(const Core::Time &time) const {
+			return static_cast<int64_t>(
+				std::floor((time.epoch() - _windowLength) / _timeStep)
+			) + 1;
+		}
+
+
+	// ----------------------------------------------------------------------
+	//  Private members
+	// ----------------------------------------------------------------------
+	private:
+		double              _windowLength;
+		double              _timeStep;
+		size_t              _maxColumns;
+		std::map<int64_t,T> _columns;
+};
+
+
+}
+}
+
+
+#endif
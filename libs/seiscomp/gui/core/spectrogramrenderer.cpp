@@ -21,6 +21,14 @@
 #include <seiscomp/gui/core/spectrogramrenderer.h>
 #include <seiscomp/gui/core/application.h>
 
+#include <QRunnable>
+#include <QThreadPool>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 namespace Seiscomp {
@@ -30,6 +38,161 @@ namespace Gui {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+namespace {
+
+
+// The number of stream and option combinations whose columns are cached
+#define MAX_CACHED_SETTINGS 4
+// The number of cached columns per stream and options
+#define MAX_CACHED_COLUMNS 2048
+
+
+// Shared by all renderers so that the number of concurrent computations is
+// bound by the number of cores and not by the number of traces.
+QThreadPool &spectrogramPool() {
+	static QThreadPool pool;
+	return pool;
+}
+
+
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+// The job state is shared between the renderer and the worker thread. The
+// worker only uses raw pointers to the records, the spectralizer and the
+// transfer function which are kept alive by the renderer until the job has
+// finished. All members below the mutex must only be accessed with the mutex
+// locked.
+struct SpectrogramRenderer::Job {
+	void run();
+
+	std::vector<const Record*>                 records;
+	IO::Spectralizer                          *spectralizer{nullptr};
+	Math::Restitution::FFT::TransferFunction  *transferFunction{nullptr};
+	double                                     scale{1.0};
+	UpdateCallback                             callback;
+	std::atomic<bool>                          cancelled{false};
+
+	std::mutex                                 mutex;
+	std::condition_variable                    finishedCondition;
+	PowerSpectra                               spectra;
+	bool                                       started{false};
+	bool                                       finished{false};
+};
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+class SpectrogramRenderer::JobRunner : public QRunnable {
+	public:
+		JobRunner(std::shared_ptr<Job> job) : _job(std::move(job)) {}
+
+		void run() override {
+			{
+				std::lock_guard<std::mutex> lock(_job->mutex);
+				// Cancelled before it has been started
+				if ( _job->finished ) {
+					return;
+				}
+				_job->started = true;
+			}
+
+			_job->run();
+
+			{
+				// Notify with the mutex locked, the renderer must not be
+				// destroyed before the callback has returned
+				std::lock_guard<std::mutex> lock(_job->mutex);
+				_job->finished = true;
+				if ( !_job->cancelled && _job->callback ) {
+					_job->callback();
+				}
+			}
+
+			_job->finishedCondition.notify_all();
+		}
+
+	private:
+		std::shared_ptr<Job> _job;
+};
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void SpectrogramRenderer::Job::run() {
+	for ( auto rec : records ) {
+		if ( cancelled ) {
+			break;
+		}
+
+		if ( !spectralizer->push(rec) ) {
+			continue;
+		}
+
+		IO::SpectrumPtr spec;
+
+		while ( (spec = spectralizer->pop()) ) {
+			if ( !spec->isValid() ) {
+				continue;
+			}
+
+			// Deconvolution
+			if ( transferFunction ) {
+				Seiscomp::ComplexDoubleArray *data = spec->data();
+				double df = spec->maximumFrequency() / (data->size()-1);
+				transferFunction->deconvolve(data->size()-1, data->typedData()+1, df, df);
+			}
+
+			auto power = new PowerSpectrum(*spec, scale);
+			bool notify;
+
+			{
+				// The reference count of the spectrum must only be touched
+				// with the mutex locked because the renderer takes it over
+				std::lock_guard<std::mutex> lock(mutex);
+				notify = spectra.empty();
+				spectra.push_back(power);
+			}
+
+			// Only notify if the renderer has collected the previous
+			// spectra to not flood the event loop
+			if ( notify && callback ) {
+				callback();
+			}
+		}
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool SpectrogramRenderer::CacheKey::operator==(const CacheKey &other) const {
+	return options.windowLength == other.options.windowLength
+	    && options.windowOverlap == other.options.windowOverlap
+	    && options.specSamples == other.options.specSamples
+	    && options.filter == other.options.filter
+	    && options.noalign == other.options.noalign
+	    && options.taperWidth == other.options.taperWidth
+	    && scale == other.scale
+	    && transferFunction == other.transferFunction
+	    && streamID == other.streamID;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 SpectrogramRenderer::SpectrogramRenderer() {
 	_tmin = _tmax = 0;
@@ -54,6 +217,15 @@ SpectrogramRenderer::SpectrogramRenderer() {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+SpectrogramRenderer::~SpectrogramRenderer() {
+	cancelJob();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void SpectrogramRenderer::setGradient(const Gradient &gradient) {
 	Gradient::const_iterator it;
@@ -121,10 +293,13 @@ void SpectrogramRenderer::setGradientRange(double lowerBound, double upperBound)
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void SpectrogramRenderer::reset() {
+	cancelJob();
+
 	if ( !_spectralizer ) return;
 
 	_spectra.clear();
 	_images.clear();
+	_columns = nullptr;
 
 	_spectralizer = new IO::Spectralizer;
 	_spectralizer->setOptions(_options);
@@ -145,16 +320,15 @@ bool SpectrogramRenderer::feed(const Record *rec) {
 		return false;
 	}
 
-	if ( _timeWindow ) {
-		// Record clipped
-		if ( rec->endTime() <= _timeWindow->startTime() ) {
-			return false;
-		}
+	if ( isClipped(rec) ) {
+		return false;
+	}
 
-		// Record clipped
-		if ( rec->startTime() >= _timeWindow->endTime() ) {
-			return false;
-		}
+	// Keep the order of records and process them when the background
+	// computation has finished
+	if ( _job ) {
+		_queuedRecords.push_back(rec);
+		return true;
 	}
 
 	if ( _spectralizer->push(rec) ) {
@@ -173,6 +347,10 @@ bool SpectrogramRenderer::feed(const Record *rec) {
 			}
 
 			_spectra.push_back(new PowerSpectrum(*spec, _scale));
+			if ( _columns ) {
+				_columns->insert(_spectra.back()->startTime, _spectra.back());
+			}
+
 			if ( !_dirty ) {
 				addSpectrum(_spectra.back().get());
 			}
@@ -207,7 +385,258 @@ bool SpectrogramRenderer::feedSequence(const RecordSequence *seq) {
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void SpectrogramRenderer::setRecords(const RecordSequence *seq) {
 	reset();
-	feedSequence(seq);
+
+	if ( !_updateCallback || !_spectralizer || !seq || seq->empty() ) {
+		feedSequence(seq);
+		return;
+	}
+
+	selectCache(seq->front()->streamID());
+
+	if ( _columns ) {
+		// Show the cached columns immediately, the job only computes the
+		// missing ones
+		Core::Time from = seq->front()->startTime();
+		Core::Time to = seq->back()->endTime();
+
+		if ( _timeWindow ) {
+			from = std::max(from, _timeWindow->startTime());
+			to = std::min(to, _timeWindow->endTime());
+		}
+
+		for ( auto &spec : _columns->columns(from, to) ) {
+			_spectra.push_back(spec);
+		}
+	}
+
+	startJob(seq);
+	setDirty();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void SpectrogramRenderer::selectCache(const std::string &streamID) {
+	_columns = nullptr;
+
+	// Columns of unaligned windows depend on the first record and cannot
+	// be reused
+	if ( _options.noalign || _options.windowOverlap >= 1 ) {
+		return;
+	}
+
+	CacheKey key;
+	key.options = _options;
+	key.scale = _scale;
+	key.transferFunction = _transferFunction;
+	key.streamID = streamID;
+
+	for ( auto it = _cache.begin(); it != _cache.end(); ++it ) {
+		if ( it->key == key ) {
+			_columns = it->columns;
+			_cache.move(it - _cache.begin(), 0);
+			return;
+		}
+	}
+
+	CacheEntry entry;
+	entry.key = key;
+	entry.columns = std::make_shared<ColumnCache>(
+		_options.windowLength, _options.windowLength * (1 - _options.windowOverlap),
+		MAX_CACHED_COLUMNS
+	);
+
+	_cache.prepend(entry);
+	while ( _cache.size() > MAX_CACHED_SETTINGS ) {
+		_cache.removeLast();
+	}
+
+	_columns = entry.columns;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void SpectrogramRenderer::setUpdateCallback(UpdateCallback cb) {
+	_updateCallback = std::move(cb);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void SpectrogramRenderer::startJob(const RecordSequence *seq) {
+	_job = std::make_shared<Job>();
+	_jobSpectralizer = new IO::Spectralizer;
+	_jobSpectralizer->setOptions(_options);
+
+	_job->spectralizer = _jobSpectralizer.get();
+	_job->transferFunction = _transferFunction.get();
+	_job->scale = _scale;
+	_job->callback = _updateCallback;
+
+	_jobRecords.reserve(seq->size());
+	_job->records.reserve(seq->size());
+
+	Core::Time tailStart = seq->back()->endTime()
+	                     - Core::TimeSpan(_options.windowLength * 2);
+
+	for ( auto &rec : *seq ) {
+		if ( isClipped(rec.get()) ) {
+			continue;
+		}
+
+		// Skip records whose columns are cached. The last windows are
+		// always processed to continue the windowing with records fed
+		// afterwards.
+		if ( _columns && (rec->endTime() <= tailStart)
+		  && !_columns->isRequired(rec->startTime(), rec->endTime()) ) {
+			continue;
+		}
+
+		// Decode the data in the GUI thread to not race with other
+		// consumers of the record
+		if ( !rec->data() ) {
+			continue;
+		}
+
+		_jobRecords.push_back(rec);
+		_job->records.push_back(rec.get());
+	}
+
+	spectrogramPool().start(new JobRunner(_job));
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void SpectrogramRenderer::cancelJob() {
+	if ( !_job ) {
+		return;
+	}
+
+	_job->cancelled = true;
+
+	{
+		std::unique_lock<std::mutex> lock(_job->mutex);
+		if ( !_job->started ) {
+			// The runner will return immediately
+			_job->finished = true;
+		}
+		else {
+			_job->finishedCondition.wait(lock, [this]() { return _job->finished; });
+		}
+
+		// Release the spectra in this thread
+		_job->spectra.clear();
+	}
+
+	_job.reset();
+	_jobSpectralizer = nullptr;
+	_jobRecords.clear();
+	_queuedRecords.clear();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void SpectrogramRenderer::collectSpectra() {
+	if ( !_job ) {
+		return;
+	}
+
+	PowerSpectra spectra;
+	bool finished;
+
+	{
+		std::lock_guard<std::mutex> lock(_job->mutex);
+		spectra.swap(_job->spectra);
+		finished = _job->finished;
+	}
+
+	for ( auto &spec : spectra ) {
+		if ( _columns ) {
+			// Columns preceding a missing column are computed again to
+			// fill the spectralizer buffer. They are shown already.
+			if ( _columns->contains(spec->startTime) ) {
+				continue;
+			}
+
+			// Cache all columns regardless of the time window
+			_columns->insert(spec->startTime, spec);
+		}
+
+		if ( _timeWindow
+		  && ((spec->endTime <= _timeWindow->startTime())
+		   || (spec->startTime >= _timeWindow->endTime())) ) {
+			continue;
+		}
+
+		// Cached columns are shown already and the computed columns fill
+		// the gaps between them
+		auto it = _spectra.end();
+		while ( it != _spectra.begin() && (*(it-1))->startTime > spec->startTime ) {
+			--it;
+		}
+
+		// The column might have been evicted from the cache in the
+		// meantime but is still shown
+		if ( (it != _spectra.begin())
+		  && (fabs(static_cast<double>((*(it-1))->startTime - spec->startTime))
+		      < static_cast<double>(spec->dt) * 0.5) ) {
+			continue;
+		}
+
+		if ( it == _spectra.end() ) {
+			_spectra.push_back(spec);
+			if ( !_dirty ) {
+				addSpectrum(spec.get());
+			}
+		}
+		else {
+			_spectra.insert(it, spec);
+			setDirty();
+		}
+	}
+
+	if ( !finished ) {
+		return;
+	}
+
+	_spectralizer = _jobSpectralizer;
+
+	_job.reset();
+	_jobSpectralizer = nullptr;
+	_jobRecords.clear();
+
+	std::vector<RecordCPtr> queuedRecords;
+	queuedRecords.swap(_queuedRecords);
+	for ( auto &rec : queuedRecords ) {
+		feed(rec.get());
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool SpectrogramRenderer::isClipped(const Record *rec) const {
+	if ( !_timeWindow ) {
+		return false;
+	}
+
+	return (rec->endTime() <= _timeWindow->startTime())
+	    || (rec->startTime() >= _timeWindow->endTime());
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -383,6 +812,8 @@ void SpectrogramRenderer::setDirty() {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void SpectrogramRenderer::renderSpectrogram() {
+	collectSpectra();
+
 	_images.clear();
 
 	for ( auto &spec : _spectra ) {
@@ -634,6 +1065,8 @@ void SpectrogramRenderer::render(QPainter &p, const QRect &rect,
 
 	double frange;
 
+	collectSpectra();
+
 	_updatedAmplitudeRange = false;
 	_renderedFmin = fmin;
 	_renderedFmax = fmax;
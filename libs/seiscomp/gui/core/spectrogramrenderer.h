@@ -28,9 +28,15 @@
 #include <seiscomp/io/recordfilter/spectralizer.h>
 #endif
 #include <seiscomp/gui/core/lut.h>
+#include <seiscomp/gui/core/spectrogramcolumncache.h>
 
 #include <QPainter>
 
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
 
 namespace Seiscomp {
 namespace Gui {
@@ -47,6 +53,10 @@ class SC_GUI_API SpectrogramRenderer {
 			Time
 		};
 
+		//! Callback which is called from a worker thread whenever new
+		//! spectra have been computed in the background.
+		using UpdateCallback = std::function<void ()>;
+
 
 	// ----------------------------------------------------------------------
 	//  X'truction
@@ -55,6 +65,9 @@ class SC_GUI_API SpectrogramRenderer {
 		//! C'tor
 		SpectrogramRenderer();
 
+		//! D'tor, cancels pending background computations
+		~SpectrogramRenderer();
+
 
 	// ----------------------------------------------------------------------
 	//  Public Interface
@@ -85,9 +98,31 @@ class SC_GUI_API SpectrogramRenderer {
 		bool feed(const Record *rec);
 		bool feedSequence(const RecordSequence *seq);
 
-		//! Resets the view and feeds the sequence
+		/**
+		 * @brief Resets the view and feeds the sequence.
+		 *
+		 * If an update callback is set then the spectra are computed in the
+		 * background and added to the spectrogram with the next call to
+		 * render(). The columns of the spectrogram are cached per stream and
+		 * options and only records which contribute to missing columns are
+		 * processed again.
+		 */
 		void setRecords(const RecordSequence *seq);
 
+		/**
+		 * @brief Sets the callback which enables background computation
+		 *        in setRecords.
+		 *
+		 * The callback is called from a worker thread and is supposed to
+		 * schedule a repaint, e.g. with a queued QWidget::update call.
+		 * Records fed while spectra are computed in the background are
+		 * processed after the computation has finished.
+		 */
+		void setUpdateCallback(UpdateCallback cb);
+
+		//! Returns whether spectra are still being computed in the background
+		bool isProcessing() const { return static_cast<bool>(_job); }
+
 		void setAlignment(const Core::Time &align);
 		void setTimeRange(double tmin, double tmax);
 
@@ -204,6 +239,34 @@ class SC_GUI_API SpectrogramRenderer {
 			double         maximumAmplitude;
 		};
 
+		typedef QList<PowerSpectrumPtr> PowerSpectra;
+		typedef Math::Restitution::FFT::TransferFunctionPtr TransferFunctionPtr;
+
+		typedef SpectrogramColumnCache<PowerSpectrumPtr> ColumnCache;
+
+		struct CacheKey {
+			bool operator==(const CacheKey &other) const;
+
+			IO::Spectralizer::Options options;
+			double                    scale{1.0};
+			TransferFunctionPtr       transferFunction;
+			std::string               streamID;
+		};
+
+		struct CacheEntry {
+			CacheKey                     key;
+			std::shared_ptr<ColumnCache> columns;
+		};
+
+		struct Job;
+		class JobRunner;
+
+		void selectCache(const std::string &streamID);
+		void startJob(const RecordSequence *seq);
+		void cancelJob();
+		void collectSpectra();
+		bool isClipped(const Record *rec) const;
+
 		void setDirty();
 		void addSpectrum(const PowerSpectrum *);
 		void fillRow(SpecImage &img, DoubleArray *spec,
@@ -214,11 +277,9 @@ class SC_GUI_API SpectrogramRenderer {
 	//  Private members
 	// ----------------------------------------------------------------------
 	private:
-		typedef QList<PowerSpectrumPtr> PowerSpectra;
-
 		typedef QList<SpecImage> SpecImageList;
+		typedef QList<CacheEntry> Cache;
 		typedef StaticColorLUT<512> Gradient512;
-		typedef Math::Restitution::FFT::TransferFunctionPtr TransferFunctionPtr;
 
 		QImage::Format            _imageFormat;
 		TransferFunctionPtr       _transferFunction;
@@ -241,6 +302,17 @@ class SC_GUI_API SpectrogramRenderer {
 		bool                      _updatedAmplitudeRange;
 		double                    _renderedFmin;
 		double                    _renderedFmax;
+
+		// Background computation
+		UpdateCallback            _updateCallback;
+		std::shared_ptr<Job>      _job;
+		IO::SpectralizerPtr       _jobSpectralizer;
+		std::vector<RecordCPtr>   _jobRecords;
+		std::vector<RecordCPtr>   _queuedRecords;
+		Cache                     _cache;
+		// The column cache of the current stream and options, null if the
+		// windows are not aligned
+		std::shared_ptr<ColumnCache> _columns;
 };
 
 
@@ -30,7 +30,11 @@ namespace Gui {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 SpectrogramWidget::SpectrogramWidget(QWidget *parent, Qt::WindowFlags f)
-: QWidget(parent, f) {}
+: QWidget(parent, f) {
+	_renderer.setUpdateCallback([this]() {
+		QMetaObject::invokeMethod(this, "update", Qt::QueuedConnection);
+	});
+}
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 
@@ -159,6 +159,9 @@ class ZoomRecordWidget : public RecordWidget {
 			for ( int i = 0; i < 3; ++i ) {
 				_spectrogram[i].setOptions(_spectrogram[i].options());
 				_spectrogram[i].setGradient(gradient);
+				_spectrogram[i].setUpdateCallback([this]() {
+					QMetaObject::invokeMethod(this, "update", Qt::QueuedConnection);
+				});
 			}
 
 			_spectrogramAxis.setLabel(tr("f [1/T] in Hz"));
@@ -338,7 +341,8 @@ class ZoomRecordWidget : public RecordWidget {
 	private:
 		void resetSpectrogram() {
 			if ( _showSpectrogram ) {
-				qApp->setOverrideCursor(Qt::WaitCursor);
+				// Spectra are computed in the background and rendered
+				// progressively
 				for ( int i = 0; i < 3; ++i ) {
 					const double *scale = recordScale(i);
 					// Scale is is nm and needs to be converted to m
@@ -348,7 +352,6 @@ class ZoomRecordWidget : public RecordWidget {
 					_spectrogram[i].setRecords(_traces ? _traces[i].raw : nullptr);
 					_spectrogram[i].renderSpectrogram();
 				}
-				qApp->restoreOverrideCursor();
 			}
 		}
 
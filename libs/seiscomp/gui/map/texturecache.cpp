@@ -60,6 +60,7 @@ TextureCache *getTexelCache = nullptr;
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 Texture::Texture(bool isDummyTexture) {
 	isDummy = isDummyTexture;
+	lastUsed = 0;
 
 	if ( !isDummy ) {
 		data = nullptr;
@@ -302,40 +303,70 @@ Texture *TextureCache::fetch(const TileIndex &tile, bool &deferred) {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void TextureCache::checkResources(Texture *tex) {
-	while ( _storedBytes > _textureCacheLimit ) {
-		quint64 min = _currentTick;
-		Storage::iterator it, min_it = _storage.end();
-		for ( it = _storage.begin(); it != _storage.end(); ++it ) {
-			if ( (it->second->lastUsed < min || min_it == _storage.end()) && it->second != tex ) {
-				min = it->second->lastUsed;
-				min_it = it;
-			}
+	// Evict least recently used textures first. The texture passed is kept
+	// even if it is the least recently used one.
+	auto it = _lru.begin();
+	while ( _storedBytes > _textureCacheLimit && it != _lru.end() ) {
+		Texture *candidate = *it;
+		++it;
+
+		if ( candidate == tex ) {
+			continue;
 		}
 
-		// Remove texture completely
-		if ( min_it != _storage.end() ) {
-			TexturePtr min_tex = min_it->second;
-			remove(_tileStore->getID(min_it->first));
-			// std::cerr << "Uncaching texture " << min_it->second->id << std::endl;
-			_storage.erase(min_it);
-			_storedBytes -= min_tex->numBytes();
+		++_statistics.evictions;
+		_statistics.evictedBytes += candidate->numBytes();
+		uncache(candidate);
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
-			for ( auto iit = _invalidMapping.begin(); iit != _invalidMapping.end(); ) {
-				if ( iit->second == min_tex.get() ) {
-					iit = _invalidMapping.erase(iit);
-				}
-				else {
-					++iit;
-				}
-			}
 
-			if ( _lastTile[0] == min_tex.get() )
-				_lastTile[0] = nullptr;
 
-			if ( _lastTile[1] == min_tex.get() )
-				_lastTile[1] = nullptr;
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void TextureCache::touch(Texture *tex) {
+	if ( tex->lastUsed == _currentTick || tex->isDummy ) {
+		tex->lastUsed = _currentTick;
+		return;
+	}
+
+	tex->lastUsed = _currentTick;
+
+	// Move the texture to the back of the LRU list. This happens at most
+	// once per texture and paint cycle.
+	_lru.erase(tex);
+	_lru.push_back(tex);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void TextureCache::uncache(Texture *tex) {
+	// Hold a reference until all mappings are cleaned up
+	TexturePtr ref = tex;
+
+	remove(_tileStore->getID(tex->id));
+	_lru.erase(tex);
+	_storage.erase(tex->id);
+	_storedBytes -= tex->numBytes();
+
+	for ( auto iit = _invalidMapping.begin(); iit != _invalidMapping.end(); ) {
+		if ( iit->second == tex ) {
+			iit = _invalidMapping.erase(iit);
+		}
+		else {
+			++iit;
 		}
 	}
+
+	if ( _lastTile[0] == tex )
+		_lastTile[0] = nullptr;
+
+	if ( _lastTile[1] == tex )
+		_lastTile[1] = nullptr;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -451,7 +482,16 @@ void TextureCache::cache(Texture *tex) {
 		QMutexLocker lock(&imageCacheMutex);
 
 		//std::cerr << "C " << tex->id << std::endl;
-		_storage[tex->id] = tex;
+		auto it = _storage.find(tex->id);
+		if ( it != _storage.end() ) {
+			_lru.erase(it->second.get());
+			_storedBytes -= it->second->numBytes();
+			it->second = tex;
+		}
+		else {
+			_storage[tex->id] = tex;
+		}
+		_lru.push_back(tex);
 		_storedBytes += tex->numBytes();
 		// Add image to global cache
 		_images[_tileStore->getID(tex->id)] = CacheEntry(tex->image, 1);
@@ -484,6 +524,7 @@ void TextureCache::invalidateTexture(const TileIndex &tile) {
 			_storedBytes -= tex->numBytes();
 
 			//std::cerr << "I " << tex->id << std::endl;
+			_lru.erase(tex);
 			_storage.erase(it);
 
 			for ( auto iit = _invalidMapping.begin(); iit != _invalidMapping.end(); ) {
@@ -506,6 +547,7 @@ void TextureCache::invalidateTexture(const TileIndex &tile) {
 void TextureCache::clear() {
 	QMutexLocker lock(&imageCacheMutex);
 
+	_lru.clear();
 	_storage.clear();
 	_images.clear();
 	_invalidMapping.clear();
@@ -519,6 +561,15 @@ void TextureCache::clear() {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void TextureCache::resetStatistics() {
+	_statistics = Statistics();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void TextureCache::remove(const QString &name) {
 	QMutexLocker lock(&imageCacheMutex);
@@ -557,15 +608,21 @@ Texture *TextureCache::get(const TileIndex &requestTile) {
 	auto it = _storage.find(tile);
 	if ( it != _storage.end() ) {
 		tex = it->second.get();
+		++_statistics.hits;
 	}
 	else {
 		auto iit = _invalidMapping.find(tile);
 		if ( iit != _invalidMapping.end() ) {
 			tex = iit->second;
+			++_statistics.hits;
 		}
 		else {
 			// std::cerr << "F " << tile << std::endl;
+			++_statistics.misses;
 			tex = fetch(tile, deferred);
+			if ( deferred ) {
+				++_statistics.deferred;
+			}
 			if ( tex ) {
 				cache(tex);
 			}
@@ -612,7 +669,7 @@ Texture *TextureCache::get(const TileIndex &requestTile) {
 	}
 
 	// std::cerr << "> " << tex->id << " with dims " << tex->image.width() << "x" << tex->image.height() << std::endl;
-	tex->lastUsed = _currentTick;
+	touch(tex);
 	return tex;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -30,6 +30,7 @@
 #ifndef Q_MOC_RUN
 #include <seiscomp/core/baseobject.h>
 #include <seiscomp/core/datetime.h>
+#include <seiscomp/core/list.h>
 #endif
 #include <seiscomp/gui/map/imagetree.h>
 
@@ -67,7 +68,8 @@ union Coord {
 
 DEFINE_SMARTPOINTER(Texture);
 
-struct SC_GUI_API Texture : public Core::BaseObject {
+struct SC_GUI_API Texture : public Core::BaseObject,
+                            public Core::Generic::IntrusiveListItem<Texture*> {
 	Texture(bool isDummy = false);
 
 	int numBytes() const;
@@ -86,6 +88,23 @@ struct SC_GUI_API Texture : public Core::BaseObject {
 DEFINE_SMARTPOINTER(TextureCache);
 
 class SC_GUI_API TextureCache : public Core::BaseObject {
+	public:
+		//! Access statistics of the cache. All counters are accumulated
+		//! since construction or the last call to resetStatistics().
+		struct Statistics {
+			//! Number of lookups served from the cache
+			quint64 hits{0};
+			//! Number of lookups which required the tile store
+			quint64 misses{0};
+			//! Number of misses where the tile store deferred loading
+			quint64 deferred{0};
+			//! Number of textures removed to stay within the cache limit
+			quint64 evictions{0};
+			//! Number of bytes released by evictions
+			quint64 evictedBytes{0};
+		};
+
+
 	public:
 		TextureCache(TileStore *mapTree, bool mercatorProjected);
 		~TextureCache();
@@ -93,6 +112,11 @@ class SC_GUI_API TextureCache : public Core::BaseObject {
 		void beginPaint();
 
 		void setCacheLimit(int limit);
+		int cacheLimit() const { return _textureCacheLimit; }
+
+		//! Returns the number of bytes occupied by all cached textures.
+		int storedBytes() const { return _storedBytes; }
+
 		void setCurrentTime(const Core::Time &t);
 
 		int maxLevel() const;
@@ -122,10 +146,15 @@ class SC_GUI_API TextureCache : public Core::BaseObject {
 		//! Clears the cache
 		void clear();
 
+		const Statistics &statistics() const { return _statistics; }
+		void resetStatistics();
+
 
 	private:
 		void cache(Texture *tex);
 		void checkResources(Texture *tex = nullptr);
+		void touch(Texture *tex);
+		void uncache(Texture *tex);
 		Texture *fetch(const TileIndex &tile, bool &deferred);
 
 		static void remove(const QString &name);
@@ -134,6 +163,8 @@ class SC_GUI_API TextureCache : public Core::BaseObject {
 	private:
 		typedef std::map<TileIndex, TexturePtr> Storage;
 		typedef std::map<TileIndex, Texture*> InvalidMapping;
+		//! Least recently used textures are at the front
+		typedef Core::Generic::IntrusiveList<Texture*> LRUList;
 
 		TileStore        *_tileStore;
 		bool              _isMercatorProjected;
@@ -142,6 +173,8 @@ class SC_GUI_API TextureCache : public Core::BaseObject {
 		int               _textureCacheLimit;
 		quint64           _currentTick;
 		InvalidMapping    _invalidMapping;
+		LRUList           _lru;
+		Statistics        _statistics;
 
 		Texture          *_lastTile[2];
 		TileIndex         _lastId[2];
@@ -26,6 +26,7 @@
 #include <seiscomp/logging/log.h>
 
 #include <QByteArray>
+#include <QCache>
 #include <QDateTime>
 #include <QDir>
 #include <QFile>
@@ -35,14 +36,17 @@
 #include <QNetworkAccessManager>
 #include <QNetworkReply>
 #include <QNetworkRequest>
+#include <QRunnable>
 #include <QSet>
 #include <QSize>
 #include <QString>
 #include <QStringList>
+#include <QThreadPool>
 #include <QUrl>
 #include <QVector>
 
 #include <algorithm>
+#include <functional>
 
 
 namespace Seiscomp {
@@ -51,6 +55,35 @@ namespace Map {
 namespace {
 
 
+// Decodes a tile image either from a file or from an in-memory buffer on a
+// worker thread and hands the result to a callback. The callback is invoked
+// from the worker thread and must only post the result to the owner.
+class DecodeJob : public QRunnable {
+	public:
+		using Callback = std::function<void (const QImage &)>;
+
+		DecodeJob(const QString &path, const QByteArray &data, Callback cb)
+		: _path(path), _data(data), _callback(std::move(cb)) {}
+
+		void run() override {
+			QImage img;
+			bool ok = _path.isEmpty() ? img.loadFromData(_data) : img.load(_path);
+			if ( ok && img.format() != QImage::Format_RGB32 &&
+			     img.format() != QImage::Format_ARGB32 ) {
+				// Convert here rather than in the texture cache which runs
+				// on the GUI thread
+				img = img.convertToFormat(QImage::Format_ARGB32);
+			}
+			_callback(ok ? img : QImage());
+		}
+
+	private:
+		QString    _path;
+		QByteArray _data;
+		Callback   _callback;
+};
+
+
 // Tile store of type "xyz": fetches map tiles from any standard XYZ /
 // slippy-map server (OpenStreetMap, OpenTopoMap, ESRI, CartoDB, custom
 // servers) over HTTP and caches them on disk.
@@ -63,11 +96,17 @@ namespace {
 // It is a QObject (without Q_OBJECT/moc) only so that it can own the network
 // access manager and act as the connection context; replies are dispatched
 // through a member function via the functor-based connect overload.
+//
+// Image decoding (PNG/JPEG) of downloaded and disk cached tiles runs on a
+// small thread pool so that zooming and panning do not stall the GUI thread.
+// Optionally, neighbouring tiles and the tiles of the next zoom level are
+// prefetched and kept decoded in a memory cache bounded by a byte budget.
 class XYZTileStore : public QObject, public TileStore {
 	public:
 		XYZTileStore() = default;
 		~XYZTileStore() override {
 			refresh();
+			_decodePool.waitForDone();
 		}
 
 	public:
@@ -152,6 +191,10 @@ class XYZTileStore : public QObject, public TileStore {
 					_userAgent = QString::fromStdString(app->configGetString("map.xyz.userAgent"));
 				}
 				catch ( ... ) {}
+				try { _decodeThreads = app->configGetInt("map.xyz.decodeThreads"); } catch ( ... ) {}
+				try { _prefetch      = app->configGetBool("map.xyz.prefetch");     } catch ( ... ) {}
+				try { _prefetchLimit = app->configGetInt("map.xyz.prefetchLimit"); } catch ( ... ) {}
+				try { _memoryCacheSize = app->configGetInt("map.xyz.memoryCacheSize"); } catch ( ... ) {}
 				try {
 					QString s = QString::fromStdString(app->configGetString("map.xyz.subdomains"));
 					for ( auto &sub : s.split(',', Qt::SkipEmptyParts) )
@@ -182,6 +225,12 @@ class XYZTileStore : public QObject, public TileStore {
 
 			_projection = Mercator;
 
+			if ( _decodeThreads > 0 )
+				_decodePool.setMaxThreadCount(_decodeThreads);
+
+			// The cost of a cached image is given in KiB
+			_images.setMaxCost(std::max(_memoryCacheSize, 0) * 1024);
+
 			_nam = new QNetworkAccessManager(this);
 			connect(_nam, &QNetworkAccessManager::finished,
 			        this, &XYZTileStore::onRequestFinished);
@@ -193,6 +242,8 @@ class XYZTileStore : public QObject, public TileStore {
 			              static_cast<int>(_sources.size()), _minLevel, _maxLevel,
 			              _cacheDir.isEmpty() ? "disabled" : qUtf8Printable(_cacheDir),
 			              _cacheDuration);
+			SEISCOMP_INFO("xyz:   decode threads=%d  prefetch=%s  memory cache=%dMB",
+			              _decodeThreads, _prefetch ? "yes" : "no", _memoryCacheSize);
 			for ( const auto &s : _sources )
 				SEISCOMP_INFO("xyz:   level %2d..%-2d -> %s",
 				              s.minLevel, s.maxLevel, qUtf8Printable(s.url));
@@ -204,30 +255,9 @@ class XYZTileStore : public QObject, public TileStore {
 		}
 
 		LoadResult load(QImage &img, const TileIndex &tile) override {
-			if ( _inflight.contains(tile.id) )
-				return Deferred;
-
-			// Negative cache: don't re-hammer the server for tiles it already
-			// told us it doesn't have (HTTP >= 400). Respect map.xyz.missingTTL.
-			auto miss = _missing.constFind(tile.id);
-			if ( miss != _missing.constEnd() ) {
-				if ( _missingTTL < 0 ||
-				     miss.value() + _missingTTL > QDateTime::currentSecsSinceEpoch() )
-					return Error;
-				_missing.erase(_missing.find(tile.id));
-			}
-
-			if ( !_cacheDir.isEmpty() ) {
-				QString path = cachePath(tile);
-				if ( QFile::exists(path) && isCacheFresh(path) ) {
-					if ( img.load(path) )
-						return OK;
-					QFile::remove(path);
-				}
-			}
-
-			startRequest(tile);
-			return Deferred;
+			LoadResult r = loadTile(img, tile);
+			prefetch(tile);
+			return r;
 		}
 
 		QString getID(const TileIndex &tile) const override {
@@ -243,14 +273,22 @@ class XYZTileStore : public QObject, public TileStore {
 		}
 
 		bool hasPendingRequests() const override {
-			return !_inflight.isEmpty();
+			// Prefetches are not reported as they are not waited for
+			return !_requested.isEmpty();
 		}
 
 		void refresh() override {
+			// Results of decode jobs which are still running are discarded
+			// by comparing the generation
+			++_generation;
+			_decodePool.clear();
+
 			for ( auto *reply : _replyMap.keys() )
 				reply->abort();
 			_replyMap.clear();
 			_inflight.clear();
+			_requested.clear();
+			_images.clear();
 		}
 
 	private:
@@ -266,6 +304,174 @@ class XYZTileStore : public QObject, public TileStore {
 			QString url;
 		};
 
+		LoadResult loadTile(QImage &img, const TileIndex &tile) {
+			QImage *cached = _images.take(tile.id);
+			if ( cached ) {
+				img = *cached;
+				delete cached;
+				return OK;
+			}
+
+			if ( _inflight.contains(tile.id) ) {
+				// Possibly a prefetch, report the result when done
+				_requested.insert(tile.id);
+				return Deferred;
+			}
+
+			if ( isMissing(tile) )
+				return Error;
+
+			if ( !_cacheDir.isEmpty() ) {
+				QString path = cachePath(tile);
+				if ( QFile::exists(path) && isCacheFresh(path) ) {
+					if ( _decodeThreads > 0 ) {
+						_requested.insert(tile.id);
+						startDecode(tile, path, QByteArray());
+						return Deferred;
+					}
+
+					if ( img.load(path) )
+						return OK;
+					QFile::remove(path);
+				}
+			}
+
+			_requested.insert(tile.id);
+			startRequest(tile);
+			return Deferred;
+		}
+
+		// Negative cache: don't re-hammer the server for tiles it already
+		// told us it doesn't have (HTTP >= 400). Respect map.xyz.missingTTL.
+		bool isMissing(const TileIndex &tile) {
+			auto miss = _missing.constFind(tile.id);
+			if ( miss == _missing.constEnd() )
+				return false;
+
+			if ( _missingTTL < 0 ||
+			     miss.value() + _missingTTL > QDateTime::currentSecsSinceEpoch() )
+				return true;
+
+			_missing.erase(_missing.find(tile.id));
+			return false;
+		}
+
+		// Loads the neighbours of a tile at the same level and its children
+		// at the next level in the background. They are kept decoded in
+		// memory until requested.
+		void prefetch(const TileIndex &tile) {
+			if ( !_prefetch || _images.maxCost() <= 0 )
+				return;
+
+			const int level = tile.level();
+			const qint64 n = qint64(1) << level;
+			const qint64 row = tile.row();
+			const qint64 col = tile.column();
+
+			TileIndex candidates[12];
+			int count = 0;
+
+			if ( level < _maxLevel ) {
+				for ( int i = 0; i < 4; ++i )
+					candidates[count++] = TileIndex(level + 1, row * 2 + (i >> 1), col * 2 + (i & 1));
+			}
+
+			for ( int dr = -1; dr <= 1; ++dr ) {
+				for ( int dc = -1; dc <= 1; ++dc ) {
+					if ( !dr && !dc ) continue;
+					qint64 r = row + dr;
+					if ( r < 0 || r >= n ) continue;
+					// Columns wrap around the date line
+					qint64 c = (col + dc + n) % n;
+					candidates[count++] = TileIndex(level, r, c);
+				}
+			}
+
+			for ( int i = 0; i < count; ++i ) {
+				if ( _inflight.size() - _requested.size() >= _prefetchLimit )
+					break;
+
+				const TileIndex &t = candidates[i];
+				if ( _inflight.contains(t.id) || _images.contains(t.id) || isMissing(t) )
+					continue;
+
+				if ( !_cacheDir.isEmpty() ) {
+					QString path = cachePath(t);
+					if ( QFile::exists(path) && isCacheFresh(path) ) {
+						// Without decode threads the tile would be decoded
+						// on the GUI thread although it might never be
+						// shown. It is loaded from disk when requested.
+						if ( _decodeThreads > 0 )
+							startDecode(t, path, QByteArray());
+						continue;
+					}
+				}
+
+				startRequest(t);
+			}
+		}
+
+		void startDecode(const TileIndex &tile, const QString &path, const QByteArray &data) {
+			_inflight.insert(tile.id);
+
+			TileId tileId = tile.id;
+			int generation = _generation;
+			_decodePool.start(new DecodeJob(path, data, [this, tileId, generation](const QImage &img) {
+				QMetaObject::invokeMethod(this, [this, tileId, generation, img]() {
+					if ( generation != _generation || !_inflight.contains(tileId) )
+						return;
+
+					TileIndex tile;
+					tile.id = tileId;
+
+					if ( img.isNull() ) {
+						_inflight.remove(tileId);
+						SEISCOMP_WARNING("xyz: image decode failed for tile %s",
+						                 qUtf8Printable(getID(tile)));
+						if ( !_cacheDir.isEmpty() )
+							QFile::remove(cachePath(tile));
+						cancelTile(tile);
+						return;
+					}
+
+					QImage tmp(img);
+					deliverTile(tmp, tile);
+				}, Qt::QueuedConnection);
+			}));
+		}
+
+		// Hands a loaded tile either to the image tree if it has been
+		// requested or to the memory cache if it has been prefetched.
+		void deliverTile(QImage &img, const TileIndex &tile) {
+			_inflight.remove(tile.id);
+
+			// One-time sanity check: the configured map.xyz.tileSize must match
+			// the pixels the server actually serves, otherwise the projection
+			// scale (which uses tileSize) picks the wrong level and the map
+			// looks blurry.
+			if ( !_tileSizeChecked ) {
+				_tileSizeChecked = true;
+				if ( img.size() != _tilesize )
+					SEISCOMP_WARNING("xyz: server tile is %dx%d but map.xyz.tileSize is %dx%d - "
+					                 "set map.xyz.tileSize to %d to avoid blurry rendering",
+					                 img.width(), img.height(),
+					                 _tilesize.width(), _tilesize.height(), img.width());
+			}
+
+			if ( _requested.remove(tile.id) ) {
+				loadingComplete(img, tile);
+				return;
+			}
+
+			int cost = std::max(1, static_cast<int>(img.sizeInBytes() / 1024));
+			_images.insert(tile.id, new QImage(img), cost);
+		}
+
+		void cancelTile(const TileIndex &tile) {
+			if ( _requested.remove(tile.id) )
+				loadingCancelled(tile);
+		}
+
 		const Source *sourceForLevel(int level) const {
 			for ( const auto &s : _sources ) {
 				if ( level >= s.minLevel && level <= s.maxLevel )
@@ -341,7 +547,6 @@ class XYZTileStore : public QObject, public TileStore {
 
 			TileId tileId = it.value();
 			_replyMap.erase(it);
-			_inflight.remove(tileId);
 
 			TileIndex tile;
 			tile.id = tileId;
@@ -352,7 +557,8 @@ class XYZTileStore : public QObject, public TileStore {
 					                 qUtf8Printable(getID(tile)),
 					                 qUtf8Printable(reply->errorString()));
 				}
-				loadingCancelled(tile);
+				_inflight.remove(tileId);
+				cancelTile(tile);
 				return;
 			}
 
@@ -362,13 +568,22 @@ class XYZTileStore : public QObject, public TileStore {
 				                 httpStatus, qUtf8Printable(getID(tile)));
 				if ( _missingTTL != 0 )
 					_missing.insert(tileId, QDateTime::currentSecsSinceEpoch());
-				loadingCancelled(tile);
+				_inflight.remove(tileId);
+				cancelTile(tile);
 				return;
 			}
 
 			QByteArray data = reply->readAll();
 			if ( data.isEmpty() ) {
-				loadingCancelled(tile);
+				_inflight.remove(tileId);
+				cancelTile(tile);
+				return;
+			}
+
+			if ( _decodeThreads > 0 ) {
+				// The tile stays in flight until it is decoded
+				persist(tile, data);
+				startDecode(tile, QString(), data);
 				return;
 			}
 
@@ -376,23 +591,16 @@ class XYZTileStore : public QObject, public TileStore {
 			if ( !img.loadFromData(data) ) {
 				SEISCOMP_WARNING("xyz: image decode failed for tile %s",
 				                 qUtf8Printable(getID(tile)));
-				loadingCancelled(tile);
+				_inflight.remove(tileId);
+				cancelTile(tile);
 				return;
 			}
 
-			// One-time sanity check: the configured map.xyz.tileSize must match
-			// the pixels the server actually serves, otherwise the projection
-			// scale (which uses tileSize) picks the wrong level and the map
-			// looks blurry.
-			if ( !_tileSizeChecked ) {
-				_tileSizeChecked = true;
-				if ( img.size() != _tilesize )
-					SEISCOMP_WARNING("xyz: server tile is %dx%d but map.xyz.tileSize is %dx%d - "
-					                 "set map.xyz.tileSize to %d to avoid blurry rendering",
-					                 img.width(), img.height(),
-					                 _tilesize.width(), _tilesize.height(), img.width());
-			}
+			persist(tile, data);
+			deliverTile(img, tile);
+		}
 
+		void persist(const TileIndex &tile, const QByteArray &data) {
 			// Only persist when caching is actually enabled for reads
 			// (cacheDuration == 0 disables the cache entirely).
 			if ( !_cacheDir.isEmpty() && _cacheDuration != 0 ) {
@@ -402,8 +610,6 @@ class XYZTileStore : public QObject, public TileStore {
 				if ( f.open(QIODevice::WriteOnly) )
 					f.write(data);
 			}
-
-			loadingComplete(img, tile);
 		}
 
 	private:
@@ -422,8 +628,19 @@ class XYZTileStore : public QObject, public TileStore {
 
 		bool                     _tileSizeChecked{false};
 
+		int                      _decodeThreads{2};
+		bool                     _prefetch{false};
+		int                      _prefetchLimit{32};
+		int                      _memoryCacheSize{32};
+		int                      _generation{0};
+		QThreadPool              _decodePool;
+		QCache<TileId, QImage>   _images;
+
 		QHash<QNetworkReply *, TileId> _replyMap;
+		//! Tiles being downloaded or decoded
 		QSet<TileId>                   _inflight;
+		//! Tiles the texture cache waits for
+		QSet<TileId>                   _requested;
 };
 
 
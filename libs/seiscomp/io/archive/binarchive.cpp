@@ -24,7 +24,9 @@
 #include <seiscomp/datamodel/version.h>
 #include <seiscomp/core/exceptions.h>
 
+#include <algorithm>
 #include <iostream>
+#include <limits>
 #include <fstream>
 #include <string.h>
 
@@ -107,6 +109,13 @@ struct FourCC {
 
 FourCC MAGIC('S','C','B','A');
 FourCC MAGIC2('S','C','B','B');
+// Compact binary archive
+FourCC MAGIC_COMPACT('S','C','C','B');
+
+// Variable sized data is allocated in chunks of at most this number of bytes
+// while it is read, so a corrupt size never allocates more memory than the
+// stream actually holds
+constexpr size_t MaxChunkSize = 65536;
 
 
 }
@@ -1010,6 +1019,37 @@ void BinaryArchive::setClassName(const char* className) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool BinaryArchive::hasBytes(size_t count) {
+	if ( !_buf ) return false;
+
+	// Memory buffers report all remaining bytes
+	std::streamsize avail = _buf->in_avail();
+	if ( avail < 0 ) return count == 0;
+	if ( static_cast<size_t>(avail) >= count ) return true;
+
+	// File buffers only report the buffered bytes, ask for the stream size.
+	// Filtering buffers, e.g. of boost::iostreams, throw instead of
+	// returning an invalid position.
+	try {
+		auto pos = _buf->pubseekoff(0, std::ios_base::cur, std::ios_base::in);
+		if ( pos == std::streampos(-1) ) return true;
+
+		auto end = _buf->pubseekoff(0, std::ios_base::end, std::ios_base::in);
+		_buf->pubseekpos(pos, std::ios_base::in);
+		if ( end == std::streampos(-1) ) return true;
+
+		return static_cast<size_t>(end - pos) >= count;
+	}
+	catch ( std::exception & ) {
+		return true;
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 int BinaryArchive::classId(const std::string& classname) {
 	for ( size_t i = 0; i < _classes.size(); ++i )
@@ -1321,6 +1361,721 @@ bool VBinaryArchive::readHeader() {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+CompactBinaryArchive::CompactBinaryArchive(int forceWriteVersion)
+: _forceWriteVersion(forceWriteVersion) {}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+CompactBinaryArchive::CompactBinaryArchive(std::streambuf* buf, bool isReading,
+                                           int forceWriteVersion)
+: BinaryArchive(buf, isReading)
+, _forceWriteVersion(forceWriteVersion) {
+	if ( isReading ) {
+		if ( !readHeader() ) {
+			throw Core::StreamException(errorMsg());
+		}
+	}
+	else
+		writeHeader();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void CompactBinaryArchive::setWriteVersion(int version) {
+	_forceWriteVersion = version;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool CompactBinaryArchive::open(const char* file) {
+	_error = "";
+
+	if ( !BinaryArchive::open(file) ) return false;
+
+	if ( !readHeader() ) {
+		close();
+		return false;
+	}
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool CompactBinaryArchive::open(std::streambuf *buf) {
+	_error = "";
+
+	if ( !BinaryArchive::open(buf) ) return false;
+
+	if ( !readHeader() ) {
+		close();
+		return false;
+	}
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool CompactBinaryArchive::create(const char* file) {
+	_error = "";
+	if ( !BinaryArchive::create(file) ) return false;
+	writeHeader();
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool CompactBinaryArchive::create(std::streambuf *buf) {
+	_error = "";
+	if ( !BinaryArchive::create(buf) ) return false;
+	writeHeader();
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void CompactBinaryArchive::close() {
+	BinaryArchive::close();
+	_error = "";
+	_strings.clear();
+	_stringIndex.clear();
+	_lastTime = 0;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+const char *CompactBinaryArchive::errorMsg() const {
+	return _error.c_str();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool CompactBinaryArchive::readVarInt(uint64_t &value) {
+	if ( !_buf ) {
+		setValidity(false);
+		return false;
+	}
+
+	value = 0;
+	for ( int shift = 0; shift < 64; shift += 7 ) {
+		auto c = _buf->sbumpc();
+		if ( c == std::streambuf::traits_type::eof() ) {
+			SEISCOMP_ERROR("read(varint): unexpected end of stream");
+			setValidity(false);
+			return false;
+		}
+
+		value |= static_cast<uint64_t>(c & 0x7f) << shift;
+		if ( !(c & 0x80) ) {
+			return true;
+		}
+	}
+
+	SEISCOMP_ERROR("read(varint): value exceeds 64 bits");
+	setValidity(false);
+	return false;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void CompactBinaryArchive::writeVarInt(uint64_t value) {
+	if ( !_buf ) return;
+
+	char tmp[10];
+	int len = 0;
+
+	while ( value >= 0x80 ) {
+		tmp[len++] = static_cast<char>(value | 0x80);
+		value >>= 7;
+	}
+
+	tmp[len++] = static_cast<char>(value);
+	writeBytes(tmp, len);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+template <typename T>
+void CompactBinaryArchive::readSigned(T &value) {
+	uint64_t tmp;
+	if ( readVarInt(tmp) ) {
+		// Zigzag decoding
+		value = static_cast<T>(static_cast<int64_t>(tmp >> 1) ^ -static_cast<int64_t>(tmp & 1));
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+template <typename T>
+void CompactBinaryArchive::writeSigned(T value) {
+	// Zigzag encoding maps small negative numbers to small varints
+	int64_t tmp = value;
+	writeVarInt((static_cast<uint64_t>(tmp) << 1) ^ static_cast<uint64_t>(tmp >> 63));
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool CompactBinaryArchive::readSize(size_t &size, size_t elementSize) {
+	uint64_t tmp;
+	if ( !readVarInt(tmp) ) {
+		return false;
+	}
+
+	// The count is untrusted input: reject it before anything is allocated
+	// if the stream cannot hold that many elements
+	if ( (tmp > std::numeric_limits<size_t>::max() / elementSize)
+	  || !hasBytes(static_cast<size_t>(tmp) * elementSize) ) {
+		SEISCOMP_ERROR("read(size): %llu elements exceed the stream size",
+		               static_cast<unsigned long long>(tmp));
+		setValidity(false);
+		return false;
+	}
+
+	size = static_cast<size_t>(tmp);
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+template <typename T>
+void CompactBinaryArchive::readIntVector(std::vector<T> &value) {
+	size_t size;
+	if ( !readSize(size) ) return;
+
+	value.clear();
+	value.reserve(std::min(size, MaxChunkSize / sizeof(T)));
+	for ( size_t i = 0; i < size; ++i ) {
+		T v;
+		readSigned(v);
+		if ( !success() ) return;
+		value.push_back(v);
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+template <typename T>
+void CompactBinaryArchive::writeIntVector(std::vector<T> &value) {
+	if ( !_buf ) return;
+	writeVarInt(value.size());
+	for ( auto v : value ) {
+		writeSigned(v);
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+template <typename T>
+void CompactBinaryArchive::readRawVector(std::vector<T> &value) {
+	size_t size;
+	if ( !readSize(size, sizeof(T)) ) return;
+
+	// Grow the vector with the data read to bound the memory also for
+	// streams which cannot tell their size
+	value.clear();
+	while ( value.size() < size ) {
+		size_t offset = value.size();
+		size_t count = std::min(size - offset, MaxChunkSize / sizeof(T));
+		value.resize(offset + count);
+
+		std::streamsize bytes = count * sizeof(T);
+		std::streamsize got = _buf->sgetn(reinterpret_cast<char*>(value.data() + offset), bytes);
+		if ( got != bytes ) {
+			SEISCOMP_ERROR("read(array): expected %d bytes from stream, got %d",
+			               static_cast<int>(bytes), static_cast<int>(got));
+			setValidity(false);
+			return;
+		}
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+template <typename T>
+void CompactBinaryArchive::writeRawVector(std::vector<T> &value) {
+	if ( !_buf ) return;
+	writeVarInt(value.size());
+	writeBytes(value.data(), static_cast<int>(value.size() * sizeof(T)));
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+template <typename T>
+void CompactBinaryArchive::readObjectVector(std::vector<T> &value) {
+	size_t size;
+	if ( !readSize(size) ) return;
+
+	value.clear();
+	value.reserve(std::min(size, MaxChunkSize / sizeof(T)));
+	for ( size_t i = 0; i < size; ++i ) {
+		T v;
+		read(v);
+		if ( !success() ) return;
+		value.push_back(std::move(v));
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+template <typename T>
+void CompactBinaryArchive::writeObjectVector(std::vector<T> &value) {
+	if ( !_buf ) return;
+	writeVarInt(value.size());
+	for ( auto &v : value ) {
+		write(v);
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void CompactBinaryArchive::read(int16_t &value) {
+	readSigned(value);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void CompactBinaryArchive::read(int32_t &value) {
+	readSigned(value);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void CompactBinaryArchive::read(int64_t &value) {
+	readSigned(value);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void CompactBinaryArchive::read(std::vector<char> &value) {
+	readRawVector(value);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void CompactBinaryArchive::read(std::vector<int8_t> &value) {
+	readRawVector(value);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void CompactBinaryArchive::read(std::vector<int16_t> &value) {
+	readIntVector(value);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void CompactBinaryArchive::read(std::vector<int32_t> &value) {
+	readIntVector(value);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void CompactBinaryArchive::read(std::vector<int64_t> &value) {
+	readIntVector(value);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void CompactBinaryArchive::read(std::vector<float> &value) {
+	readRawVector(value);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void CompactBinaryArchive::read(std::vector<double> &value) {
+	readRawVector(value);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void CompactBinaryArchive::read(std::vector<std::string> &value) {
+	readObjectVector(value);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void CompactBinaryArchive::read(std::vector<Core::Time> &value) {
+	readObjectVector(value);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void CompactBinaryArchive::read(std::vector<std::complex<double> > &value) {
+	readRawVector(value);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void CompactBinaryArchive::read(std::string &value) {
+	// A tag of zero introduces a new string which is added to the
+	// string table, otherwise it references the entry tag-1.
+	uint64_t tag;
+	if ( !readVarInt(tag) ) return;
+
+	if ( tag ) {
+		if ( tag > _strings.size() ) {
+			SEISCOMP_ERROR("read(string): invalid string table index %d",
+			               static_cast<int>(tag - 1));
+			setValidity(false);
+			return;
+		}
+
+		value = _strings[tag - 1];
+		return;
+	}
+
+	size_t size;
+	if ( !readSize(size) ) return;
+
+	value.clear();
+	while ( value.size() < size ) {
+		size_t offset = value.size();
+		size_t count = std::min(size - offset, MaxChunkSize);
+		value.resize(offset + count);
+
+		std::streamsize got = _buf->sgetn(&value[offset], static_cast<std::streamsize>(count));
+		if ( got != static_cast<std::streamsize>(count) ) {
+			SEISCOMP_ERROR("read(string): expected %d bytes from stream, got %d",
+			               static_cast<int>(size), static_cast<int>(offset + got));
+			setValidity(false);
+			return;
+		}
+	}
+
+	_strings.push_back(value);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void CompactBinaryArchive::read(Seiscomp::Core::Time &value) {
+	Core::Time::Storage delta = 0;
+	readSigned(delta);
+	if ( !success() ) return;
+
+	_lastTime += delta;
+	value = Core::Time::FromEpoch(_lastTime / 1000000, _lastTime % 1000000);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void CompactBinaryArchive::write(int16_t value) {
+	writeSigned(value);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void CompactBinaryArchive::write(int32_t value) {
+	writeSigned(value);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void CompactBinaryArchive::write(int64_t value) {
+	writeSigned(value);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void CompactBinaryArchive::write(std::vector<char> &value) {
+	writeRawVector(value);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void CompactBinaryArchive::write(std::vector<int8_t> &value) {
+	writeRawVector(value);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void CompactBinaryArchive::write(std::vector<int16_t> &value) {
+	writeIntVector(value);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void CompactBinaryArchive::write(std::vector<int32_t> &value) {
+	writeIntVector(value);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void CompactBinaryArchive::write(std::vector<int64_t> &value) {
+	writeIntVector(value);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void CompactBinaryArchive::write(std::vector<float> &value) {
+	writeRawVector(value);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void CompactBinaryArchive::write(std::vector<double> &value) {
+	writeRawVector(value);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void CompactBinaryArchive::write(std::vector<std::string> &value) {
+	writeObjectVector(value);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void CompactBinaryArchive::write(std::vector<Core::Time> &value) {
+	writeObjectVector(value);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void CompactBinaryArchive::write(std::vector<std::complex<double> > &value) {
+	writeRawVector(value);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void CompactBinaryArchive::write(std::string &value) {
+	if ( !_buf ) return;
+
+	auto it = _stringIndex.find(value);
+	if ( it != _stringIndex.end() ) {
+		writeVarInt(it->second);
+		return;
+	}
+
+	writeVarInt(0);
+	writeVarInt(value.size());
+	writeBytes(value.data(), static_cast<int>(value.size()));
+	_stringIndex.emplace(value, _stringIndex.size() + 1);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void CompactBinaryArchive::write(Seiscomp::Core::Time &value) {
+	// Times of an object such as creation time and pick time are usually
+	// close to each other, storing the difference keeps the varints short
+	Core::Time::Storage tmp = value.epochSeconds() * 1000000 + value.microseconds();
+	writeSigned(tmp - _lastTime);
+	_lastTime = tmp;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void CompactBinaryArchive::writeHeader() {
+	_strings.clear();
+	_stringIndex.clear();
+	_lastTime = 0;
+
+	if ( _forceWriteVersion <= 0 ) {
+		setVersion({ DataModel::Version::Major, DataModel::Version::Minor });
+	}
+	else {
+		_version = _forceWriteVersion;
+		_version = _version.majorMinor();
+	}
+
+	writeBytes(MAGIC_COMPACT.cc, FourCC::Size);
+	writeVarInt(Version);
+	writeVarInt(_version.majorTag() << 0x10 | _version.minorTag());
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool CompactBinaryArchive::readHeader() {
+	_strings.clear();
+	_stringIndex.clear();
+	_lastTime = 0;
+
+	FourCC magic;
+	if ( !_buf || (_buf->sgetn(magic.cc, FourCC::Size) != FourCC::Size)
+	  || !(magic == MAGIC_COMPACT) ) {
+		_error = "invalid header format, expected SCCB";
+		return false;
+	}
+
+	uint64_t formatVersion, versionTag;
+	if ( !readVarInt(formatVersion) || !readVarInt(versionTag) ) {
+		_error = "invalid header, unexpected end of stream";
+		return false;
+	}
+
+	if ( formatVersion > Version ) {
+		_error = "unsupported format version " + std::to_string(formatVersion);
+		return false;
+	}
+
+	setVersion(Core::Version(static_cast<uint32_t>(versionTag) >> 0x10,
+	                         static_cast<uint32_t>(versionTag) & 0xffff));
+
+	if ( !versionTag ) {
+		_error = "invalid version";
+		return false;
+	}
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 }
 }
@@ -24,6 +24,7 @@
 #include <seiscomp/core/io.h>
 #include <seiscomp/core.h>
 #include <streambuf>
+#include <unordered_map>
 
 namespace Seiscomp {
 namespace IO {
@@ -170,6 +171,12 @@ class SC_SYSTEM_CORE_API BinaryArchive : public Seiscomp::Core::Archive {
 
 		int writeBytes(const void*, int);
 
+		//! Returns whether the stream holds at least count more bytes to
+		//! read. Element counts read from the stream must be checked with
+		//! this function before memory is allocated for them. Streams which
+		//! cannot tell their size are assumed to hold enough data.
+		bool hasBytes(size_t count);
+
 
 	// ----------------------------------------------------------------------
 	//  Implementation
@@ -267,6 +274,145 @@ class SC_SYSTEM_CORE_API VBinaryArchive : public BinaryArchive {
 		uint32_t    _formatHint{0};
 		std::string _error;
 };
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+/** \brief A compact binary archive intended for messaging
+ *
+ * The layout of objects is the same as with BinaryArchive but integers,
+ * lengths and class ids are stored as zigzag varints, times as varint
+ * deltas to the previously written time and each distinct string including
+ * class names only once per archive. A pick notifier message is about
+ * 25% smaller than its VBinaryArchive representation (about 300 instead of
+ * 400 bytes) which is close to the size of a deflated VBinaryArchive
+ * (about 280 bytes) at a fraction of the encoding cost.
+ * The archive is always versioned.
+ */
+class SC_SYSTEM_CORE_API CompactBinaryArchive : public BinaryArchive {
+	public:
+		static constexpr unsigned Version = 1;
+
+
+	// ----------------------------------------------------------------------
+	//  Xstruction
+	// ----------------------------------------------------------------------
+	public:
+		//! Constructor
+		CompactBinaryArchive(int forceWriteVersion = -1);
+
+		//! Constructor with predefined buffer and mode
+		CompactBinaryArchive(std::streambuf* buf, bool isReading = true,
+		                     int forceWriteVersion = -1);
+
+
+	// ----------------------------------------------------------------------
+	//  Public Interface
+	// ----------------------------------------------------------------------
+	public:
+		void setWriteVersion(int version);
+
+		bool open(const char* file) override;
+		bool open(std::streambuf*);
+
+		bool create(const char* file) override;
+		bool create(std::streambuf*);
+
+		void close() override;
+
+		const char *errorMsg() const;
+
+		using BinaryArchive::read;
+		using BinaryArchive::write;
+
+		void read(std::int16_t& value) override;
+		void read(std::int32_t& value) override;
+		void read(std::int64_t& value) override;
+
+		void read(std::vector<char>& value) override;
+		void read(std::vector<int8_t>& value) override;
+		void read(std::vector<int16_t>& value) override;
+		void read(std::vector<int32_t>& value) override;
+		void read(std::vector<int64_t>& value) override;
+		void read(std::vector<float>& value) override;
+		void read(std::vector<double>& value) override;
+		void read(std::vector<std::string>& value) override;
+		void read(std::vector<Core::Time>& value) override;
+		void read(std::vector<std::complex<double> >& value) override;
+
+		void read(std::string& value) override;
+		void read(Seiscomp::Core::Time& value) override;
+
+		void write(std::int16_t value) override;
+		void write(std::int32_t value) override;
+		void write(std::int64_t value) override;
+
+		void write(std::vector<char>& value) override;
+		void write(std::vector<int8_t>& value) override;
+		void write(std::vector<int16_t>& value) override;
+		void write(std::vector<int32_t>& value) override;
+		void write(std::vector<int64_t>& value) override;
+		void write(std::vector<float>& value) override;
+		void write(std::vector<double>& value) override;
+		void write(std::vector<std::string>& value) override;
+		void write(std::vector<Core::Time>& value) override;
+		void write(std::vector<std::complex<double> >& value) override;
+
+		void write(std::string& value) override;
+		void write(Seiscomp::Core::Time& value) override;
+
+
+	// ----------------------------------------------------------------------
+	//  Implementation
+	// ----------------------------------------------------------------------
+	private:
+		bool readVarInt(uint64_t &value);
+		void writeVarInt(uint64_t value);
+
+		template <typename T>
+		void readSigned(T &value);
+
+		template <typename T>
+		void writeSigned(T value);
+
+		//! Reads a count of elements which occupy at least elementSize
+		//! bytes each and invalidates the archive if the stream cannot
+		//! hold that many elements.
+		bool readSize(size_t &size, size_t elementSize = 1);
+
+		template <typename T>
+		void readIntVector(std::vector<T> &value);
+
+		template <typename T>
+		void writeIntVector(std::vector<T> &value);
+
+		template <typename T>
+		void readRawVector(std::vector<T> &value);
+
+		template <typename T>
+		void writeRawVector(std::vector<T> &value);
+
+		template <typename T>
+		void readObjectVector(std::vector<T> &value);
+
+		template <typename T>
+		void writeObjectVector(std::vector<T> &value);
+
+		void writeHeader();
+		bool readHeader();
+
+	private:
+		using StringTable = std::vector<std::string>;
+		using StringIndex = std::unordered_map<std::string, uint64_t>;
+
+		int                 _forceWriteVersion;
+		std::string         _error;
+		StringTable         _strings;
+		StringIndex         _stringIndex;
+		//! The previous time read or written, times are stored as deltas
+		Core::Time::Storage _lastTime{0};
+};
 
 
 }
@@ -120,6 +120,16 @@ class SC_SYSTEM_CORE_API GFArchive : public Core::BaseObject {
 
 		bool hasLocalTravelTimes() const { return _hasLocalTravelTimes; }
 
+		/**
+		 * @brief Enables linear interpolation between the two neighbouring
+		 *        distances of the archive grid. If disabled, which is the
+		 *        default, the Green's function of the nearest distance is
+		 *        returned. Archives without a distance grid ignore this
+		 *        setting.
+		 */
+		void setDistanceInterpolation(bool enable) { _distanceInterpolation = enable; }
+		bool distanceInterpolation() const { return _distanceInterpolation; }
+
 
 	public:
 		static GFArchive* Create(const char* service);
@@ -127,6 +137,7 @@ class SC_SYSTEM_CORE_API GFArchive : public Core::BaseObject {
 
 	protected:
 		bool _hasLocalTravelTimes{false};
+		bool _distanceInterpolation{false};
 };
 
 
@@ -0,0 +1,162 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#include <seiscomp/io/gfarchive/gfcache.h>
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <unordered_set>
+
+
+namespace Seiscomp {
+namespace IO {
+
+
+namespace {
+
+
+using Cache = Util::LRUCache<std::string, Core::GreensFunctionCPtr>;
+
+
+size_t bytes(const std::string &key, const Core::GreensFunctionCPtr &gf) {
+	size_t bytes = key.size();
+	for ( int i = 0; i < Core::GreensFunctionComponent::Quantity; ++i ) {
+		const Array *data = gf->data(i);
+		if ( data )
+			bytes += size_t(data->size()) * size_t(data->elementSize());
+	}
+	return bytes;
+}
+
+
+Cache &cache() {
+	static Cache instance(256*1024*1024, bytes);
+	return instance;
+}
+
+
+}
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Core::GreensFunctionCPtr GFCache::Get(const std::string &key,
+                                      const Loader &loader) {
+	// Decodes without holding the lock
+	return cache().get(key, loader);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+size_t GFCache::Prefetch(const Batch &batch, size_t threads) {
+	auto &c = cache();
+	std::vector<const Batch::value_type*> pending;
+
+	if ( !c.capacity() )
+		return 0;
+
+	{
+		std::unordered_set<std::string> keys;
+		for ( const auto &item : batch ) {
+			if ( c.contains(item.first) )
+				continue;
+			if ( !keys.insert(item.first).second )
+				continue;
+			pending.push_back(&item);
+		}
+	}
+
+	if ( pending.empty() )
+		return 0;
+
+	if ( !threads )
+		threads = std::max(1u, std::thread::hardware_concurrency());
+	threads = std::min(threads, pending.size());
+
+	std::atomic<size_t> next(0);
+	std::atomic<size_t> loaded(0);
+
+	auto worker = [&]() {
+		size_t i;
+		while ( (i = next++) < pending.size() ) {
+			Core::GreensFunctionCPtr gf = pending[i]->second();
+			if ( !gf )
+				continue;
+
+			++loaded;
+
+			c.countMiss();
+			c.insert(pending[i]->first, gf);
+		}
+	};
+
+	if ( threads == 1 )
+		worker();
+	else {
+		std::vector<std::thread> pool;
+		for ( size_t i = 0; i < threads; ++i )
+			pool.emplace_back(worker);
+		for ( auto &t : pool )
+			t.join();
+	}
+
+	return loaded;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void GFCache::SetCapacity(size_t bytes) {
+	cache().setCapacity(bytes);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void GFCache::Clear() {
+	cache().clear();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+GFCache::Statistics GFCache::GetStatistics() {
+	return cache().statistics();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+}
+}
@@ -0,0 +1,100 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#ifndef SEISCOMP_IO_GFARCHIVE_GFCACHE_H
+#define SEISCOMP_IO_GFARCHIVE_GFCACHE_H
+
+
+#include <seiscomp/core/greensfunction.h>
+#include <seiscomp/utils/lrucache.h>
+
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+namespace Seiscomp {
+namespace IO {
+
+
+/**
+ * @brief Process wide cache of decoded Green's functions.
+ *
+ * Moment tensor inversions request the same grid nodes of an archive over
+ * and over again. Archives look up the decoded Green's function of a grid
+ * node with a key which identifies the file and all parameters that were
+ * applied while decoding, e.g. the cut time span. Cached objects are shared
+ * and must not be modified, use Core::GreensFunction::clone to obtain a
+ * modifiable copy. The cache is bound by the memory of the stored samples
+ * and evicts the least recently used entries. All methods are thread-safe.
+ */
+class SC_SYSTEM_CORE_API GFCache {
+	// ----------------------------------------------------------------------
+	//  Public types
+	// ----------------------------------------------------------------------
+	public:
+		//! Decodes a Green's function, returns nullptr on error
+		using Loader = std::function<Core::GreensFunction*()>;
+		using Batch = std::vector<std::pair<std::string, Loader>>;
+
+		using Statistics = Util::LRUCacheStatistics;
+
+
+	// ----------------------------------------------------------------------
+	//  Public interface
+	// ----------------------------------------------------------------------
+	public:
+		/**
+		 * @brief Returns the Green's function for a key and calls the loader
+		 *        if it is not cached yet.
+		 * @return The shared Green's function or nullptr if the loader failed
+		 */
+		static Core::GreensFunctionCPtr Get(const std::string &key,
+		                                    const Loader &loader);
+
+		/**
+		 * @brief Loads all entries of a batch which are not cached yet in
+		 *        parallel.
+		 * @param batch The keys and loaders. Loaders are called concurrently
+		 *              and must therefore be thread-safe.
+		 * @param threads The maximum number of threads, 0 uses the number of
+		 *                available cores
+		 * @return The number of loaded entries
+		 */
+		static size_t Prefetch(const Batch &batch, size_t threads = 0);
+
+		//! Sets the maximum memory of all cached Green's functions in bytes.
+		//! A value of 0 disables the cache. The default is 256 MiB.
+		static void SetCapacity(size_t bytes);
+
+		//! Removes all cached Green's functions and resets the statistics.
+		static void Clear();
+
+		static Statistics GetStatistics();
+};
+
+
+}
+}
+
+
+#endif
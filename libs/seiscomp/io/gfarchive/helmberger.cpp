@@ -27,11 +27,14 @@
 #include <seiscomp/core/typedarray.h>
 #include <seiscomp/core/greensfunction.h>
 #include <seiscomp/core/system.h>
+#include <seiscomp/io/gfarchive/gfcache.h>
 #include <seiscomp/io/gfarchive/helmberger.h>
 #include <seiscomp/math/geo.h>
+#include <seiscomp/utils/files.h>
 
 #include <iostream>
 #include <fstream>
+#include <memory>
 
 #include <boost/version.hpp>
 #include <boost/filesystem/operations.hpp>
@@ -51,6 +54,14 @@ REGISTER_GFARCHIVE(HelmbergerArchive, "helmberger");
 namespace {
 
 
+std::string cacheKey(const std::string &file, const Core::TimeSpan &ts,
+                     double timeOfs) {
+	char tmp[64];
+	snprintf(tmp, sizeof(tmp), "#%.6f#%.6f", ts.length(), timeOfs);
+	return file + tmp;
+}
+
+
 void interpolate(Core::GreensFunction *gf1, const Core::GreensFunction *gf2,
                  double dist, double lower, double upper) {
 	double coeff2 = (dist-lower) / (upper-lower);
@@ -264,6 +275,7 @@ bool HelmbergerArchive::addRequest(const std::string &id,
 	_requests.back().model = model;
 	_requests.back().distance = Math::Geo::deg2km(dist);
 	_requests.back().depth = source.depth;
+	_prefetch = true;
 
 	return true;
 }
@@ -294,6 +306,7 @@ bool HelmbergerArchive::addRequest(const std::string &id,
 	_requests.back().distance = Math::Geo::deg2km(dist);
 	_requests.back().depth = source.depth;
 	_requests.back().timeSpan = span;
+	_prefetch = true;
 
 	return true;
 }
@@ -303,172 +316,230 @@ bool HelmbergerArchive::addRequest(const std::string &id,
 
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
-Core::GreensFunction *HelmbergerArchive::get() {
-	while ( !_requests.empty() ) {
-		Request req = _requests.front();
-		_requests.pop_front();
+bool HelmbergerArchive::support(const Request &req, Support &s) const {
+	int distKm = (int)req.distance;
+	int iDepth = (int)req.depth;
+
+	ModelMap::const_iterator mit = _models.find(req.model);
+	if ( mit == _models.end() ) {
+		SEISCOMP_DEBUG("Request dropped, model %s not available", req.model);
+		return false;
+	}
 
-		std::string modelprefix = req.model/* + "_efl"*/;
-		std::string pathprefix = _baseDirectory + "/" + modelprefix + "/" +
-		                         modelprefix/* + "_tmp"*/;
+	DoubleList::const_iterator lbdist = mit->second.distances.lower_bound(distKm);
+	DoubleList::const_iterator ubdist = lbdist--;
+	DoubleList::const_iterator lbdep = mit->second.depths.lower_bound(req.depth);
+	DoubleList::const_iterator ubdep = lbdep--;
 
-		int distKm = (int)req.distance;
-		int iDepth = (int)req.depth;
+	double dist1, dist2, dist;
+	double dep1, dep2, dep;
 
-		ModelMap::iterator mit = _models.find(req.model);
-		if ( mit == _models.end() ) {
-			SEISCOMP_DEBUG("Request dropped, model %s not available", req.model);
-			continue;
-		}
+	// Distance is lower than the first stored value
+	if ( ubdist == mit->second.distances.begin() ) {
+		dist1 = *ubdist;
+		++ubdist;
+		dist2 = *ubdist;
 
-		DoubleList::iterator lbdist = mit->second.distances.lower_bound(distKm);
-		DoubleList::iterator ubdist = lbdist--;
-		DoubleList::iterator lbdep = mit->second.depths.lower_bound(req.depth);
-		DoubleList::iterator ubdep = lbdep--;
+		double maxDistError = dist2 - dist1;
+		if ( dist1 - distKm > maxDistError ) {
+			SEISCOMP_DEBUG("Distance too low: %d km", distKm);
+			return false;
+		}
 
-		double dist1, dist2, dist;
-		double dep1, dep2, dep;
+		dist2 = dist1;
+	}
+	// Distance is greater than the last stored value
+	else if ( ubdist == mit->second.distances.end() ) {
+		dist2 = *lbdist;
+		--lbdist;
+		dist1 = *lbdist;
+
+		double maxDistError = dist2 - dist1;
+		if ( distKm - dist2 > maxDistError ) {
+			SEISCOMP_DEBUG("Distance too high: %d km", distKm);
+			return false;
+		}
 
-		// Distance is lower than the first stored value
-		if ( ubdist == mit->second.distances.begin() ) {
-			dist1 = *ubdist;
-			++ubdist;
-			dist2 = *ubdist;
+		dist2 = dist1;
+	}
+	else {
+		dist1 = *lbdist;
+		dist2 = *ubdist;
+	}
 
-			double maxDistError = dist2 - dist1;
-			if ( dist1 - distKm > maxDistError ) {
-				SEISCOMP_DEBUG("Distance too low: %d km", distKm);
-				continue;
-			}
+	// Depth is lower than the first stored value
+	if ( ubdep == mit->second.depths.begin() ) {
+		dep1 = *ubdep;
+		++ubdep;
+		dep2 = *ubdep;
 
-			dist2 = dist1;
+		double maxDepError = dep2 - dep1;
+		if ( dep1 - iDepth > maxDepError ) {
+			SEISCOMP_DEBUG("Depth too low: %d km", iDepth);
+			return false;
 		}
-		// Distance is greater than the last stored value
-		else if ( ubdist == mit->second.distances.end() ) {
-			dist2 = *lbdist;
-			--lbdist;
-			dist1 = *lbdist;
-
-			double maxDistError = dist2 - dist1;
-			if ( distKm - dist2 > maxDistError ) {
-				SEISCOMP_DEBUG("Distance too high: %d km", distKm);
-				continue;
-			}
 
-			dist2 = dist1;
-		}
-		else {
-			dist1 = *lbdist;
-			dist2 = *ubdist;
+		dep2 = dep1;
+
+	}
+	// Depth is greater than the last stored value
+	else if ( ubdep == mit->second.depths.end() ) {
+		dep2 = *lbdep;
+		--lbdep;
+		dep1 = *lbdep;
+
+		double maxDepError = dep2 - dep1;
+		if ( iDepth - dep2 > maxDepError ) {
+			SEISCOMP_DEBUG("Depth too high: %d km", iDepth);
+			return false;
 		}
 
-		// Depth is lower than the first stored value
-		if ( ubdep == mit->second.depths.begin() ) {
-			dep1 = dep2 = *ubdep;
+		dep2 = dep1;
+	}
+	else {
+		dep1 = *lbdep;
+		dep2 = *ubdep;
+	}
 
-			dep1 = *ubdep;
-			++ubdep;
-			dep2 = *ubdep;
+	if ( fabs(distKm - dist1) < fabs(distKm - dist2) ) {
+		dist = dist1;
+	}
+	else {
+		dist = dist2;
+	}
 
-			double maxDepError = dep2 - dep1;
-			if ( dep1 - iDepth > maxDepError ) {
-				SEISCOMP_DEBUG("Depth too low: %d km", iDepth);
-				continue;
-			}
+	if ( fabs(iDepth - dep1) < fabs(iDepth - dep2) ) {
+		dep = dep1;
+	}
+	else {
+		dep = dep2;
+	}
 
-			dep2 = dep1;
+	s.distance = distKm;
 
-		}
-		// Depth is greater than the last stored value
-		else if ( ubdep == mit->second.depths.end() ) {
-			dep2 = *lbdep;
-			--lbdep;
-			dep1 = *lbdep;
-
-			double maxDepError = dep2 - dep1;
-			if ( iDepth - dep2 > maxDepError ) {
-				SEISCOMP_DEBUG("Depth too high: %d km", iDepth);
-				continue;
-			}
+	if ( _distanceInterpolation ) {
+		s.dist1 = dist1;
+		s.dist2 = dist2;
+	}
+	else
+		s.dist1 = s.dist2 = dist;
 
-			dep2 = dep1;
-		}
-		else {
-			dep1 = *lbdep;
-			dep2 = *ubdep;
-		}
+	s.dep = dep;
+
+	double velocity = mit->second.velocity;
+	s.timeOffset = velocity != 0 ? dist / velocity : 0;
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
-		if ( fabs(distKm - dist1) < fabs(distKm - dist2) ) {
-			dist = dist1;
-		}
-		else {
-			dist = dist2;
-		}
 
-		if ( fabs(iDepth - dep1) < fabs(iDepth - dep2) ) {
-			dep = dep1;
-		}
-		else {
-			dep = dep2;
-		}
 
-		/*
-		if ( fabs(depError) > maxDepError || fabs(distError) > maxDistError ) {
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+std::string HelmbergerArchive::file(const std::string &model,
+                                    double dist, double dep) const {
+	std::string modelprefix = model/* + "_efl"*/;
+	return _baseDirectory + "/" + modelprefix + "/" + modelprefix/* + "_tmp"*/ +
+	       Core::toString(dist) + "d" + Core::toString(dep) + ".disp";
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Core::GreensFunctionCPtr HelmbergerArchive::load(const std::string &path,
+                                                 const Core::TimeSpan &ts,
+                                                 double timeOfs) {
+	return GFCache::Get(cacheKey(path, ts, timeOfs), [&]() {
+		return read(path, ts, timeOfs);
+	});
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void HelmbergerArchive::prefetch() {
+	GFCache::Batch batch;
+
+	for ( const Request &req : _requests ) {
+		Support s;
+		if ( !support(req, s) ) continue;
+
+		Core::TimeSpan ts = _defaultTimespan;
+		if ( req.timeSpan ) ts = req.timeSpan;
+
+		for ( double dist : { s.dist1, s.dist2 } ) {
+			std::string path = file(req.model, dist, s.dep);
+			double ofs = s.timeOffset;
+			batch.emplace_back(cacheKey(path, ts, ofs), [this, path, ts, ofs]() {
+				return read(path, ts, ofs);
+			});
 		}
-		*/
+	}
+
+	GFCache::Prefetch(batch);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Core::GreensFunction *HelmbergerArchive::get() {
+	// Decode all files of the pending requests in parallel once
+	if ( _prefetch ) {
+		prefetch();
+		_prefetch = false;
+	}
+
+	while ( !_requests.empty() ) {
+		Request req = _requests.front();
+		_requests.pop_front();
+
+		Support s;
+		if ( !support(req, s) ) continue;
 
 		Core::TimeSpan ts = _defaultTimespan;
 		if ( req.timeSpan ) ts = req.timeSpan;
 
-		double ofs = _models[req.model].velocity != 0?dist / _models[req.model].velocity:0;
+		std::string file1 = file(req.model, s.dist1, s.dep);
+		Core::GreensFunctionCPtr gf1 = load(file1, ts, s.timeOffset);
 
-		if ( dist1 == dist || dist2 == dist ) {
-			std::string file = pathprefix + Core::toString(dist) + "d" + Core::toString(dep) + ".disp";
-			//std::cout << file << std::endl;
+		if ( s.dist1 == s.dist2 ) {
+			if ( !gf1 ) continue;
 
-			Core::GreensFunction *gf = read(file, ts, ofs);
-			if ( gf ) {
-				gf->setId(req.id);
-				gf->setModel(req.model);
-				gf->setDepth(dep);
-				gf->setDistance(dist);
-				//SEISCOMP_DEBUG("GF: dist = %.2f, ofs = %.2f", gf->distance(), gf->timeOffset());
-				return gf;
-			}
+			// Cached Green's functions are shared, work on a copy
+			Core::GreensFunction *gf = gf1->clone();
+			gf->setId(req.id);
+			gf->setModel(req.model);
+			gf->setDepth(s.dep);
+			gf->setDistance(s.dist1);
+			//SEISCOMP_DEBUG("GF: dist = %.2f, ofs = %.2f", gf->distance(), gf->timeOffset());
+			return gf;
 		}
-		else {
-			std::string file = pathprefix + Core::toString(dist1) + "d" + Core::toString(dep) + ".disp";
-			Core::GreensFunction *gf1 = read(file, ts, ofs);
 
-			file = pathprefix + Core::toString(dist2) + "d" + Core::toString(dep) + ".disp";
-			Core::GreensFunction *gf2 = read(file, ts, ofs);
+		std::string file2 = file(req.model, s.dist2, s.dep);
+		Core::GreensFunctionCPtr gf2 = load(file2, ts, s.timeOffset);
 
-			if ( gf1 && gf2 ) {
-				gf1->setId(req.id);
-				gf1->setModel(req.model);
-				gf1->setDepth(dep);
-				gf1->setDistance(distKm);
+		if ( !gf1 || !gf2 ) {
+			SEISCOMP_ERROR("Unable to read %s or %s", file1, file2);
+			continue;
+		}
 
-				interpolate(gf1, gf2, distKm, dist1, dist2);
-				delete gf2;
+		Core::GreensFunction *gf = gf1->clone();
+		gf->setId(req.id);
+		gf->setModel(req.model);
+		gf->setDepth(s.dep);
+		gf->setDistance(s.distance);
 
-				//SEISCOMP_DEBUG("GF: dist = %.2f, ofs = %.2f", gf1->distance(), gf1->timeOffset());
-				return gf1;
-			}
-			else {
-				SEISCOMP_ERROR("Unable to read %s or %s",
-				               pathprefix + Core::toString(dist1) + "d" + Core::toString(dep) + ".disp",
-				               file);
-				if ( gf1 ) {
-					delete gf1;
-				}
-				if ( gf2 ) {
-					delete gf2;
-				}
-			}
-		}
+		interpolate(gf, gf2.get(), s.distance, s.dist1, s.dist2);
 
-		//SEISCOMP_DEBUG("No greensfunction found");
+		//SEISCOMP_DEBUG("GF: dist = %.2f, ofs = %.2f", gf->distance(), gf->timeOffset());
+		return gf;
 	}
 
 	return nullptr;
@@ -485,12 +556,18 @@ Core::GreensFunction* HelmbergerArchive::read(const std::string &file,
 	if ( timeOfs >= (double)ts )
 		return nullptr;
 
-	std::ifstream ifs(file.c_str());
-	if ( !ifs.good() ) {
+	Util::MappedFile mapped;
+	if ( !mapped.open(file) ) {
 		//SEISCOMP_DEBUG("%s: not found", file.c_str());
 		return nullptr;
 	}
 
+	// The stream reads directly from the mapped pages
+	std::unique_ptr<std::streambuf> buf(
+		Util::bytesToStreambuf(const_cast<char*>(mapped.data()), mapped.size())
+	);
+	std::istream ifs(buf.get());
+
 	int components = 0;
 	ifs >> components;
 	if ( components < 8 ) {
@@ -23,6 +23,7 @@
 #define SEISCOMP_IO_GFARCHIVE_HELMBERGER_H
 
 
+#include <seiscomp/core/greensfunction.h>
 #include <seiscomp/io/gfarchive.h>
 
 #include <string>
@@ -84,7 +85,33 @@ class SC_SYSTEM_CORE_API HelmbergerArchive : public GFArchive {
 	//  Private member
 	// ----------------------------------------------------------------------
 	private:
+		struct Request {
+			Core::TimeSpan timeSpan;
+			std::string    id;
+			std::string    model;
+			double         distance;
+			double         depth;
+		};
+
+		//! The grid nodes used to compute the Green's function of a request
+		struct Support {
+			int    distance;
+			//! The neighbouring distances, equal if no interpolation in
+			//! distance is performed
+			double dist1;
+			double dist2;
+			//! The nearest depth
+			double dep;
+			double timeOffset;
+		};
+
 		bool hasModel(const std::string &) const;
+		bool support(const Request &req, Support &s) const;
+		Core::GreensFunctionCPtr load(const std::string &file,
+		                              const Core::TimeSpan &ts, double timeOfs);
+		void prefetch();
+
+		std::string file(const std::string &model, double dist, double dep) const;
 		Core::GreensFunction* read(const std::string &file,
 		                           const Core::TimeSpan &ts, double timeOfs);
 
@@ -93,13 +120,6 @@ class SC_SYSTEM_CORE_API HelmbergerArchive : public GFArchive {
 	//  Private member
 	// ----------------------------------------------------------------------
 	private:
-		struct Request {
-			Core::TimeSpan timeSpan;
-			std::string    id;
-			std::string    model;
-			double         distance;
-			double         depth;
-		};
 
 		typedef std::list<Request> RequestList;
 		typedef std::set<double> DoubleList;
@@ -116,6 +136,7 @@ class SC_SYSTEM_CORE_API HelmbergerArchive : public GFArchive {
 		std::string        _baseDirectory;
 		Core::TimeSpan     _defaultTimespan;
 		RequestList        _requests;
+		bool               _prefetch{false};
 };
 
 }
@@ -27,14 +27,17 @@
 #include <seiscomp/core/greensfunction.h>
 #include <seiscomp/core/system.h>
 #include <seiscomp/math/geo.h>
+#include <seiscomp/io/gfarchive/gfcache.h>
 #include <seiscomp/io/gfarchive/sc3gf1d.h>
 #include <seiscomp/io/records/sacrecord.h>
+#include <seiscomp/utils/files.h>
 
 #include <rapidjson/document.h>
 #include <rapidjson/istreamwrapper.h>
 
 #include <iostream>
 #include <fstream>
+#include <memory>
 
 #include <boost/version.hpp>
 #include <boost/filesystem/operations.hpp>
@@ -94,34 +97,10 @@ namespace IO {
 namespace {
 
 
-double getValue(const std::map<double, double> &map, double ref) {
-	// Get element after the distance
-	std::map<double, double>::const_iterator it_to = map.lower_bound(ref);
-	std::map<double, double>::const_iterator it_from = it_to;
-
-	// After supported key range
-	if ( it_to == map.end() )
-		return -1;
-
-	double toRef = it_to->first;
-	double fromRef = toRef;
-
-	// Before supported key range
-	if ( it_to == map.begin() ) {
-		if ( toRef > ref )
-			return -1;
-
-		return it_to->second;
-	}
-
-	--it_from;
-	fromRef = it_from->first;
-
-	double ref1 = it_from->second;
-	double ref2 = it_to->second;
-
-	// Interpolate value
-	return (ref1 * (toRef-ref) + ref2 * (ref-fromRef)) / (toRef - fromRef);
+std::string cacheKey(const std::string &file, const Core::TimeSpan &ts) {
+	char tmp[32];
+	snprintf(tmp, sizeof(tmp), "#%.6f", ts.length());
+	return file + tmp;
 }
 
 
@@ -452,6 +431,7 @@ bool SC3GF1DArchive::addRequest(const std::string &id,
 	_requests.back().model = model;
 	_requests.back().distance = Math::Geo::deg2km(dist);
 	_requests.back().depth = source.depth;
+	_prefetch = true;
 
 	return true;
 }
@@ -481,6 +461,7 @@ bool SC3GF1DArchive::addRequest(const std::string &id,
 	_requests.back().distance = Math::Geo::deg2km(dist);
 	_requests.back().depth = source.depth;
 	_requests.back().timeSpan = span;
+	_prefetch = true;
 
 	return true;
 }
@@ -490,278 +471,249 @@ bool SC3GF1DArchive::addRequest(const std::string &id,
 
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
-Core::GreensFunction* SC3GF1DArchive::get() {
-	while ( !_requests.empty() ) {
-		Request req = _requests.front();
-		_requests.pop_front();
-
-		std::string pathprefix = _baseDirectory + "/" + req.model + "/";
+bool SC3GF1DArchive::support(const Request &req, Support &s) const {
+	int distKm = (int)req.distance;
+	double fDepth = req.depth;
+
+	ModelMap::const_iterator mit = _models.find(req.model);
+	if ( mit == _models.end() ) return false;
+
+	DoubleList::const_iterator lbdist = mit->second.distances.lower_bound(distKm);
+	DoubleList::const_iterator ubdist = lbdist--;
+	DoubleList::const_iterator lbdep = mit->second.depths.lower_bound(req.depth);
+	DoubleList::const_iterator ubdep = lbdep--;
+
+	double dist1, dist2, dist;
+	double dep1, dep2, dep;
+
+	// Distance is lower than the first stored value
+	if ( ubdist == mit->second.distances.begin() ) {
+		dist1 = *ubdist;
+		++ubdist;
+		if ( ubdist != mit->second.distances.end() )
+			dist2 = *ubdist;
+		else
+			dist2 = dist1;
 
-		int distKm = (int)req.distance;
-		double fDepth = req.depth;
+		double maxDistError = dist2 - dist1;
+		if ( dist1 - distKm > maxDistError ) {
+			SEISCOMP_DEBUG("Distance too low: %d km", distKm);
+			return false;
+		}
 
-		ModelMap::iterator mit = _models.find(req.model);
-		if ( mit == _models.end() ) continue;
+		dist2 = dist1;
+	}
+	// Distance is greater than the last stored value
+	else if ( ubdist == mit->second.distances.end() ) {
+		dist2 = *lbdist;
+		--lbdist;
+		dist1 = *lbdist;
+
+		double maxDistError = dist2 - dist1;
+		if ( distKm - dist2 > maxDistError ) {
+			SEISCOMP_DEBUG("Distance too high: %d km", distKm);
+			return false;
+		}
 
-		DoubleList::iterator lbdist = mit->second.distances.lower_bound(distKm);
-		DoubleList::iterator ubdist = lbdist--;
-		DoubleList::iterator lbdep = mit->second.depths.lower_bound(req.depth);
-		DoubleList::iterator ubdep = lbdep--;
+		dist2 = dist1;
+	}
+	else {
+		dist1 = *lbdist;
+		dist2 = *ubdist;
+	}
 
-		double dist1, dist2, dist;
-		double dep1, dep2, dep;
+	// Depth is lower than the first stored value
+	if ( ubdep == mit->second.depths.begin() ) {
+		dep1 = *ubdep;
+		++ubdep;
+		if ( ubdep != mit->second.depths.end() )
+			dep2 = *ubdep;
+		else
+			dep2 = dep1;
 
-		// Distance is lower than the first stored value
-		if ( ubdist == mit->second.distances.begin() ) {
-			dist1 = *ubdist;
-			++ubdist;
-			if ( ubdist != mit->second.distances.end() )
-				dist2 = *ubdist;
-			else
-				dist2 = dist1;
+		double maxDepError = dep2 - dep1;
+		if ( dep1 - fDepth > maxDepError ) {
+			SEISCOMP_DEBUG("Depth too low: %f km < %d km", fDepth, (int)dep1);
+			return false;
+		}
 
-			double maxDistError = dist2 - dist1;
-			if ( dist1 - distKm > maxDistError ) {
-				SEISCOMP_DEBUG("Distance too low: %d km", distKm);
-				continue;
-			}
+		dep2 = dep1;
 
-			dist2 = dist1;
+	}
+	// Depth is greater than the last stored value
+	else if ( ubdep == mit->second.depths.end() ) {
+		dep2 = *lbdep;
+		--lbdep;
+		dep1 = *lbdep;
+
+		double maxDepError = dep2 - dep1;
+		if ( fDepth - dep2 > maxDepError ) {
+			SEISCOMP_DEBUG("Depth too high: %f km", fDepth);
+			return false;
 		}
-		// Distance is greater than the last stored value
-		else if ( ubdist == mit->second.distances.end() ) {
-			dist2 = *lbdist;
-			--lbdist;
-			dist1 = *lbdist;
-
-			double maxDistError = dist2 - dist1;
-			if ( distKm - dist2 > maxDistError ) {
-				SEISCOMP_DEBUG("Distance too high: %d km", distKm);
-				continue;
-			}
 
-			dist2 = dist1;
-		}
-		else {
-			dist1 = *lbdist;
-			dist2 = *ubdist;
-		}
+		dep2 = dep1;
+	}
+	else {
+		dep1 = *lbdep;
+		dep2 = *ubdep;
+	}
 
-		// Depth is lower than the first stored value
-		if ( ubdep == mit->second.depths.begin() ) {
-			dep1 = dep2 = *ubdep;
+	if ( fabs(distKm - dist1) < fabs(distKm - dist2) ) {
+		dist = dist1;
+	}
+	else {
+		dist = dist2;
+	}
 
-			dep1 = *ubdep;
-			++ubdep;
-			if ( ubdep != mit->second.depths.end() )
-				dep2 = *ubdep;
-			else
-				dep2 = dep1;
+	if ( fabs(fDepth - dep1) < fabs(fDepth - dep2) ) {
+		dep = dep1;
+	}
+	else {
+		dep = dep2;
+	}
 
-			double maxDepError = dep2 - dep1;
-			if ( dep1 - fDepth > maxDepError ) {
-				SEISCOMP_DEBUG("Depth too low: %f km < %d km", fDepth, (int)dep1);
-				continue;
-			}
+	s.distance = distKm;
 
-			dep2 = dep1;
+	if ( _distanceInterpolation ) {
+		s.dist1 = dist1;
+		s.dist2 = dist2;
+	}
+	else
+		s.dist1 = s.dist2 = dist;
 
-		}
-		// Depth is greater than the last stored value
-		else if ( ubdep == mit->second.depths.end() ) {
-			dep2 = *lbdep;
-			--lbdep;
-			dep1 = *lbdep;
-
-			double maxDepError = dep2 - dep1;
-			if ( fDepth - dep2 > maxDepError ) {
-				SEISCOMP_DEBUG("Depth too high: %f km", fDepth);
-				continue;
-			}
+	s.dep = dep;
+	s.altDep = dep;
+	if ( dep != dep1 )
+		s.altDep = dep1;
+	else if ( dep != dep2 )
+		s.altDep = dep2;
 
-			dep2 = dep1;
-		}
-		else {
-			dep1 = *lbdep;
-			dep2 = *ubdep;
-		}
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
-		if ( fabs(distKm - dist1) < fabs(distKm - dist2) ) {
-			dist = dist1;
-		}
-		else {
-			dist = dist2;
-		}
 
-		if ( fabs(fDepth - dep1) < fabs(fDepth - dep2) ) {
-			dep = dep1;
-		}
-		else {
-			dep = dep2;
-		}
 
-		/*
-		if ( fabs(depError) > maxDepError || fabs(distError) > maxDistError ) {
-		}
-		*/
 
-		// For greens functions for bilinear interpolation
-		Core::GreensFunction *gf_11;
-		Core::GreensFunction *gf_12;
-		Core::GreensFunction *gf_21;
-		Core::GreensFunction *gf_22;
-
-		if ( (dist == dist1) || (dist == dist2) || (dist1 == dist2) ) {
-			char dep_str[10], dist_str[10];
-			snprintf(dep_str, 10, "%04d", (int)dep*10);
-			snprintf(dist_str, 10, "%05d", (int)dist);
-			std::string file = pathprefix + dep_str + "/" + dist_str + "/" + dep_str + "." + dist_str + ".";
-
-			Core::TimeSpan ts = _defaultTimespan;
-			if ( req.timeSpan ) ts = req.timeSpan;
-
-			//double ofs = dist / _models[req.model].velocity;
-			double ofs = 0;
-
-			Core::GreensFunction *gf = read(file, ts, ofs);
-			if ( gf ) {
-				gf->setId(req.id);
-				gf->setModel(req.model);
-				gf->setDepth(dep);
-				gf->setDistance(dist);
-				gf_11 = gf_12 = gf;
-			}
-			else {
-				SEISCOMP_ERROR("Unable to read %s", file.c_str());
-				continue;
-			}
-		}
-		else {
-			char dep_str[10], dist1_str[10], dist2_str[10];
-			snprintf(dep_str, 10, "%04d", (int)dep*10);
-			snprintf(dist1_str, 10, "%05d", (int)dist1);
-			snprintf(dist2_str, 10, "%05d", (int)dist2);
-			std::string file1 = pathprefix + dep_str + "/" + dist1_str + "/" + dep_str + "." + dist1_str + ".";
-			std::string file2 = pathprefix + dep_str + "/" + dist2_str + "/" + dep_str + "." + dist2_str + ".";
-
-			Core::TimeSpan ts = _defaultTimespan;
-			if ( req.timeSpan ) ts = req.timeSpan;
-
-			//double ofs = dist / _models[req.model].velocity;
-			double ofs = 0;
-
-			Core::GreensFunction *gf1 = read(file1, ts, ofs);
-			Core::GreensFunction *gf2 = read(file2, ts, ofs);
-			if ( gf1 && gf2 ) {
-				gf1->setId(req.id);
-				gf1->setModel(req.model);
-				gf1->setDepth(dep);
-				gf1->setDistance(distKm);
-
-				gf_11 = gf1;
-				gf_12 = gf2;
-			}
-			else {
-				SEISCOMP_ERROR("Unable to read %s or %s",
-				               file1.c_str(), file2.c_str());
-				if ( gf1 ) delete gf1;
-				if ( gf2 ) delete gf2;
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+std::string SC3GF1DArchive::file(const std::string &model,
+                                 double dist, double dep) const {
+	char dep_str[10], dist_str[10];
+	snprintf(dep_str, 10, "%04d", (int)dep*10);
+	snprintf(dist_str, 10, "%05d", (int)dist);
+	return _baseDirectory + "/" + model + "/" + dep_str + "/" + dist_str + "/" + dep_str + "." + dist_str + ".";
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
-				continue;
-			}
-		}
 
 
-		double alt_dep = dep;
-		if ( dep != dep1 )
-			alt_dep = dep1;
-		else if ( dep != dep2 )
-			alt_dep = dep2;
 
-		if ( dep == alt_dep ) {
-			gf_21 = gf_11;
-			gf_22 = gf_12;
-		}
-		else {
-			if ( (dist == dist1) || (dist == dist2) || (dist1 == dist2) ) {
-				char dep_str[10], dist_str[10];
-				snprintf(dep_str, 10, "%04d", (int)alt_dep*10);
-				snprintf(dist_str, 10, "%05d", (int)dist);
-				std::string file = pathprefix + dep_str + "/" + dist_str + "/" + dep_str + "." + dist_str + ".";
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Core::GreensFunctionCPtr SC3GF1DArchive::load(const std::string &model,
+                                              double dist, double dep,
+                                              const Core::TimeSpan &ts) {
+	std::string path = file(model, dist, dep);
+	Core::GreensFunctionCPtr gf = GFCache::Get(cacheKey(path, ts), [&]() {
+		return read(path, ts, 0);
+	});
+
+	if ( !gf )
+		SEISCOMP_ERROR("Unable to read %s", path.c_str());
+
+	return gf;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
-				Core::TimeSpan ts = _defaultTimespan;
-				if ( req.timeSpan ) ts = req.timeSpan;
 
-				//double ofs = dist / _models[req.model].velocity;
-				double ofs = 0;
 
-				Core::GreensFunction *gf = read(file, ts, ofs);
-				if ( gf ) {
-					gf_21 = gf_22 = gf;
-				}
-				else {
-					if ( gf_11 ) delete gf_11;
-					if ( gf_12 && (gf_11 != gf_12) ) delete gf_12;
 
-					SEISCOMP_ERROR("Unable to read %s", file.c_str());
-					continue;
-				}
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void SC3GF1DArchive::prefetch() {
+	GFCache::Batch batch;
+
+	for ( const Request &req : _requests ) {
+		Support s;
+		if ( !support(req, s) ) continue;
+
+		Core::TimeSpan ts = _defaultTimespan;
+		if ( req.timeSpan ) ts = req.timeSpan;
+
+		for ( double dep : { s.dep, s.altDep } ) {
+			for ( double dist : { s.dist1, s.dist2 } ) {
+				std::string path = file(req.model, dist, dep);
+				std::string key = cacheKey(path, ts);
+				batch.emplace_back(key, [this, path, ts]() {
+					return read(path, ts, 0);
+				});
 			}
-			else {
-				char dep_str[10], dist1_str[10], dist2_str[10];
-				snprintf(dep_str, 10, "%04d", (int)alt_dep*10);
-				snprintf(dist1_str, 10, "%05d", (int)dist1);
-				snprintf(dist2_str, 10, "%05d", (int)dist2);
-				std::string file1 = pathprefix + dep_str + "/" + dist1_str + "/" + dep_str + "." + dist1_str + ".";
-				std::string file2 = pathprefix + dep_str + "/" + dist2_str + "/" + dep_str + "." + dist2_str + ".";
-
-				Core::TimeSpan ts = _defaultTimespan;
-				if ( req.timeSpan ) ts = req.timeSpan;
-
-				//double ofs = dist / _models[req.model].velocity;
-				double ofs = 0;
-
-				Core::GreensFunction *gf1 = read(file1, ts, ofs);
-				Core::GreensFunction *gf2 = read(file2, ts, ofs);
-				if ( gf1 && gf2 ) {
-					gf_21 = gf1;
-					gf_22 = gf2;
-				}
-				else {
-					SEISCOMP_ERROR("Unable to read %s or %s",
-					               file1.c_str(), file2.c_str());
-					if ( gf1 ) delete gf1;
-					if ( gf2 ) delete gf2;
+		}
+	}
 
-					if ( gf_11 ) delete gf_11;
-					if ( gf_12 && (gf_11 != gf_12) ) delete gf_12;
+	GFCache::Prefetch(batch);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
-					continue;
-				}
-			}
 
-			gf_11->setDepth(fDepth);
-		}
 
-		if ( !interpolate(gf_11, gf_12, gf_21, gf_22,
-		                  distKm, dist1, dist2, fDepth, dep, alt_dep) ) {
-			SEISCOMP_ERROR("Interpolation for %d / %f failed", distKm, fDepth);
 
-			if ( gf_11 ) delete gf_11;
-			if ( gf_12 && (gf_11 != gf_12) ) delete gf_12;
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Core::GreensFunction* SC3GF1DArchive::get() {
+	// Decode all grid nodes of the pending requests in parallel once
+	if ( _prefetch ) {
+		prefetch();
+		_prefetch = false;
+	}
+
+	while ( !_requests.empty() ) {
+		Request req = _requests.front();
+		_requests.pop_front();
+
+		Support s;
+		if ( !support(req, s) ) continue;
+
+		Core::TimeSpan ts = _defaultTimespan;
+		if ( req.timeSpan ) ts = req.timeSpan;
+
+		// For greens functions for bilinear interpolation
+		Core::GreensFunctionCPtr gf_11, gf_12, gf_21, gf_22;
+
+		gf_11 = load(req.model, s.dist1, s.dep, ts);
+		if ( !gf_11 ) continue;
+
+		gf_12 = s.dist1 == s.dist2 ? gf_11 : load(req.model, s.dist2, s.dep, ts);
+		if ( !gf_12 ) continue;
 
-			if ( gf_21 && ((gf_21 != gf_11) && (gf_21 != gf_12)) ) delete gf_21;
-			if ( gf_22 && ((gf_22 != gf_11) && (gf_22 != gf_12) && (gf_22 != gf_21)) ) delete gf_22;
+		if ( s.dep == s.altDep ) {
+			gf_21 = gf_11;
+			gf_22 = gf_12;
 		}
 		else {
-			if ( gf_12 && (gf_12 != gf_11) ) delete gf_12;
-			if ( gf_21 && ((gf_21 != gf_11) && (gf_21 != gf_12)) ) delete gf_21;
-			if ( gf_22 && ((gf_22 != gf_11) && (gf_22 != gf_12) && (gf_22 != gf_21)) ) delete gf_22;
+			gf_21 = load(req.model, s.dist1, s.altDep, ts);
+			if ( !gf_21 ) continue;
 
-			return gf_11;
+			gf_22 = s.dist1 == s.dist2 ? gf_21 : load(req.model, s.dist2, s.altDep, ts);
+			if ( !gf_22 ) continue;
 		}
 
-		SEISCOMP_DEBUG("No greensfunction found");
+		// Cached Green's functions are shared, work on a copy
+		Core::GreensFunction *gf = gf_11->clone();
+		gf->setId(req.id);
+		gf->setModel(req.model);
+		gf->setDepth(s.dep == s.altDep ? s.dep : req.depth);
+		gf->setDistance(s.dist1 == s.dist2 ? s.dist1 : s.distance);
+
+		if ( (gf_12 == gf_11) && (gf_21 == gf_11) )
+			return gf;
+
+		if ( !interpolate(gf, gf_12.get(), gf_21.get(), gf_22.get(),
+		                  s.distance, s.dist1, s.dist2, req.depth, s.dep, s.altDep) ) {
+			SEISCOMP_ERROR("Interpolation for %d / %f failed", s.distance, req.depth);
+			delete gf;
+			continue;
+		}
+
+		return gf;
 	}
 
 	return nullptr;
@@ -801,15 +753,22 @@ Core::GreensFunction *SC3GF1DArchive::read(const std::string &file,
 
 	for ( int i = 0; i < GF_COMPS; ++i ) {
 		std::string filename = file + comps[i].toString();
-		std::ifstream ifs(filename .c_str());
-		if ( !ifs.good() ) {
+		Util::MappedFile mapped;
+		if ( !mapped.open(filename) ) {
 			SEISCOMP_DEBUG("Green's functions - %s: not found", filename.c_str());
+			if ( gf ) delete gf;
 			return nullptr;
 		}
 
+		// The stream reads directly from the mapped pages
+		std::unique_ptr<std::streambuf> buf(
+			Util::bytesToStreambuf(const_cast<char*>(mapped.data()), mapped.size())
+		);
+		std::istream is(buf.get());
+
 		IO::SACRecord sac;
 		try {
-			sac.read(ifs);
+			sac.read(is);
 		}
 		catch ( std::exception &exc ) {
 			SEISCOMP_ERROR("%s: %s", filename.c_str(), exc.what());
@@ -1029,6 +988,9 @@ OPT(double) SC3GF1DArchive::getTravelTime(const std::string &phase,
 				return Core::None;
 			}
 
+			for ( const std::string &ph : phaseMap )
+				config.travelTimes[ph].setAxes(distanceMap, depthMap);
+
 			for ( rapidjson::SizeType i = 0; i < vTT.Size(); ++i ) {
 				const rapidjson::Value &distances = vTT[i];
 				if ( !distances.IsArray() ) {
@@ -1068,7 +1030,7 @@ OPT(double) SC3GF1DArchive::getTravelTime(const std::string &phase,
 						}
 
 						// Populate table
-						config.travelTimes[phaseMap[k]][distanceMap[j]][depthMap[i]] = tt.GetDouble();
+						config.travelTimes[phaseMap[k]].set(distanceMap[j], depthMap[i], tt.GetDouble());
 					}
 				}
 			}
@@ -1094,8 +1056,6 @@ OPT(double) SC3GF1DArchive::getTravelTime(const std::string &phase,
 			return Core::None;
 		}
 
-		TTDistance &distanceDepths = pit->second;
-
 		double dist, az, baz;
 		Math::Geo::delazi_wgs84(
 			source.lat, source.lon,
@@ -1103,41 +1063,7 @@ OPT(double) SC3GF1DArchive::getTravelTime(const std::string &phase,
 			&dist, &az, &baz
 		);
 
-		dist = Math::Geo::deg2km(dist);
-
-		// Get element after the distance
-		TTDistance::iterator it_dist_to = distanceDepths.lower_bound(dist);
-		TTDistance::iterator it_dist_from = it_dist_to;
-
-		// Distance out of range
-		if ( it_dist_to == distanceDepths.end() ) {
-			return Core::None;
-		}
-
-		double toDist = it_dist_to->first;
-		double fromDist = toDist;
-
-		// Before supported distance
-		if ( it_dist_to == distanceDepths.begin() ) {
-			if ( toDist > dist ) {
-				return Core::None;
-			}
-
-			return getValue(it_dist_to->second, source.depth);
-		}
-
-		--it_dist_from;
-		fromDist = it_dist_from->first;
-
-		double tt1 = getValue(it_dist_from->second, source.depth);
-		double tt2 = getValue(it_dist_to->second, source.depth);
-
-		if ( tt1 < 0 || tt2 < 0 ) {
-			return Core::None;
-		}
-
-		// Interpolate distances
-		return (tt1 * (toDist - dist) + tt2 * (dist - fromDist)) / (toDist - fromDist);
+		return pit->second.value(Math::Geo::deg2km(dist), source.depth);
 	}
 
 	return Core::None;
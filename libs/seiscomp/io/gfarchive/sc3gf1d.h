@@ -22,7 +22,9 @@
 #define SEISCOMP_IO_GFARCHIVE_SAUL_H
 
 
+#include <seiscomp/core/greensfunction.h>
 #include <seiscomp/io/gfarchive.h>
+#include <seiscomp/io/gfarchive/traveltimegrid.h>
 #include <seiscomp/seismology/ttt.h>
 
 #include <string>
@@ -84,7 +86,33 @@ class SC_SYSTEM_CORE_API SC3GF1DArchive : public GFArchive {
 	//  Private member
 	// ----------------------------------------------------------------------
 	private:
+		struct Request {
+			Core::TimeSpan timeSpan;
+			std::string    id;
+			std::string    model;
+			double         distance;
+			double         depth;
+		};
+
+		//! The grid nodes used to compute the Green's function of a request
+		struct Support {
+			int    distance;
+			//! The neighbouring distances, equal if no interpolation in
+			//! distance is performed
+			double dist1;
+			double dist2;
+			//! The nearest and the second neighbouring depth
+			double dep;
+			double altDep;
+		};
+
 		bool hasModel(const std::string &) const;
+		bool support(const Request &req, Support &s) const;
+		Core::GreensFunctionCPtr load(const std::string &model, double dist,
+		                              double dep, const Core::TimeSpan &ts);
+		void prefetch();
+
+		std::string file(const std::string &model, double dist, double dep) const;
 		Core::GreensFunction* read(const std::string &file,
 		                           const Core::TimeSpan &ts, double timeOfs);
 
@@ -93,19 +121,10 @@ class SC_SYSTEM_CORE_API SC3GF1DArchive : public GFArchive {
 	//  Private member
 	// ----------------------------------------------------------------------
 	private:
-		struct Request {
-			Core::TimeSpan timeSpan;
-			std::string    id;
-			std::string    model;
-			double         distance;
-			double         depth;
-		};
 
 		typedef std::list<Request> RequestList;
 		typedef std::set<double> DoubleList;
-		typedef std::map<double, double> TTDepth;
-		typedef std::map<double, TTDepth> TTDistance;
-		typedef std::map<std::string, TTDistance> TTPhases;
+		typedef std::map<std::string, TravelTimeGrid> TTPhases;
 
 		struct ModelConfig {
 			ModelConfig() : travelTimesInitialized(false) {}
@@ -125,6 +144,7 @@ class SC_SYSTEM_CORE_API SC3GF1DArchive : public GFArchive {
 		std::string        _baseDirectory;
 		Core::TimeSpan     _defaultTimespan;
 		RequestList        _requests;
+		bool               _prefetch{false};
 };
 
 }
@@ -0,0 +1,153 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#include <seiscomp/io/gfarchive/traveltimegrid.h>
+
+#include <algorithm>
+
+
+namespace Seiscomp {
+namespace IO {
+
+
+namespace {
+
+
+void sortUnique(std::vector<double> &values) {
+	std::sort(values.begin(), values.end());
+	values.erase(std::unique(values.begin(), values.end()), values.end());
+}
+
+
+bool indexOf(const std::vector<double> &axis, double value, size_t &index) {
+	auto it = std::lower_bound(axis.begin(), axis.end(), value);
+	if ( it == axis.end() || *it != value )
+		return false;
+
+	index = it - axis.begin();
+	return true;
+}
+
+
+}
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void TravelTimeGrid::setAxes(std::vector<double> distances,
+                             std::vector<double> depths) {
+	sortUnique(distances);
+	sortUnique(depths);
+
+	_distances = std::move(distances);
+	_depths = std::move(depths);
+	_values.assign(_distances.size() * _depths.size(), -1);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool TravelTimeGrid::set(double distance, double depth, double travelTime) {
+	size_t i, j;
+	if ( !indexOf(_distances, distance, i) || !indexOf(_depths, depth, j) )
+		return false;
+
+	_values[i * _depths.size() + j] = travelTime;
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+double TravelTimeGrid::depthValue(size_t distanceIndex, double depth) const {
+	// Get element after the depth
+	auto to = std::lower_bound(_depths.begin(), _depths.end(), depth);
+
+	// After supported depth range
+	if ( to == _depths.end() )
+		return -1;
+
+	size_t j = to - _depths.begin();
+	const double *row = &_values[distanceIndex * _depths.size()];
+
+	// Before supported depth range
+	if ( j == 0 )
+		return *to > depth ? -1 : row[0];
+
+	double fromDepth = _depths[j-1];
+	double toDepth = *to;
+	double tt1 = row[j-1];
+	double tt2 = row[j];
+
+	if ( tt1 < 0 || tt2 < 0 )
+		return -1;
+
+	return (tt1 * (toDepth - depth) + tt2 * (depth - fromDepth)) / (toDepth - fromDepth);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+OPT(double) TravelTimeGrid::value(double distance, double depth) const {
+	// Get element after the distance
+	auto to = std::lower_bound(_distances.begin(), _distances.end(), distance);
+
+	// Distance out of range
+	if ( to == _distances.end() )
+		return Core::None;
+
+	size_t i = to - _distances.begin();
+	double tt2 = depthValue(i, depth);
+	if ( tt2 < 0 )
+		return Core::None;
+
+	// Before supported distance
+	if ( i == 0 ) {
+		if ( *to > distance )
+			return Core::None;
+		return tt2;
+	}
+
+	double tt1 = depthValue(i-1, depth);
+	if ( tt1 < 0 )
+		return Core::None;
+
+	double fromDistance = _distances[i-1];
+	double toDistance = *to;
+
+	// Interpolate distances
+	return (tt1 * (toDistance - distance) + tt2 * (distance - fromDistance)) / (toDistance - fromDistance);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+}
+}
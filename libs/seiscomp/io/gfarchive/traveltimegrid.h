@@ -0,0 +1,92 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#ifndef SEISCOMP_IO_GFARCHIVE_TRAVELTIMEGRID_H
+#define SEISCOMP_IO_GFARCHIVE_TRAVELTIMEGRID_H
+
+
+#include <seiscomp/core.h>
+#include <seiscomp/core/optional.h>
+
+#include <vector>
+
+
+namespace Seiscomp {
+namespace IO {
+
+
+/**
+ * @brief Travel times of a single phase sampled on a distance/depth grid.
+ *
+ * The axes and values are stored in flat sorted arrays. Lookups are two
+ * binary searches followed by a bilinear interpolation of the four
+ * neighbouring nodes.
+ */
+class SC_SYSTEM_CORE_API TravelTimeGrid {
+	// ----------------------------------------------------------------------
+	//  Public interface
+	// ----------------------------------------------------------------------
+	public:
+		//! Sets the grid axes and resets all values. The axes do not need
+		//! to be sorted, duplicate values are merged.
+		void setAxes(std::vector<double> distances, std::vector<double> depths);
+
+		//! Sets the travel time of a grid node. Returns false if the node
+		//! is not part of the grid.
+		bool set(double distance, double depth, double travelTime);
+
+		/**
+		 * @brief Returns the travel time interpolated between the
+		 *        neighbouring distances and depths.
+		 * @return The travel time or None if either coordinate is out of
+		 *         the grid range or a neighbouring node is not set.
+		 */
+		OPT(double) value(double distance, double depth) const;
+
+		bool empty() const { return _values.empty(); }
+
+
+	// ----------------------------------------------------------------------
+	//  Private methods
+	// ----------------------------------------------------------------------
+	private:
+		//! Returns the travel time at a distance index interpolated in depth
+		//! or a negative value if not available
+		double depthValue(size_t distanceIndex, double depth) const;
+
+
+	// ----------------------------------------------------------------------
+	//  Private members
+	// ----------------------------------------------------------------------
+	private:
+		std::vector<double> _distances;
+		std::vector<double> _depths;
+		// Row major: _values[distanceIndex * _depths.size() + depthIndex],
+		// unset nodes are negative
+		std::vector<double> _values;
+};
+
+
+}
+}
+
+
+#endif
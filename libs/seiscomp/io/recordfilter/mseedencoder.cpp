@@ -26,8 +26,13 @@
 #include <seiscomp/io/records/mseed/encoder/steim1.h>
 #include <seiscomp/io/records/mseed/encoder/steim2.h>
 
-#include <streambuf>
+#include <algorithm>
+#include <atomic>
 #include <istream>
+#include <map>
+#include <memory>
+#include <streambuf>
+#include <thread>
 
 #include "mseedencoder.h"
 
@@ -148,6 +153,107 @@ void MSeedEncoder::allowFloatingPointCompression(bool f) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+size_t MSeedEncoder::encode(const Record *rec, std::vector<RecordPtr> &records) {
+	size_t count = 0;
+
+	for ( Record *out = feed(rec); out; out = pop() ) {
+		records.push_back(out);
+		++count;
+	}
+
+	return count;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+size_t MSeedEncoder::flush(std::vector<RecordPtr> &records) {
+	size_t count = 0;
+
+	for ( Record *out = flush(); out; out = pop() ) {
+		records.push_back(out);
+		++count;
+	}
+
+	return count;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+std::vector<RecordPtr>
+MSeedEncoder::encode(const std::vector<RecordCPtr> &records,
+                     size_t threads) const {
+	struct Stream {
+		std::vector<const Record*> input;
+		std::vector<RecordPtr>     output;
+	};
+
+	std::vector<Stream> streams;
+	std::map<std::string, size_t> streamIndex;
+
+	for ( const auto &rec : records ) {
+		if ( !rec ) {
+			continue;
+		}
+
+		auto it = streamIndex.emplace(rec->streamID(), streams.size()).first;
+		if ( it->second == streams.size() ) {
+			streams.emplace_back();
+		}
+
+		streams[it->second].input.push_back(rec.get());
+	}
+
+	std::atomic<size_t> next{0};
+	auto work = [this, &streams, &next]() {
+		for ( size_t i = next++; i < streams.size(); i = next++ ) {
+			std::unique_ptr<RecordFilterInterface> encoder(clone());
+			auto mseedEncoder = static_cast<MSeedEncoder*>(encoder.get());
+			for ( auto rec : streams[i].input ) {
+				mseedEncoder->encode(rec, streams[i].output);
+			}
+			mseedEncoder->flush(streams[i].output);
+		}
+	};
+
+	if ( !threads ) {
+		threads = std::thread::hardware_concurrency();
+	}
+
+	threads = std::min(threads, streams.size());
+
+	if ( threads > 1 ) {
+		std::vector<std::thread> workers;
+		for ( size_t i = 0; i < threads; ++i ) {
+			workers.emplace_back(work);
+		}
+
+		for ( auto &worker : workers ) {
+			worker.join();
+		}
+	}
+	else {
+		work();
+	}
+
+	std::vector<RecordPtr> output;
+	for ( auto &stream : streams ) {
+		output.insert(output.end(), stream.output.begin(), stream.output.end());
+	}
+
+	return output;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 Record *MSeedEncoder::feed(const Record *rec) {
 	if ( !rec || !rec->data() || !rec->sampleCount() ) {
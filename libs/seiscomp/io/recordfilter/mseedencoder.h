@@ -26,6 +26,8 @@
 #include <seiscomp/io/recordfilter.h>
 #include <seiscomp/math/filter.h>
 
+#include <vector>
+
 
 namespace Seiscomp {
 namespace IO {
@@ -69,6 +71,42 @@ class SC_SYSTEM_CORE_API MSeedEncoder : public RecordFilterInterface {
 
 		void allowFloatingPointCompression(bool f);
 
+		/**
+		 * @brief Encodes a record and appends all completed MiniSEED
+		 *        records to a list. In contrast to feed() which returns
+		 *        at most one record per call, no output is held back.
+		 * @param rec The input record
+		 * @param records The list to append the MiniSEED records to
+		 * @return The number of appended records
+		 */
+		size_t encode(const Record *rec, std::vector<RecordPtr> &records);
+
+		/**
+		 * @brief Flushes the encoder and appends all remaining MiniSEED
+		 *        records to a list.
+		 * @param records The list to append the MiniSEED records to
+		 * @return The number of appended records
+		 */
+		size_t flush(std::vector<RecordPtr> &records);
+
+		/**
+		 * @brief Encodes a set of records of possibly several streams
+		 *        with the settings of this instance. Each stream is encoded
+		 *        with its own encoder and streams are distributed among
+		 *        worker threads. The state of this instance is not changed.
+		 *
+		 * The output contains the MiniSEED records of each stream in the
+		 * order the streams first appear in the input. All encoders are
+		 * flushed at the end. The output is the same as when feeding the
+		 * records of each stream into a separate instance.
+		 * @param records The input records
+		 * @param threads The number of worker threads. 0 uses the number
+		 *                of hardware threads.
+		 * @return The MiniSEED records
+		 */
+		std::vector<RecordPtr> encode(const std::vector<RecordCPtr> &records,
+		                              size_t threads = 0) const;
+
 
 	// ------------------------------------------------------------------
 	//  RecordFilter interface
@@ -307,7 +307,8 @@ Record *Spectralizer::fft(const Record *rec) {
 
 	ArrayPtr tmp_ar;
 	const DoubleArray *ar = DoubleArray::ConstCast(rec->data());
-	if ( ar == nullptr ) {
+	// The filter is applied in-place and must not modify the record data
+	if ( (ar == nullptr) || _buffer->filter ) {
 		tmp_ar = rec->data()->copy(Array::DOUBLE);
 		ar = DoubleArray::ConstCast(tmp_ar);
 		if ( ar == nullptr ) {
@@ -95,8 +95,8 @@ class Encoder : public Core::BaseObject {
 		}
 
 	protected:
-		void tick() {
-			++_ticks;
+		void tick(int n = 1) {
+			_ticks += n;
 		}
 
 		void queue() {
@@ -25,6 +25,9 @@
 #include "encoder.h"
 #include "format.h"
 
+#include <algorithm>
+#include <vector>
+
 
 namespace Seiscomp::IO::MSEED {
 
@@ -42,6 +45,14 @@ __attribute__((packed))
 ;
 
 
+/**
+ * @brief Steim2 encoder.
+ *
+ * Samples are processed in blocks. For each block the differences and the
+ * number of differences that fit into a 32 bit word together with each of
+ * them are computed first in a loop without branches which the compiler
+ * vectorizes. The words are then packed greedily from these arrays.
+ */
 template<typename T>
 class Steim2 : public Encoder {
 	public:
@@ -52,24 +63,48 @@ class Steim2 : public Encoder {
 		void flush() override;
 		void push(size_t n, const void *samples) override;
 
+	public:
+		//! The maximum number of samples classified at once
+		static constexpr size_t BlockSize = 1024;
+
+		/**
+		 * @brief Computes the differences of samples to their predecessors
+		 *        and the number of differences per word each of them
+		 *        permits (1 to 7).
+		 * @param samples The input samples
+		 * @param values The samples converted to integers
+		 * @param diffs The differences
+		 * @param widths The number of differences per word
+		 * @param n The number of samples
+		 * @param last The sample preceding the first one
+		 * @return false if a difference exceeds 30 bits
+		 */
+		static bool classify(const T *samples, int32_t *values,
+		                     int32_t *diffs, uint8_t *widths,
+		                     size_t n, int32_t last);
+
 	private:
-		void updateSpw(int bp);
-		void store(int32_t value);
-		void initPacket();
+		void clip(size_t first);
+		void encode(bool final);
+		void packWord(const int32_t *diffs, int count);
+		void initPacket(int32_t beginSample);
 		void finishPacket();
-		void updatePacket();
 		void queuePacket();
 		int numberOfFrames();
 
 	private:
-		int      _frameCount{0};
-		int      _bp{0};
-		int      _fp{0};
-		int32_t  _last_s;
-		int      _spw{4};
-		int32_t  _lastSample{0};
-		int32_t  _buf[8];
-		uint32_t _nibbleWord{0};
+		int                  _frameCount{0};
+		int                  _fp{0};
+		int32_t              _lastSample{0};
+		int32_t              _endSample{0};
+		// The very first word takes at most four differences which keeps
+		// the output identical to former versions
+		int                  _maxWidth{4};
+		uint32_t             _nibbleWord{0};
+		// Samples which are not yet packed
+		std::vector<int32_t> _values;
+		std::vector<int32_t> _diffs;
+		std::vector<uint8_t> _widths;
 };
 
 
@@ -26,51 +26,36 @@ namespace Seiscomp::IO::MSEED {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 template<typename T>
-void Steim2<T>::updateSpw(int bp) {
-	assert(bp < 7);
+bool Steim2<T>::classify(const T *samples, int32_t *values, int32_t *diffs,
+                         uint8_t *widths, size_t n, int32_t last) {
+	uint32_t overflow = 0;
 
-	if ( _buf[bp] < -536870912 ) {
-		std::cerr << _format->networkCode << "." << _format->stationCode << "."
-		          << _format->locationCode << "." << _format->channelCode << ": "
-		             "value " << _buf[bp] << " is too large for Steim2 encoding"
-		          << std::endl;
-		_buf[bp] = -536870912;
-		_spw = 1;
-		return;
+	if ( !n ) {
+		return true;
 	}
 
-	if ( _buf[bp] > 536870911 ) {
-		std::cerr << _format->networkCode << "." << _format->stationCode << "."
-		          << _format->locationCode << "." << _format->channelCode << ": "
-		             "value " << _buf[bp] << " is too large for Steim2 encoding"
-		          << std::endl;
-		_buf[bp] = 536870911;
-		_spw = 1;
-		return;
+	for ( size_t i = 0; i < n; ++i ) {
+		values[i] = static_cast<int32_t>(samples[i]);
 	}
 
-	int spw1 = 7;
-	if ( _buf[bp] < -16384 || _buf[bp] > 16383 ) {
-		spw1 = 1;
-	}
-	else if ( _buf[bp] < -512 || _buf[bp] > 511 ) {
-		spw1 = 2;
+	// Differences wrap around instead of overflowing
+	diffs[0] = static_cast<int32_t>(static_cast<uint32_t>(values[0]) - static_cast<uint32_t>(last));
+	for ( size_t i = 1; i < n; ++i ) {
+		diffs[i] = static_cast<int32_t>(static_cast<uint32_t>(values[i]) - static_cast<uint32_t>(values[i-1]));
 	}
-	else if ( _buf[bp] < -128 || _buf[bp] > 127 ) {
-		spw1 = 3;
-	}
-	else if ( _buf[bp] < -32 || _buf[bp] > 31 ) {
-		spw1 = 4;
-	}
-	else if ( _buf[bp] < -16 || _buf[bp] > 15 ) {
-		spw1 = 5;
-	}
-	else if ( _buf[bp] < -8  || _buf[bp] > 7 ) {
-		spw1 = 6;
-	}
-	if ( spw1 < _spw ) {
-		_spw = spw1;
+
+	for ( size_t i = 0; i < n; ++i ) {
+		// Negative values are mapped to their one's complement which
+		// accounts for the asymmetric two's complement ranges, e.g.
+		// [-8,7] for 4 bits maps to [0,7].
+		uint32_t m = static_cast<uint32_t>(diffs[i] ^ (diffs[i] >> 31));
+		widths[i] = static_cast<uint8_t>(
+			7 - (m > 7) - (m > 15) - (m > 31) - (m > 127) - (m > 511) - (m > 16383)
+		);
+		overflow |= static_cast<uint32_t>(m > 536870911);
 	}
+
+	return !overflow;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -79,12 +64,19 @@ void Steim2<T>::updateSpw(int bp) {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 template<typename T>
-void Steim2<T>::store(int32_t value) {
-	assert(_bp < 7);
-	_buf[_bp] = value - _lastSample;
-	_lastSample = value;
-	updateSpw(_bp);
-	++_bp;
+void Steim2<T>::clip(size_t first) {
+	for ( size_t i = first; i < _diffs.size(); ++i ) {
+		if ( (_diffs[i] >= -536870912) && (_diffs[i] <= 536870911) ) {
+			continue;
+		}
+
+		std::cerr << _format->networkCode << "." << _format->stationCode << "."
+		          << _format->locationCode << "." << _format->channelCode << ": "
+		             "value " << _diffs[i] << " is too large for Steim2 encoding"
+		          << std::endl;
+		_diffs[i] = _diffs[i] < 0 ? -536870912 : 536870911;
+		_widths[i] = 1;
+	}
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -93,14 +85,7 @@ void Steim2<T>::store(int32_t value) {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 template<typename T>
-void Steim2<T>::initPacket() {
-	int i;
-	int32_t beginSample = _lastSample;
-
-	for ( i = 1; i < _bp; ++i ) {
-		beginSample -= _buf[i];
-	}
-
+void Steim2<T>::initPacket(int32_t beginSample) {
 	reset();
 	Steim2Frame *frames = reinterpret_cast<Steim2Frame*>(_currentData);
 	if ( _format->bigEndian ) {
@@ -121,19 +106,12 @@ void Steim2<T>::initPacket() {
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 template<typename T>
 void Steim2<T>::finishPacket() {
-	int i;
-	int32_t endSample = _lastSample;
-
-	for ( i = 0; i < _bp; ++i ) {
-		endSample -= _buf[i];
-	}
-
 	Steim2Frame *frames = reinterpret_cast<Steim2Frame*>(_currentData);
 	if ( _format->bigEndian ) {
-		frames[0].sampleWord[1] = Core::Endianess::Converter::ToBigEndian<uint32_t>(endSample);
+		frames[0].sampleWord[1] = Core::Endianess::Converter::ToBigEndian<uint32_t>(_endSample);
 	}
 	else {
-		frames[0].sampleWord[1] = Core::Endianess::Converter::ToLittleEndian<uint32_t>(endSample);
+		frames[0].sampleWord[1] = Core::Endianess::Converter::ToLittleEndian<uint32_t>(_endSample);
 	}
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -143,63 +121,50 @@ void Steim2<T>::finishPacket() {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 template<typename T>
-void Steim2<T>::updatePacket() {
+void Steim2<T>::packWord(const int32_t *diffs, int count) {
+	const uint32_t *d = reinterpret_cast<const uint32_t*>(diffs);
 	unsigned int nibble = 0;
 	uint32_t sampleWord = 0;
 
-	assert(_bp < 8);
-
-	int used = _bp;
-
-	while ( used > _spw ) {
-		--used;
-		_spw = 7;
-		for ( int i = 0; i < used; ++i ) {
-			updateSpw(i);
-		}
-	}
-
-	_spw = used;
-
-	switch ( _spw ) {
+	switch ( count ) {
 		case 7:
 			nibble = 3;
-			sampleWord = (2U << 30) | ((_buf[0] & 0xf) << 24) |
-				((_buf[1] & 0xf) << 20) | ((_buf[2] & 0xf) << 16) |
-				((_buf[3] & 0xf) << 12) | ((_buf[4] & 0xf) << 8) |
-				((_buf[5] & 0xf) << 4) | (_buf[6] & 0xf);
+			sampleWord = (2U << 30) | ((d[0] & 0xf) << 24) |
+				((d[1] & 0xf) << 20) | ((d[2] & 0xf) << 16) |
+				((d[3] & 0xf) << 12) | ((d[4] & 0xf) << 8) |
+				((d[5] & 0xf) << 4) | (d[6] & 0xf);
 			break;
 		case 6:
 			nibble = 3;
-			sampleWord = (1U << 30) | ((_buf[0] & 0x1f) << 25) |
-				((_buf[1] & 0x1f) << 20) | ((_buf[2] & 0x1f) << 15) |
-				((_buf[3] & 0x1f) << 10) | ((_buf[4] & 0x1f) << 5) |
-				(_buf[5] & 0x1f);
+			sampleWord = (1U << 30) | ((d[0] & 0x1f) << 25) |
+				((d[1] & 0x1f) << 20) | ((d[2] & 0x1f) << 15) |
+				((d[3] & 0x1f) << 10) | ((d[4] & 0x1f) << 5) |
+				(d[5] & 0x1f);
 			break;
 		case 5:
 			nibble = 3;
-			sampleWord = ((_buf[0] & 0x3f) << 24) | ((_buf[1] & 0x3f) << 18) |
-				((_buf[2] & 0x3f) << 12) | ((_buf[3] & 0x3f) << 6) |
-				(_buf[4] & 0x3f);
+			sampleWord = ((d[0] & 0x3f) << 24) | ((d[1] & 0x3f) << 18) |
+				((d[2] & 0x3f) << 12) | ((d[3] & 0x3f) << 6) |
+				(d[4] & 0x3f);
 			break;
 		case 4:
 			nibble = 1;
-			sampleWord = ((_buf[0] & 0xff) << 24) | ((_buf[1] & 0xff) << 16) |
-				((_buf[2] & 0xff) << 8) | ((_buf[3] & 0xff) << 0);
+			sampleWord = ((d[0] & 0xff) << 24) | ((d[1] & 0xff) << 16) |
+				((d[2] & 0xff) << 8) | ((d[3] & 0xff) << 0);
 			break;
 		case 3:
 			nibble = 2;
-			sampleWord = (3U << 30) | ((_buf[0] & 0x3ff) << 20) |
-				((_buf[1] & 0x3ff) << 10) | (_buf[2] & 0x3ff);
+			sampleWord = (3U << 30) | ((d[0] & 0x3ff) << 20) |
+				((d[1] & 0x3ff) << 10) | (d[2] & 0x3ff);
 			break;
 		case 2:
 			nibble = 2;
-			sampleWord = (2U << 30) | ((_buf[0] & 0x7fff) << 15) |
-				(_buf[1] & 0x7fff);
+			sampleWord = (2U << 30) | ((d[0] & 0x7fff) << 15) |
+				(d[1] & 0x7fff);
 			break;
 		case 1:
 			nibble = 2;
-			sampleWord = (1U << 30) | (_buf[0] & 0x3fffffff);
+			sampleWord = (1U << 30) | (d[0] & 0x3fffffff);
 			break;
 		default:
 			assert(0);
@@ -207,15 +172,7 @@ void Steim2<T>::updatePacket() {
 	}
 
 	_nibbleWord |= (nibble << (30 - ((_fp + 1) << 1)));
-
-	_spw = 7;
-	for ( int i = 0; i < _bp - used; ++i ) {
-		_buf[i] = _buf[i + used];
-		updateSpw(i);
-	}
-
-	_bp -= used;
-	_sampleCount += used;
+	_sampleCount += count;
 
 	Steim2Frame *frames = reinterpret_cast<Steim2Frame*>(_currentData);
 	if ( _format->bigEndian ) {
@@ -224,7 +181,7 @@ void Steim2<T>::updatePacket() {
 	}
 	else {
 		frames[_frameCount].nibbleWord = Core::Endianess::Converter::ToLittleEndian<uint32_t>(_nibbleWord);
-		if ( used != 4 ) {
+		if ( count != 4 ) {
 			frames[_frameCount].sampleWord[_fp] = Core::Endianess::Converter::ToLittleEndian<uint32_t>(sampleWord);
 		}
 		else {
@@ -239,7 +196,6 @@ void Steim2<T>::updatePacket() {
 	_nibbleWord = 0;
 	_fp = 0;
 	++_frameCount;
-	return;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -263,53 +219,98 @@ void Steim2<T>::queuePacket() {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 template<typename T>
-void Steim2<T>::push(size_t n, const void *samples) {
-	for ( size_t i = 0; i < n; ++i ) {
-		int32_t sample = static_cast<const T*>(samples)[i];
-		store(sample);
-		tick();
-
-		while ( _bp >= _spw ) {
-			if( !_currentPacket ) {
-				_currentPacket = _format->getBuffer(getTime(_bp),
-				                                    _timingQuality,
-				                                    &_currentData,
-				                                    &_currentDataLen);
-				initPacket();
+void Steim2<T>::encode(bool final) {
+	size_t count = _diffs.size();
+	size_t p = 0;
+
+	while ( p < count ) {
+		size_t avail = count - p;
+		int width = std::min(static_cast<int>(_widths[p]), _maxWidth);
+		int used = 1;
+
+		// Take as many differences as fit into one word together
+		while ( (used < width) && (static_cast<size_t>(used) < avail) ) {
+			int w = std::min(width, static_cast<int>(_widths[p + used]));
+			if ( w <= used ) {
+				break;
 			}
 
-			updatePacket();
-			if ( _frameCount == numberOfFrames() ) {
-				finishPacket();
-				queuePacket();
-			}
+			width = w;
+			++used;
 		}
-	}
-}
-// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
-
-
 
+		// The word could take more differences than available, wait for
+		// the next samples
+		if ( !final && (static_cast<size_t>(used) == avail) && (used < width) ) {
+			break;
+		}
 
-// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
-template<typename T>
-void Steim2<T>::flush() {
-	while ( _bp ) {
 		if ( !_currentPacket ) {
-			_currentPacket = _format->getBuffer(getTime(_bp),
+			_currentPacket = _format->getBuffer(getTime(static_cast<int>(avail)),
 			                                    _timingQuality,
 			                                    &_currentData,
 			                                    &_currentDataLen);
-			initPacket();
+			initPacket(_values[p]);
 		}
 
-		updatePacket();
-		if( _frameCount == numberOfFrames() ) {
+		packWord(&_diffs[p], used);
+		_maxWidth = 7;
+		_endSample = _values[p + used - 1];
+		p += used;
+
+		if ( _frameCount == numberOfFrames() ) {
 			finishPacket();
 			queuePacket();
 		}
 	}
 
+	if ( p ) {
+		_values.erase(_values.begin(), _values.begin() + p);
+		_diffs.erase(_diffs.begin(), _diffs.begin() + p);
+		_widths.erase(_widths.begin(), _widths.begin() + p);
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+template<typename T>
+void Steim2<T>::push(size_t n, const void *samples) {
+	auto data = static_cast<const T*>(samples);
+
+	while ( n ) {
+		size_t count = std::min(n, BlockSize);
+		size_t first = _diffs.size();
+
+		_values.resize(first + count);
+		_diffs.resize(first + count);
+		_widths.resize(first + count);
+
+		if ( !classify(data, &_values[first], &_diffs[first], &_widths[first],
+		               count, _lastSample) ) {
+			clip(first);
+		}
+
+		_lastSample = _values.back();
+		tick(static_cast<int>(count));
+		encode(false);
+
+		data += count;
+		n -= count;
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+template<typename T>
+void Steim2<T>::flush() {
+	encode(true);
+
 	if ( _currentPacket ) {
 		finishPacket();
 		queuePacket();
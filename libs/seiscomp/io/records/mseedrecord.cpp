@@ -52,6 +52,7 @@
 #include <cctype>
 #include <cstring>
 #include <string_view>
+#include <vector>
 
 
 using namespace std;
@@ -90,12 +91,130 @@ void mstrncpy(std::string &dest, const char *source, int length) {
 }
 
 
+// dest must be able to hold length + 1 characters
+void mstrncpy(char *dest, const char *source, int length) {
+	for ( ; length; ++source, --length ) {
+		if ( *source == '\0' ) {
+			break;
+		}
+
+		if ( *source != ' ' ) {
+			*dest++ = *source;
+		}
+	}
+
+	*dest = '\0';
+}
+
+
+// Returns the start time of a miniSEED 2 record from a fixed header
+// with native byte order not including blockette 1001.
+Core::Time v2StartTime(const void *header) {
+	using namespace MSEED::V2;
+
+	auto hours = *Hour::Get(header);
+	auto minutes = *Minute::Get(header);
+	auto seconds = *Second::Get(header);
+	auto fsec = *FSecond::Get(header) * 100;
+
+	auto time = Core::Time::FromYearDay(*Year::Get(header), *YDay::Get(header));
+	time += Core::TimeSpan(hours * 3600 + minutes * 60 + seconds, fsec);
+
+	if ( *TimeCorrection::Get(header) != 0 && !(*ActivityFlags::Get(header) & 0x02) ) {
+		time += Core::TimeSpan(0, *TimeCorrection::Get(header) * 100);
+	}
+
+	return time;
+}
+
+
+// Returns the sampling rate of a miniSEED 2 record as fraction from a
+// fixed header with native byte order.
+void v2SamplingRate(const void *header, int64_t &num, int64_t &den) {
+	using namespace MSEED::V2;
+
+	if ( *SamplingRateF::Get(header) > 0 ) {
+		num = *SamplingRateF::Get(header);
+		den = 1;
+	}
+	else {
+		num = 1;
+		den = -*SamplingRateF::Get(header);
+	}
+
+	if ( *SamplingRateM::Get(header) > 0 ) {
+		num *= *SamplingRateM::Get(header);
+	}
+	else {
+		den *= -*SamplingRateM::Get(header);
+	}
+}
+
+
+// Deferral is enabled per reading thread, e.g. the acquisition thread of a
+// StreamApplication, and does not affect other readers in the process
+thread_local bool deferredAuthentication = false;
+
+
+// Applies the result of a signature validation to a record. A valid
+// signature is given by the matched certificate.
+void applyAuthentication(Record *rec, const X509 *cert) {
+	if ( !cert ) {
+		rec->setAuthentication(Record::SIGNATURE_VALIDATION_FAILED);
+		SEISCOMP_WARNING("MSEED: Signature validation failed");
+		return;
+	}
+
+	X509_NAME *name = X509_get_subject_name(const_cast<X509*>(cert));
+	if ( name ) {
+		int pos = X509_NAME_get_index_by_NID(name, NID_organizationName, -1);
+		if ( pos != -1 ) {
+			X509_NAME_ENTRY *e = X509_NAME_get_entry(name, pos);
+			ASN1_STRING *str = X509_NAME_ENTRY_get_data(e);
+			if ( ASN1_STRING_type(str) != V_ASN1_UTF8STRING ) {
+				unsigned char *utf8 = 0;
+				int length = ASN1_STRING_to_UTF8(&utf8, str);
+				if ( length > 0 ) {
+					rec->setAuthority(string(reinterpret_cast<char*>(utf8), size_t(length)));
+				}
+				if ( utf8 ) {
+					OPENSSL_free(utf8);
+				}
+			}
+			else {
+#if OPENSSL_VERSION_NUMBER < 0x10100000L
+				rec->setAuthority(string(reinterpret_cast<char*>(ASN1_STRING_data(str)), size_t(ASN1_STRING_length(str))));
+#else
+				rec->setAuthority(string(reinterpret_cast<const char*>(ASN1_STRING_get0_data(str)), ASN1_STRING_length(str)));
+#endif
+			}
+		}
+		else {
+			SEISCOMP_WARNING("MSEED: Failed to extract certificate authority (O)");
+		}
+	}
+
+	rec->setAuthentication(Record::SIGNATURE_VALIDATED);
+}
+
+
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+struct MSeedRecord::PendingSignature {
+	std::string authority;
+	std::string digest;
+	std::string signature;
+};
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 IMPLEMENT_SC_CLASS_DERIVED(MSeedRecord, Record, "MSeedRecord");
 REGISTER_RECORD(MSeedRecord, "mseed");
@@ -334,6 +453,7 @@ MSeedRecord &MSeedRecord::operator=(const MSeedRecord &msrec) {
 		_encodingFlag = msrec._encodingFlag;
 		_recordLength = msrec._recordLength;
 		_endTime = msrec._endTime;
+		_pendingSignature = msrec._pendingSignature;
 	}
 
 	return *this;
@@ -645,46 +765,22 @@ void MSeedRecord::updateAuthentication(const char *rec, size_t reclen, size_t bl
 
 	const unsigned char *pp = reinterpret_cast<const unsigned char *>(blkt) + b2000DataOffset;
 
+	if ( deferredAuthentication ) {
+		auto pending = std::make_shared<PendingSignature>();
+		pending->authority = header;
+		pending->digest.assign(reinterpret_cast<const char*>(digest), nDigest);
+		pending->signature.assign(reinterpret_cast<const char*>(pp), nSignature);
+		_pendingSignature = pending;
+		return;
+	}
+
 	const X509 *cert;
 	if ( !cs.validate(header, reinterpret_cast<const char*>(digest),
 	                  nDigest, pp, nSignature, &cert) ) {
-		const_cast<MSeedRecord*>(this)->_authenticationStatus = SIGNATURE_VALIDATION_FAILED;
-		SEISCOMP_WARNING("MSEED: Signature validation failed");
+		cert = nullptr;
 	}
-	else {
-		if ( cert ) {
-			X509_NAME *name = X509_get_subject_name(const_cast<X509*>(cert));
-			if ( name ) {
-				int pos = X509_NAME_get_index_by_NID(name, NID_organizationName, -1);
-				if ( pos != -1 ) {
-					X509_NAME_ENTRY *e = X509_NAME_get_entry(name, pos);
-					ASN1_STRING *str = X509_NAME_ENTRY_get_data(e);
-					if ( ASN1_STRING_type(str) != V_ASN1_UTF8STRING ) {
-						unsigned char *utf8 = 0;
-						int length = ASN1_STRING_to_UTF8(&utf8, str);
-						if ( length > 0 ) {
-							const_cast<MSeedRecord*>(this)->_authority.assign(reinterpret_cast<char*>(utf8), size_t(length));
-						}
-						if ( utf8 ) {
-							OPENSSL_free(utf8);
-						}
-					}
-					else {
-#if OPENSSL_VERSION_NUMBER < 0x10100000L
-						_authority.assign(reinterpret_cast<char*>(ASN1_STRING_data(str)), size_t(ASN1_STRING_length(str)));
-#else
-						_authority.assign(reinterpret_cast<const char*>(ASN1_STRING_get0_data(str)), ASN1_STRING_length(str));
-#endif
-					}
-				}
-				else {
-					SEISCOMP_WARNING("MSEED: Failed to extract certificate authority (O)");
-				}
-			}
-		}
 
-		_authenticationStatus = SIGNATURE_VALIDATED;
-	}
+	applyAuthentication(this, cert);
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -801,6 +897,7 @@ void MSeedRecord::read(std::istream &is) {
 	auto &buffer = _raw.impl();
 
 	_data = nullptr;
+	_pendingSignature = nullptr;
 	_byteOrder &= TargetLittleEndian;
 	_encoding = -1;
 	_net = _sta = _loc = _cha = {};
@@ -837,17 +934,7 @@ void MSeedRecord::read(std::istream &is) {
 					swapHeader(header);
 				}
 
-				auto hours = *Hour::Get(header);
-				auto minutes = *Minute::Get(header);
-				auto seconds = *Second::Get(header);
-				auto fsec = *FSecond::Get(header) * 100;
-
-				_stime = Core::Time::FromYearDay(*Year::Get(header), *YDay::Get(header));
-				_stime += Core::TimeSpan(hours * 3600 + minutes * 60 + seconds, fsec);
-
-				if ( *TimeCorrection::Get(header) != 0 && !(*ActivityFlags::Get(header) & 0x02) ) {
-					_stime += Core::TimeSpan(0, *TimeCorrection::Get(header) * 100);
-				}
+				_stime = v2StartTime(header);
 
 				mstrncpy(_net, Network::Get(header), 2);
 				mstrncpy(_sta, Station::Get(header), 5);
@@ -978,22 +1065,7 @@ void MSeedRecord::read(std::istream &is) {
 				_fsamp = 0.0;
 
 				int64_t sfNum{0}, sfDen{0};
-
-				if ( *SamplingRateF::Get(header) > 0 ) {
-					sfNum = *SamplingRateF::Get(header);
-					sfDen = 1;
-				}
-				else {
-					sfNum = 1;
-					sfDen = -*SamplingRateF::Get(header);
-				}
-
-				if ( *SamplingRateM::Get(header) > 0 ) {
-					sfNum *= *SamplingRateM::Get(header);
-				}
-				else {
-					sfDen *= -*SamplingRateM::Get(header);
-				}
+				v2SamplingRate(header, sfNum, sfDen);
 
 				if ( sfDen > 0 ) {
 					_fsamp = static_cast<double>(sfNum) / static_cast<double>(sfDen);
@@ -1166,6 +1238,242 @@ void MSeedRecord::read(std::istream &is) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool MSeedRecord::ReadHeader(const void *ptr, size_t len, MSeedHeader &header) {
+	using namespace MSEED;
+
+	const char *data = static_cast<const char*>(ptr);
+
+	if ( (len >= V2::HeaderLength) && V2::isValidHeader(data) ) {
+		using namespace MSEED::V2;
+
+		char fixed[HeaderLength];
+		memcpy(fixed, data, HeaderLength);
+
+		bool swapflag = false;
+		if ( !isValidYearDay(*Year::Get(fixed), *YDay::Get(fixed)) ) {
+			swapflag = true;
+			swapHeader(fixed);
+		}
+
+		header.format = V2;
+		header.quality = *DataQuality::Get(fixed);
+		mstrncpy(header.networkCode, Network::Get(fixed), 2);
+		mstrncpy(header.stationCode, Station::Get(fixed), 5);
+		mstrncpy(header.locationCode, Location::Get(fixed), 2);
+		mstrncpy(header.channelCode, Channel::Get(fixed), 3);
+		header.startTime = v2StartTime(fixed);
+		header.sampleCount = *SampleCount::Get(fixed);
+		header.recordLength = -1;
+
+		size_t blkt_offset = *BlocketteOffset::Get(fixed);
+		while ( (blkt_offset != 0) && (blkt_offset + BHeadLength <= len) ) {
+			auto blkt_type = swap(*reinterpret_cast<const uint16_t*>(data + blkt_offset), swapflag);
+			size_t next_blkt = swap(*reinterpret_cast<const uint16_t*>(data + blkt_offset + 2), swapflag);
+
+			if ( (next_blkt != 0) && ((next_blkt < 4) || ((next_blkt - 4) <= blkt_offset)) ) {
+				return false;
+			}
+
+			if ( blkt_offset + BHeadLength + B1000Length <= len ) {
+				if ( (blkt_type == 1000) && (*B1000RecLength::Get(data + blkt_offset) < 31) ) {
+					header.recordLength = 1 << *B1000RecLength::Get(data + blkt_offset);
+				}
+				else if ( blkt_type == 1001 ) {
+					header.startTime += Core::TimeSpan(0, *B1001MicroSecond::Get(data + blkt_offset));
+				}
+			}
+
+			blkt_offset = next_blkt;
+		}
+
+		int64_t sfNum{0}, sfDen{0};
+		v2SamplingRate(fixed, sfNum, sfDen);
+
+		header.samplingFrequency = sfDen > 0 ? static_cast<double>(sfNum) / static_cast<double>(sfDen) : 0.0;
+		if ( sfNum > 0 ) {
+			header.endTime = header.startTime + Core::TimeSpan(0, header.sampleCount * sfDen * 1000000 / sfNum);
+		}
+		else {
+			header.endTime = header.startTime;
+		}
+
+		return true;
+	}
+	else if ( (len >= V3::HeaderLength) && V3::isValidHeader(data) ) {
+		using namespace MSEED::V3;
+		using C = Core::Endianess::Converter;
+
+		uint8_t sidLength = *SIDLength::Get(data);
+		if ( HeaderLength + sidLength > len ) {
+			return false;
+		}
+
+		string net, sta, loc, cha;
+		if ( !sid2nslc({ SID::Get(data), sidLength }, net, sta, loc, cha)
+		  || (net.size() > MSeedHeader::MaxCodeLength)
+		  || (sta.size() > MSeedHeader::MaxCodeLength)
+		  || (loc.size() > MSeedHeader::MaxCodeLength)
+		  || (cha.size() > MSeedHeader::MaxCodeLength) ) {
+			return false;
+		}
+
+		header.format = V3;
+		header.quality = 'D';
+		strcpy(header.networkCode, net.c_str());
+		strcpy(header.stationCode, sta.c_str());
+		strcpy(header.locationCode, loc.c_str());
+		strcpy(header.channelCode, cha.c_str());
+
+		header.recordLength = HeaderLength + sidLength +
+		                      C::FromLittleEndian(*ExtraLength::Get(data)) +
+		                      C::FromLittleEndian(*DataLength::Get(data));
+		header.sampleCount = C::FromLittleEndian(*SampleCount::Get(data));
+		header.samplingFrequency = C::FromLittleEndian(*SamplingRate::Get(data));
+		if ( header.samplingFrequency < 0 ) {
+			header.samplingFrequency = -1.0 / header.samplingFrequency;
+		}
+
+		header.startTime = Core::Time::FromYearDay(
+			C::FromLittleEndian(*Year::Get(data)),
+			C::FromLittleEndian(*YDay::Get(data))
+		);
+
+		header.startTime += Core::TimeSpan(
+			C::FromLittleEndian(*Hour::Get(data)) * 3600 +
+			C::FromLittleEndian(*Minute::Get(data)) * 60 +
+			C::FromLittleEndian(*Second::Get(data)),
+			C::FromLittleEndian(*Nanoseconds::Get(data)) / 1000
+		);
+
+		if ( header.samplingFrequency > 0 ) {
+			header.endTime = header.startTime + Core::TimeSpan(0, header.sampleCount * 1000000.0 / header.samplingFrequency + 0.5);
+		}
+		else {
+			header.endTime = header.startTime;
+		}
+
+		return true;
+	}
+
+	return false;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool MSeedRecord::ReadHeader(std::istream &is, MSeedHeader &header) {
+	// Large enough for the fixed header plus common blockettes of
+	// miniSEED 2 and the fixed header plus the longest possible SID
+	// of miniSEED 3
+	char buffer[512];
+
+	auto pos = is.tellg();
+	if ( pos < 0 ) {
+		return false;
+	}
+
+	is.read(buffer, sizeof(buffer));
+	auto bytesRead = is.gcount();
+	if ( bytesRead <= 0 ) {
+		return false;
+	}
+
+	// The last record of a file is usually shorter than the buffer
+	is.clear();
+
+	if ( !ReadHeader(buffer, static_cast<size_t>(bytesRead), header)
+	  || (header.recordLength <= 0)
+	  || (static_cast<size_t>(header.recordLength) > MSEED::MaximumRecordLength) ) {
+		is.seekg(pos);
+		return false;
+	}
+
+	is.seekg(pos + static_cast<std::streamoff>(header.recordLength));
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void MSeedRecord::SetDeferredAuthentication(bool enable) {
+	deferredAuthentication = enable;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool MSeedRecord::DeferredAuthentication() {
+	return deferredAuthentication;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void MSeedRecord::ValidateAuthentication(MSeedRecord *const *records, size_t count) {
+	std::vector<Util::CertificateStore::Signature> signatures;
+	std::vector<MSeedRecord*> signedRecords;
+	signatures.reserve(count);
+	signedRecords.reserve(count);
+
+	for ( size_t i = 0; i < count; ++i ) {
+		auto *pending = records[i]->_pendingSignature.get();
+		if ( !pending ) {
+			continue;
+		}
+
+		Util::CertificateStore::Signature sig;
+		sig.authority = pending->authority;
+		sig.digest = pending->digest.data();
+		sig.nDigest = pending->digest.size();
+		sig.signature = reinterpret_cast<const unsigned char*>(pending->signature.data());
+		sig.nSignature = static_cast<unsigned int>(pending->signature.size());
+		signatures.push_back(sig);
+		signedRecords.push_back(records[i]);
+	}
+
+	if ( signatures.empty() ) {
+		return;
+	}
+
+	Util::CertificateStore::global().validate(signatures.data(), signatures.size());
+
+	for ( size_t i = 0; i < signedRecords.size(); ++i ) {
+		applyAuthentication(signedRecords[i], signatures[i].certificate);
+		signedRecords[i]->_pendingSignature = nullptr;
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+std::string MSeedHeader::streamID() const {
+	std::string id;
+	id.reserve(4 * MaxCodeLength + 3);
+	id += networkCode;
+	id += '.';
+	id += stationCode;
+	id += '.';
+	id += locationCode;
+	id += '.';
+	id += channelCode;
+	return id;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void MSeedRecord::write(std::ostream &out) {
 	using namespace MSEED;
@@ -28,6 +28,8 @@
 
 #include <string>
 #include <cstdint>
+#include <iosfwd>
+#include <memory>
 
 
 namespace Seiscomp::IO {
@@ -35,6 +37,8 @@ namespace Seiscomp::IO {
 
 DEFINE_SMARTPOINTER(MSeedRecord);
 
+struct MSeedHeader;
+
 
 class SC_SYSTEM_CORE_API LibmseedException : public Core::StreamException {
 	public:
@@ -76,6 +80,58 @@ class SC_SYSTEM_CORE_API MSeedRecord: public Record {
 		 */
 		static int64_t Detect(const void *data, size_t len, Format *format = nullptr);
 
+		/**
+		 * @brief Parses the header of a record without creating a record
+		 *        instance and without touching the data payload.
+		 * For miniSEED 2 the memory block must contain the fixed header and
+		 * the blockettes 1000 and 1001, for miniSEED 3 the fixed header and
+		 * the source identifier.
+		 * @param data The memory address.
+		 * @param len The length in bytes of the memory block.
+		 * @param header The header to be populated.
+		 * @return Success flag
+		 */
+		static bool ReadHeader(const void *data, size_t len, MSeedHeader &header);
+
+		/**
+		 * @brief Parses the header of the next record in a stream and
+		 *        positions the stream at the start of the following record.
+		 * The stream must be seekable. If the header cannot be parsed or the
+		 * record length is unknown then the stream position is restored.
+		 * @param is The input stream.
+		 * @param header The header to be populated.
+		 * @return Success flag
+		 */
+		static bool ReadHeader(std::istream &is, MSeedHeader &header);
+
+		/**
+		 * @brief Enables or disables deferred signature validation for
+		 *        records read by the calling thread.
+		 * If enabled, signed records read afterwards by this thread keep
+		 * the digest and the signature instead of validating them while
+		 * reading. Their authentication state remains NOT_SIGNED until
+		 * ValidateAuthentication is called which is usually done by a
+		 * SignatureValidator. Records read by other threads are validated
+		 * while reading. The default is disabled.
+		 * @param enable Whether to defer validation
+		 */
+		static void SetDeferredAuthentication(bool enable);
+
+		//! Returns whether signature validation is deferred for records
+		//! read by the calling thread
+		static bool DeferredAuthentication();
+
+		/**
+		 * @brief Validates the pending signatures of a batch of records and
+		 *        updates their authentication state and authority.
+		 * Records without a pending signature are left untouched. The
+		 * records may be validated in any thread but a record must not be
+		 * accessed otherwise during validation.
+		 * @param records The records
+		 * @param count The number of records
+		 */
+		static void ValidateAuthentication(MSeedRecord *const *records, size_t count);
+
 		//! Assignment Operator
 		MSeedRecord &operator=(const MSeedRecord &ms);
 
@@ -114,6 +170,10 @@ class SC_SYSTEM_CORE_API MSeedRecord: public Record {
 		//! Returns the length of a Mini SEED record
 		int recordLength() const { return _recordLength; }
 
+		//! Returns whether the record has been read with deferred
+		//! authentication and its signature has not been validated yet
+		bool hasPendingAuthentication() const { return _pendingSignature != nullptr; }
+
 		//! Returns a nonmutable pointer to the data samples if the data is available; otherwise 0
 		//! (the data type is independent from the original one and was given by the DataType flag in the constructor)
 		const Array* data() const override;
@@ -145,6 +205,8 @@ class SC_SYSTEM_CORE_API MSeedRecord: public Record {
 
 
 	private:
+		struct PendingSignature;
+
 		void updateAuthentication(const char *rec, size_t reclen, size_t offset);
 		void unpackData(const char *rec, size_t reclen) const;
 
@@ -159,6 +221,38 @@ class SC_SYSTEM_CORE_API MSeedRecord: public Record {
 		uint32_t             _recordLength{0};
 		Seiscomp::Core::Time _endTime;
 		bool                 _encodingFlag{false};
+
+		std::shared_ptr<const PendingSignature> _pendingSignature;
+};
+
+
+/**
+ * @brief Lightweight view of a miniSEED record header as returned by
+ *        MSeedRecord::ReadHeader.
+ *
+ * It is meant for routing and filtering where only the stream and the time
+ * window of a record are of interest. Codes are stored in fixed size buffers
+ * and no data is decoded.
+ */
+struct SC_SYSTEM_CORE_API MSeedHeader {
+	//! Maximum length of a single code, miniSEED 3 allows up to 8 characters
+	static constexpr size_t MaxCodeLength = 8;
+
+	MSeedRecord::Format format{MSeedRecord::V2};
+	char                networkCode[MaxCodeLength+1]{};
+	char                stationCode[MaxCodeLength+1]{};
+	char                locationCode[MaxCodeLength+1]{};
+	char                channelCode[MaxCodeLength+1]{};
+	char                quality{'D'};
+	Core::Time          startTime;
+	Core::Time          endTime;
+	double              samplingFrequency{0};
+	int                 sampleCount{0};
+	//! The record length in bytes or -1 if unknown
+	int                 recordLength{-1};
+
+	//! Returns the stream id in the form NET.STA.LOC.CHA
+	std::string streamID() const;
 };
 
 
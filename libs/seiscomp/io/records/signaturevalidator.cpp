@@ -0,0 +1,235 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#include <seiscomp/io/records/mseedrecord.h>
+#include <seiscomp/io/records/signaturevalidator.h>
+
+#include <algorithm>
+
+
+namespace Seiscomp::IO {
+namespace {
+
+
+// Upper bound of records validated by a worker in one go
+constexpr size_t MaxBatchSize = 64;
+
+
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+SignatureValidator::SignatureValidator(Output output, size_t threads, size_t window)
+: _output(std::move(output))
+, _window(std::max(window, size_t(1))) {
+	if ( !threads ) {
+		threads = std::max(std::thread::hardware_concurrency(), 1u);
+	}
+
+	for ( size_t i = 0; i < threads; ++i ) {
+		_workers.emplace_back(&SignatureValidator::work, this);
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+SignatureValidator::~SignatureValidator() {
+	close();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool SignatureValidator::push(Record *rec) {
+	auto *msrec = dynamic_cast<MSeedRecord*>(rec);
+	if ( msrec && !msrec->hasPendingAuthentication() ) {
+		msrec = nullptr;
+	}
+
+	std::unique_lock<std::mutex> lock(_mutex);
+	_slotAvailable.wait(lock, [this] {
+		return _slots.size() < _window || _rejected || _closing;
+	});
+
+	if ( _rejected || _closing ) {
+		delete rec;
+		return false;
+	}
+
+	_slots.push_back({rec, msrec, msrec == nullptr});
+
+	if ( msrec ) {
+		_workAvailable.notify_one();
+	}
+	else if ( _dispatched + 1 == _slots.size() ) {
+		// Nothing is waiting for a worker in front of this record and it
+		// can be forwarded as soon as its predecessors are done
+		++_dispatched;
+		emit(lock);
+	}
+
+	return !_rejected;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void SignatureValidator::close() {
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		if ( _closing ) {
+			return;
+		}
+		_closing = true;
+	}
+
+	// Workers only return if nothing is left to validate
+	_workAvailable.notify_all();
+	_slotAvailable.notify_all();
+
+	for ( auto &worker : _workers ) {
+		worker.join();
+	}
+
+	std::unique_lock<std::mutex> lock(_mutex);
+	emit(lock);
+
+	for ( auto &slot : _slots ) {
+		delete slot.record;
+	}
+
+	_slots.clear();
+	_dispatched = 0;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void SignatureValidator::work() {
+	std::vector<MSeedRecord*> batch;
+	std::vector<size_t> sequenceNumbers;
+
+	std::unique_lock<std::mutex> lock(_mutex);
+
+	while ( true ) {
+		_workAvailable.wait(lock, [this] {
+			return _dispatched < _slots.size() || _closing;
+		});
+
+		if ( _dispatched >= _slots.size() ) {
+			return;
+		}
+
+		// Share the undispatched records with the other workers
+		size_t available = _slots.size() - _dispatched;
+		size_t count = std::min(std::max(available / _workers.size(), size_t(1)), MaxBatchSize);
+
+		batch.clear();
+		sequenceNumbers.clear();
+
+		for ( size_t i = _dispatched; i < _dispatched + count; ++i ) {
+			if ( _slots[i].signedRecord ) {
+				batch.push_back(_slots[i].signedRecord);
+				sequenceNumbers.push_back(_head + i);
+			}
+		}
+
+		_dispatched += count;
+
+		if ( _dispatched < _slots.size() ) {
+			_workAvailable.notify_one();
+		}
+
+		lock.unlock();
+		MSeedRecord::ValidateAuthentication(batch.data(), batch.size());
+		lock.lock();
+
+		// Slots in front of the batch may have been forwarded meanwhile
+		// but none of the batch
+		for ( auto seq : sequenceNumbers ) {
+			_slots[seq - _head].done = true;
+		}
+
+		emit(lock);
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void SignatureValidator::emit(std::unique_lock<std::mutex> &lock) {
+	// Only one thread forwards records at a time which keeps the order.
+	// Records which become ready meanwhile are picked up by the loop.
+	if ( _emitting ) {
+		return;
+	}
+
+	_emitting = true;
+
+	while ( !_slots.empty() && _slots.front().done ) {
+		Record *rec = _slots.front().record;
+		_slots.pop_front();
+		++_head;
+		if ( _dispatched ) {
+			--_dispatched;
+		}
+
+		_slotAvailable.notify_one();
+
+		if ( _rejected ) {
+			delete rec;
+			continue;
+		}
+
+		lock.unlock();
+		bool accepted = _output(rec);
+		lock.lock();
+
+		if ( !accepted ) {
+			delete rec;
+			_rejected = true;
+			_slotAvailable.notify_all();
+		}
+	}
+
+	_emitting = false;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+}
@@ -0,0 +1,160 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#ifndef SEISCOMP_IO_RECORDS_SIGNATUREVALIDATOR_H
+#define SEISCOMP_IO_RECORDS_SIGNATUREVALIDATOR_H
+
+
+#include <seiscomp/core/record.h>
+#include <seiscomp/core.h>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace Seiscomp::IO {
+
+
+class MSeedRecord;
+
+
+/**
+ * @brief Validates record signatures in a pool of worker threads.
+ *
+ * Records are pushed in the order they have been read. Signed miniSEED
+ * records which have been read with deferred authentication (see
+ * MSeedRecord::SetDeferredAuthentication, which must be enabled in the
+ * thread reading the records) are validated in batches by the workers,
+ * all other records just pass through. The records are forwarded
+ * to the output function in exactly the order they have been pushed.
+ *
+ * At most window records are in flight. If the window is full then push
+ * blocks until the oldest record has been forwarded. The output function
+ * is never called concurrently but may be called from any worker thread
+ * or from the thread calling push or close.
+ *
+ * The number of validated and failed signatures is accumulated by the
+ * certificate store, see Util::CertificateStore::validatedCount.
+ */
+class SC_SYSTEM_CORE_API SignatureValidator {
+	// ----------------------------------------------------------------------
+	//  Public types
+	// ----------------------------------------------------------------------
+	public:
+		/**
+		 * Receives the records in input order. The ownership is transferred
+		 * if true is returned. If false is returned, the record is deleted
+		 * and all subsequent records are discarded.
+		 */
+		using Output = std::function<bool (Record*)>;
+
+
+	// ----------------------------------------------------------------------
+	//  X'truction
+	// ----------------------------------------------------------------------
+	public:
+		/**
+		 * @brief Creates the validator and starts the workers.
+		 * @param output The output function
+		 * @param threads The number of worker threads, 0 uses the number
+		 *                of available cores
+		 * @param window The maximum number of records in flight
+		 */
+		SignatureValidator(Output output, size_t threads = 0, size_t window = 1024);
+
+		//! Calls close()
+		~SignatureValidator();
+
+		SignatureValidator(const SignatureValidator &) = delete;
+		SignatureValidator &operator=(const SignatureValidator &) = delete;
+
+
+	// ----------------------------------------------------------------------
+	//  Public interface
+	// ----------------------------------------------------------------------
+	public:
+		/**
+		 * @brief Pushes a record. The ownership is always transferred.
+		 * @param rec The record
+		 * @return False if the output function has rejected a record
+		 *         before, true otherwise.
+		 */
+		bool push(Record *rec);
+
+		/**
+		 * @brief Waits until all pushed records have been forwarded and
+		 *        stops the workers. Subsequent pushes are rejected.
+		 */
+		void close();
+
+		//! Returns the number of worker threads
+		size_t threads() const { return _workers.size(); }
+
+		//! Returns the maximum number of records in flight
+		size_t window() const { return _window; }
+
+
+	// ----------------------------------------------------------------------
+	//  Private methods
+	// ----------------------------------------------------------------------
+	private:
+		void work();
+		void emit(std::unique_lock<std::mutex> &lock);
+
+
+	// ----------------------------------------------------------------------
+	//  Private members
+	// ----------------------------------------------------------------------
+	private:
+		struct Slot {
+			Record      *record;
+			//! The record to validate or null if it passes through
+			MSeedRecord *signedRecord;
+			bool         done;
+		};
+
+		Output                   _output;
+		size_t                   _window;
+		std::vector<std::thread> _workers;
+
+		std::mutex               _mutex;
+		std::condition_variable  _workAvailable;
+		std::condition_variable  _slotAvailable;
+		//! Records in flight in input order
+		std::deque<Slot>         _slots;
+		//! Sequence number of the first slot
+		size_t                   _head{0};
+		//! Number of leading slots which have been handed to a worker
+		size_t                   _dispatched{0};
+		bool                     _emitting{false};
+		bool                     _closing{false};
+		bool                     _rejected{false};
+};
+
+
+}
+
+
+#endif
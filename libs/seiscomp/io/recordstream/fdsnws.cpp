@@ -20,10 +20,16 @@
 
 #define SEISCOMP_COMPONENT FDSNWSConnection
 
+#include <condition_variable>
 #include <cstdlib>
+#include <deque>
+#include <map>
+#include <mutex>
 #include <string>
 #include <set>
+#include <thread>
 #include <utility>
+#include <vector>
 
 #include <seiscomp/logging/log.h>
 #include <seiscomp/core/strings.h>
@@ -42,6 +48,228 @@ using namespace Seiscomp::RecordStream;
 
 REGISTER_RECORDSTREAM(FDSNWSConnection, "fdsnws");
 REGISTER_RECORDSTREAM(FDSNWSSSLConnection, "fdsnwss");
+
+
+namespace {
+
+
+// Reads a miniSEED record from the response body of a client
+IO::MSeedRecord *readRecord(IO::HTTPClient &client, bool &eof) {
+	// HACK to retrieve the record length
+	string data = client.readBinary(RECSIZE);
+	if ( data.empty() ) {
+		eof = true;
+		return nullptr;
+	}
+
+	auto reclen = IO::MSeedRecord::Detect(data.data(), RECSIZE);
+	std::istringstream stream(std::istringstream::in|std::istringstream::binary);
+	if ( reclen > RECSIZE ) {
+		stream.str(data + client.readBinary(reclen - RECSIZE));
+	}
+	else {
+		if ( reclen <= 0 ) {
+			SEISCOMP_ERROR("Retrieving the record length failed (try 512 Byte)!");
+		}
+		stream.str(data);
+	}
+
+	auto *rec = new IO::MSeedRecord;
+	try {
+		rec->read(stream);
+	}
+	catch ( ... ) {
+		delete rec;
+		return nullptr;
+	}
+
+	return rec;
+}
+
+
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+/**
+ * A request which is split into chunks. The chunks are fetched concurrently
+ * by a number of workers, each with its own keep-alive connection, while the
+ * records are delivered strictly in chunk order. The chunks are ordered by
+ * time window first, so the records of each stream stay ordered in time.
+ */
+struct FDSNWSConnectionBase::ChunkedRequest {
+	struct Chunk {
+		std::string           postData;
+		std::deque<Record*>   records;
+		bool                  done{false};
+	};
+
+	~ChunkedRequest() {
+		abort();
+
+		for ( auto &thread : threads ) {
+			thread.join();
+		}
+
+		for ( auto &chunk : chunks ) {
+			for ( auto *rec : chunk.records ) {
+				delete rec;
+			}
+		}
+	}
+
+	void start(const std::string &url, size_t connections, int timeout) {
+		// Allow the workers to run ahead by a few chunks but do not buffer
+		// the whole response
+		window = 2 * connections;
+
+		for ( size_t i = 0; i < connections; ++i ) {
+			clients.emplace_back(new IO::HTTPClient);
+			if ( timeout > 0 ) {
+				clients.back()->setTimeout(timeout);
+			}
+		}
+
+		for ( size_t i = 0; i < connections; ++i ) {
+			threads.emplace_back(&ChunkedRequest::run, this, clients[i].get(), url);
+		}
+	}
+
+	void abort() {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			aborted = true;
+		}
+
+		cv.notify_all();
+
+		for ( auto &client : clients ) {
+			client->close();
+		}
+	}
+
+	void run(IO::HTTPClient *client, std::string url) {
+		while ( true ) {
+			size_t index;
+
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				cv.wait(lock, [this]() {
+					return aborted || nextChunk >= chunks.size()
+					    || nextChunk < current + window;
+				});
+
+				if ( aborted || nextChunk >= chunks.size() ) {
+					return;
+				}
+
+				index = nextChunk++;
+			}
+
+			fetch(client, url, chunks[index]);
+
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				chunks[index].done = true;
+			}
+
+			cv.notify_all();
+		}
+	}
+
+	void fetch(IO::HTTPClient *client, const std::string &url, Chunk &chunk) {
+		try {
+			client->post(url, chunk.postData);
+			if ( !client->chunked() && client->remainingBytes() <= 0 ) {
+				return;
+			}
+
+			while ( true ) {
+				if ( client->error().empty() ) {
+					bool eof = false;
+					auto *rec = readRecord(*client, eof);
+					if ( eof ) {
+						break;
+					}
+
+					if ( !rec ) {
+						continue;
+					}
+
+					{
+						std::lock_guard<std::mutex> lock(mutex);
+						if ( aborted ) {
+							delete rec;
+							return;
+						}
+						chunk.records.push_back(rec);
+					}
+
+					cv.notify_all();
+					continue;
+				}
+
+				string data = client->readBinary(client->chunked() ? 512 : client->remainingBytes());
+				if ( data.empty() ) {
+					throw GeneralException(client->error());
+				}
+
+				client->error() += data;
+			}
+		}
+		catch ( const GeneralException &e ) {
+			if ( !aborted ) {
+				SEISCOMP_ERROR("fdsnws: %s", e.what());
+			}
+
+			client->disconnect();
+		}
+	}
+
+	Record *next() {
+		std::unique_lock<std::mutex> lock(mutex);
+
+		while ( !aborted && current < chunks.size() ) {
+			auto &chunk = chunks[current];
+
+			if ( !chunk.records.empty() ) {
+				auto *rec = chunk.records.front();
+				chunk.records.pop_front();
+				return rec;
+			}
+
+			if ( chunk.done ) {
+				++current;
+				lock.unlock();
+				cv.notify_all();
+				lock.lock();
+				continue;
+			}
+
+			cv.wait(lock);
+		}
+
+		return nullptr;
+	}
+
+	std::vector<Chunk>                           chunks;
+	std::vector<std::unique_ptr<IO::HTTPClient>> clients;
+	std::vector<std::thread>                     threads;
+	std::mutex                                   mutex;
+	std::condition_variable                      cv;
+	size_t                                       nextChunk{0};
+	size_t                                       current{0};
+	size_t                                       window{0};
+	bool                                         aborted{false};
+
+	//! Start time of the last record delivered per stream. The responses
+	//! of adjacent time windows share the record covering the boundary
+	//! which must not be delivered twice.
+	std::map<std::string, Core::Time>            lastStartTimes;
+};
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 
@@ -59,6 +287,13 @@ FDSNWSConnectionBase::FDSNWSConnectionBase(const char *protocol, int defaultPort
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+FDSNWSConnectionBase::~FDSNWSConnectionBase() {}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 bool FDSNWSConnectionBase::setSource(const std::string &source) {
 	// IO::RecordStream entry point. All URL normalisation (scheme translation, default
@@ -107,6 +342,48 @@ bool FDSNWSConnectionBase::setURL(const std::string &url) {
 		}
 	}
 
+	// Extract the options for chunked requests which must not be passed
+	// to the server
+	auto items = _url.queryItems();
+	bool hasOptions = false;
+
+	auto it = items.find("connections");
+	if ( it != items.end() ) {
+		if ( !Core::fromString(_connections, it->second) || !_connections ) {
+			SEISCOMP_ERROR("Invalid FDSNWS connections: %s", it->second);
+			return false;
+		}
+		items.erase(it);
+		hasOptions = true;
+	}
+
+	it = items.find("streamsPerRequest");
+	if ( it != items.end() ) {
+		if ( !Core::fromString(_streamsPerRequest, it->second) ) {
+			SEISCOMP_ERROR("Invalid FDSNWS streamsPerRequest: %s", it->second);
+			return false;
+		}
+		items.erase(it);
+		hasOptions = true;
+	}
+
+	it = items.find("requestWindow");
+	if ( it != items.end() ) {
+		double seconds;
+		if ( !Core::fromString(seconds, it->second) || seconds <= 0 ) {
+			SEISCOMP_ERROR("Invalid FDSNWS requestWindow: %s", it->second);
+			return false;
+		}
+		_requestWindow = TimeSpan(seconds);
+		items.erase(it);
+		hasOptions = true;
+	}
+
+	if ( hasOptions ) {
+		_url.setQueryItems(items);
+		_url.encode();
+	}
+
 	return true;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -208,6 +485,10 @@ bool FDSNWSConnectionBase::clear() {
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 // Hopefully safe to be called from another thread
 void FDSNWSConnectionBase::close() {
+	if ( _chunkedRequest ) {
+		_chunkedRequest->abort();
+	}
+
 	HTTPClient::close();
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -218,6 +499,7 @@ void FDSNWSConnectionBase::close() {
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 bool FDSNWSConnectionBase::reconnect() {
 	HTTPClient::reset();
+	_chunkedRequest.reset();
 	_readingData = false;
 	return true;
 }
@@ -286,8 +568,146 @@ string FDSNWSConnectionBase::createPostData() {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool FDSNWSConnectionBase::startChunkedRequest() {
+	struct Line {
+		const StreamIdx *stream;
+		Time             startTime;
+		Time             endTime;
+	};
+
+	string lineSeparator;
+
+	auto it = _url.queryItems().find("crlf");
+	if ( (it != _url.queryItems().end())
+	     && (it->second.empty() || it->second == "true") ) {
+		lineSeparator = "\r\n";
+	}
+	else {
+		lineSeparator = "\n";
+	}
+
+	// Split the time window of each stream. All pieces with the same index
+	// go into the same time slice.
+	vector<vector<Line>> slices;
+
+	for ( auto it = _streams.begin(); it != _streams.end(); ++it ) {
+		if ( (!it->startTime() && !_stime) || (!it->endTime() && !_etime) ) {
+			/* invalid time window ignore stream */
+			SEISCOMP_WARNING("Ignoring request with invalid time window: %s",
+			                 it->str(_stime, _etime));
+			continue;
+		}
+
+		Time startTime = it->startTime() ? *it->startTime() : *_stime;
+		Time endTime = it->endTime() ? *it->endTime() : *_etime;
+
+		for ( size_t slice = 0; ; ++slice ) {
+			Time sliceEnd = endTime;
+			if ( _requestWindow && (startTime + *_requestWindow < endTime) ) {
+				sliceEnd = startTime + *_requestWindow;
+			}
+
+			if ( slices.size() <= slice ) {
+				slices.resize(slice + 1);
+			}
+
+			slices[slice].push_back({&*it, startTime, sliceEnd});
+
+			if ( sliceEnd >= endTime ) {
+				break;
+			}
+
+			startTime = sliceEnd;
+		}
+	}
+
+	if ( slices.empty() ) {
+		return false;
+	}
+
+	size_t streamsPerRequest = _streamsPerRequest;
+	if ( !streamsPerRequest ) {
+		streamsPerRequest = (slices.front().size() + _connections - 1) / _connections;
+	}
+
+	_chunkedRequest.reset(new ChunkedRequest);
+
+	for ( const auto &slice : slices ) {
+		for ( size_t i = 0; i < slice.size(); i += streamsPerRequest ) {
+			ChunkedRequest::Chunk chunk;
+
+			for ( size_t j = i; j < min(slice.size(), i + streamsPerRequest); ++j ) {
+				const Line &line = slice[j];
+				chunk.postData += line.stream->network() + " " + line.stream->station() + " ";
+				chunk.postData += line.stream->location().empty() ? "--" : line.stream->location();
+				chunk.postData += " ";
+				chunk.postData += line.stream->channel();
+				chunk.postData += " ";
+				chunk.postData += line.startTime.toString("%FT%T.%f");
+				chunk.postData += " ";
+				chunk.postData += line.endTime.toString("%FT%T.%f");
+				chunk.postData += lineSeparator;
+			}
+
+			_chunkedRequest->chunks.push_back(std::move(chunk));
+		}
+	}
+
+	SEISCOMP_DEBUG("Requesting %d streams in %d chunks over %d connections",
+	               int(_streams.size()), int(_chunkedRequest->chunks.size()),
+	               int(_connections));
+
+	Util::Url url(_url);
+	url.encode();
+	_chunkedRequest->start(url.toString(),
+	                       min(_connections, _chunkedRequest->chunks.size()),
+	                       _timeout);
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 Record *FDSNWSConnectionBase::next() {
+	if ( _connections > 1 || _streamsPerRequest || _requestWindow ) {
+		if ( !_readingData ) {
+			_readingData = true;
+			if ( !startChunkedRequest() ) {
+				return nullptr;
+			}
+		}
+
+		if ( !_chunkedRequest ) {
+			return nullptr;
+		}
+
+		Record *rec;
+		while ( (rec = _chunkedRequest->next()) ) {
+			if ( _requestWindow ) {
+				auto it = _chunkedRequest->lastStartTimes.find(rec->streamID());
+				if ( it == _chunkedRequest->lastStartTimes.end() ) {
+					_chunkedRequest->lastStartTimes[rec->streamID()] = rec->startTime();
+				}
+				else if ( rec->startTime() <= it->second ) {
+					delete rec;
+					continue;
+				}
+				else {
+					it->second = rec->startTime();
+				}
+			}
+
+			setupRecord(rec);
+			return rec;
+		}
+
+		return nullptr;
+	}
+
 	// On entry, _socket may be null (no request issued yet) or may already point at an
 	// open or closed socket. The reading-loop invariant 'data has been requested' is
 	// captured by _readingData.
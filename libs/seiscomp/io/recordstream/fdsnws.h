@@ -24,6 +24,7 @@
 #include <string>
 #include <set>
 #include <iostream>
+#include <memory>
 #include <sstream>
 #include <seiscomp/core.h>
 #include <seiscomp/core/interruptible.h>
@@ -55,6 +56,9 @@ class SC_SYSTEM_CORE_API FDSNWSConnectionBase : public IO::RecordStream,
 		// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 		FDSNWSConnectionBase(const char *protocol, int defaultPort);
 
+	public:
+		~FDSNWSConnectionBase() override;
+
 
 	public:
 		//! The recordtype cannot be selected when using an arclink
@@ -76,6 +80,18 @@ class SC_SYSTEM_CORE_API FDSNWSConnectionBase : public IO::RecordStream,
 		//! at all, the connection's default scheme (see constructor)
 		//! is used. Also applies the FDSNWS default request path when
 		//! the URL carries none.
+		//!
+		//! The following query parameters configure chunked retrieval
+		//! and are not sent to the server:
+		//!  - connections: the number of requests issued concurrently,
+		//!    each over its own keep-alive connection
+		//!  - streamsPerRequest: the maximum number of streams per
+		//!    request, by default the streams are spread evenly over
+		//!    all connections
+		//!  - requestWindow: the time window in seconds into which the
+		//!    time window of each stream is split
+		//! If none of them is given then all streams are requested at
+		//! once.
 		bool setURL(const std::string &url) override;
 
 	public:
@@ -119,8 +135,14 @@ class SC_SYSTEM_CORE_API FDSNWSConnectionBase : public IO::RecordStream,
 
 		std::string createPostData();
 
+		//! Splits the request into chunks according to the connection
+		//! options and starts fetching them
+		bool startChunkedRequest();
+
 
 	private:
+		struct ChunkedRequest;
+
 		const char          *_protocol;
 		int                  _defaultPort;
 		std::set<StreamIdx>  _streams;
@@ -128,6 +150,11 @@ class SC_SYSTEM_CORE_API FDSNWSConnectionBase : public IO::RecordStream,
 		OPT(Core::Time)      _etime;
 		std::string          _reqID;
 		bool                 _readingData;
+
+		size_t               _connections{1};
+		size_t               _streamsPerRequest{0};
+		OPT(Core::TimeSpan)  _requestWindow;
+		std::unique_ptr<ChunkedRequest> _chunkedRequest;
 };
 
 
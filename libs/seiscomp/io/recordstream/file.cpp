@@ -23,6 +23,7 @@
 #include <seiscomp/core/strings.h>
 #include <seiscomp/core/system.h>
 #include <seiscomp/logging/log.h>
+#include <seiscomp/io/records/mseedrecord.h>
 #include <seiscomp/system/environment.h>
 
 
@@ -140,6 +141,8 @@ bool File::addStream(const string &net, const string &sta,
 	}
 	else { // wildcards characters are present
 		_reFilter.emplace_back(id, TimeWindowFilter());
+		_rePatterns.add(id);
+		_rePatternsCompiled = false;
 	}
 
 	return true;
@@ -160,6 +163,8 @@ bool File::addStream(const string &net, const string &sta,
 	}
 	else { // wildcards characters are present
 		_reFilter.emplace_back(id, TimeWindowFilter(startTime, endTime));
+		_rePatterns.add(id);
+		_rePatternsCompiled = false;
 	}
 
 	return true;
@@ -207,6 +212,7 @@ bool File::setRecordType(const char *type) {
 	}
 
 	_factory = factory;
+	_mseed = !strcmp(type, "mseed");
 	return true;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -215,9 +221,7 @@ bool File::setRecordType(const char *type) {
 
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
-const File::TimeWindowFilter* File::findTimeWindowFilter(Record *rec) {
-	const string streamID = rec->streamID();
-
+const File::TimeWindowFilter* File::findTimeWindowFilter(const string &streamID) {
 	// First look for fully qualified stream id (no wildcards)
 	const auto &it = _filter.find(streamID);
 	if ( it != _filter.end() ) {
@@ -225,16 +229,19 @@ const File::TimeWindowFilter* File::findTimeWindowFilter(Record *rec) {
 	}
 
 	// then search the wildcarded filters
-	for ( const auto &pair : _reFilter ) {
-		const auto &wild = pair.first;
-		const auto &twf = pair.second;
-		if ( Core::wildcmp(wild, streamID) ) {
-			// now add this stream to the fully qualified ones, so that
-			// next record with the same stream will be resolved without
-			// going through this loop
-			_filter.emplace(streamID, twf);
-			return &twf;
-		}
+	if ( !_rePatternsCompiled ) {
+		_rePatterns.compile();
+		_rePatternsCompiled = true;
+	}
+
+	int index = _rePatterns.match(streamID);
+	if ( index != Util::WildcardSet::NoMatch ) {
+		const auto &twf = _reFilter[index].second;
+		// now add this stream to the fully qualified ones, so that
+		// next record with the same stream will be resolved without
+		// matching the patterns again
+		_filter.emplace(streamID, twf);
+		return &twf;
 	}
 
 	// no matches
@@ -245,6 +252,36 @@ const File::TimeWindowFilter* File::findTimeWindowFilter(Record *rec) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool File::accept(const string &streamID,
+                  const Core::Time &startTime, const Core::Time &endTime) {
+	const TimeWindowFilter *twf = nullptr;
+
+	if ( !_filter.empty() || !_reFilter.empty() ) {
+		twf = findTimeWindowFilter(streamID);
+		// Not subscribed
+		if ( !twf ) {
+			return false;
+		}
+	}
+
+	const auto &stime = twf && twf->start ? twf->start : _startTime;
+	if ( stime && (endTime < *stime) ) {
+		return false;
+	}
+
+	const auto &etime = twf && twf->end ? twf->end : _endTime;
+	if ( etime && (startTime >= *etime) ) {
+		return false;
+	}
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 Record *File::next() {
 	if ( _closeRequested ) {
@@ -256,6 +293,8 @@ Record *File::next() {
 		}
 		_filter.clear();
 		_reFilter.clear();
+		_rePatterns.clear();
+		_rePatternsCompiled = false;
 		_closeRequested = false;
 		return nullptr;
 	}
@@ -264,7 +303,26 @@ Record *File::next() {
 		return nullptr;
 	}
 
+	bool filtered = !_filter.empty() || !_reFilter.empty() || _startTime || _endTime;
+
 	while ( !_closeRequested ) {
+		bool accepted = false;
+
+		// Skip unwanted miniSEED records by parsing their headers only. This
+		// requires a seekable stream.
+		if ( filtered && _mseed && (_current == &_fstream) ) {
+			auto pos = _current->tellg();
+			IO::MSeedHeader header;
+			if ( IO::MSeedRecord::ReadHeader(*_current, header) ) {
+				if ( !accept(header.streamID(), header.startTime, header.endTime) ) {
+					continue;
+				}
+
+				_current->seekg(pos);
+				accepted = true;
+			}
+		}
+
 		auto *rec = _factory->create();
 		if ( !rec ) {
 			return nullptr;
@@ -285,54 +343,10 @@ Record *File::next() {
 			continue;
 		}
 
-		if ( !_filter.empty() || !_reFilter.empty() ) {
-			const auto *twf = findTimeWindowFilter(rec);
-			// Not subscribed
-			if ( !twf ) {
-				delete rec;
-				continue;
-			}
-
-			if ( twf->start ) {
-				if ( rec->endTime() < *twf->start ) {
-					delete rec;
-					continue;
-				}
-			}
-			else if ( _startTime ) {
-				if ( rec->endTime() < *_startTime ) {
-					delete rec;
-					continue;
-				}
-			}
-
-			if ( twf->end ) {
-				if ( rec->startTime() >= *twf->end ) {
-					delete rec;
-					continue;
-				}
-			}
-			else if ( _endTime ) {
-				if ( rec->startTime() >= *_endTime ) {
-					delete rec;
-					continue;
-				}
-			}
-		}
-		else {
-			if ( _startTime ) {
-				if ( rec->endTime() < *_startTime ) {
-					delete rec;
-					continue;
-				}
-			}
-
-			if ( _endTime ) {
-				if ( rec->startTime() >= *_endTime ) {
-					delete rec;
-					continue;
-				}
-			}
+		if ( filtered && !accepted
+		  && !accept(rec->streamID(), rec->startTime(), rec->endTime()) ) {
+			delete rec;
+			continue;
 		}
 
 		return rec;
@@ -27,6 +27,7 @@
 #include <map>
 
 #include <seiscomp/io/recordstream.h>
+#include <seiscomp/utils/wildcardset.h>
 #include <seiscomp/core.h>
 
 
@@ -118,15 +119,21 @@ class SC_SYSTEM_CORE_API File : public Seiscomp::IO::RecordStream {
 		using FilterMap = std::map<std::string, TimeWindowFilter>;
 		using ReFilterList = std::vector<std::pair<std::string,TimeWindowFilter> >;
 
-		const TimeWindowFilter *findTimeWindowFilter(Record *rec);
+		const TimeWindowFilter *findTimeWindowFilter(const std::string &streamID);
+		bool accept(const std::string &streamID,
+		            const Core::Time &startTime, const Core::Time &endTime);
 
 		RecordFactory   *_factory{nullptr};
+		bool             _mseed{false};
 		std::string      _name;
 		bool             _closeRequested;
 		std::fstream     _fstream;
 		std::istream    *_current{&_fstream};
 		FilterMap        _filter;
 		ReFilterList     _reFilter;
+		// Patterns of _reFilter in the same order
+		Util::WildcardSet _rePatterns;
+		bool             _rePatternsCompiled{false};
 		OPT(Core::Time)  _startTime;
 		OPT(Core::Time)  _endTime;
 };
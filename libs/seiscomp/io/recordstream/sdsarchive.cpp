@@ -22,6 +22,11 @@
 
 #include <sys/stat.h>
 
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <thread>
+
 #include <boost/version.hpp>
 #include <boost/filesystem/path.hpp>
 #include <boost/filesystem/operations.hpp>
@@ -74,6 +79,15 @@ Time getStartTime(const string &file) {
 		return startTime;
 	}
 
+	IO::MSeedHeader header;
+	while ( IO::MSeedRecord::ReadHeader(ifs, header) ) {
+		if ( header.sampleCount > 0 ) {
+			return header.startTime;
+		}
+	}
+
+	// Fall back to full record parsing, e.g. if the record length
+	// cannot be derived from the header
 	while ( ifs ) {
 		IO::MSeedRecord rec;
 		rec.setHint(Record::META_ONLY);
@@ -97,6 +111,302 @@ Time getStartTime(const string &file) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+/**
+ * The files of a request are grouped into streams, e.g. all day files of
+ * GE.MORC..BHZ. Worker threads refill the record buffers of the streams
+ * chunk-wise, the one with the fewest buffered records first. The
+ * position in the current file is kept between chunks so that at most one
+ * file per thread is open.
+ *
+ * Without merging, next() returns buffered records of any stream and
+ * continues with the same stream as long as records are available. With
+ * merging, next() waits until each unfinished stream has at least one
+ * buffered record and returns the one with the smallest start time. In
+ * both cases at most window records are buffered per stream.
+ */
+struct SDSArchive::ParallelReader {
+	struct FileJob {
+		string       path;
+		bool         first;
+		const Index *index;
+	};
+
+	struct Stream {
+		vector<FileJob>  files;
+		// The file being read and the position of the next record in
+		// it, -1 if the file has not yet been opened
+		size_t           file{0};
+		streamoff        offset{-1};
+		deque<Record*>   records;
+		bool             busy{false};
+		bool             exhausted{false};
+	};
+
+	using HeapItem = pair<Time, size_t>;
+	using Heap = priority_queue<HeapItem, vector<HeapItem>, greater<HeapItem>>;
+
+	ParallelReader(SDSArchive *archive)
+	: archive(archive) {}
+
+	~ParallelReader() {
+		stop();
+
+		for ( auto &stream : streams ) {
+			for ( auto rec : stream.records ) {
+				delete rec;
+			}
+		}
+	}
+
+	void add(const File &file, const Index *index) {
+		// Strip year and day of year from the file name
+		auto name = fs::path(file.first).filename().string();
+		auto pos = name.rfind('.');
+		if ( pos != string::npos ) {
+			pos = name.rfind('.', pos - 1);
+		}
+
+		if ( pos != string::npos ) {
+			name.erase(pos);
+		}
+
+		auto it = streamIndex.emplace(name, streams.size()).first;
+		if ( it->second == streams.size() ) {
+			streams.emplace_back();
+		}
+
+		streams[it->second].files.push_back(FileJob{file.first, file.second, index});
+	}
+
+	void start(int threads) {
+		// Every stream needs a head record before the first merge
+		for ( size_t i = streams.size(); i > 0; --i ) {
+			waiting.push_back(i - 1);
+		}
+
+		refillThreshold = static_cast<size_t>(archive->_window) / 2;
+		threads = min(threads, static_cast<int>(streams.size()));
+		for ( int i = 0; i < threads; ++i ) {
+			workers.emplace_back(&ParallelReader::work, this);
+		}
+	}
+
+	void stop() {
+		{
+			lock_guard<std::mutex> l(stateMutex);
+			stopped = true;
+		}
+
+		workAvailable.notify_all();
+		recordsAvailable.notify_all();
+
+		for ( auto &worker : workers ) {
+			worker.join();
+		}
+
+		workers.clear();
+	}
+
+	Record *next() {
+		unique_lock<std::mutex> lock(stateMutex);
+
+		if ( archive->_merge ) {
+			while ( !waiting.empty() ) {
+				auto &stream = streams[waiting.back()];
+				recordsAvailable.wait(lock, [this, &stream]() {
+					return stopped || !stream.records.empty() || stream.exhausted;
+				});
+
+				if ( stopped ) {
+					return nullptr;
+				}
+
+				if ( !stream.records.empty() ) {
+					heap.push(HeapItem(stream.records.front()->startTime(), waiting.back()));
+				}
+
+				waiting.pop_back();
+			}
+
+			if ( heap.empty() ) {
+				return nullptr;
+			}
+
+			auto idx = heap.top().second;
+			heap.pop();
+			waiting.push_back(idx);
+			return pop(idx);
+		}
+
+		while ( !stopped ) {
+			bool finished = true;
+
+			for ( size_t i = 0; i < streams.size(); ++i ) {
+				auto idx = (cursor + i) % streams.size();
+				if ( !streams[idx].records.empty() ) {
+					cursor = idx;
+					return pop(idx);
+				}
+
+				if ( !streams[idx].exhausted ) {
+					finished = false;
+				}
+			}
+
+			if ( finished ) {
+				break;
+			}
+
+			recordsAvailable.wait(lock);
+		}
+
+		return nullptr;
+	}
+
+	// Must be called with the lock held
+	Record *pop(size_t idx) {
+		auto &stream = streams[idx];
+		auto rec = stream.records.front();
+		stream.records.pop_front();
+
+		if ( !stream.exhausted && (stream.records.size() == refillThreshold) ) {
+			workAvailable.notify_one();
+		}
+
+		return rec;
+	}
+
+	// Must be called with the lock held
+	Stream *pick() {
+		Stream *candidate = nullptr;
+
+		for ( auto &stream : streams ) {
+			if ( stream.busy || stream.exhausted
+			  || (stream.records.size() > refillThreshold) ) {
+				continue;
+			}
+
+			if ( !candidate || (stream.records.size() < candidate->records.size()) ) {
+				candidate = &stream;
+			}
+		}
+
+		return candidate;
+	}
+
+	void work() {
+		unique_lock<std::mutex> lock(stateMutex);
+		vector<Record*> records;
+
+		while ( !stopped ) {
+			auto stream = pick();
+			if ( !stream ) {
+				workAvailable.wait(lock);
+				continue;
+			}
+
+			stream->busy = true;
+			auto count = static_cast<size_t>(archive->_window) - stream->records.size();
+			lock.unlock();
+
+			read(*stream, count, records);
+
+			lock.lock();
+			stream->records.insert(stream->records.end(), records.begin(), records.end());
+			stream->exhausted = stream->file >= stream->files.size();
+			stream->busy = false;
+			records.clear();
+			recordsAvailable.notify_all();
+		}
+	}
+
+	// Reads up to count records of a stream into records. Only called by
+	// the worker which marked the stream busy.
+	void read(Stream &stream, size_t count, vector<Record*> &records) {
+		while ( (records.size() < count) && (stream.file < stream.files.size()) ) {
+			const auto &job = stream.files[stream.file];
+			bool eof = false;
+
+			ifstream ifs(job.path.c_str(), ifstream::in | ifstream::binary);
+			if ( !ifs.is_open() ) {
+				SEISCOMP_DEBUG("R %s (not found)", job.path);
+				eof = true;
+			}
+			else if ( stream.offset < 0 ) {
+				SEISCOMP_DEBUG("R %s (first: %d)", job.path, job.first);
+				// File part of start time
+				if ( job.first && !archive->setStart(ifs, job.path, *job.index, true) ) {
+					SEISCOMP_DEBUG("W %s (linear search)", job.path);
+					if ( !archive->setStart(ifs, job.path, *job.index, false) ) {
+						SEISCOMP_WARNING("Error reading file %s; start of time window maybe incorrect",
+						                 job.path);
+						eof = true;
+					}
+				}
+			}
+			else {
+				ifs.seekg(stream.offset, ios::beg);
+			}
+
+			while ( !eof && (records.size() < count) ) {
+				auto rec = new IO::MSeedRecord(archive->_dataType, archive->_hint);
+				try {
+					rec->read(ifs);
+					if ( rec->startTime() > job.index->etime ) {
+						delete rec;
+						eof = true;
+						break;
+					}
+
+					records.push_back(rec);
+				}
+				catch ( EndOfStreamException &e ) {
+					delete rec;
+					SEISCOMP_DEBUG("exc: %s", e.what());
+					eof = true;
+				}
+				catch ( exception &e ) {
+					delete rec;
+					SEISCOMP_ERROR("exc: %d, %s", (int)ifs.tellg(), e.what());
+					if ( !ifs.good() ) {
+						eof = true;
+					}
+				}
+			}
+
+			if ( !eof ) {
+				stream.offset = ifs.tellg();
+				eof = stream.offset < 0;
+			}
+
+			if ( eof ) {
+				++stream.file;
+				stream.offset = -1;
+			}
+		}
+	}
+
+	SDSArchive            *archive;
+	vector<Stream>         streams;
+	map<string, size_t>    streamIndex;
+	vector<thread>         workers;
+	std::mutex             stateMutex;
+	condition_variable     workAvailable;
+	condition_variable     recordsAvailable;
+	size_t                 refillThreshold{0};
+	bool                   stopped{false};
+	// Merge state: streams without a record in the heap and the heap of
+	// the next record of each stream
+	vector<size_t>         waiting;
+	Heap                   heap;
+	size_t                 cursor{0};
+};
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 SDSArchive::Index::Index() {}
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -211,7 +521,47 @@ SDSArchive::~SDSArchive() {}
 
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
-bool SDSArchive::setSource(const string &src) {
+bool SDSArchive::setSource(const string &source) {
+	string src = source;
+
+	size_t pos = source.find('?');
+	if ( pos != string::npos ) {
+		src = source.substr(0, pos);
+		vector<string> toks;
+		Core::split(toks, source.c_str() + pos + 1, "&");
+		for ( const auto &tok : toks ) {
+			string name, value;
+
+			pos = tok.find('=');
+			if ( pos != string::npos ) {
+				name = tok.substr(0, pos);
+				value = tok.substr(pos + 1);
+			}
+			else {
+				name = tok;
+			}
+
+			if ( name == "threads" ) {
+				if ( !Core::fromString(_threads, value) || (_threads < 0) ) {
+					SEISCOMP_ERROR("Invalid number of threads: %s", value);
+					return false;
+				}
+			}
+			else if ( name == "window" ) {
+				if ( !Core::fromString(_window, value) || (_window < 1) ) {
+					SEISCOMP_ERROR("Invalid window: %s", value);
+					return false;
+				}
+			}
+			else if ( name == "merge" ) {
+				_merge = true;
+			}
+			else if ( !name.empty() ) {
+				SEISCOMP_WARNING("Unknown parameter: %s", name);
+			}
+		}
+	}
+
 	if ( src.empty() ) {
 		_arcroots.push_back(Environment::Instance()->installDir() + "/var/lib/archive");
 	}
@@ -226,6 +576,10 @@ bool SDSArchive::setSource(const string &src) {
 
 	_closeRequested = false;
 	SEISCOMP_DEBUG("Total of %ld archive roots are in use.", _arcroots.size());
+	if ( _threads > 0 ) {
+		SEISCOMP_DEBUG("Reading with %d threads, window: %d, merge: %d",
+		               _threads, _window, _merge);
+	}
 	return true;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -317,6 +671,10 @@ bool SDSArchive::setTimeout(int seconds) {
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void SDSArchive::close() {
 	lock_guard<mutex> l(_mutex);
+	if ( _reader ) {
+		_reader->stop();
+	}
+
 	_readFiles.clear();
 	_fnames = FileQueue();
 	_streamSet.clear();
@@ -584,38 +942,35 @@ void SDSArchive::resolveRequest() {
 
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
-bool SDSArchive::setStart(const string &fname, bool bsearch) {
+bool SDSArchive::setStart(istream &is, const string &fname,
+                          const Index &index, bool bsearch) {
 	double samprate = 0.0;
 	Time physFirstStartTime, physFirstEndTime;
 	Time recstime, recetime;
-	Time stime = !_curidx->stime ? _stime.value_or(Time()) : *_curidx->stime;
+	Time stime = !index.stime ? _stime.value_or(Time()) : *index.stime;
 	long int offset = 0;
 	bool result = true;
 
-	_file.seekg(0, ios::end);
-	const auto size = (long int)_file.tellg();
-	_file.seekg(0, ios::beg);
+	is.seekg(0, ios::end);
+	const auto size = (long int)is.tellg();
+	is.seekg(0, ios::beg);
 
 	if ( size <= 0 ) {
 		return false;
 	}
 
 	if ( bsearch ) {
-		//! binary search
-		IO::MSeedRecord mseed;
-		mseed.setHint(Record::META_ONLY);
+		//! binary search, only the record headers are parsed
+		IO::MSeedHeader header;
 
-		try {
-			mseed.read(_file);
-		}
-		catch ( exception &e ) {
+		if ( !IO::MSeedRecord::ReadHeader(is, header) ) {
 			return false;
 		}
 
-		samprate = mseed.samplingFrequency();
-		physFirstStartTime = mseed.startTime();
+		samprate = header.samplingFrequency;
+		physFirstStartTime = header.startTime;
 		if ( samprate > 0. ) {
-			physFirstEndTime = mseed.endTime();
+			physFirstEndTime = header.endTime;
 		}
 		else {
 			SEISCOMP_WARNING("[%s@0] Wrong sampling frequency %.2f!", fname, samprate);
@@ -628,7 +983,7 @@ bool SDSArchive::setStart(const string &fname, bool bsearch) {
 		long start = 0;
 		long half = 0;
 		long end = 0;
-		const int reclen = mseed.recordLength();
+		const int reclen = header.recordLength;
 
 		if ( recstime < stime ) {
 			end = static_cast<long>(size / reclen);
@@ -636,32 +991,31 @@ bool SDSArchive::setStart(const string &fname, bool bsearch) {
 
 		while ( (end - start) > 1 ) {
 			half = start + (end - start) / 2;
-			_file.seekg(half * reclen, ios::beg);
+			is.seekg(half * reclen, ios::beg);
 
-			try {
-				mseed.read(_file);
-				if ( mseed.recordLength() != reclen ) {
-					SEISCOMP_WARNING("[%s] Detected mixed record length (%d != %d), abort binary search",
-					                 fname, reclen, mseed.recordLength());
-					return false;
-				}
-				samprate = mseed.samplingFrequency();
-				recstime = mseed.startTime();
-				if ( samprate > 0. ) {
-					recetime = mseed.endTime();
-				}
-				else {
-					SEISCOMP_WARNING("[%s@%ld] Wrong sampling frequency %.2f!",
-					                 fname, half*reclen, samprate);
-					recetime = recstime + TimeSpan(1, 0);
-					result = false;
-				}
-			}
-			catch ( ... ) {
+			if ( !IO::MSeedRecord::ReadHeader(is, header) ) {
 				SEISCOMP_WARNING("[%s@%d] Couldn't read mseed header", fname, half * reclen);
 				return false;
 			}
 
+			if ( header.recordLength != reclen ) {
+				SEISCOMP_WARNING("[%s] Detected mixed record length (%d != %d), abort binary search",
+				                 fname, reclen, header.recordLength);
+				return false;
+			}
+
+			samprate = header.samplingFrequency;
+			recstime = header.startTime;
+			if ( samprate > 0. ) {
+				recetime = header.endTime;
+			}
+			else {
+				SEISCOMP_WARNING("[%s@%ld] Wrong sampling frequency %.2f!",
+				                 fname, half*reclen, samprate);
+				recetime = recstime + TimeSpan(1, 0);
+				result = false;
+			}
+
 			if ( recetime < stime ) {
 				start = half;
 				if ( (end - start) == 1 ) {
@@ -688,14 +1042,14 @@ bool SDSArchive::setStart(const string &fname, bool bsearch) {
 		offset = half * reclen;
 	}
 	else {
-		while ( _file ) {
+		while ( is ) {
 			IO::MSeedRecord mseed;
 			mseed.setHint(Record::META_ONLY);
 
-			offset = _file.tellg();
+			offset = is.tellg();
 
 			try {
-				mseed.read(_file);
+				mseed.read(is);
 			}
 			catch ( exception &e ) {
 				continue;
@@ -723,9 +1077,9 @@ bool SDSArchive::setStart(const string &fname, bool bsearch) {
 		}
 	}
 
-	_file.seekg(offset, ios::beg);
+	is.seekg(offset, ios::beg);
 	if ( offset == size ) {
-		_file.clear(ios::eofbit);
+		is.clear(ios::eofbit);
 	}
 
 	return result;
@@ -735,8 +1089,62 @@ bool SDSArchive::setStart(const string &fname, bool bsearch) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void SDSArchive::startReader() {
+	_reader.reset(new ParallelReader(this));
+
+	for ( _curiter = _orderedRequests.begin(); _curiter != _orderedRequests.end(); ++_curiter ) {
+		if ( !_etime ) {
+			_etime = Time::UTC();
+		}
+
+		if ( !_curiter->stime && !_stime ) {
+			SEISCOMP_WARNING("... has invalid time window -> ignore this request above");
+			continue;
+		}
+
+		_curidx = &*_curiter;
+		// Check start/end times and set globals if not set
+		if ( !_curidx->stime ) {
+			_curidx->stime = _stime;
+		}
+		if ( !_curidx->etime ) {
+			_curidx->etime = _etime;
+		}
+
+		resolveRequest();
+
+		while ( !_fnames.empty() ) {
+			_reader->add(_fnames.front(), _curidx);
+			_fnames.pop();
+		}
+	}
+
+	_reader->start(_threads);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 Seiscomp::Record *SDSArchive::next() {
+	if ( _threads > 0 ) {
+		{
+			lock_guard<mutex> l(_mutex);
+			if ( !_reader ) {
+				if ( _closeRequested ) {
+					return nullptr;
+				}
+
+				startReader();
+			}
+		}
+
+		// Not locked to allow close() from another thread
+		return _reader->next();
+	}
+
 	lock_guard<mutex> l(_mutex);
 
 	if ( _file.is_open() ) {
@@ -811,9 +1219,9 @@ Seiscomp::Record *SDSArchive::next() {
 					SEISCOMP_DEBUG("R %s (first: %d)", file.first, file.second);
 					// File part of start time
 					if ( file.second ) {
-						if ( !setStart(file.first, true) ) {
+						if ( !setStart(_file, file.first, *_curidx, true) ) {
 							SEISCOMP_DEBUG("W %s (linear search)", file.first);
-							if ( !setStart(file.first, false) ) {
+							if ( !setStart(_file, file.first, *_curidx, false) ) {
 								SEISCOMP_WARNING("Error reading file %s; start of time window maybe incorrect",
 								                 file.first);
 								_file.close();
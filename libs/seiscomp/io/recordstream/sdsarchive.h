@@ -25,6 +25,7 @@
 #include <fstream>
 #include <queue>
 #include <list>
+#include <memory>
 #include <set>
 #include <mutex>
 
@@ -105,6 +106,9 @@ class SDSArchive : public Seiscomp::IO::RecordStream {
 		};
 
 
+		// Reads the files of several streams concurrently, see next()
+		struct ParallelReader;
+
 		using IndexSet = std::set<Index>;
 		using IndexList = std::list<Index>;
 		using File = std::pair<std::string, bool>;
@@ -120,12 +124,24 @@ class SDSArchive : public Seiscomp::IO::RecordStream {
 		FileQueue                 _fnames;
 		std::set<std::string>     _readFiles;
 		std::mutex                _mutex;
-		bool                      _closeRequested;
+		bool                      _closeRequested{false};
 		std::ifstream             _file;
 
+		// Number of reader threads, 0 reads the files sequentially in
+		// the calling thread
+		int                       _threads{0};
+		// Whether records of concurrently read streams are merged by
+		// start time
+		bool                      _merge{false};
+		// Maximum number of records buffered per stream
+		int                       _window{100};
+		std::unique_ptr<ParallelReader> _reader;
+
 		int getDoy(const Seiscomp::Core::Time &time);
 		void resolveRequest();
-		bool setStart(const std::string &fname, bool bsearch);
+		void startReader();
+		bool setStart(std::istream &is, const std::string &fname,
+		              const Index &index, bool bsearch);
 
 		bool resolveNet(std::string &path,
 		                const std::string &net, const std::string &sta,
@@ -0,0 +1,841 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#define SEISCOMP_COMPONENT SHM
+
+#include <seiscomp/io/recordstream/shm.h>
+#include <seiscomp/io/records/mseedrecord.h>
+#include <seiscomp/core/strings.h>
+#include <seiscomp/core/system.h>
+#include <seiscomp/logging/log.h>
+
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+using namespace std;
+
+
+namespace Seiscomp {
+namespace RecordStream {
+
+
+using namespace SharedMemory;
+
+
+IMPLEMENT_SC_CLASS_DERIVED(SharedMemoryStream,
+                           Seiscomp::IO::RecordStream,
+                           "SharedMemoryStream");
+
+REGISTER_RECORDSTREAM(SharedMemoryStream, "shm");
+
+
+namespace {
+
+
+string objectName(const string &name) {
+	return name.empty() || name[0] != '/' ? "/" + name : name;
+}
+
+
+size_t indexOffset() {
+	return (sizeof(Header) + 63) & ~size_t(63);
+}
+
+
+size_t slotsOffset(size_t indexSize) {
+	return (indexOffset() + indexSize * sizeof(IndexEntry) + 63) & ~size_t(63);
+}
+
+
+size_t segmentSize(size_t slotCount, size_t slotSize, size_t indexSize) {
+	return slotsOffset(indexSize) + slotCount * slotSize;
+}
+
+
+// FNV-1a
+uint32_t hashStreamID(const char *id, size_t len) {
+	uint32_t h = 2166136261u;
+	for ( size_t i = 0; i < len; ++i ) {
+		h ^= static_cast<unsigned char>(id[i]);
+		h *= 16777619u;
+	}
+	return h;
+}
+
+
+}
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+SharedMemoryFeeder::SharedMemoryFeeder() {}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+SharedMemoryFeeder::~SharedMemoryFeeder() {
+	close();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool SharedMemoryFeeder::create(const string &name,
+                                size_t slotCount, size_t slotSize,
+                                size_t indexSize, const char *recordType) {
+	close();
+
+	// Each slot must be 8 byte aligned to keep the sequence atomic
+	slotSize = (slotSize + sizeof(SlotHeader) + 7) & ~size_t(7);
+
+	if ( !slotCount || !indexSize || strlen(recordType) >= sizeof(Header::recordType) ) {
+		SEISCOMP_ERROR("[shm] %s: invalid ring geometry", name.c_str());
+		return false;
+	}
+
+	if ( slotCount > UINT32_MAX || slotSize > UINT32_MAX || indexSize > UINT32_MAX ) {
+		SEISCOMP_ERROR("[shm] %s: ring too large", name.c_str());
+		return false;
+	}
+
+	string objName = objectName(name);
+
+	// Start with a fresh segment. Readers still attached to a previous
+	// ring keep their mapping and will not see any new records.
+	shm_unlink(objName.c_str());
+
+	int fd = shm_open(objName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+	if ( fd < 0 ) {
+		SEISCOMP_ERROR("[shm] %s: %s", name.c_str(), strerror(errno));
+		return false;
+	}
+
+	size_t size = segmentSize(slotCount, slotSize, indexSize);
+	if ( ftruncate(fd, static_cast<off_t>(size)) != 0 ) {
+		SEISCOMP_ERROR("[shm] %s: %s", name.c_str(), strerror(errno));
+		::close(fd);
+		shm_unlink(objName.c_str());
+		return false;
+	}
+
+	void *mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	::close(fd);
+
+	if ( mapping == MAP_FAILED ) {
+		SEISCOMP_ERROR("[shm] %s: %s", name.c_str(), strerror(errno));
+		shm_unlink(objName.c_str());
+		return false;
+	}
+
+	_name = name;
+	_mapping = mapping;
+	_mappingSize = size;
+
+	// ftruncate zero fills the segment, so only the header needs to be set
+	auto *base = static_cast<char*>(_mapping);
+	_header = new (base) Header;
+	_index = reinterpret_cast<IndexEntry*>(base + indexOffset());
+	_slots = base + slotsOffset(indexSize);
+
+	for ( size_t i = 0; i < indexSize; ++i ) {
+		new (_index + i) IndexEntry;
+		_index[i].state.store(0, memory_order_relaxed);
+	}
+
+	for ( size_t i = 0; i < slotCount; ++i ) {
+		auto *slot = new (_slots + i * slotSize) SlotHeader;
+		slot->sequence.store(0, memory_order_relaxed);
+	}
+
+	_header->version = Version;
+	_header->slotCount = static_cast<uint32_t>(slotCount);
+	_header->slotSize = static_cast<uint32_t>(slotSize);
+	_header->indexSize = static_cast<uint32_t>(indexSize);
+	strncpy(_header->recordType, recordType, sizeof(_header->recordType)-1);
+	_header->head.store(0, memory_order_relaxed);
+
+	// Publish the magic last so that readers do not attach to a half
+	// initialized ring
+	atomic_thread_fence(memory_order_release);
+	memcpy(_header->magic, Magic, sizeof(Magic));
+
+	SEISCOMP_INFO("[shm] %s: created ring with %zu slots of %zu bytes (%zu MB)",
+	              name.c_str(), slotCount, slotSize, size / (1024*1024));
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void SharedMemoryFeeder::close(bool unlink) {
+	if ( _mapping ) {
+		munmap(_mapping, _mappingSize);
+		if ( unlink ) {
+			shm_unlink(objectName(_name).c_str());
+		}
+	}
+
+	_mapping = nullptr;
+	_mappingSize = 0;
+	_header = nullptr;
+	_index = nullptr;
+	_slots = nullptr;
+	_streams.clear();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool SharedMemoryFeeder::isOpen() const {
+	return _mapping != nullptr;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+uint64_t SharedMemoryFeeder::head() const {
+	return _header ? _header->head.load(memory_order_relaxed) : 0;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+int SharedMemoryFeeder::findOrInsertStream(const string &streamID) {
+	auto it = _streams.find(streamID);
+	if ( it != _streams.end() ) {
+		return static_cast<int>(it->second);
+	}
+
+	if ( streamID.size() > MaxStreamIDLength ) {
+		SEISCOMP_WARNING("[shm] %s: stream id too long", streamID.c_str());
+		return -1;
+	}
+
+	uint32_t size = _header->indexSize;
+	uint32_t pos = hashStreamID(streamID.data(), streamID.size()) % size;
+
+	for ( uint32_t i = 0; i < size; ++i, pos = (pos + 1) % size ) {
+		IndexEntry &entry = _index[pos];
+		// The feeder is the only writer, so an unused entry can be
+		// claimed without compare-exchange
+		if ( entry.state.load(memory_order_relaxed) == 0 ) {
+			memset(entry.id, 0, sizeof(entry.id));
+			memcpy(entry.id, streamID.data(), streamID.size());
+			entry.state.store(1, memory_order_release);
+			_streams[streamID] = pos;
+			return static_cast<int>(pos);
+		}
+
+		// Entry left from a previous feeder process attached to the
+		// same segment
+		if ( streamID == entry.id ) {
+			_streams[streamID] = pos;
+			return static_cast<int>(pos);
+		}
+	}
+
+	SEISCOMP_WARNING("[shm] %s: stream index is full, dropping %s",
+	                 _name.c_str(), streamID.c_str());
+	return -1;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool SharedMemoryFeeder::push(Record *rec) {
+	if ( !rec || !_header ) {
+		return false;
+	}
+
+	// Publish the received payload if still available rather than
+	// encoding the samples again
+	if ( !strcmp(_header->recordType, "mseed") && IO::MSeedRecord::Cast(rec) ) {
+		const Array *raw = rec->raw();
+		if ( raw && raw->size() > 0 ) {
+			return push(static_cast<const char*>(raw->data()),
+			            static_cast<size_t>(raw->size()) * raw->elementSize(),
+			            rec->streamID(), rec->startTime(), rec->endTime());
+		}
+	}
+
+	ostringstream os;
+	try {
+		rec->write(os);
+	}
+	catch ( exception &e ) {
+		SEISCOMP_WARNING("[shm] %s: failed to serialize record: %s",
+		                 rec->streamID().c_str(), e.what());
+		return false;
+	}
+
+	_buffer = os.str();
+	return push(_buffer.data(), _buffer.size(), rec->streamID(),
+	            rec->startTime(), rec->endTime());
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool SharedMemoryFeeder::push(const char *data, size_t size,
+                              const string &streamID,
+                              const Core::Time &startTime,
+                              const Core::Time &endTime) {
+	if ( !_header ) {
+		return false;
+	}
+
+	if ( size > _header->slotSize - sizeof(SlotHeader) ) {
+		SEISCOMP_WARNING("[shm] %s: record of %zu bytes exceeds slot size",
+		                 streamID.c_str(), size);
+		return false;
+	}
+
+	int streamIndex = findOrInsertStream(streamID);
+	if ( streamIndex < 0 ) {
+		return false;
+	}
+
+	uint64_t seq = _header->head.load(memory_order_relaxed);
+	auto *slot = reinterpret_cast<SlotHeader*>(
+		_slots + (seq % _header->slotCount) * _header->slotSize
+	);
+
+	// Mark the slot as busy before modifying the payload
+	slot->sequence.store(0, memory_order_relaxed);
+	atomic_thread_fence(memory_order_release);
+
+	slot->streamIndex = static_cast<uint32_t>(streamIndex);
+	slot->length = static_cast<uint32_t>(size);
+	slot->startSeconds = startTime.epochSeconds();
+	slot->startMicroSeconds = startTime.microseconds();
+	slot->endSeconds = endTime.epochSeconds();
+	slot->endMicroSeconds = endTime.microseconds();
+	memcpy(reinterpret_cast<char*>(slot) + sizeof(SlotHeader), data, size);
+
+	slot->sequence.store(seq + 1, memory_order_release);
+	_header->head.store(seq + 1, memory_order_release);
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+streambuf *SharedMemoryStream::StreamBuffer::setbuf(char *s, streamsize n) {
+	setp(nullptr, nullptr);
+	setg(s, s, s + n);
+	return this;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+SharedMemoryStream::SharedMemoryStream() {
+	setRecordType("mseed");
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+SharedMemoryStream::~SharedMemoryStream() {
+	detach();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool SharedMemoryStream::setSource(const string &source) {
+	detach();
+
+	_pollInterval = 10;
+	_closeRequested = false;
+
+	size_t pos = source.find('?');
+	if ( pos != string::npos ) {
+		_name = source.substr(0, pos);
+		vector<string> toks;
+		Core::split(toks, source.substr(pos+1).c_str(), "&");
+		for ( const auto &tok : toks ) {
+			string name, value;
+
+			pos = tok.find('=');
+			if ( pos != string::npos ) {
+				name = tok.substr(0, pos);
+				value = tok.substr(pos+1);
+			}
+			else {
+				name = tok;
+			}
+
+			if ( name == "poll" ) {
+				if ( !Core::fromString(_pollInterval, value) || _pollInterval < 1 ) {
+					SEISCOMP_ERROR("[shm] invalid poll interval: %s", value.c_str());
+					return false;
+				}
+			}
+			else if ( !name.empty() ) {
+				SEISCOMP_WARNING("[shm] unknown parameter: %s", name.c_str());
+			}
+		}
+	}
+	else {
+		_name = source;
+	}
+
+	if ( _name.empty() ) {
+		_name = "seiscomp";
+	}
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool SharedMemoryStream::addStream(const string &net, const string &sta,
+                                   const string &loc, const string &cha) {
+	return addStream(net, sta, loc, cha, Core::None, Core::None);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool SharedMemoryStream::addStream(const string &net, const string &sta,
+                                   const string &loc, const string &cha,
+                                   const OPT(Seiscomp::Core::Time) &startTime,
+                                   const OPT(Seiscomp::Core::Time) &endTime) {
+	auto id = net + "." + sta + "." + loc + "." + cha;
+	if ( id.find_first_of("*?") == string::npos ) {
+		_filter[id] = TimeWindowFilter(startTime, endTime);
+	}
+	else { // wildcards characters are present
+		_reFilter.emplace_back(id, TimeWindowFilter(startTime, endTime));
+		_rePatterns.add(id);
+		_rePatternsCompiled = false;
+	}
+
+	// Subscriptions changed, resolve all streams again
+	_subscriptions.clear();
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool SharedMemoryStream::setStartTime(const OPT(Seiscomp::Core::Time) &startTime) {
+	_startTime = startTime;
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool SharedMemoryStream::setEndTime(const OPT(Seiscomp::Core::Time) &endTime) {
+	_endTime = endTime;
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void SharedMemoryStream::close() {
+	_closeRequested = true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool SharedMemoryStream::setRecordType(const char *type) {
+	auto *factory = RecordFactory::Find(type);
+	if ( !factory ) {
+		SEISCOMP_ERROR("Unknown record type '%s'", type);
+		return false;
+	}
+
+	_factory = factory;
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool SharedMemoryStream::attach() {
+	string objName = objectName(_name);
+	int fd = shm_open(objName.c_str(), O_RDONLY, 0);
+	if ( fd < 0 ) {
+		return false;
+	}
+
+	struct stat st;
+	if ( fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(Header) ) {
+		::close(fd);
+		return false;
+	}
+
+	void *mapping = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	::close(fd);
+
+	if ( mapping == MAP_FAILED ) {
+		SEISCOMP_ERROR("[shm] %s: %s", _name.c_str(), strerror(errno));
+		return false;
+	}
+
+	auto *header = static_cast<const Header*>(mapping);
+	if ( memcmp(header->magic, Magic, sizeof(Magic)) != 0 ) {
+		// Not yet initialized by the feeder
+		munmap(mapping, st.st_size);
+		return false;
+	}
+
+	atomic_thread_fence(memory_order_acquire);
+
+	if ( header->version != Version
+	  || segmentSize(header->slotCount, header->slotSize, header->indexSize) > static_cast<size_t>(st.st_size) ) {
+		SEISCOMP_ERROR("[shm] %s: incompatible ring layout", _name.c_str());
+		munmap(mapping, st.st_size);
+		return false;
+	}
+
+	char recordType[sizeof(header->recordType)+1];
+	memcpy(recordType, header->recordType, sizeof(header->recordType));
+	recordType[sizeof(header->recordType)] = '\0';
+
+	if ( !setRecordType(recordType) ) {
+		munmap(mapping, st.st_size);
+		return false;
+	}
+
+	_mapping = mapping;
+	_mappingSize = st.st_size;
+	_inode = st.st_ino;
+	_header = header;
+	_index = reinterpret_cast<const IndexEntry*>(
+		static_cast<const char*>(mapping) + indexOffset()
+	);
+	_slots = static_cast<const char*>(mapping) + slotsOffset(header->indexSize);
+	_subscriptions.clear();
+	_buffer.resize(header->slotSize);
+
+	uint64_t head = _header->head.load(memory_order_acquire);
+	if ( _startTime && head > _header->slotCount ) {
+		_cursor = head - _header->slotCount;
+	}
+	else if ( _startTime ) {
+		_cursor = 0;
+	}
+	else {
+		_cursor = head;
+	}
+
+	SEISCOMP_INFO("[shm] %s: attached at sequence %llu",
+	              _name.c_str(), static_cast<unsigned long long>(_cursor));
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool SharedMemoryStream::isStale() const {
+	int fd = shm_open(objectName(_name).c_str(), O_RDONLY, 0);
+	if ( fd < 0 ) {
+		// Removed, keep reading what is left
+		return false;
+	}
+
+	struct stat st;
+	bool stale = fstat(fd, &st) == 0 && st.st_ino != _inode;
+	::close(fd);
+	return stale;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void SharedMemoryStream::idle() {
+	// Check about once a second whether the feeder has recreated the ring
+	// while we are still reading the old one
+	if ( ++_idlePolls * _pollInterval >= 1000 ) {
+		_idlePolls = 0;
+		if ( isStale() ) {
+			SEISCOMP_INFO("[shm] %s: ring has been recreated", _name.c_str());
+			detach();
+			return;
+		}
+	}
+
+	this_thread::sleep_for(chrono::milliseconds(_pollInterval));
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void SharedMemoryStream::detach() {
+	if ( _mapping ) {
+		munmap(_mapping, _mappingSize);
+	}
+
+	_mapping = nullptr;
+	_mappingSize = 0;
+	_inode = 0;
+	_idlePolls = 0;
+	_header = nullptr;
+	_index = nullptr;
+	_slots = nullptr;
+	_subscriptions.clear();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+const SharedMemoryStream::TimeWindowFilter *
+SharedMemoryStream::findTimeWindowFilter(uint32_t streamIndex, bool &subscribed) {
+	if ( _filter.empty() && _reFilter.empty() ) {
+		subscribed = true;
+		return nullptr;
+	}
+
+	if ( _subscriptions.empty() ) {
+		_subscriptions.resize(_header->indexSize);
+	}
+
+	Subscription &sub = _subscriptions[streamIndex];
+	if ( !sub.resolved ) {
+		const IndexEntry &entry = _index[streamIndex];
+		if ( entry.state.load(memory_order_acquire) == 0 ) {
+			subscribed = false;
+			return nullptr;
+		}
+
+		string streamID(entry.id, strnlen(entry.id, sizeof(entry.id)));
+
+		sub.resolved = true;
+		sub.filter = nullptr;
+
+		auto it = _filter.find(streamID);
+		if ( it != _filter.end() ) {
+			sub.filter = &it->second;
+		}
+		else {
+			if ( !_rePatternsCompiled ) {
+				_rePatterns.compile();
+				_rePatternsCompiled = true;
+			}
+
+			int index = _rePatterns.match(streamID);
+			if ( index != Util::WildcardSet::NoMatch ) {
+				sub.filter = &_filter.emplace(streamID, _reFilter[index].second).first->second;
+			}
+		}
+	}
+
+	subscribed = sub.filter != nullptr;
+	return sub.filter;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool SharedMemoryStream::accept(const TimeWindowFilter *twf,
+                                const Core::Time &startTime,
+                                const Core::Time &endTime) const {
+	const OPT(Core::Time) &stime = twf && twf->start ? twf->start : _startTime;
+	const OPT(Core::Time) &etime = twf && twf->end ? twf->end : _endTime;
+
+	if ( stime && endTime < *stime ) {
+		return false;
+	}
+
+	if ( etime && startTime >= *etime ) {
+		return false;
+	}
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Record *SharedMemoryStream::next() {
+	while ( !_closeRequested ) {
+		if ( !_header && !attach() ) {
+			this_thread::sleep_for(chrono::milliseconds(_pollInterval * 10));
+			continue;
+		}
+
+		uint64_t head = _header->head.load(memory_order_acquire);
+		if ( _cursor >= head ) {
+			idle();
+			continue;
+		}
+
+		if ( head - _cursor > _header->slotCount ) {
+			uint64_t skip = head - _header->slotCount;
+			SEISCOMP_WARNING("[shm] %s: reader overrun, skipping %llu records",
+			                 _name.c_str(),
+			                 static_cast<unsigned long long>(skip - _cursor));
+			_cursor = skip;
+		}
+
+		uint64_t seq = _cursor;
+		auto *slot = reinterpret_cast<const SlotHeader*>(
+			_slots + (seq % _header->slotCount) * _header->slotSize
+		);
+
+		if ( slot->sequence.load(memory_order_acquire) != seq + 1 ) {
+			// The record has been or is being overwritten by the feeder.
+			// It cannot be read anymore. Back off before continuing with
+			// the next one: if the feeder died while writing the slot, the
+			// sequence will never change again.
+			SEISCOMP_DEBUG("[shm] %s: record %llu has been overwritten",
+			               _name.c_str(), static_cast<unsigned long long>(seq));
+			++_cursor;
+			idle();
+			continue;
+		}
+
+		_idlePolls = 0;
+
+		uint32_t streamIndex = slot->streamIndex;
+		uint32_t length = slot->length;
+		Core::Time startTime = Core::Time::FromEpoch(slot->startSeconds, slot->startMicroSeconds);
+		Core::Time endTime = Core::Time::FromEpoch(slot->endSeconds, slot->endMicroSeconds);
+
+		bool subscribed = false;
+		const TimeWindowFilter *twf = nullptr;
+		if ( streamIndex < _header->indexSize ) {
+			twf = findTimeWindowFilter(streamIndex, subscribed);
+		}
+
+		bool wanted = subscribed && accept(twf, startTime, endTime)
+		           && length <= _header->slotSize - sizeof(SlotHeader);
+		if ( wanted ) {
+			memcpy(_buffer.data(),
+			       reinterpret_cast<const char*>(slot) + sizeof(SlotHeader),
+			       length);
+		}
+
+		atomic_thread_fence(memory_order_acquire);
+		if ( slot->sequence.load(memory_order_relaxed) != seq + 1 ) {
+			// The writer has overtaken us while copying
+			continue;
+		}
+
+		++_cursor;
+
+		if ( !wanted ) {
+			continue;
+		}
+
+		auto *rec = _factory->create();
+		if ( !rec ) {
+			return nullptr;
+		}
+
+		setupRecord(rec);
+
+		istream stream(&_streambuf);
+		stream.rdbuf()->pubsetbuf(_buffer.data(), length);
+
+		try {
+			rec->read(stream);
+		}
+		catch ( exception &e ) {
+			SEISCOMP_ERROR("[shm] read exception: %s", e.what());
+			delete rec;
+			continue;
+		}
+
+		return rec;
+	}
+
+	detach();
+	_filter.clear();
+	_reFilter.clear();
+	_rePatterns.clear();
+	_rePatternsCompiled = false;
+	_closeRequested = false;
+
+	return nullptr;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+}
+}
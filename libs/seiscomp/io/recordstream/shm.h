@@ -0,0 +1,301 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#ifndef SEISCOMP_SERVICES_RECORDSTREAM_SHM_H
+#define SEISCOMP_SERVICES_RECORDSTREAM_SHM_H
+
+
+#include <seiscomp/io/recordstream.h>
+#include <seiscomp/utils/wildcardset.h>
+#include <seiscomp/core.h>
+
+#include <sys/types.h>
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+
+namespace Seiscomp {
+namespace RecordStream {
+
+
+namespace SharedMemory {
+
+
+/**
+ * @brief Layout of a shared memory record ring.
+ *
+ * The segment starts with a Header followed by the stream index (an open
+ * addressing hash table with Header::indexSize entries) and Header::slotCount
+ * slots of Header::slotSize bytes each. A slot holds a SlotHeader followed
+ * by the raw record payload.
+ *
+ * Records are numbered with a monotonically increasing sequence number.
+ * Record n is stored in slot n % slotCount. Each slot is protected by a
+ * sequence lock: the writer sets SlotHeader::sequence to 0 before touching
+ * the slot and to n + 1 after the payload has been written. Readers copy the
+ * payload and check the sequence again afterwards to detect that they have
+ * been overrun by the writer.
+ */
+constexpr char     Magic[4] = {'S', 'C', 'R', 'R'};
+constexpr uint32_t Version = 1;
+constexpr size_t   MaxStreamIDLength = 63;
+
+struct Header {
+	char                  magic[4];
+	uint32_t              version;
+	uint32_t              slotCount;
+	uint32_t              slotSize;
+	uint32_t              indexSize;
+	char                  recordType[16];
+	//! The sequence number of the next record to be written
+	std::atomic<uint64_t> head;
+};
+
+struct IndexEntry {
+	//! 0 if unused, 1 if the id has been written
+	std::atomic<uint32_t> state;
+	char                  id[MaxStreamIDLength+1];
+};
+
+struct SlotHeader {
+	std::atomic<uint64_t> sequence;
+	uint32_t              streamIndex;
+	uint32_t              length;
+	int64_t               startSeconds;
+	int64_t               endSeconds;
+	int32_t               startMicroSeconds;
+	int32_t               endMicroSeconds;
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "Shared memory ring requires lock-free 64 bit atomics");
+
+
+}
+
+
+DEFINE_SMARTPOINTER(SharedMemoryFeeder);
+
+/**
+ * @brief Publishes records into a shared memory ring which can be read by
+ *        any number of SharedMemoryStream instances on the same host.
+ *
+ * Only one feeder must write to a ring at a time. Readers never block the
+ * feeder: if a reader is too slow then it will skip the records that
+ * have been overwritten in the meantime.
+ */
+class SC_SYSTEM_CORE_API SharedMemoryFeeder : public Core::BaseObject {
+	// ----------------------------------------------------------------------
+	//  X'truction
+	// ----------------------------------------------------------------------
+	public:
+		SharedMemoryFeeder();
+		~SharedMemoryFeeder() override;
+
+
+	// ----------------------------------------------------------------------
+	//  Public interface
+	// ----------------------------------------------------------------------
+	public:
+		/**
+		 * @brief Creates (or recreates) a shared memory ring.
+		 * @param name The name of the ring, e.g. "seiscomp". It maps to the
+		 *             POSIX shared memory object "/name".
+		 * @param slotCount The number of records held by the ring.
+		 * @param slotSize The maximum size of a record in bytes.
+		 * @param indexSize The maximum number of distinct streams.
+		 * @param recordType The record type written to the ring, which
+		 *                   is used by readers to decode the payload.
+		 * @return Success flag
+		 */
+		bool create(const std::string &name,
+		            size_t slotCount = 65536, size_t slotSize = 512,
+		            size_t indexSize = 8192,
+		            const char *recordType = "mseed");
+
+		/**
+		 * @brief Unmaps the ring.
+		 * @param unlink Whether to remove the shared memory object.
+		 */
+		void close(bool unlink = false);
+
+		bool isOpen() const;
+
+		/**
+		 * @brief Publishes a record. miniSEED records read with the
+		 *        SAVE_RAW hint are published as received, other records
+		 *        are serialized with Record::write.
+		 * @return Success flag
+		 */
+		bool push(Record *rec);
+
+		/**
+		 * @brief Publishes an already serialized record.
+		 * @return Success flag
+		 */
+		bool push(const char *data, size_t size, const std::string &streamID,
+		          const Core::Time &startTime, const Core::Time &endTime);
+
+		//! Returns the sequence number of the next record to be written.
+		uint64_t head() const;
+
+
+	// ----------------------------------------------------------------------
+	//  Private members
+	// ----------------------------------------------------------------------
+	private:
+		int findOrInsertStream(const std::string &streamID);
+
+	private:
+		using StreamIndex = std::map<std::string, uint32_t>;
+
+		std::string                  _name;
+		void                        *_mapping{nullptr};
+		size_t                       _mappingSize{0};
+		SharedMemory::Header        *_header{nullptr};
+		SharedMemory::IndexEntry    *_index{nullptr};
+		char                        *_slots{nullptr};
+		StreamIndex                  _streams;
+		std::string                  _buffer;
+};
+
+
+DEFINE_SMARTPOINTER(SharedMemoryStream);
+
+/**
+ * @brief RecordStream implementation which reads records from a shared
+ *        memory ring written by a SharedMemoryFeeder.
+ *
+ * The source is the name of the ring optionally followed by parameters,
+ * e.g. "seiscomp?poll=10". Without a start time the stream starts with the
+ * next record published by the feeder, otherwise with the oldest record
+ * still held by the ring. The stream never ends unless close() is called.
+ */
+class SC_SYSTEM_CORE_API SharedMemoryStream : public Seiscomp::IO::RecordStream {
+	DECLARE_SC_CLASS(SharedMemoryStream)
+
+	// ----------------------------------------------------------------------
+	//  X'truction
+	// ----------------------------------------------------------------------
+	public:
+		SharedMemoryStream();
+		~SharedMemoryStream() override;
+
+
+	// ----------------------------------------------------------------------
+	//  Public RecordStream interface
+	// ----------------------------------------------------------------------
+	public:
+		bool setSource(const std::string &source) override;
+
+		bool addStream(const std::string &networkCode,
+		               const std::string &stationCode,
+		               const std::string &locationCode,
+		               const std::string &channelCode) override;
+
+		bool addStream(const std::string &networkCode,
+		               const std::string &stationCode,
+		               const std::string &locationCode,
+		               const std::string &channelCode,
+		               const OPT(Seiscomp::Core::Time) &startTime,
+		               const OPT(Seiscomp::Core::Time) &endTime) override;
+
+		bool setStartTime(const OPT(Seiscomp::Core::Time) &startTime) override;
+		bool setEndTime(const OPT(Seiscomp::Core::Time) &endTime) override;
+
+		void close() override;
+
+		bool setRecordType(const char *type) override;
+
+		Record *next() override;
+
+
+	// ----------------------------------------------------------------------
+	//  Implementation
+	// ----------------------------------------------------------------------
+	private:
+		struct TimeWindowFilter {
+			TimeWindowFilter() {}
+			TimeWindowFilter(const OPT(Core::Time) &stime,
+			                 const OPT(Core::Time) &etime)
+			: start(stime), end(etime) {}
+
+			OPT(Core::Time) start;
+			OPT(Core::Time) end;
+		};
+
+		using FilterMap = std::map<std::string, TimeWindowFilter>;
+		using ReFilterList = std::vector<std::pair<std::string,TimeWindowFilter> >;
+
+		// Cached subscription state per stream index entry
+		struct Subscription {
+			bool                    resolved{false};
+			const TimeWindowFilter *filter{nullptr};
+		};
+
+		class StreamBuffer : public std::streambuf {
+			public:
+				std::streambuf *setbuf(char *s, std::streamsize n) override;
+		};
+
+		bool attach();
+		void detach();
+		bool isStale() const;
+		//! Waits one poll interval and detaches if the ring is stale
+		void idle();
+		const TimeWindowFilter *findTimeWindowFilter(uint32_t streamIndex,
+		                                             bool &subscribed);
+		bool accept(const TimeWindowFilter *twf,
+		            const Core::Time &startTime, const Core::Time &endTime) const;
+
+		RecordFactory               *_factory{nullptr};
+		std::string                  _name;
+		int                          _pollInterval{10};
+		std::atomic<bool>            _closeRequested{false};
+		void                        *_mapping{nullptr};
+		size_t                       _mappingSize{0};
+		ino_t                        _inode{0};
+		int                          _idlePolls{0};
+		const SharedMemory::Header  *_header{nullptr};
+		const SharedMemory::IndexEntry *_index{nullptr};
+		const char                  *_slots{nullptr};
+		uint64_t                     _cursor{0};
+		FilterMap                    _filter;
+		ReFilterList                 _reFilter;
+		// Patterns of _reFilter in the same order
+		Util::WildcardSet            _rePatterns;
+		bool                         _rePatternsCompiled{false};
+		std::vector<Subscription>    _subscriptions;
+		OPT(Core::Time)              _startTime;
+		OPT(Core::Time)              _endTime;
+		std::vector<char>            _buffer;
+		StreamBuffer                 _streambuf;
+};
+
+
+}
+}
+
+
+#endif
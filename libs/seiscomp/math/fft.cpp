@@ -205,6 +205,18 @@ void ifft(int n, T *out, ComplexArray &coeff) {
 
 
 
+int fftSpectrumSize(int n) {
+	int fftn = Filtering::next_power_of_2(n);
+	if ( fftn <= 0 ) return 0;
+
+#ifdef MATH_USE_FFTW3
+	return fftn/2+1;
+#else
+	return fftn/2;
+#endif
+}
+
+
 //!
 //! wrapper for the NR "realft" FFT routine
 //! input: real data, N points
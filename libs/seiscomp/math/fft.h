@@ -40,6 +40,10 @@ typedef std::vector<std::complex<double>> ComplexArray;
 template <typename T>
 void fft(ComplexArray &spec, int n, const T *data);
 
+//! Returns the number of coefficients fft returns for a time series with
+//! n samples.
+SC_SYSTEM_CORE_API int fftSpectrumSize(int n);
+
 template <typename T>
 void fft(ComplexArray &spec, const std::vector<T> &data) {
 	fft(spec, static_cast<int>(data.size()), data.data());
@@ -66,19 +66,10 @@ void costaper(int n, T *inout, int istart, int iend, int estart, int eend) {
 }
 
 
-}
-
-
 template <typename T>
-bool transformFFT(int n, T *inout, double fsamp,
-                  const FFT::TransferFunction *tf, double cutoff,
-                  double min_freq, double max_freq) {
+bool prepareTimeSeries(int n, T *inout, double fsamp, double cutoff) {
 	if ( n <= 0 ) return false;
 
-	int fftn = n;
-	if ( fftn <= 0 )
-		return false;
-
 	if ( fsamp <= 0 )
 		return false;
 
@@ -94,19 +85,15 @@ bool transformFFT(int n, T *inout, double fsamp,
 		inout[i] -= mean;
 
 	// Time series taper
-	int iTaperStart, iTaperEnd;
-	int eTaperStart, eTaperEnd;
-	int taperLength;
-
 	if ( cutoff > 0 ) {
-		taperLength = (int)(cutoff * fsamp);
+		int taperLength = (int)(cutoff * fsamp);
 		if ( taperLength > n ) taperLength = n;
 
-		iTaperStart = 0;
-		iTaperEnd = taperLength;
+		int iTaperStart = 0;
+		int iTaperEnd = taperLength;
 
-		eTaperStart = n - taperLength;
-		eTaperEnd = n;
+		int eTaperStart = n - taperLength;
+		int eTaperEnd = n;
 
 		if ( iTaperEnd > eTaperStart )
 			eTaperStart = iTaperEnd;
@@ -114,17 +101,14 @@ bool transformFFT(int n, T *inout, double fsamp,
 		costaper(n, inout, iTaperStart, iTaperEnd, eTaperStart, eTaperEnd);
 	}
 
-	double nyquist_freq = fsamp * 0.5;
-
-	vector<Complex> data_coeff;
-	// len(data_coeff) = fftn/2+1
-	fft(data_coeff, n, inout);
+	return true;
+}
 
-	int fftn2 = data_coeff.size();
 
+void spectralTaper(int fftn2, double df, double min_freq, double max_freq,
+                   int &iTaperStart, int &iTaperEnd,
+                   int &eTaperStart, int &eTaperEnd) {
 	// Initial spectra taper
-	double df = nyquist_freq / (fftn2-1);
-
 	if ( min_freq > 0 ) {
 		iTaperEnd = (int)(min_freq / df);
 		if ( iTaperEnd > fftn2 ) iTaperEnd = fftn2;
@@ -146,13 +130,38 @@ bool transformFFT(int n, T *inout, double fsamp,
 		if ( eTaperStart < iTaperEnd ) eTaperStart = iTaperEnd;
 	}
 	else {
-		eTaperStart = data_coeff.size();
+		eTaperStart = fftn2;
 		eTaperEnd = eTaperStart;
 	}
+}
+
+
+}
 
-	// Multiply by freqs
-	df = nyquist_freq/(fftn2-1);
 
+template <typename T>
+bool transformFFT(int n, T *inout, double fsamp,
+                  const FFT::TransferFunction *tf, double cutoff,
+                  double min_freq, double max_freq) {
+	if ( !prepareTimeSeries(n, inout, fsamp, cutoff) )
+		return false;
+
+	double nyquist_freq = fsamp * 0.5;
+
+	vector<Complex> data_coeff;
+	// len(data_coeff) = fftn/2+1
+	fft(data_coeff, n, inout);
+
+	int fftn2 = data_coeff.size();
+
+	double df = nyquist_freq / (fftn2-1);
+
+	int iTaperStart, iTaperEnd;
+	int eTaperStart, eTaperEnd;
+	spectralTaper(fftn2, df, min_freq, max_freq,
+	              iTaperStart, iTaperEnd, eTaperStart, eTaperEnd);
+
+	// Multiply by freqs
 	tf->deconvolve(data_coeff.size()-1, &data_coeff[1], df, df);
 
 	costaper(data_coeff.size(), data_coeff.data(), iTaperStart, iTaperEnd, eTaperStart, eTaperEnd);
@@ -164,6 +173,53 @@ bool transformFFT(int n, T *inout, double fsamp,
 }
 
 
+bool deconvolutionSpectrum(std::vector<Complex> &spectrum, int n, double fsamp,
+                           const FFT::TransferFunction *tf,
+                           double min_freq, double max_freq) {
+	if ( (n <= 0) || (fsamp <= 0) )
+		return false;
+
+	int fftn2 = fftSpectrumSize(n);
+	if ( fftn2 < 2 )
+		return false;
+
+	double df = fsamp * 0.5 / (fftn2-1);
+
+	spectrum.assign(fftn2, Complex(1,0));
+	tf->deconvolve(fftn2-1, &spectrum[1], df, df);
+
+	int iTaperStart, iTaperEnd;
+	int eTaperStart, eTaperEnd;
+	spectralTaper(fftn2, df, min_freq, max_freq,
+	              iTaperStart, iTaperEnd, eTaperStart, eTaperEnd);
+
+	costaper(fftn2, spectrum.data(), iTaperStart, iTaperEnd, eTaperStart, eTaperEnd);
+
+	return true;
+}
+
+
+template <typename T>
+bool transformFFT(int n, T *inout, double fsamp,
+                  const std::vector<Complex> &spectrum, double cutoff) {
+	if ( (int)spectrum.size() != fftSpectrumSize(n) )
+		return false;
+
+	if ( !prepareTimeSeries(n, inout, fsamp, cutoff) )
+		return false;
+
+	vector<Complex> data_coeff;
+	fft(data_coeff, n, inout);
+
+	for ( size_t i = 0; i < data_coeff.size(); ++i )
+		data_coeff[i] *= spectrum[i];
+
+	ifft(n, inout, data_coeff);
+
+	return true;
+}
+
+
 // Explicit template instantiation for float and double types
 template SC_SYSTEM_CORE_API
 bool transformFFT<float>(int n, float *inout, double fsamp,
@@ -175,6 +231,14 @@ bool transformFFT<double>(int n, double *inout, double fsamp,
                           const FFT::TransferFunction *tf,
                           double cutoff, double min_freq, double max_freq);
 
+template SC_SYSTEM_CORE_API
+bool transformFFT<float>(int n, float *inout, double fsamp,
+                         const std::vector<Complex> &spectrum, double cutoff);
+
+template SC_SYSTEM_CORE_API
+bool transformFFT<double>(int n, double *inout, double fsamp,
+                          const std::vector<Complex> &spectrum, double cutoff);
+
 }
 }
 }
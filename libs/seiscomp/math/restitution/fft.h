@@ -51,6 +51,23 @@ bool transformFFT(std::vector<T> &inout, double fsamp, const FFT::TransferFuncti
 }
 
 
+// Computes the spectral coefficients transformFFT multiplies the spectra
+// of a time series with n samples by. That is the inverse of the
+// transfer function combined with the spectral taper defined by min_freq
+// and max_freq. The result only depends on its input parameters and can
+// be reused for time series of the same length and sampling frequency.
+SC_SYSTEM_CORE_API
+bool deconvolutionSpectrum(std::vector<Complex> &spectrum, int n, double fsamp,
+                           const FFT::TransferFunction *tf,
+                           double min_freq, double max_freq);
+
+// Same as transformFFT with a transfer function but multiplies the spectra
+// with a spectrum computed with deconvolutionSpectrum.
+template <typename T>
+bool transformFFT(int n, T *inout, double fsamp, const std::vector<Complex> &spectrum,
+                  double cutoff);
+
+
 template <typename T>
 bool transformFFT(int n, T *inout, double fsamp, int n_poles, SeismometerResponse::Pole *poles,
                   int n_zeros, SeismometerResponse::Zero *zeros, double norm,
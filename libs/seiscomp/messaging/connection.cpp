@@ -24,6 +24,7 @@
 #include <seiscomp/core/strings.h>
 #include <seiscomp/messaging/connection.h>
 #include <seiscomp/messaging/status.h>
+#include <seiscomp/utils/latency.h>
 #include <seiscomp/utils/url.h>
 #include <seiscomp/system/hostinfo.h>
 
@@ -451,10 +452,27 @@ Result Connection::sendMessage(const Core::Message *msg) {
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 Result Connection::sendMessage(const string &targetGroup, const Core::Message *msg) {
 	if ( !_protocol ) return _lastError = InvalidProtocol;
+
+	Util::LatencyMonitor *latency = Util::LatencyMonitor::Instance();
+	Util::LatencyMonitor::Timestamp start = latency ? Util::LatencyMonitor::Now() : 0;
+
 	_lastError = _protocol->sendMessage(targetGroup, msg,
 	                                    Protocol::Regular,
 	                                    _defaultContentEncoding,
 	                                    _defaultContentType);
+
+	if ( latency && _lastError == OK ) {
+		Util::LatencyMonitor::Timestamp end = Util::LatencyMonitor::Now();
+		latency->record(Util::LatencyMonitor::Publish, "group/" + targetGroup, end - start);
+
+		// Accounts the message to the object whose processing caused it
+		auto scope = Util::LatencyMonitor::Scope::Current();
+		if ( scope ) {
+			latency->record(Util::LatencyMonitor::EndToEnd, scope->streamClass(),
+			                end - scope->arrival());
+		}
+	}
+
 	return _lastError;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -609,6 +627,19 @@ Result Connection::setCertificate(const string &cert) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+Result Connection::setSubscriptionFilter(const string &group,
+                                         const string &expression) {
+	if ( !_protocol ) return _lastError = InvalidProtocol;
+
+	_protocol->setSubscriptionFilter(group, expression);
+	return OK;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 }
 }
@@ -246,6 +246,17 @@ class SC_SYSTEM_CLIENT_API Connection : public Core::BaseObject {
 
 		Result setCertificate(const std::string &cert);
 
+		/**
+		 * @brief Attaches a filter expression to the subscription of a
+		 *        group, see Protocol::setSubscriptionFilter. This method
+		 *        has to be called after setSource and prior to subscribe.
+		 * @param group The group name
+		 * @param expression The filter expression
+		 * @return Result code
+		 */
+		Result setSubscriptionFilter(const std::string &group,
+		                             const std::string &expression);
+
 	// ----------------------------------------------------------------------
 	//  Query functions
 	// ----------------------------------------------------------------------
@@ -277,6 +277,9 @@ Core::Message *Protocol::decode(const char *blob, size_t blob_length,
 			case IMPORTED_XML:
 				parse<ImportXMLArchive>(msg, blob, blob_length, encoding);
 				break;
+			case CompactBinary:
+				parse<IO::CompactBinaryArchive>(msg, blob, blob_length, encoding);
+				break;
 			default:
 				break;
 		}
@@ -327,6 +330,8 @@ bool Protocol::encode(std::string &blob, const Core::Message *msg,
 			return write<IO::XMLArchive>(blob, msg, encoding, schemaVersion);
 		case IMPORTED_XML:
 			return write<ImportXMLArchive>(blob, msg, encoding, schemaVersion);
+		case CompactBinary:
+			return write<IO::CompactBinaryArchive>(blob, msg, encoding, schemaVersion);
 		default:
 			break;
 	}
@@ -357,6 +362,32 @@ void Protocol::setCertificate(const string &cert) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void Protocol::setSubscriptionFilter(const string &group,
+                                     const string &expression) {
+	if ( expression.empty() ) {
+		_subscriptionFilters.erase(group);
+	}
+	else {
+		_subscriptionFilters[group] = expression;
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+const string &Protocol::subscriptionFilter(const string &group) const {
+	static const string Empty;
+	auto it = _subscriptionFilters.find(group);
+	return it != _subscriptionFilters.end() ? it->second : Empty;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 }
 }
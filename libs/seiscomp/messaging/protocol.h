@@ -239,14 +239,16 @@ class SC_SYSTEM_CLIENT_API Protocol : public Core::InterruptibleObject {
 				JSON,
 				XML,
 				IMPORTED_XML,
-				Text
+				Text,
+				CompactBinary
 			),
 			ENAMES(
 				"application/x-sc-bin",
 				"text/json",
 				"application/x-sc-xml",
 				"text/xml",
-				"text/plain"
+				"text/plain",
+				"application/x-sc-cbin"
 			)
 		);
 
@@ -500,6 +502,23 @@ class SC_SYSTEM_CLIENT_API Protocol : public Core::InterruptibleObject {
 
 		void setCertificate(const std::string &cert);
 
+		/**
+		 * @brief Attaches a filter expression to the subscription of a
+		 *        group. The broker then forwards only those notifiers of
+		 *        the group which match the expression, e.g.
+		 *        "class=Pick,Amplitude;network=GE". This method has to be
+		 *        called prior to subscribe to have an effect. Protocols
+		 *        which do not support server side filtering ignore it.
+		 * @param group The group name
+		 * @param expression The filter expression. An empty expression
+		 *                   removes the filter.
+		 */
+		void setSubscriptionFilter(const std::string &group,
+		                           const std::string &expression);
+
+		//! Returns the filter expression of a group or an empty string
+		const std::string &subscriptionFilter(const std::string &group) const;
+
 		static Core::Message *decode(const std::string &blob,
 		                             ContentEncoding encoding,
 		                             ContentType type);
@@ -542,7 +561,8 @@ class SC_SYSTEM_CLIENT_API Protocol : public Core::InterruptibleObject {
 		enum ProtocolFlags {
 			WANT_MEMBERSHIP_INFO          = 0x01,
 			SUPPORTS_DELETE_TREE          = 0x02,
-			REQUIRES_LEGACY_BINARY_FORMAT = 0x04
+			REQUIRES_LEGACY_BINARY_FORMAT = 0x04,
+			SUPPORTS_COMPACT_BINARY       = 0x08
 		};
 
 		Groups             _groups;
@@ -555,6 +575,7 @@ class SC_SYSTEM_CLIENT_API Protocol : public Core::InterruptibleObject {
 		uint32_t           _protocolFlags{WANT_MEMBERSHIP_INFO};
 		KeyValueStore      _extendedParameters;
 		std::string        _certificate;   //!< Optional client certificate
+		KeyValueStore      _subscriptionFilters; //!< Filter expression per group
 
 		// Mutexes to synchronize read access from separate threads.
 		mutable std::mutex _readMutex;
@@ -22,6 +22,7 @@
 
 #include <seiscomp/logging/log.h>
 #include <seiscomp/datamodel/version.h>
+#include <seiscomp/io/archive/binarchive.h>
 #include <seiscomp/messaging/protocols/scmp/websocket.h>
 #include <seiscomp/messaging/messages/database.h>
 #include <seiscomp/broker/protocol.h>
@@ -277,6 +278,7 @@ Result WebsocketConnection::connect(const char *address,
 		_schemaVersion = 0;
 		_protocolFlags &= ~SUPPORTS_DELETE_TREE;
 		_protocolFlags |= REQUIRES_LEGACY_BINARY_FORMAT;
+		_protocolFlags &= ~SUPPORTS_COMPACT_BINARY;
 		_extendedParameters = KeyValueStore();
 		_state = State();
 		_select.clear();
@@ -463,19 +465,35 @@ Result WebsocketConnection::connect(const char *address,
 			if ( clientName )
 				os << SCMP_PROTO_CMD_CONNECT_HEADER_CLIENT_NAME ":" << clientName << "\n";
 
-			if ( !_subscriptions.empty() ) {
-				os << SCMP_PROTO_CMD_CONNECT_HEADER_SUBSCRIPTIONS ": ";
-				set<string>::iterator it;
-				int idx = 0;
-				for ( it = _subscriptions.begin(); it != _subscriptions.end(); ++it, ++idx ) {
-					if ( idx )
-						os << ',';
-					os << *it;
-				}
+			int idx = 0;
+			for ( const auto &group : _subscriptions ) {
+				if ( idx++ )
+					os << ',';
+				else
+					os << SCMP_PROTO_CMD_CONNECT_HEADER_SUBSCRIPTIONS ": ";
+				os << group;
+			}
 
+			if ( idx )
 				os << '\n';
+
+			// Filters are sent with the subscriptions so that the broker
+			// applies them already to the messages replayed from the
+			// sequence number
+			for ( const auto &group : _subscriptions ) {
+				const string &filter = subscriptionFilter(group);
+				if ( filter.empty() )
+					continue;
+
+				os << SCMP_PROTO_CMD_CONNECT_HEADER_SUBSCRIPTION_FILTER ": "
+				   << group << ':' << filter << '\n';
 			}
 
+			// Announce that compact binary messages can be decoded, the
+			// server converts them to binary for clients which do not
+			os << SCMP_PROTO_CMD_CONNECT_HEADER_COMPACT_BINARY_VERSION ": "
+			   << IO::CompactBinaryArchive::Version << "\n";
+
 			os << SCMP_PROTO_CMD_CONNECT_HEADER_MEMBERSHIP_INFO ": "
 			   << ((_protocolFlags & WANT_MEMBERSHIP_INFO) ? "1":"0") << "\n"
 			      SCMP_PROTO_CMD_CONNECT_HEADER_SELF_DISCARD ": 1\n"
@@ -580,6 +598,17 @@ Result WebsocketConnection::connect(const char *address,
 					_protocolFlags &= ~REQUIRES_LEGACY_BINARY_FORMAT;
 				}
 			}
+			else if ( headers.nameEquals(SCMP_PROTO_REPLY_CONNECT_HEADER_COMPACT_BINARY_VERSION) ) {
+				uint32_t compactVersion;
+				if ( !Core::fromString(compactVersion, { headers.val_start, headers.val_len }) ) {
+					SEISCOMP_WARNING("Invalid Compact-Binary-Version content: %s",
+					                 string_view(headers.val_start, headers.val_len));
+					continue;
+				}
+				if ( (compactVersion > 0) && (compactVersion <= IO::CompactBinaryArchive::Version) ) {
+					_protocolFlags |= SUPPORTS_COMPACT_BINARY;
+				}
+			}
 			// Parse DB extensions
 			else if ( headers.nameEquals("DB-Access") ) {
 				string readParameters(headers.val_start, headers.val_len);
@@ -688,7 +717,16 @@ Result WebsocketConnection::subscribe(const std::string &group) {
 		msg.data = SCMP_PROTO_CMD_SUBSCRIBE "\n"
 		           SCMP_PROTO_CMD_SUBSCRIBE_HEADER_GROUPS ":";
 		msg.data += group;
-		msg.data += "\n\n";
+		msg.data += "\n";
+
+		const string &filter = subscriptionFilter(group);
+		if ( !filter.empty() ) {
+			msg.data += SCMP_PROTO_CMD_SUBSCRIBE_HEADER_FILTER ":";
+			msg.data += filter;
+			msg.data += "\n";
+		}
+
+		msg.data += "\n";
 
 		r = send(&msg, WSFrame::TextFrame, false);
 		if ( r != OK )
@@ -898,6 +936,12 @@ Result WebsocketConnection::sendMessage(const std::string &targetGroup,
 
 		BufferPtr websocketFrame = new Buffer;
 
+		// The compact format is only used if the server announced support
+		// for it during the handshake
+		if ( (*contentType == CompactBinary) && !(_protocolFlags & SUPPORTS_COMPACT_BINARY) ) {
+			contentType = ContentType(Binary);
+		}
+
 		string blob;
 		if ( !encode(blob, msg, *contentEncoding, *contentType, schemaVersion().packed, _protocolFlags) || blob.empty() ) {
 			return EncodingError;
@@ -1252,7 +1296,7 @@ Result WebsocketConnection::disconnect() {
 	_registeredClientName = string();
 	_state.sequenceNumber = Core::None;
 	_schemaVersion = 0;
-	_protocolFlags &= ~SUPPORTS_DELETE_TREE;
+	_protocolFlags &= ~(SUPPORTS_DELETE_TREE | SUPPORTS_COMPACT_BINARY);
 	_extendedParameters = KeyValueStore();
 	// Remove all un-ack'ed messages as we have actively disconnected
 	// the session
@@ -142,7 +142,11 @@ void Application::registerProcessor(const std::string& networkCode,
                                     const std::string& locationCode,
                                     const std::string& channelCode,
                                     WaveformProcessor *wp) {
-	_processors.insert(ProcessorMap::value_type(networkCode + "." + stationCode + "." + locationCode + "." + channelCode, wp));
+	const Core::StreamIDTable::Entry *entry =
+		Core::StreamIDTable::Intern(networkCode, stationCode, locationCode, channelCode);
+
+	// Processors of a stream are fed in the order of registration
+	_processors[entry->handle].push_back(wp);
 
 	// Because we are dealing with a multimap we need to check if the pointer
 	// is already registered for this station. Otherwise the remove method will
@@ -168,7 +172,7 @@ void Application::registerProcessor(const std::string& networkCode,
 	               locationCode.c_str(), channelCode.c_str(),
                        (long)wp);
 	SEISCOMP_DEBUG("Current processor count: %lu/%lu, object count: %d",
-		      (unsigned long)_processors.size(),
+		      (unsigned long)processorCount(),
 	              (unsigned long)_stationProcessors.size(),
 		      Core::BaseObject::ObjectCount());
 }
@@ -268,31 +272,28 @@ void Application::removeProcessors(const std::string& networkCode,
                                    const std::string& locationCode,
                                    const std::string& channelCode) {
 
-	bool checkPendingQueue;
-	std::pair<ProcessorMap::iterator, ProcessorMap::iterator> itq =
-		_processors.equal_range(networkCode + "." +
-		                        stationCode + "." +
-		                        locationCode + "." +
-		                        channelCode);
-
-	checkPendingQueue = itq.first == itq.second;
-
-	// Remove stations - processor association
-	for ( ProcessorMap::iterator it = itq.first; it != itq.second; ++it ) {
-		for ( StationProcessors::iterator its = _stationProcessors.begin();
-		      its != _stationProcessors.end(); )
-		{
-			if ( its->second == it->second ) {
-				SEISCOMP_DEBUG("Removed processor from station %s", its->first.c_str());
-				_stationProcessors.erase(its++);
-				break;
+	const Core::StreamIDTable::Entry *entry =
+		Core::StreamIDTable::Find(networkCode, stationCode, locationCode, channelCode);
+	ProcessorMap::iterator itq =
+		_processors.find(entry ? entry->handle : Core::StreamIDTable::InvalidHandle);
+
+	if ( itq != _processors.end() ) {
+		// Remove stations - processor association
+		for ( const WaveformProcessorPtr &proc : itq->second ) {
+			for ( StationProcessors::iterator its = _stationProcessors.begin();
+			      its != _stationProcessors.end(); )
+			{
+				if ( its->second == proc ) {
+					SEISCOMP_DEBUG("Removed processor from station %s", its->first.c_str());
+					_stationProcessors.erase(its++);
+					break;
+				}
 			}
 		}
-	}
-
-	_processors.erase(itq.first, itq.second);
 
-	if ( !checkPendingQueue ) return;
+		_processors.erase(itq);
+		return;
+	}
 
 	// Remove from pending queue (if exists)
 	for ( WaveformProcessorQueue::iterator it = _waveformProcessorQueue.begin();
@@ -340,11 +341,19 @@ void Application::removeProcessor(Processing::WaveformProcessor *wp) {
 	for ( ProcessorMap::iterator it = _processors.begin();
 	      it != _processors.end(); )
 	{
-		if ( it->second.get() == wp ) {
-			SEISCOMP_DEBUG("Removed processor from stream %s    addr=0x%lx",
-				       it->first.c_str(), (long)wp);
-			_processors.erase(it++);
+		Processors &procs = it->second;
+		for ( Processors::iterator itp = procs.begin(); itp != procs.end(); ) {
+			if ( itp->get() == wp ) {
+				SEISCOMP_DEBUG("Removed processor from stream %s    addr=0x%lx",
+					       Core::StreamIDTable::Get(it->first)->streamID.c_str(), (long)wp);
+				itp = procs.erase(itp);
+			}
+			else
+				++itp;
 		}
+
+		if ( procs.empty() )
+			it = _processors.erase(it);
 		else
 			++it;
 	}
@@ -383,7 +392,10 @@ void Application::removeProcessor(Processing::WaveformProcessor *wp) {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 size_t Application::processorCount() const {
-	return _processors.size();
+	size_t count = 0;
+	for ( const auto &item : _processors )
+		count += item.second.size();
+	return count;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -437,7 +449,6 @@ void Application::updateObject(const std::string& parentID, DataModel::Object* o
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void Application::handleRecord(Record *rec) {
-	std::string streamID = rec->streamID();
 	std::list<WaveformProcessor*> trashList;
 
 	RecordPtr tmp(rec);
@@ -448,21 +459,23 @@ void Application::handleRecord(Record *rec) {
 
 	_registrationBlocked = true;
 
-	std::pair<ProcessorMap::iterator, ProcessorMap::iterator> itq = _processors.equal_range(streamID);
-	for ( ProcessorMap::iterator it = itq.first; it != itq.second; ++it ) {
-		// The proc must not be already on the removal list
-		if ( std::find(_waveformProcessorRemovalQueue.begin(),
-		               _waveformProcessorRemovalQueue.end(),
-		               it->second) != _waveformProcessorRemovalQueue.end() )
-			continue;
-
-		// Schedule the processor for deletion when finished
-		if ( it->second->isFinished() )
-			trashList.push_back(it->second.get());
-		else {
-			it->second->feed(rec);
-			if ( it->second->isFinished() )
-				trashList.push_back(it->second.get());
+	ProcessorMap::iterator itq = _processors.find(rec->streamHandle());
+	if ( itq != _processors.end() ) {
+		for ( const WaveformProcessorPtr &proc : itq->second ) {
+			// The proc must not be already on the removal list
+			if ( std::find(_waveformProcessorRemovalQueue.begin(),
+			               _waveformProcessorRemovalQueue.end(),
+			               proc) != _waveformProcessorRemovalQueue.end() )
+				continue;
+
+			// Schedule the processor for deletion when finished
+			if ( proc->isFinished() )
+				trashList.push_back(proc.get());
+			else {
+				proc->feed(rec);
+				if ( proc->isFinished() )
+					trashList.push_back(proc.get());
+			}
 		}
 	}
 
@@ -540,10 +553,15 @@ void Application::enableStation(const std::string& code, bool enabled) {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void Application::enableStream(const std::string& code, bool enabled) {
-	std::pair<StationProcessors::iterator, StationProcessors::iterator> itq = _processors.equal_range(code);
-	for (StationProcessors::iterator it = itq.first; it != itq.second; ++it) {
+	const Core::StreamIDTable::Entry *entry = Core::StreamIDTable::Find(code);
+	if ( !entry ) return;
+
+	ProcessorMap::iterator itq = _processors.find(entry->handle);
+	if ( itq == _processors.end() ) return;
+
+	for ( const WaveformProcessorPtr &proc : itq->second ) {
 		SEISCOMP_INFO("%s stream %s", enabled?"Enabling":"Disabling", code.c_str());
-		it->second->setEnabled(enabled);
+		proc->setEnabled(enabled);
 	}
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
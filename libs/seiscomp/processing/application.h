@@ -22,6 +22,9 @@
 #define SEISCOMP_PROCESSING_STREAMPROCESSOR_APPLICATION_H
 
 
+#include <unordered_map>
+#include <vector>
+
 #include <seiscomp/client/streamapplication.h>
 #include <seiscomp/datamodel/waveformstreamid.h>
 #include <seiscomp/processing/waveformprocessor.h>
@@ -127,7 +130,8 @@ class SC_SYSTEM_CLIENT_API Application : public Client::StreamApplication {
 	// ----------------------------------------------------------------------
 	private:
 		typedef std::multimap<std::string, WaveformProcessorPtr> StationProcessors;
-		typedef std::multimap<std::string, WaveformProcessorPtr> ProcessorMap;
+		typedef std::vector<WaveformProcessorPtr>                 Processors;
+		typedef std::unordered_map<Core::StreamHandle, Processors> ProcessorMap;
 		typedef DataModel::WaveformStreamID                      WID;
 		typedef std::pair<WID, WaveformProcessorPtr>             WaveformProcessorItem;
 		typedef std::pair<WID, TimeWindowProcessorPtr>           TimeWindowProcessorItem;
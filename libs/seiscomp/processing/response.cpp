@@ -21,6 +21,9 @@
 
 #include <seiscomp/processing/response.h>
 #include <seiscomp/math/restitution/fft.h>
+#include <seiscomp/utils/lrucache.h>
+
+#include <functional>
 
 
 namespace Seiscomp {
@@ -30,6 +33,90 @@ namespace Processing  {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+namespace {
+
+
+template <typename T>
+void appendBinary(std::string &out, const T &value) {
+	out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+
+struct SpectrumKey {
+	bool operator==(const SpectrumKey &other) const {
+		return n == other.n
+		    && numberOfIntegrations == other.numberOfIntegrations
+		    && fsamp == other.fsamp
+		    && minFreq == other.minFreq
+		    && maxFreq == other.maxFreq
+		    && fingerprint == other.fingerprint;
+	}
+
+	std::string fingerprint;
+	int         n;
+	int         numberOfIntegrations;
+	double      fsamp;
+	double      minFreq;
+	double      maxFreq;
+};
+
+
+struct SpectrumKeyHash {
+	size_t operator()(const SpectrumKey &key) const {
+		size_t seed = std::hash<std::string>()(key.fingerprint);
+		combine(seed, std::hash<int>()(key.n));
+		combine(seed, std::hash<int>()(key.numberOfIntegrations));
+		combine(seed, std::hash<double>()(key.fsamp));
+		combine(seed, std::hash<double>()(key.minFreq));
+		combine(seed, std::hash<double>()(key.maxFreq));
+		return seed;
+	}
+
+	static void combine(size_t &seed, size_t value) {
+		seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+	}
+};
+
+
+using SpectrumCache = Util::LRUCache<SpectrumKey, ResponseSpectrumCache::SpectrumCPtr, SpectrumKeyHash>;
+
+
+size_t bytes(const SpectrumKey &key,
+             const ResponseSpectrumCache::SpectrumCPtr &spectrum) {
+	return spectrum->size() * sizeof(Math::Complex) + key.fingerprint.size();
+}
+
+
+SpectrumCache &spectrumCache() {
+	static SpectrumCache cache(32*1024*1024, bytes);
+	return cache;
+}
+
+
+ResponseSpectrumCache::SpectrumCPtr
+computeSpectrum(Response *response, int n, double fsamp,
+                double min_freq, double max_freq, int numberOfIntegrations) {
+	Math::Restitution::FFT::TransferFunctionPtr tf =
+		response->getTransferFunction(numberOfIntegrations);
+	if ( !tf )
+		return nullptr;
+
+	auto spectrum = std::make_shared<ResponseSpectrumCache::Spectrum>();
+	if ( !Math::Restitution::deconvolutionSpectrum(*spectrum, n, fsamp, tf.get(),
+	                                               min_freq, max_freq) )
+		return nullptr;
+
+	return spectrum;
+}
+
+
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 Response::Response() {}
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -49,13 +136,13 @@ bool Response::deconvolveFFT(int n, float *inout, double fsamp,
                              double cutoff,
                              double min_freq, double max_freq,
                              int numberOfIntegrations) {
-	Math::Restitution::FFT::TransferFunctionPtr tf =
-		getTransferFunction(numberOfIntegrations);
-	if ( !tf )
+	ResponseSpectrumCache::SpectrumCPtr spectrum =
+		ResponseSpectrumCache::Get(this, n, fsamp, min_freq, max_freq,
+		                           numberOfIntegrations);
+	if ( !spectrum )
 		return false;
 
-	return Math::Restitution::transformFFT(n, inout, fsamp, tf.get(),
-	                                         cutoff, min_freq, max_freq);
+	return Math::Restitution::transformFFT(n, inout, fsamp, *spectrum, cutoff);
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -67,13 +154,13 @@ bool Response::deconvolveFFT(int n, double *inout, double fsamp,
                              double cutoff,
                              double min_freq, double max_freq,
                              int numberOfIntegrations) {
-	Math::Restitution::FFT::TransferFunctionPtr tf =
-		getTransferFunction(numberOfIntegrations);
-	if ( !tf )
+	ResponseSpectrumCache::SpectrumCPtr spectrum =
+		ResponseSpectrumCache::Get(this, n, fsamp, min_freq, max_freq,
+		                           numberOfIntegrations);
+	if ( !spectrum )
 		return false;
 
-	return Math::Restitution::transformFFT(n, inout, fsamp, tf.get(),
-	                                         cutoff, min_freq, max_freq);
+	return Math::Restitution::transformFFT(n, inout, fsamp, *spectrum, cutoff);
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -116,6 +203,73 @@ Response::getTransferFunction(int numberOfIntegrations) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool Response::fingerprint(std::string &) const {
+	return false;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+ResponseSpectrumCache::SpectrumCPtr
+ResponseSpectrumCache::Get(Response *response, int n, double fsamp,
+                           double min_freq, double max_freq,
+                           int numberOfIntegrations) {
+	auto &cache = spectrumCache();
+	SpectrumKey key;
+
+	if ( !response->fingerprint(key.fingerprint) ) {
+		cache.countMiss();
+		return computeSpectrum(response, n, fsamp, min_freq, max_freq,
+		                       numberOfIntegrations);
+	}
+
+	key.n = n;
+	key.numberOfIntegrations = numberOfIntegrations;
+	key.fsamp = fsamp;
+	key.minFreq = min_freq;
+	key.maxFreq = max_freq;
+
+	// Evaluates the transfer function without holding the lock
+	return cache.get(key, [&]() {
+		return computeSpectrum(response, n, fsamp, min_freq, max_freq,
+		                       numberOfIntegrations);
+	});
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void ResponseSpectrumCache::SetCapacity(size_t bytes) {
+	spectrumCache().setCapacity(bytes);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void ResponseSpectrumCache::Clear() {
+	spectrumCache().clear();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+ResponseSpectrumCache::Statistics ResponseSpectrumCache::GetStatistics() {
+	return spectrumCache().statistics();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 ResponsePAZ::ResponsePAZ() {}
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -244,6 +398,33 @@ ResponsePAZ::getTransferFunction(int numberOfIntegrations) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool ResponsePAZ::fingerprint(std::string &fingerprint) const {
+	if ( !_normalizationFactor )
+		return false;
+
+	fingerprint = "PAZ";
+	appendBinary(fingerprint, *_normalizationFactor);
+
+	appendBinary(fingerprint, static_cast<uint64_t>(_poles.size()));
+	for ( const auto &p : _poles ) {
+		appendBinary(fingerprint, p.real());
+		appendBinary(fingerprint, p.imag());
+	}
+
+	appendBinary(fingerprint, static_cast<uint64_t>(_zeros.size()));
+	for ( const auto &z : _zeros ) {
+		appendBinary(fingerprint, z.real());
+		appendBinary(fingerprint, z.imag());
+	}
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 ResponseFAP::ResponseFAP() {}
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -302,6 +483,24 @@ Math::Restitution::FFT::TransferFunction *ResponseFAP::getTransferFunction(int n
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool ResponseFAP::fingerprint(std::string &fingerprint) const {
+	fingerprint = "FAP";
+
+	appendBinary(fingerprint, static_cast<uint64_t>(_faps.size()));
+	for ( const auto &fap : _faps ) {
+		appendBinary(fingerprint, fap.frequency);
+		appendBinary(fingerprint, fap.amplitude);
+		appendBinary(fingerprint, fap.phaseAngle);
+	}
+
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 }
 }
@@ -26,8 +26,11 @@
 #include <seiscomp/core/typedarray.h>
 #include <seiscomp/math/restitution/transferfunction.h>
 #include <seiscomp/math/filter/seismometers.h>
+#include <seiscomp/utils/lrucache.h>
 #include <seiscomp/client.h>
 
+#include <memory>
+#include <string>
 #include <vector>
 
 
@@ -85,6 +88,61 @@ class SC_SYSTEM_CLIENT_API Response : public Core::BaseObject {
 		//!                             additional zeros to 'zeros'.
 		virtual Math::Restitution::FFT::TransferFunction *
 			getTransferFunction(int numberOfIntegrations = 0);
+
+		//! Writes a binary representation of all parameters that define
+		//! the transfer function to fingerprint. Two responses with the
+		//! same fingerprint must produce the same transfer function.
+		//! The fingerprint is used to share evaluated responses in the
+		//! ResponseSpectrumCache. The default implementation returns false
+		//! which disables caching for this response.
+		virtual bool fingerprint(std::string &fingerprint) const;
+};
+
+
+/**
+ * @brief Process wide cache of evaluated deconvolution spectra.
+ *
+ * Evaluating the transfer function at every frequency bin is a significant
+ * part of a deconvolution in the frequency domain. Response::deconvolveFFT
+ * looks up the spectrum for the response fingerprint, sampling frequency,
+ * number of samples, number of integrations and spectral taper in this
+ * cache and only evaluates the transfer function on a miss. The cache is
+ * bound by the memory of the stored spectra and evicts the least recently
+ * used entries. All methods are thread-safe.
+ */
+class SC_SYSTEM_CLIENT_API ResponseSpectrumCache {
+	// ----------------------------------------------------------------------
+	//  Public types
+	// ----------------------------------------------------------------------
+	public:
+		using Spectrum = std::vector<Math::Complex>;
+		using SpectrumCPtr = std::shared_ptr<const Spectrum>;
+
+		using Statistics = Util::LRUCacheStatistics;
+
+
+	// ----------------------------------------------------------------------
+	//  Public interface
+	// ----------------------------------------------------------------------
+	public:
+		/**
+		 * @brief Returns the deconvolution spectrum for a response and
+		 *        computes it if it is not cached yet.
+		 * @return The spectrum or nullptr if the response does not provide
+		 *         a transfer function.
+		 */
+		static SpectrumCPtr Get(Response *response, int n, double fsamp,
+		                        double min_freq, double max_freq,
+		                        int numberOfIntegrations);
+
+		//! Sets the maximum memory of all cached spectra in bytes. A value
+		//! of 0 disables the cache. The default is 32 MiB.
+		static void SetCapacity(size_t bytes);
+
+		//! Removes all cached spectra and resets the statistics.
+		static void Clear();
+
+		static Statistics GetStatistics();
 };
 
 
@@ -139,6 +197,8 @@ class SC_SYSTEM_CLIENT_API ResponsePAZ : public Response {
 		Math::Restitution::FFT::TransferFunction *
 			getTransferFunction(int numberOfIntegrations = 0) override;
 
+		bool fingerprint(std::string &fingerprint) const override;
+
 
 	// ----------------------------------------------------------------------
 	//  Private interface
@@ -185,6 +245,8 @@ class SC_SYSTEM_CLIENT_API ResponseFAP : public Response {
 		Math::Restitution::FFT::TransferFunction *
 			getTransferFunction(int numberOfIntegrations = 0) override;
 
+		bool fingerprint(std::string &fingerprint) const override;
+
 
 	// ----------------------------------------------------------------------
 	//  Private interface
@@ -96,7 +96,21 @@ void StreamBuffer::setTimeSpan(const Seiscomp::Core::TimeSpan& timeSpan) {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 RecordSequence* StreamBuffer::sequence(const WaveformID& wid) const {
-	SequenceMap::const_iterator it = _sequences.find(wid);
+	auto entry = Core::StreamIDTable::Find(wid.networkCode, wid.stationCode,
+	                                       wid.locationCode, wid.channelCode);
+	if ( !entry )
+		return nullptr;
+	return sequence(entry->handle);
+}
+
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+RecordSequence* StreamBuffer::sequence(Core::StreamHandle handle) const {
+	SequenceMap::const_iterator it = _sequences.find(handle);
 	if ( it != _sequences.end() )
 		return it->second;
 	return nullptr;
@@ -115,8 +129,8 @@ RecordSequence* StreamBuffer::feed(const Record *rec) {
 		return nullptr;
 	}
 
-	WaveformID wid(rec);
-	RecordSequence *seq = sequence(wid);
+	Core::StreamHandle handle = rec->streamHandle();
+	RecordSequence *seq = sequence(handle);
 
 	if ( !seq ) {
 		switch ( _mode ) {
@@ -128,7 +142,7 @@ RecordSequence* StreamBuffer::feed(const Record *rec) {
 				break;
 		}
 
-		_sequences[wid] = seq;
+		_sequences[handle] = seq;
 		_newStreamAdded = true;
 	}
 
@@ -157,10 +171,7 @@ void StreamBuffer::printStreams(std::ostream& os) const {
 	for ( SequenceMap::const_iterator it = _sequences.begin();
 	      it != _sequences.end(); ++it ) {
 		os << "["
-		          << it->first.networkCode << "."
-		          << it->first.stationCode << "."
-		          << it->first.locationCode << "."
-		          << it->first.channelCode << "] "
+		          << Core::StreamIDTable::Get(it->first)->streamID << "] "
 		          << it->second->timeWindow().startTime().toString("%F %T") << " - "
 		          << it->second->timeWindow().endTime().toString("%F %T")
 		          << std::endl;
@@ -178,15 +189,12 @@ std::list<std::string> StreamBuffer::getStreams() const {
 
 	for ( SequenceMap::const_iterator it = _sequences.begin();
 	      it != _sequences.end(); ++it ) {
-		
-		streamList.push_back(
-		              it->first.networkCode + "."
-		            + it->first.stationCode + "."
-		            + it->first.locationCode + "."
-		            + it->first.channelCode
-		);
+		streamList.push_back(Core::StreamIDTable::Get(it->first)->streamID);
 	}
 
+	// Return the streams in lexicographical order
+	streamList.sort();
+
 	return streamList;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
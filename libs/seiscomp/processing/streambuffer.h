@@ -24,8 +24,10 @@
 
 #include <string>
 #include <list>
+#include <unordered_map>
 
 #include <seiscomp/core/recordsequence.h>
+#include <seiscomp/core/streamid.h>
 #include <seiscomp/client.h>
 
 
@@ -99,6 +101,7 @@ class SC_SYSTEM_CLIENT_API StreamBuffer {
 		void setTimeSpan(const Core::TimeSpan &timeSpan);
 
 		RecordSequence *sequence(const WaveformID &wid) const;
+		RecordSequence *sequence(Core::StreamHandle handle) const;
 		RecordSequence *feed(const Record *rec);
 
 		bool addedNewStream() const;
@@ -119,7 +122,7 @@ class SC_SYSTEM_CLIENT_API StreamBuffer {
 			RING_BUFFER
 		};
 
-		using SequenceMap = std::map<WaveformID, RecordSequence*>;
+		using SequenceMap = std::unordered_map<Core::StreamHandle, RecordSequence*>;
 
 		Mode                     _mode;
 		Seiscomp::Core::Time     _timeStart;
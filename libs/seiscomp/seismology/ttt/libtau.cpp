@@ -21,8 +21,13 @@
 
 #include <math.h>
 #include <string.h>
+#include <atomic>
 #include <iostream>
+#include <list>
+#include <map>
+#include <mutex>
 #include <stdexcept>
+#include <unordered_map>
 
 #include <seiscomp/core/strings.h>
 #include <seiscomp/system/environment.h>
@@ -51,6 +56,24 @@ double takeoff_angle(double p, double zs, double vzs) {
 }
 
 
+using Depth = libtau::Depth;
+
+
+std::atomic<size_t> depthCacheSize{32};
+std::atomic<double> depthResolution{0};
+
+
+// The phase code pointers of a handle refer to the phase code buffer of its
+// first depth structure. They need to be adjusted whenever depth structures
+// are copied from another handle.
+void rebasePhaseCodes(libtau &handle) {
+	for ( int i = 0; i < jbrn; ++i ) {
+		handle.depths[0].phcd[i] = handle.depths[0].phcd_buf + i * 10;
+		handle.depths[1].phcd[i] = handle.depths[0].phcd_buf + i * 10;
+	}
+}
+
+
 }
 
 
@@ -65,6 +88,85 @@ namespace Seiscomp {
 namespace TTT {
 
 
+/**
+ * The tables of a model as read by tabin and the cache of depth corrected
+ * tables. The depth dependent state of a handle is entirely held in
+ * depths[0] which depset resets from the pristine copy in depths[1]. The
+ * cache stores copies of depths[0] after depth correction. The tables are
+ * read-only after initialization and the cache is protected by a mutex.
+ */
+struct LibTau::SharedModel {
+	using Entry = std::pair<float, std::unique_ptr<Depth>>;
+	using Entries = std::list<Entry>;
+
+	~SharedModel() {
+		tabout(&tables);
+	}
+
+	bool restore(float depth, libtau &handle) {
+		std::lock_guard<std::mutex> lock(mutex);
+		auto it = index.find(depth);
+		if ( it == index.end() ) {
+			return false;
+		}
+
+		// Move to front
+		entries.splice(entries.begin(), entries, it->second);
+		memcpy(&handle.depths[0], it->second->second.get(), sizeof(Depth));
+		handle.D = 0;
+		rebasePhaseCodes(handle);
+		return true;
+	}
+
+	void store(float depth, const libtau &handle) {
+		size_t capacity = depthCacheSize;
+
+		std::lock_guard<std::mutex> lock(mutex);
+		if ( index.find(depth) != index.end() ) {
+			return;
+		}
+
+		std::unique_ptr<Depth> snapshot;
+
+		while ( !entries.empty() && entries.size() >= capacity ) {
+			// Reuse the memory of the least recently used entry
+			snapshot = std::move(entries.back().second);
+			index.erase(entries.back().first);
+			entries.pop_back();
+		}
+
+		if ( !capacity ) {
+			return;
+		}
+
+		if ( !snapshot ) {
+			snapshot.reset(new Depth);
+		}
+
+		memcpy(snapshot.get(), &handle.depths[0], sizeof(Depth));
+		entries.emplace_front(depth, std::move(snapshot));
+		index[depth] = entries.begin();
+	}
+
+	std::string                                   path;
+	libtau                                        tables;
+	std::mutex                                    mutex;
+	Entries                                       entries;
+	std::unordered_map<float, Entries::iterator>  index;
+};
+
+
+
+
+void LibTau::SetDepthCacheSize(size_t entries) {
+	depthCacheSize = entries;
+}
+
+
+void LibTau::SetDepthResolution(double resolution) {
+	depthResolution = resolution;
+}
+
 
 LibTau::LibTau(const LibTau &other) {
 	*this = other;
@@ -72,9 +174,21 @@ LibTau::LibTau(const LibTau &other) {
 
 
 LibTau &LibTau::operator=(const LibTau &other) {
-	_handle = other._handle;
-	_depth = -1;
-	_initialized = false;
+	if ( this == &other ) {
+		return *this;
+	}
+
+	if ( _initialized ) {
+		detach();
+	}
+
+	// Share the tables of the other instance
+	_model = other._model;
+	_sharedModel = other._sharedModel;
+	if ( _sharedModel ) {
+		attach();
+	}
+
 	return *this;
 }
 
@@ -83,7 +197,7 @@ LibTau::~LibTau() {
 	if ( !_initialized ) {
 		return;
 	}
-	tabout(&_handle);
+	detach();
 }
 
 
@@ -110,9 +224,7 @@ void LibTau::initPath(const std::string &model) {
 
 	if ( _model != model ) {
 		if ( _initialized ) {
-			tabout(&_handle);
-			_depth = -1;
-			_initialized = false;
+			detach();
 		}
 	}
 	else if ( _initialized ) {
@@ -120,26 +232,75 @@ void LibTau::initPath(const std::string &model) {
 	}
 
 	if ( !model.empty() ) {
+		static std::mutex registryMutex;
+		static std::map<std::string, std::weak_ptr<SharedModel>> registry;
+
 		std::string tablePath = tablePrefix + model;
 
-		// Fill the handle structure with zeros
-		memset(&_handle, 0, sizeof(_handle));
-		int err = tabin(&_handle, tablePath.c_str());
-		if ( err ) {
-			std::ostringstream errmsg;
-			errmsg  << tablePath << ".hed and " << tablePath << ".tbl";
-			throw FileNotFoundError(errmsg.str());
+		{
+			std::lock_guard<std::mutex> lock(registryMutex);
+			auto &sharedModel = registry[tablePath];
+			_sharedModel = sharedModel.lock();
+
+			if ( !_sharedModel ) {
+				auto newModel = std::make_shared<SharedModel>();
+
+				// Fill the handle structure with zeros
+				memset(&newModel->tables, 0, sizeof(newModel->tables));
+				int err = tabin(&newModel->tables, tablePath.c_str());
+				if ( err ) {
+					registry.erase(tablePath);
+					std::ostringstream errmsg;
+					errmsg  << tablePath << ".hed and " << tablePath << ".tbl";
+					throw FileNotFoundError(errmsg.str());
+				}
+
+				brnset(&newModel->tables, "all");
+				newModel->path = tablePath;
+
+				sharedModel = newModel;
+				_sharedModel = newModel;
+			}
 		}
 
-		_depth = -1;
-		_initialized = true;
-		brnset(&_handle, "all");
+		attach();
 	}
 
 	_model = model;
 }
 
 
+void LibTau::attach() {
+	memcpy(&_handle, &_sharedModel->tables, sizeof(_handle));
+	rebasePhaseCodes(_handle);
+
+	// Depth correction reads from the table file. Each instance uses its
+	// own file handle to not serialize depth corrections between threads.
+	std::string tableFile = _sharedModel->path + ".tbl";
+	_handle.fpin = fopen(tableFile.c_str(), "rb");
+	if ( !_handle.fpin ) {
+		_sharedModel = nullptr;
+		throw FileNotFoundError(tableFile);
+	}
+
+	_depth = -1;
+	_initialized = true;
+}
+
+
+void LibTau::detach() {
+	if ( _handle.fpin ) {
+		fclose(_handle.fpin);
+		_handle.fpin = nullptr;
+	}
+
+	// The allocations of the handle are owned by the shared model
+	_sharedModel = nullptr;
+	_depth = -1;
+	_initialized = false;
+}
+
+
 void LibTau::setDepth(double depth) {
 	if ( (depth < 0.01) || (depth > 800) ) {
 		throw std::out_of_range(
@@ -152,7 +313,23 @@ void LibTau::setDepth(double depth) {
 
 	if ( depth != _depth ) {
 		_depth = depth;
-		depset(&_handle, _depth);
+
+		double resolution = depthResolution;
+		if ( resolution > 0 ) {
+			// Note that min and max are defined as macros by geog.h
+			depth = round(depth / resolution) * resolution;
+			if ( depth < 0.01 ) {
+				depth = 0.01;
+			}
+			else if ( depth > 800 ) {
+				depth = 800;
+			}
+		}
+
+		if ( !_sharedModel->restore(depth, _handle) ) {
+			depset(&_handle, depth);
+			_sharedModel->store(depth, _handle);
+		}
 	}
 }
 
@@ -23,6 +23,7 @@
 #define SEISCOMP_TTT_LIBTAU_H
 
 
+#include <memory>
 #include <string>
 #include <seiscomp/seismology/ttt.h>
 
@@ -41,6 +42,12 @@ namespace TTT {
  * TTTLibTau
  *
  * A class to compute seismic travel times for 1D models like "iasp91".
+ *
+ * The tables of a model are read only once per process and shared between
+ * all instances using the same model. Depth corrected branch tables are
+ * kept in a least recently used cache per model, so changing the source
+ * depth back to a depth used before by any instance does not require to
+ * recompute them.
  */
 class SC_SYSTEM_CORE_API LibTau : public TravelTimeTableInterface {
 	public:
@@ -55,6 +62,23 @@ class SC_SYSTEM_CORE_API LibTau : public TravelTimeTableInterface {
 		LibTau &operator=(const LibTau &other);
 
 
+	public:
+		/**
+		 * Sets the maximum number of depth corrected tables cached per
+		 * model. Each entry requires about 150kb. A value of 0 disables the
+		 * cache. The default is 32.
+		 */
+		static void SetDepthCacheSize(size_t entries);
+
+		/**
+		 * Sets the resolution in km to which source depths are rounded
+		 * before the tables are depth corrected. Rounding increases the
+		 * number of cache hits at the cost of accuracy. The default is 0
+		 * which disables rounding.
+		 */
+		static void SetDepthResolution(double resolution);
+
+
 	public:
 		bool setModel(const std::string &model) override;
 		const std::string &model() const override;
@@ -72,10 +96,11 @@ class SC_SYSTEM_CORE_API LibTau : public TravelTimeTableInterface {
 		 *
 		 * It should be noted that in this implementation it is extremely
 		 * important to compute as many travel times for the same focal
-		 * depth as possible. Changing the depth will always result in
-		 * the time-consuming re-computation of some internal tables,
-		 * which can be avoided by as many consecutive compute() calls as
-		 * possible, for the same depth.
+		 * depth as possible. Changing the depth to a depth which is not
+		 * in the depth cache will result in the time-consuming
+		 * re-computation of some internal tables, which can be avoided by
+		 * as many consecutive compute() calls as possible, for the same
+		 * depth.
 		 * @param lat1 The source latitude in degrees
 		 * @param lon1 The source longitude in degrees
 		 * @param dep1 The source depth in km
@@ -123,8 +148,18 @@ class SC_SYSTEM_CORE_API LibTau : public TravelTimeTableInterface {
 
 		void initPath(const std::string &model);
 
+		//! Initializes the handle from the tables of the shared model
+		void attach();
+		//! Releases the shared model
+		void detach();
+
+
+	private:
+		struct SharedModel;
+		using SharedModelPtr = std::shared_ptr<SharedModel>;
 
 		libtau             _handle;
+		SharedModelPtr     _sharedModel;
 		double             _depth{-1};
 		std::string        _model;
 		bool               _initialized{false};
@@ -24,6 +24,7 @@
 #include <seiscomp/core/strings.h>
 #include <seiscomp/core/system.h>
 #include <seiscomp/utils/files.h>
+#include <seiscomp/utils/timer.h>
 
 #include <boost/version.hpp>
 #include <boost/filesystem/operations.hpp>
@@ -34,9 +35,12 @@
 #include <sys/types.h>
 #include <errno.h>
 
+#include <atomic>
 #include <stdexcept>
 #include <fstream>
 #include <set>
+#include <thread>
+#include <tuple>
 
 
 using namespace std;
@@ -1612,45 +1616,17 @@ bool Module::loadBinding(ModuleBinding &binding,
 	Model::SymbolFileMap &symbols = *usedSymbols;
 
 	if ( !filename.empty() ) {
-		Config::Config *cfg = new Config::Config;
-
 		if ( Util::fileExists(filename) ) {
-			if ( delegate ) delegate->aboutToRead(filename.c_str());
-
-			while ( true ) {
-				if ( delegate ) cfg->setLogger(delegate);
-
-				if ( cfg->readConfig(filename, Environment::CS_CONFIG_APP) ) {
-					if ( delegate ) delegate->finishedReading(filename.c_str());
-					break;
-				}
-
-				if ( delegate == nullptr || !delegate->handleReadError(filename.c_str()) ) {
-					if ( !allowConfigFileErrors ) {
-						cerr << "ERROR: read " << filename << " failed" << endl;
-						delete cfg;
-						return false;
-					}
-
-					break;
-				}
-
-				delete cfg;
-				cfg = new Config::Config;
+			Model::SymbolFileMap fileSymbols;
+			if ( !model->readSymbols(fileSymbols, filename, Environment::CS_CONFIG_APP,
+			                         false, delegate) && !allowConfigFileErrors ) {
+				cerr << "ERROR: read " << filename << " failed" << endl;
+				return false;
 			}
-		}
 
-		SymbolTable *symtab = cfg->symbolTable();
-		if ( symtab == nullptr ) {
-			delete cfg;
-			cerr << "ERROR: internal error: symbol table not available" << endl;
-			return false;
+			for ( auto &item : fileSymbols )
+				symbols[item.first] = item.second;
 		}
-
-		for ( SymbolTable::iterator it = symtab->begin(); it != symtab->end(); ++it )
-			symbols[(*it)->name] = new SymbolMapItem(**it);
-
-		delete cfg;
 	}
 	else if ( !allowConfigFileErrors ) {
 		cerr << "ERROR: file required" << endl;
@@ -2232,15 +2208,279 @@ Module *Model::create(SchemaDefinitions *schema, SchemaModule *def) {
 }
 
 
+struct Model::ParsedFiles {
+	struct LogEntry {
+		Config::LogLevel level;
+		std::string      filename;
+		int              line;
+		std::string      message;
+	};
+
+	struct LogRecorder : Config::Logger {
+		void log(Config::LogLevel level, const char *filename, int line,
+		         const char *msg) override {
+			entries.push_back({level, filename ? filename : "", line, msg ? msg : ""});
+		}
+
+		std::vector<LogEntry> entries;
+	};
+
+	struct File {
+		bool                        success{false};
+		time_t                      lastModified{0};
+		std::vector<Config::Symbol> symbols;
+		std::vector<LogEntry>       log;
+	};
+
+	using Key = std::tuple<std::string, int, bool>;
+
+	std::map<Key, File> files;
+};
+
+
+size_t Model::parseFiles(const std::vector<ParseRequest> &requests, bool recordLog) {
+	_parsedFiles = std::make_shared<ParsedFiles>();
+
+	std::vector<ParsedFiles::File> results(requests.size());
+	std::atomic<size_t> next(0);
+
+	// Each file is parsed into its own symbol table. Nothing else is shared
+	// between the workers, in particular not the delegate.
+	auto worker = [&]() {
+		size_t i;
+		while ( (i = next++) < requests.size() ) {
+			const ParseRequest &req = requests[i];
+			ParsedFiles::File &file = results[i];
+			ParsedFiles::LogRecorder recorder;
+			Config::Config cfg;
+
+			if ( recordLog ) {
+				cfg.setLogger(&recorder);
+			}
+
+			file.lastModified = lastModificationTime(req.uri);
+			file.success = cfg.readConfig(req.uri, req.stage, req.raw);
+
+			SymbolTable *symtab = cfg.symbolTable();
+			if ( symtab ) {
+				for ( auto it = symtab->begin(); it != symtab->end(); ++it ) {
+					file.symbols.push_back(**it);
+				}
+			}
+
+			file.log = std::move(recorder.entries);
+		}
+	};
+
+	size_t threads = _parseThreads ? _parseThreads : std::max(1u, std::thread::hardware_concurrency());
+	threads = std::max<size_t>(1, std::min(threads, requests.size()));
+	if ( threads <= 1 ) {
+		worker();
+	}
+	else {
+		std::vector<std::thread> pool;
+		for ( size_t i = 0; i < threads; ++i ) {
+			pool.emplace_back(worker);
+		}
+		for ( auto &t : pool ) {
+			t.join();
+		}
+	}
+
+	for ( size_t i = 0; i < requests.size(); ++i ) {
+		_parsedFiles->files.emplace(
+			ParsedFiles::Key(requests[i].uri, requests[i].stage, requests[i].raw),
+			std::move(results[i])
+		);
+	}
+
+	return threads;
+}
+
+
+bool Model::readSymbols(SymbolFileMap &symbols, const std::string &uri,
+                        int stage, bool raw, ConfigDelegate *delegate) {
+	if ( delegate ) {
+		delegate->aboutToRead(uri.c_str());
+	}
+
+	if ( _parsedFiles ) {
+		auto it = _parsedFiles->files.find(ParsedFiles::Key(uri, stage, raw));
+		if ( it != _parsedFiles->files.end() ) {
+			ParsedFiles::File file = std::move(it->second);
+			_parsedFiles->files.erase(it);
+
+			if ( delegate ) {
+				for ( auto &entry : file.log ) {
+					delegate->log(entry.level, entry.filename.c_str(),
+					              entry.line, entry.message.c_str());
+				}
+			}
+
+			if ( file.success || !delegate || !delegate->handleReadError(uri.c_str()) ) {
+				if ( file.success && delegate ) {
+					delegate->finishedReading(uri.c_str());
+				}
+
+				symbols.lastModified = file.lastModified;
+				for ( auto &symbol : file.symbols ) {
+					symbols[symbol.name] = new SymbolMapItem(symbol);
+				}
+
+				return file.success;
+			}
+
+			// The delegate requested to read the file again
+		}
+	}
+
+	std::unique_ptr<Config::Config> cfg;
+	bool success = false;
+
+	while ( true ) {
+		cfg.reset(new Config::Config);
+
+		if ( delegate ) {
+			cfg->setLogger(delegate);
+		}
+
+		symbols.lastModified = lastModificationTime(uri);
+
+		if ( cfg->readConfig(uri, stage, raw) ) {
+			if ( delegate ) {
+				delegate->finishedReading(uri.c_str());
+			}
+			success = true;
+			break;
+		}
+
+		if ( !delegate || !delegate->handleReadError(uri.c_str()) ) {
+			break;
+		}
+	}
+
+	SymbolTable *symtab = cfg->symbolTable();
+	if ( symtab ) {
+		for ( auto it = symtab->begin(); it != symtab->end(); ++it ) {
+			symbols[(*it)->name] = new SymbolMapItem(**it);
+		}
+	}
+
+	return success;
+}
+
+
 bool Model::readConfig(int updateMaxStage, ConfigDelegate *delegate) {
+	Util::StopWatch stopWatch;
 	fs::directory_iterator it;
 	fs::directory_iterator fsDirEnd;
 	string keyDir;
+	vector<ParseRequest> requests;
+	set<string> requestedFiles;
 
 	// Clear configuration of stations
 	stations.clear();
 	symbols.clear();
 
+	// Collect all files which are going to be read below: the module
+	// configurations of each stage, the profiles and the station bindings.
+	// They are parsed in parallel and consumed afterwards in the same order
+	// as before.
+	for ( size_t i = 0; i < modules.size(); ++i ) {
+		Module *mod = modules[i].get();
+
+		for ( int stage = Environment::CS_FIRST; stage <= Environment::CS_LAST; ++stage ) {
+			string uri = configFileLocation(true, mod->definition->name, stage);
+			if ( requestedFiles.insert(uri).second )
+				requests.push_back({uri, stage, true});
+		}
+
+		if ( !mod->supportsBindings() ) continue;
+
+		try {
+			it = fs::directory_iterator(SC_FS_PATH(stationConfigDir(true, mod->definition->name)));
+		}
+		catch ( ... ) {
+			it = fsDirEnd;
+		}
+
+		for ( ; it != fsDirEnd; ++it ) {
+			if ( fs::is_directory(*it) ) continue;
+			if ( SC_FS_IT_LEAF(it).compare(0, 8, "profile_") != 0 ) continue;
+			if ( requestedFiles.insert(SC_FS_IT_STR(it)).second )
+				requests.push_back({SC_FS_IT_STR(it), Environment::CS_CONFIG_APP, false});
+		}
+	}
+
+	// Read station key files
+	vector<pair<StationID, StationPtr>> stationKeys;
+	keyDir = stationConfigDir(true);
+
+	try {
+		it = fs::directory_iterator(SC_FS_PATH(keyDir));
+	}
+	catch ( ... ) {
+		it = fsDirEnd;
+		SEISCOMP_DEBUG("%s not available", keyDir.c_str());
+	}
+
+	for ( ; it != fsDirEnd; ++it ) {
+		if ( fs::is_directory(*it) ) continue;
+		string filename = SC_FS_IT_LEAF(it);
+		if ( filename.compare(0, 8, "station_") != 0 )
+			continue;
+
+		size_t pos = filename.find('_', 8);
+		if ( pos == string::npos ) {
+			cerr << filename << ": invalid station id: expected '_' as "
+			                    "net-sta separator: ignoring" << endl;
+			continue;
+		}
+
+		StationID id;
+		id.networkCode = filename.substr(8, pos-8);
+		id.stationCode = filename.substr(pos+1);
+
+		if ( id.networkCode.empty() ) {
+			cerr << filename << ": invalid station id: network code must "
+			                    "not be empty: ignoring" << endl;
+			continue;
+		}
+
+		if ( id.stationCode.empty() ) {
+			cerr << filename << ": invalid station id: station code must "
+			                    "not be empty: ignoring" << endl;
+			continue;
+		}
+
+		//SEISCOMP_DEBUG("reading station key %s", it->path().string().c_str());
+		StationPtr station = new Station;
+		if ( !station->readConfig(SC_FS_IT_STR(it).c_str()) )
+			cerr << SC_FS_IT_STR(it) << ": error reading configuration: "
+			                               "set empty" << endl;
+
+		for ( size_t i = 0; i < station->config.size(); ++i ) {
+			if ( !station->config[i].profile.empty() ) continue;
+
+			Module *mod = module(station->config[i].moduleName);
+			if ( mod == nullptr || !mod->bindingTemplate ) continue;
+
+			string bindingFile = stationConfigDir(true, mod->definition->name)
+			                   + "/station_" + id.networkCode + "_" + id.stationCode;
+			if ( Util::fileExists(bindingFile)
+			  && requestedFiles.insert(bindingFile).second )
+				requests.push_back({bindingFile, Environment::CS_CONFIG_APP, false});
+		}
+
+		stationKeys.push_back(make_pair(id, station));
+	}
+
+	_readStatistics = ReadStatistics();
+	_readStatistics.files = requests.size();
+	_readStatistics.parseTime = stopWatch.elapsed().length();
+	_readStatistics.threads = parseFiles(requests, delegate != nullptr);
+	_readStatistics.parseTime = stopWatch.elapsed().length() - _readStatistics.parseTime;
+
 	// Collect all symbols at each stage and build global map
 	for ( size_t i = 0; i < modules.size(); ++i ) {
 		Module *mod = modules[i].get();
@@ -2262,50 +2502,8 @@ bool Model::readConfig(int updateMaxStage, ConfigDelegate *delegate) {
 
 			SEISCOMP_DEBUG("reading config %s", uri.c_str());
 
-			if ( delegate ) {
-				delegate->aboutToRead(uri.c_str());
-			}
-
-			Config::Config *cfg;
-			time_t lastModified = 0;
-
-			while ( true ) {
-				cfg = new Config::Config();
-
-				if ( delegate ) {
-					cfg->setLogger(delegate);
-				}
-
-				lastModified = lastModificationTime(uri);
-
-				if ( cfg->readConfig(uri, stage, true) ) {
-					if ( delegate ) {
-						delegate->finishedReading(uri.c_str());
-					}
-					break;
-				}
-
-				if ( !delegate || !delegate->handleReadError(uri.c_str()) ) {
-					break;
-				}
-
-				delete cfg;
-			}
-
 			symbols[uri] = SymbolFileMap();
-			symbols[uri].lastModified = lastModified;
-
-			SymbolTable *symtab = cfg->symbolTable();
-			if ( !symtab ) {
-				delete cfg;
-				continue;
-			}
-
-			for ( auto it = symtab->begin(); it != symtab->end(); ++it ) {
-				symbols[uri][(*it)->name] = new SymbolMapItem(**it);
-			}
-
-			delete cfg;
+			readSymbols(symbols[uri], uri, stage, true, delegate);
 		}
 	}
 
@@ -2374,50 +2572,9 @@ bool Model::readConfig(int updateMaxStage, ConfigDelegate *delegate) {
 	}
 
 	// Read station module configuration
-	keyDir = stationConfigDir(true);
-
-	try {
-		it = fs::directory_iterator(SC_FS_PATH(keyDir));
-	}
-	catch ( ... ) {
-		it = fsDirEnd;
-		SEISCOMP_DEBUG("%s not available", keyDir.c_str());
-	}
-
-	for ( ; it != fsDirEnd; ++it ) {
-		if ( fs::is_directory(*it) ) continue;
-		string filename = SC_FS_IT_LEAF(it);
-		if ( filename.compare(0, 8, "station_") != 0 )
-			continue;
-
-		size_t pos = filename.find('_', 8);
-		if ( pos == string::npos ) {
-			cerr << filename << ": invalid station id: expected '_' as "
-			                    "net-sta separator: ignoring" << endl;
-			continue;
-		}
-
-		StationID id;
-		id.networkCode = filename.substr(8, pos-8);
-		id.stationCode = filename.substr(pos+1);
-
-		if ( id.networkCode.empty() ) {
-			cerr << filename << ": invalid station id: network code must "
-			                    "not be empty: ignoring" << endl;
-			continue;
-		}
-
-		if ( id.stationCode.empty() ) {
-			cerr << filename << ": invalid station id: station code must "
-			                    "not be empty: ignoring" << endl;
-			continue;
-		}
-
-		//SEISCOMP_DEBUG("reading station key %s", it->path().string().c_str());
-		StationPtr station = new Station;
-		if ( !station->readConfig(SC_FS_IT_STR(it).c_str()) )
-			cerr << SC_FS_IT_STR(it) << ": error reading configuration: "
-			                               "set empty" << endl;
+	for ( auto &key : stationKeys ) {
+		const StationID &id = key.first;
+		StationPtr station = key.second;
 
 		stations[id] = station;
 
@@ -2442,6 +2599,18 @@ bool Model::readConfig(int updateMaxStage, ConfigDelegate *delegate) {
 		}
 	}
 
+	_readStatistics.modules = modules.size();
+	_readStatistics.stations = stations.size();
+	_readStatistics.totalTime = stopWatch.elapsed().length();
+
+	SEISCOMP_INFO("Read configuration of %d modules and %d stations in %fs, "
+	              "parsing %d files with %d threads took %fs",
+	              int(_readStatistics.modules), int(_readStatistics.stations),
+	              _readStatistics.totalTime, int(_readStatistics.files),
+	              int(_readStatistics.threads), _readStatistics.parseTime);
+
+	_parsedFiles.reset();
+
 	/*
 	for ( size_t i = 0; i < modules.size(); ++i ) {
 		Module *mod = modules[i].get();
@@ -2887,5 +3056,20 @@ void Model::accept(ModelVisitor *visitor) const {
 }
 
 
+void Model::setParseThreads(size_t threads) {
+	_parseThreads = threads;
+}
+
+
+size_t Model::parseThreads() const {
+	return _parseThreads;
+}
+
+
+const Model::ReadStatistics &Model::readStatistics() const {
+	return _readStatistics;
+}
+
+
 }
 }
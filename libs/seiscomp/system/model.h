@@ -28,6 +28,7 @@
 #include <seiscomp/system/environment.h>
 #include <seiscomp/system/schema.h>
 #include <seiscomp/core.h>
+#include <memory>
 #include <string>
 #include <vector>
 #include <map>
@@ -646,6 +647,21 @@ class SC_SYSTEM_CORE_API Station : public Core::BaseObject {
 class SC_SYSTEM_CORE_API Model : public Core::BaseObject {
 	DECLARE_RTTI;
 
+	// ------------------------------------------------------------------
+	//  Public types
+	// ------------------------------------------------------------------
+	public:
+		//! Statistics of Model::readConfig
+		struct ReadStatistics {
+			size_t modules{0};    //!< Number of modules
+			size_t stations{0};   //!< Number of stations
+			size_t files{0};      //!< Number of parsed configuration files
+			size_t threads{0};    //!< Number of threads used for parsing
+			double parseTime{0};  //!< Time in seconds to parse the files
+			double totalTime{0};  //!< Time in seconds of readConfig
+		};
+
+
 	// ------------------------------------------------------------------
 	//  X'truction
 	// ------------------------------------------------------------------
@@ -708,6 +724,15 @@ class SC_SYSTEM_CORE_API Model : public Core::BaseObject {
 		//! Accepts a model visitor and starts to traversing its nodes
 		void accept(ModelVisitor *) const;
 
+		//! Sets the number of threads which parse the configuration files
+		//! in readConfig. 0 uses one thread per CPU core, 1 parses all
+		//! files on the calling thread.
+		void setParseThreads(size_t threads);
+		size_t parseThreads() const;
+
+		//! Returns the statistics of the last call to readConfig
+		const ReadStatistics &readStatistics() const;
+
 
 	// ------------------------------------------------------------------
 	//  Private interface
@@ -736,6 +761,34 @@ class SC_SYSTEM_CORE_API Model : public Core::BaseObject {
 		mutable SymbolMap       symbols;
 		ModMap                  modMap;
 		std::string             keyDirOverride;
+
+	private:
+		struct ParsedFiles;
+		struct ParseRequest {
+			std::string uri;
+			int         stage;
+			bool        raw;
+		};
+
+		//! Parses the given configuration files concurrently. The results
+		//! are picked up by readSymbols in the order the files are
+		//! needed. If recordLog is set then the log messages of the parser
+		//! are kept and passed to the delegate in readSymbols. Returns the
+		//! number of threads used.
+		size_t parseFiles(const std::vector<ParseRequest> &requests, bool recordLog);
+
+		//! Reads the symbols of a configuration file into a symbol map and
+		//! informs the delegate. A file parsed by parseFiles is taken
+		//! from _parsedFiles. Returns false if the file could not be
+		//! parsed and the delegate did not succeed in re-reading it.
+		bool readSymbols(SymbolFileMap &symbols, const std::string &uri,
+		                 int stage, bool raw, ConfigDelegate *delegate);
+
+		std::shared_ptr<ParsedFiles> _parsedFiles;
+		size_t                       _parseThreads{0};
+		ReadStatistics               _readStatistics;
+
+	friend class Module;
 };
 
 
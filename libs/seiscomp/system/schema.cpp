@@ -25,12 +25,16 @@
 #include <boost/version.hpp>
 #include <boost/filesystem/operations.hpp>
 #include <boost/filesystem/path.hpp>
+#include <libxml/parser.h>
+#include <atomic>
 #include <string>
 #include <fstream>
+#include <thread>
 
 #include <seiscomp/system/schema.h>
 #include <seiscomp/core/strings.h>
 #include <seiscomp/core/system.h>
+#include <seiscomp/utils/timer.h>
 
 
 namespace fs = boost::filesystem;
@@ -543,8 +547,8 @@ bool SchemaDefinitions::load(const char *path) {
 
 
 bool SchemaDefinitions::reload() {
-	IO::XMLArchive ar;
-	ar.setListDelimiter(',');
+	Util::StopWatch stopWatch;
+	vector<string> files;
 
 	_modules.clear();
 	_plugins.clear();
@@ -553,22 +557,74 @@ bool SchemaDefinitions::reload() {
 	try {
 		SC_FS_DECLARE_PATH(directory, _path);
 
-		// Search for all XML files and parse them
+		// Search for all XML files
 		for ( fs::directory_iterator it(directory); it != fsDirEnd; ++it ) {
 			if ( fs::is_directory(*it) ) continue;
 			string filename = SC_FS_IT_STR(it);
 			if ( fs::path(filename).extension() != ".xml" ) continue;
+			files.push_back(filename);
+		}
+	}
+	catch ( std::exception &exc ) {
+		SEISCOMP_ERROR("%s", exc.what());
+		return false;
+	}
 
-			SEISCOMP_DEBUG("Loading %s", filename.c_str());
-			if ( !ar.open(filename.c_str()) ) {
-				SEISCOMP_ERROR("Failed to load %s", filename.c_str());
+	// The directory order is arbitrary. Sorting the files makes the result
+	// of duplicate definitions, where the first one wins, reproducible.
+	std::sort(files.begin(), files.end());
+
+	// Parse all files independently of each other and merge them afterwards
+	// in file order
+	vector<SchemaDefinitions> parsed(files.size());
+	vector<char> success(files.size(), 0);
+
+	// libxml2 must be initialized before it is used from several threads
+	xmlInitParser();
+
+	std::atomic<size_t> next(0);
+	auto worker = [&]() {
+		size_t i;
+		while ( (i = next++) < files.size() ) {
+			IO::XMLArchive ar;
+			ar.setListDelimiter(',');
+			if ( !ar.open(files[i].c_str()) )
 				continue;
-			}
 
-			serialize(ar);
+			parsed[i].serialize(ar);
 			ar.close();
+			success[i] = 1;
+		}
+	};
+
+	size_t threads = _loadThreads ? _loadThreads : std::max(1u, std::thread::hardware_concurrency());
+	threads = std::max<size_t>(1, std::min(threads, files.size()));
+	if ( threads <= 1 )
+		worker();
+	else {
+		vector<std::thread> pool;
+		for ( size_t i = 0; i < threads; ++i )
+			pool.emplace_back(worker);
+		for ( auto &t : pool )
+			t.join();
+	}
+
+	for ( size_t i = 0; i < files.size(); ++i ) {
+		SEISCOMP_DEBUG("Loading %s", files[i].c_str());
+		if ( !success[i] ) {
+			SEISCOMP_ERROR("Failed to load %s", files[i].c_str());
+			continue;
 		}
 
+		for ( auto &module : parsed[i]._modules )
+			add(module.get());
+		for ( auto &plugin : parsed[i]._plugins )
+			add(plugin.get());
+		for ( auto &binding : parsed[i]._bindings )
+			add(binding.get());
+	}
+
+	try {
 		// Read the aliases file and create the aliases
 		fs::path aliases = _path / fs::path("aliases");
 		ifstream ifs(aliases.string().c_str());
@@ -601,6 +657,12 @@ bool SchemaDefinitions::reload() {
 	// Sort modules by name
 	std::sort(_modules.begin(), _modules.end(), moduleSort);
 
+	SEISCOMP_DEBUG("Loaded %d description files with %d threads in %fs: "
+	               "%d modules, %d plugins, %d bindings",
+	               int(files.size()), int(threads),
+	               stopWatch.elapsed().length(), int(_modules.size()),
+	               int(_plugins.size()), int(_bindings.size()));
+
 	return true;
 }
 
@@ -469,6 +469,12 @@ class SC_SYSTEM_CORE_API SchemaDefinitions : public Core::BaseObject {
 		bool load(const char *path);
 		bool reload();
 
+		//! Sets the number of threads which parse the description files.
+		//! 0 uses one thread per CPU core, 1 parses all files on the
+		//! calling thread.
+		void setLoadThreads(size_t threads) { _loadThreads = threads; }
+		size_t loadThreads() const { return _loadThreads; }
+
 
 	// ------------------------------------------------------------------
 	//  Attributes
@@ -478,6 +484,7 @@ class SC_SYSTEM_CORE_API SchemaDefinitions : public Core::BaseObject {
 		std::vector<SchemaPluginPtr>  _plugins;
 		std::vector<SchemaBindingPtr> _bindings;
 		std::string                   _path;
+		size_t                        _loadThreads{0};
 };
 
 
@@ -0,0 +1,246 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#define SEISCOMP_TEST_MODULE SeisComP
+#include <seiscomp/unittest/unittests.h>
+
+#include <seiscomp/client/inventory.h>
+#include <seiscomp/datamodel/inventory_package.h>
+#include <seiscomp/io/archive/xmlarchive.h>
+
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+#include <sstream>
+
+
+using namespace std;
+using namespace Seiscomp;
+namespace fs = boost::filesystem;
+
+
+namespace {
+
+
+DataModel::InventoryPtr createInventory() {
+	DataModel::InventoryPtr inv = new DataModel::Inventory;
+
+	DataModel::ResponsePAZPtr paz = DataModel::ResponsePAZ::Create("ResponsePAZ/STS2");
+	paz->setName("STS2");
+	paz->setType("A");
+	paz->setGain(1500.0);
+	paz->setNormalizationFactor(6.0077e7);
+	paz->setNormalizationFrequency(1.0);
+	paz->setNumberOfPoles(2);
+	paz->setNumberOfZeros(2);
+	paz->setPoles(DataModel::ComplexArray());
+	paz->poles().content() = { { -0.037004, 0.037016 }, { -0.037004, -0.037016 } };
+	paz->setZeros(DataModel::ComplexArray());
+	paz->zeros().content() = { { 0, 0 }, { 0, 0 } };
+	inv->add(paz.get());
+
+	DataModel::ResponseFIRPtr fir = DataModel::ResponseFIR::Create("ResponseFIR/FIR1");
+	fir->setName("FIR1");
+	fir->setGain(1.0);
+	fir->setDecimationFactor(2);
+	fir->setDelay(0.5);
+	fir->setCorrection(0.5);
+	fir->setNumberOfCoefficients(3);
+	fir->setSymmetry("A");
+	fir->setCoefficients(DataModel::RealArray());
+	fir->coefficients().content() = { 0.25, 0.5, 0.25 };
+	inv->add(fir.get());
+
+	DataModel::SensorPtr sensor = DataModel::Sensor::Create("Sensor/STS2");
+	sensor->setName("STS2");
+	sensor->setUnit("M/S");
+	sensor->setResponse(paz->publicID());
+	inv->add(sensor.get());
+
+	DataModel::DataloggerPtr logger = DataModel::Datalogger::Create("Datalogger/Q330");
+	logger->setName("Q330");
+	logger->setGain(419430.0);
+	DataModel::DecimationPtr decimation = new DataModel::Decimation;
+	decimation->setSampleRateNumerator(20);
+	decimation->setSampleRateDenominator(1);
+	DataModel::Blob chain;
+	chain.setContent(fir->publicID());
+	decimation->setDigitalFilterChain(chain);
+	logger->add(decimation.get());
+	inv->add(logger.get());
+
+	DataModel::NetworkPtr net = DataModel::Network::Create("Network/GE");
+	net->setCode("GE");
+	net->setStart(Core::Time(1993, 1, 1));
+	net->setDescription("GEOFON");
+	inv->add(net.get());
+
+	for ( const char *code : { "MORC", "UGM" } ) {
+		DataModel::StationPtr sta = DataModel::Station::Create(string("Station/GE.") + code);
+		sta->setCode(code);
+		sta->setStart(Core::Time(2000, 1, 1));
+		sta->setLatitude(49.7766);
+		sta->setLongitude(17.5428);
+		sta->setElevation(740.0);
+		net->add(sta.get());
+
+		DataModel::SensorLocationPtr loc = DataModel::SensorLocation::Create(sta->publicID() + ".");
+		loc->setCode("");
+		loc->setStart(Core::Time(2000, 1, 1));
+		sta->add(loc.get());
+
+		for ( const char *cha : { "BHZ", "BHN", "BHE" } ) {
+			DataModel::StreamPtr stream = DataModel::Stream::Create(loc->publicID() + "." + cha);
+			stream->setCode(cha);
+			stream->setStart(Core::Time(2000, 1, 1));
+			stream->setSampleRateNumerator(20);
+			stream->setSampleRateDenominator(1);
+			stream->setGain(6.29e8);
+			stream->setGainFrequency(1.0);
+			stream->setGainUnit("M/S");
+			stream->setSensor(sensor->publicID());
+			stream->setDatalogger(logger->publicID());
+			loc->add(stream.get());
+		}
+	}
+
+	return inv;
+}
+
+
+string toXML(DataModel::Inventory *inv) {
+	stringbuf buf(ios_base::out);
+	IO::XMLArchive ar;
+	ar.create(&buf);
+	ar.setFormattedOutput(true);
+	ar << inv;
+	ar.close();
+	return buf.str();
+}
+
+
+struct TempDir {
+	TempDir() : path(fs::temp_directory_path() / fs::unique_path()) {
+		fs::create_directories(path);
+	}
+
+	~TempDir() {
+		fs::remove_all(path);
+	}
+
+	string file(const char *name) const {
+		return (path / name).string();
+	}
+
+	fs::path path;
+};
+
+
+}
+
+
+BOOST_AUTO_TEST_SUITE(seiscomp_client_inventory)
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(snapshotRoundTrip) {
+	TempDir tmp;
+	string xmlFile = tmp.file("inventory.xml");
+	string snapshotFile = tmp.file("inventory.bin");
+
+	{
+		DataModel::InventoryPtr inv = createInventory();
+		IO::XMLArchive ar;
+		BOOST_REQUIRE(ar.create(xmlFile.c_str()));
+		ar << inv;
+		ar.close();
+	}
+
+	auto *inventory = Client::Inventory::Instance();
+
+	inventory->load(xmlFile.c_str());
+	BOOST_REQUIRE(inventory->inventory() != nullptr);
+	string expected = toXML(inventory->inventory());
+	BOOST_REQUIRE(inventory->writeSnapshot(snapshotFile.c_str()));
+	Client::Inventory::Reset();
+
+	// The snapshot is written atomically and detected by its header
+	BOOST_CHECK(!fs::exists(snapshotFile + ".tmp"));
+	{
+		ifstream ifs(snapshotFile, ios::binary);
+		char magic[4];
+		BOOST_REQUIRE(ifs.read(magic, 4));
+		BOOST_CHECK_EQUAL(string(magic, 4), "SCCB");
+	}
+
+	BOOST_CHECK(fs::file_size(snapshotFile) < fs::file_size(xmlFile));
+
+	inventory->load(snapshotFile.c_str());
+	BOOST_REQUIRE(inventory->inventory() != nullptr);
+	BOOST_CHECK_EQUAL(inventory->inventory()->responsePAZCount(), 1);
+	BOOST_CHECK_EQUAL(inventory->inventory()->responseFIRCount(), 1);
+	BOOST_CHECK_EQUAL(toXML(inventory->inventory()), expected);
+
+	// Responses are resolved from the snapshot as well
+	DataModel::Stream *stream = inventory->getStream("GE", "UGM", "", "BHZ", Core::Time(2024, 1, 1));
+	BOOST_REQUIRE(stream != nullptr);
+	DataModel::Sensor *sensor = inventory->inventory()->findSensor(stream->sensor());
+	BOOST_REQUIRE(sensor != nullptr);
+	DataModel::ResponsePAZ *paz = inventory->inventory()->findResponsePAZ(sensor->response());
+	BOOST_REQUIRE(paz != nullptr);
+	BOOST_CHECK_EQUAL(paz->poles().content().size(), 2);
+
+	Client::Inventory::Reset();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(snapshotTruncated) {
+	TempDir tmp;
+	string snapshotFile = tmp.file("inventory.bin");
+	string truncatedFile = tmp.file("truncated.bin");
+
+	auto *inventory = Client::Inventory::Instance();
+	inventory->setInventory(createInventory().get());
+	BOOST_REQUIRE(inventory->writeSnapshot(snapshotFile.c_str()));
+	Client::Inventory::Reset();
+
+	{
+		ifstream ifs(snapshotFile, ios::binary);
+		string data((istreambuf_iterator<char>(ifs)), istreambuf_iterator<char>());
+		ofstream ofs(truncatedFile, ios::binary);
+		ofs.write(data.data(), data.size() / 2);
+	}
+
+	BOOST_CHECK_THROW(inventory->load(truncatedFile.c_str()), std::exception);
+	BOOST_CHECK(inventory->inventory() == nullptr);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,279 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#define SEISCOMP_TEST_MODULE SeisComP
+#include <seiscomp/unittest/unittests.h>
+
+#include <seiscomp/core/continuoustrace.h>
+#include <seiscomp/core/recordsequence.h>
+#include <seiscomp/utils/timer.h>
+
+#include <iostream>
+#include <random>
+
+
+using namespace std;
+using namespace Seiscomp;
+
+
+namespace {
+
+
+GenericRecordPtr createRecord(mt19937 &rng, const Core::Time &start,
+                              double fs, int samples) {
+	GenericRecordPtr rec = new GenericRecord("XX", "ABCD", "", "XYZ", start, fs);
+	uniform_int_distribution<int> value(-10000, 10000);
+
+	// Integer values are exactly representable in all sample types
+	switch ( rng() % 3 ) {
+		case 0:
+		{
+			IntArrayPtr data = new IntArray(samples);
+			for ( int i = 0; i < samples; ++i ) {
+				(*data)[i] = value(rng);
+			}
+			rec->setData(data.get());
+			break;
+		}
+		case 1:
+		{
+			FloatArrayPtr data = new FloatArray(samples);
+			for ( int i = 0; i < samples; ++i ) {
+				(*data)[i] = value(rng);
+			}
+			rec->setData(data.get());
+			break;
+		}
+		default:
+		{
+			DoubleArrayPtr data = new DoubleArray(samples);
+			for ( int i = 0; i < samples; ++i ) {
+				(*data)[i] = value(rng);
+			}
+			rec->setData(data.get());
+			break;
+		}
+	}
+
+	return rec;
+}
+
+
+void checkEqual(const GenericRecord *rec1, const GenericRecord *rec2) {
+	BOOST_REQUIRE(rec1 != nullptr);
+	BOOST_REQUIRE(rec2 != nullptr);
+	BOOST_CHECK_EQUAL(rec1->streamID(), rec2->streamID());
+	BOOST_CHECK(rec1->startTime() == rec2->startTime());
+	BOOST_CHECK_EQUAL(rec1->samplingFrequency(), rec2->samplingFrequency());
+
+	auto data1 = DoubleArray::ConstCast(rec1->data());
+	auto data2 = DoubleArray::ConstCast(rec2->data());
+	BOOST_REQUIRE(data1 != nullptr);
+	BOOST_REQUIRE(data2 != nullptr);
+	BOOST_CHECK_EQUAL_COLLECTIONS(data1->impl().begin(), data1->impl().end(),
+	                              data2->impl().begin(), data2->impl().end());
+}
+
+
+}
+
+
+BOOST_AUTO_TEST_SUITE(seiscomp_core_continuoustrace)
+
+
+BOOST_AUTO_TEST_CASE(contiguous) {
+	mt19937 rng(3);
+	uniform_int_distribution<int> samples(1, 150);
+
+	RingBuffer seq(0);
+	DoubleContinuousTrace trace(100);
+	Core::Time time(2024, 1, 1, 0, 0, 0);
+
+	for ( int i = 0; i < 500; ++i ) {
+		auto rec = createRecord(rng, time, 20, samples(rng));
+		time = rec->endTime();
+		seq.feed(rec.get());
+		BOOST_CHECK(trace.feed(rec.get()));
+	}
+
+	BOOST_CHECK_EQUAL(trace.segments().size(), 1);
+	BOOST_CHECK(trace.gaps().empty());
+	BOOST_CHECK(trace.timeWindow() == seq.timeWindow());
+	BOOST_CHECK_EQUAL(trace.stationCode(), "ABCD");
+
+	GenericRecordPtr rec1 = seq.contiguousRecord<double>();
+	GenericRecordPtr rec2 = trace.contiguousRecord();
+	checkEqual(rec1.get(), rec2.get());
+	BOOST_CHECK_EQUAL(static_cast<size_t>(rec2->sampleCount()), trace.sampleCount());
+
+	// Spans are clipped to the sampling intervals which intersect the
+	// window
+	auto start = trace.timeWindow().startTime();
+	Core::TimeWindow tw(start + Core::TimeSpan(10.01), start + Core::TimeSpan(20.0));
+	auto spans = trace.spans(tw);
+	BOOST_REQUIRE_EQUAL(spans.size(), 1);
+	BOOST_CHECK(spans[0].startTime() == start + Core::TimeSpan(10.0));
+	BOOST_CHECK_EQUAL(spans[0].size(), 200);
+
+	auto data = DoubleArray::ConstCast(rec1->data());
+	for ( size_t i = 0; i < spans[0].size(); ++i ) {
+		BOOST_CHECK_EQUAL(spans[0][i], (*data)[200+i]);
+	}
+
+	BOOST_CHECK_EQUAL(trace.availability(tw), 100.0);
+	BOOST_CHECK(trace.spans(Core::TimeWindow(start - Core::TimeSpan(10.0), start)).empty());
+}
+
+
+BOOST_AUTO_TEST_CASE(gapsAndOverlaps) {
+	mt19937 rng(5);
+	IntContinuousTrace trace(64);
+	Core::Time time(2024, 1, 1, 0, 0, 0);
+
+	auto rec = createRecord(rng, time, 10, 100);
+	BOOST_CHECK(trace.feed(rec.get()));
+
+	// Jitter within the tolerance
+	rec = createRecord(rng, rec->endTime() + Core::TimeSpan(0.02), 10, 100);
+	BOOST_CHECK(trace.feed(rec.get()));
+	BOOST_CHECK_EQUAL(trace.segments().size(), 1);
+
+	// Overlap of 30 samples
+	auto overlapping = createRecord(rng, rec->endTime() - Core::TimeSpan(3.0), 10, 50);
+	BOOST_CHECK(trace.feed(overlapping.get()));
+	BOOST_CHECK_EQUAL(trace.sampleCount(), 220);
+
+	// Completely overlapping record and different sampling frequency
+	BOOST_CHECK(!trace.feed(createRecord(rng, time, 10, 50).get()));
+	BOOST_CHECK(!trace.feed(createRecord(rng, overlapping->endTime(), 20, 50).get()));
+
+	// Gap of 5 samples
+	auto last = trace.timeWindow().endTime();
+	rec = createRecord(rng, last + Core::TimeSpan(0.5), 10, 80);
+	BOOST_CHECK(trace.feed(rec.get()));
+	BOOST_REQUIRE_EQUAL(trace.segments().size(), 2);
+	BOOST_REQUIRE_EQUAL(trace.gaps().size(), 1);
+	BOOST_CHECK(trace.gaps()[0] == Core::TimeWindow(last, rec->startTime()));
+
+	Core::TimeWindow tw(last - Core::TimeSpan(1.0), rec->startTime() + Core::TimeSpan(1.0));
+	auto spans = trace.spans(tw);
+	BOOST_REQUIRE_EQUAL(spans.size(), 2);
+	BOOST_CHECK_EQUAL(spans[0].size(), 10);
+	BOOST_CHECK_EQUAL(spans[1].size(), 10);
+	BOOST_CHECK_CLOSE(trace.availability(tw), 80.0, 1E-6);
+
+	GenericRecordPtr contiguous = trace.contiguousRecord(&tw);
+	BOOST_CHECK_EQUAL(contiguous->sampleCount(), 10);
+
+	contiguous = trace.contiguousRecord(&tw, true);
+	BOOST_REQUIRE_EQUAL(contiguous->sampleCount(), 25);
+	auto data = IntArray::ConstCast(contiguous->data());
+	BOOST_REQUIRE(data != nullptr);
+	BOOST_CHECK_EQUAL((*data)[12], (spans[0][9] + spans[1][0]) / 2);
+
+	// Feeding the trace to a record sequence and back yields the same data
+	RingBuffer seq(0);
+	BOOST_CHECK_EQUAL(trace.toSequence(seq), 2);
+	IntContinuousTrace copy(1000);
+	BOOST_CHECK_EQUAL(copy.feed(seq), 2);
+	BOOST_REQUIRE_EQUAL(copy.segments().size(), 2);
+	BOOST_CHECK_EQUAL(copy.sampleCount(), trace.sampleCount());
+
+	GenericRecordPtr rec1 = copy.contiguousRecord(nullptr, true);
+	GenericRecordPtr rec2 = trace.contiguousRecord(nullptr, true);
+	auto data1 = IntArray::ConstCast(rec1->data());
+	auto data2 = IntArray::ConstCast(rec2->data());
+	BOOST_CHECK_EQUAL_COLLECTIONS(data1->impl().begin(), data1->impl().end(),
+	                              data2->impl().begin(), data2->impl().end());
+}
+
+
+BOOST_AUTO_TEST_CASE(trimFront) {
+	mt19937 rng(9);
+	FloatContinuousTrace trace(100);
+	Core::Time time(2024, 1, 1, 0, 0, 0);
+
+	for ( int i = 0; i < 10; ++i ) {
+		auto rec = createRecord(rng, time, 1, 100);
+		time = rec->endTime() + Core::TimeSpan(10, 0);
+		trace.feed(rec.get());
+	}
+
+	BOOST_CHECK_EQUAL(trace.segments().size(), 10);
+	auto spans = trace.spans();
+	float sample = spans[2][50];
+
+	// Cut in the middle of the third segment
+	trace.trimFront(spans[2].startTime() + Core::TimeSpan(50, 0));
+	BOOST_REQUIRE_EQUAL(trace.segments().size(), 8);
+	BOOST_CHECK_EQUAL(trace.sampleCount(), 750);
+	BOOST_CHECK(trace.timeWindow().startTime() == spans[2].startTime() + Core::TimeSpan(50, 0));
+	BOOST_CHECK_EQUAL(trace.spans()[0][0], sample);
+
+	// Appending continues after trimming
+	BOOST_CHECK(trace.feed(createRecord(rng, time, 1, 10).get()));
+	BOOST_CHECK_EQUAL(trace.sampleCount(), 760);
+
+	trace.trimFront(time + Core::TimeSpan(100, 0));
+	BOOST_CHECK(trace.empty());
+	BOOST_CHECK_EQUAL(trace.sampleCount(), 0);
+	BOOST_CHECK(trace.feed(createRecord(rng, time, 1, 10).get()));
+	BOOST_CHECK_EQUAL(trace.sampleCount(), 10);
+}
+
+
+BOOST_AUTO_TEST_CASE(measureperformance) {
+	mt19937 rng(1);
+	RingBuffer seq(0);
+	DoubleContinuousTrace trace;
+	Core::Time time(2024, 1, 1, 0, 0, 0);
+
+	for ( int i = 0; i < 20000; ++i ) {
+		auto rec = createRecord(rng, time, 100, 400);
+		time = rec->endTime();
+		seq.feed(rec.get());
+		trace.feed(rec.get());
+	}
+
+	const int runs = 20;
+	double sum1 = 0, sum2 = 0;
+
+	Util::StopWatch timer;
+	for ( int i = 0; i < runs; ++i ) {
+		GenericRecordPtr rec = seq.contiguousRecord<double>();
+		sum1 += rec->sampleCount();
+	}
+	auto elapsed1 = timer.elapsed();
+
+	timer.restart();
+	for ( int i = 0; i < runs; ++i ) {
+		GenericRecordPtr rec = trace.contiguousRecord();
+		sum2 += rec->sampleCount();
+	}
+	auto elapsed2 = timer.elapsed();
+
+	BOOST_CHECK_EQUAL(sum1, sum2);
+
+	cerr << "RecordSequence::contiguousRecord: " << elapsed1 << endl;
+	cerr << "ContinuousTrace::contiguousRecord: " << elapsed2 << endl;
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
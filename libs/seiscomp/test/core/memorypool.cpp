@@ -0,0 +1,168 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+
+#define SEISCOMP_TEST_MODULE SeisComP
+
+
+#include <condition_variable>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+#include <seiscomp/core/genericrecord.h>
+#include <seiscomp/core/memorypool.h>
+#include <seiscomp/core/typedarray.h>
+#include <seiscomp/utils/timer.h>
+#include <seiscomp/unittest/unittests.h>
+
+
+using namespace std;
+using namespace Seiscomp;
+
+
+namespace {
+
+
+// A minimal single producer, single consumer queue
+class RecordQueue {
+	public:
+		void push(RecordPtr rec) {
+			{
+				lock_guard<mutex> lock(_mutex);
+				_records.push_back(std::move(rec));
+			}
+			_cond.notify_one();
+		}
+
+		RecordPtr pop() {
+			unique_lock<mutex> lock(_mutex);
+			_cond.wait(lock, [this]() { return !_records.empty(); });
+			RecordPtr rec = std::move(_records.front());
+			_records.pop_front();
+			return rec;
+		}
+
+	private:
+		mutex              _mutex;
+		condition_variable _cond;
+		deque<RecordPtr>   _records;
+};
+
+
+}
+
+
+BOOST_AUTO_TEST_SUITE(seiscomp_core_memorypool)
+
+
+BOOST_AUTO_TEST_CASE(reuse) {
+	Core::MemoryPool::SetEnabled(true);
+
+	void *block = Core::MemoryPool::Allocate(100);
+	BOOST_REQUIRE(block != nullptr);
+	Core::MemoryPool::Release(block, 100);
+
+	// Blocks of the same size class are reused
+	void *block2 = Core::MemoryPool::Allocate(120);
+	BOOST_CHECK_EQUAL(block, block2);
+	Core::MemoryPool::Release(block2, 120);
+
+	// Large blocks are not pooled but must be released as well
+	block = Core::MemoryPool::Allocate(Core::MemoryPool::MaxBlockSize + 1);
+	BOOST_REQUIRE(block != nullptr);
+	Core::MemoryPool::Release(block, Core::MemoryPool::MaxBlockSize + 1);
+
+	// Blocks allocated with an enabled pool can be released with a disabled
+	// one and vice versa
+	block = Core::MemoryPool::Allocate(64);
+	Core::MemoryPool::SetEnabled(false);
+	block2 = Core::MemoryPool::Allocate(64);
+	Core::MemoryPool::Release(block, 64);
+	Core::MemoryPool::SetEnabled(true);
+	Core::MemoryPool::Release(block2, 64);
+}
+
+
+BOOST_AUTO_TEST_CASE(crossThread) {
+	RecordQueue queue;
+	int received = 0;
+
+	thread consumer([&queue, &received]() {
+		for ( int i = 0; i < 10000; ++i ) {
+			auto rec = queue.pop();
+			if ( rec->sampleCount() == 100 ) {
+				++received;
+			}
+		}
+	});
+
+	for ( int i = 0; i < 10000; ++i ) {
+		GenericRecordPtr rec = new GenericRecord("XX", "ABC", "", "HHZ", Core::Time(i, 0), 100.0);
+		rec->setData(new Int32Array(100));
+		queue.push(rec);
+	}
+
+	consumer.join();
+
+	BOOST_CHECK_EQUAL(received, 10000);
+}
+
+
+BOOST_AUTO_TEST_CASE(measureperformance) {
+	// Ten seconds of data of 10000 streams with one record per second and
+	// stream. Records are created in one thread and released in another as
+	// done with acquisition and processing threads.
+#define RECORDS 100000
+	double elapsed[2];
+	int32_t samples[100] = {};
+
+	for ( int pass = 0; pass < 2; ++pass ) {
+		Core::MemoryPool::SetEnabled(pass == 1);
+
+		RecordQueue queue;
+		Util::StopWatch stopWatch;
+
+		thread consumer([&queue]() {
+			for ( int i = 0; i < RECORDS; ++i ) {
+				queue.pop();
+			}
+		});
+
+		for ( int i = 0; i < RECORDS; ++i ) {
+			GenericRecordPtr rec = new GenericRecord("XX", "ABC", "", "HHZ", Core::Time(i / 10000, 0), 100.0);
+			rec->setData(100, samples, Array::INT);
+			queue.push(rec);
+		}
+
+		consumer.join();
+		elapsed[pass] = stopWatch.elapsed().length();
+	}
+
+	Core::MemoryPool::SetEnabled(true);
+
+	cerr << "records/s without pool: " << RECORDS / elapsed[0] << endl;
+	cerr << "records/s with pool: " << RECORDS / elapsed[1] << endl;
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
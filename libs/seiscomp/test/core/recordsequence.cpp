@@ -26,6 +26,10 @@
 #include <seiscomp/core/typedarray.h>
 #include <seiscomp/utils/timer.h>
 
+#include <algorithm>
+#include <iostream>
+#include <random>
+
 
 using namespace std;
 using namespace Seiscomp;
@@ -55,6 +59,109 @@ const Record *findRecord2(const RecordSequence &seq, const Core::Time &ts) {
 */
 
 
+GenericRecordPtr createRecord(mt19937 &rng, const Core::Time &start,
+                              double fs, int samples) {
+	GenericRecordPtr rec = new GenericRecord("XX", "ABCD", "", "XYZ", start, fs);
+	uniform_real_distribution<double> value(-1E4, 1E4);
+
+	switch ( rng() % 3 ) {
+		case 0:
+		{
+			IntArrayPtr data = new IntArray(samples);
+			for ( int i = 0; i < samples; ++i ) {
+				(*data)[i] = static_cast<int>(value(rng));
+			}
+			rec->setData(data.get());
+			break;
+		}
+		case 1:
+		{
+			FloatArrayPtr data = new FloatArray(samples);
+			for ( int i = 0; i < samples; ++i ) {
+				(*data)[i] = static_cast<float>(value(rng));
+			}
+			rec->setData(data.get());
+			break;
+		}
+		default:
+		{
+			DoubleArrayPtr data = new DoubleArray(samples);
+			for ( int i = 0; i < samples; ++i ) {
+				(*data)[i] = value(rng);
+			}
+			rec->setData(data.get());
+			break;
+		}
+	}
+
+	return rec;
+}
+
+
+// Compares the indexed queries of seq with a copy of the records which
+// has been filled directly and therefore scans all records.
+void compareWithScan(const RecordSequence &seq, mt19937 &rng) {
+	RingBuffer scan(0, seq.tolerance());
+	for ( const auto &rec : seq ) {
+		scan.push_back(rec);
+	}
+
+	auto r1 = seq.amplitudeRange();
+	auto r2 = scan.amplitudeRange();
+	BOOST_CHECK_EQUAL(r1.first, r2.first);
+	BOOST_CHECK_EQUAL(r1.second, r2.second);
+
+	auto w1 = seq.windows();
+	auto w2 = scan.windows();
+	BOOST_REQUIRE_EQUAL(w1.size(), w2.size());
+	for ( size_t i = 0; i < w1.size(); ++i ) {
+		BOOST_CHECK(w1[i] == w2[i]);
+	}
+
+	auto g1 = seq.gaps();
+	auto g2 = scan.gaps();
+	BOOST_REQUIRE_EQUAL(g1.size(), g2.size());
+	for ( size_t i = 0; i < g1.size(); ++i ) {
+		BOOST_CHECK(g1[i] == g2[i]);
+	}
+
+	if ( seq.empty() ) {
+		return;
+	}
+
+	auto tw = seq.timeWindow();
+	double length = static_cast<double>(tw.length());
+	uniform_real_distribution<double> offset(-0.1 * length, 1.1 * length);
+	uniform_int_distribution<size_t> pick(0, seq.size()-1);
+
+	for ( int i = 0; i < 20; ++i ) {
+		Core::Time t1 = tw.startTime() + Core::TimeSpan(offset(rng));
+		Core::Time t2 = tw.startTime() + Core::TimeSpan(offset(rng));
+
+		// Also use record boundaries
+		if ( i % 4 == 0 ) {
+			t1 = seq[pick(rng)]->startTime();
+		}
+		else if ( i % 4 == 1 ) {
+			t2 = seq[pick(rng)]->endTime();
+		}
+
+		if ( t2 < t1 ) {
+			swap(t1, t2);
+		}
+
+		Core::TimeWindow window(t1, t2);
+
+		r1 = seq.amplitudeRange(&window);
+		r2 = scan.amplitudeRange(&window);
+		BOOST_CHECK_EQUAL(r1.first, r2.first);
+		BOOST_CHECK_EQUAL(r1.second, r2.second);
+
+		BOOST_CHECK_EQUAL(seq.availability(window), scan.availability(window));
+	}
+}
+
+
 }
 
 
@@ -129,4 +236,124 @@ BOOST_AUTO_TEST_CASE(bounds) {
 }
 
 
+BOOST_AUTO_TEST_CASE(summaryIndex) {
+	mt19937 rng(7);
+	uniform_int_distribution<int> samples(1, 200);
+	uniform_int_distribution<int> event(0, 99);
+
+	RingBuffer ring(300);
+	TimeWindowBuffer window(Core::TimeWindow(Core::Time(2024, 1, 1, 0, 10, 0),
+	                                         Core::Time(2024, 1, 1, 2, 0, 0)));
+
+	Core::Time time(2024, 1, 1, 0, 0, 0);
+	double fs = 100;
+	vector<GenericRecordPtr> delayed;
+
+	for ( int i = 0; i < 3000; ++i ) {
+		int e = event(rng);
+
+		if ( e < 3 ) {
+			// Gap
+			time += Core::TimeSpan(0.5 + e);
+		}
+		else if ( e < 6 ) {
+			// Jitter within and beyond the tolerance
+			time += Core::TimeSpan((e - 4.5) * 0.4 / fs);
+		}
+		else if ( e < 7 ) {
+			fs = fs == 100 ? 20 : 100;
+		}
+
+		auto rec = createRecord(rng, time, fs, samples(rng));
+		time = rec->endTime();
+
+		if ( e == 7 ) {
+			// Records which must not be decoded on feed
+			rec->setHint(Record::SAVE_RAW);
+		}
+
+		// Feed some records out of order
+		if ( e >= 90 ) {
+			delayed.push_back(rec);
+		}
+		else {
+			ring.feed(rec.get());
+			window.feed(rec.get());
+		}
+
+		if ( delayed.size() > 5 ) {
+			shuffle(delayed.begin(), delayed.end(), rng);
+			for ( auto &rec : delayed ) {
+				ring.feed(rec.get());
+				window.feed(rec.get());
+			}
+			delayed.clear();
+		}
+
+		if ( i % 100 == 99 ) {
+			compareWithScan(ring, rng);
+			compareWithScan(window, rng);
+		}
+	}
+
+	// Changed tolerance
+	ring.setTolerance(2.5);
+	compareWithScan(ring, rng);
+	ring.feed(createRecord(rng, time, fs, 10).get());
+	compareWithScan(ring, rng);
+
+	// Modified container
+	ring.pop_back();
+	compareWithScan(ring, rng);
+	ring.clear();
+	compareWithScan(ring, rng);
+	ring.feed(createRecord(rng, time, fs, 10).get());
+	compareWithScan(ring, rng);
+}
+
+
+BOOST_AUTO_TEST_CASE(measureperformance) {
+	mt19937 rng(1);
+	RingBuffer seq(0), scan(0);
+	Core::Time time(2024, 1, 1, 0, 0, 0);
+
+	for ( int i = 0; i < 20000; ++i ) {
+		auto rec = createRecord(rng, time, 100, 400);
+		time = rec->endTime();
+		if ( i % 1000 == 999 ) {
+			time += Core::TimeSpan(10, 0);
+		}
+		seq.feed(rec.get());
+		scan.push_back(rec);
+	}
+
+	auto tw = seq.timeWindow();
+	Core::TimeWindow window(tw.startTime() + Core::TimeSpan(3600, 0),
+	                        tw.endTime() - Core::TimeSpan(3600, 0));
+	const int runs = 100;
+	double sum1 = 0, sum2 = 0;
+
+	Util::StopWatch timer;
+	for ( int i = 0; i < runs; ++i ) {
+		sum1 += scan.amplitudeRange(&window).second;
+		sum1 += scan.availability(window);
+		sum1 += scan.gaps().size();
+	}
+	auto elapsed1 = timer.elapsed();
+
+	timer.restart();
+	for ( int i = 0; i < runs; ++i ) {
+		sum2 += seq.amplitudeRange(&window).second;
+		sum2 += seq.availability(window);
+		sum2 += seq.gaps().size();
+	}
+	auto elapsed2 = timer.elapsed();
+
+	BOOST_CHECK_EQUAL(sum1, sum2);
+
+	cerr << "Scanning queries: " << elapsed1 << endl;
+	cerr << "Indexed queries: " << elapsed2 << endl;
+}
+
+
 BOOST_AUTO_TEST_SUITE_END()
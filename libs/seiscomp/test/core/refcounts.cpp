@@ -26,6 +26,8 @@
 #include <string>
 #include <cstdio>
 #include <atomic>
+#include <thread>
+#include <vector>
 
 #include <boost/intrusive_ptr.hpp>
 
@@ -85,7 +87,7 @@ BOOST_AUTO_TEST_SUITE(seiscomp_core_referencecounts)
 
 BOOST_AUTO_TEST_CASE(measureperformance) {
 #define LOOPN 100000000
-	double elapsed1, elapsed2, elapsed3;
+	double elapsed1, elapsed2, elapsed3, elapsed4;
 
 	{
 		X::Pointer ptr1 = new X, ptr2;
@@ -126,9 +128,70 @@ BOOST_AUTO_TEST_CASE(measureperformance) {
 		elapsed3 = stopWatch.elapsed().length();
 	}
 
+	{
+		DoubleArrayPtr ptr1 = new DoubleArray, ptr2;
+
+		Util::StopWatch stopWatch;
+
+		for ( size_t i = 0; i < LOOPN; ++i ) {
+			ptr2 = nullptr;
+			ptr2 = ptr1;
+		}
+
+		elapsed4 = stopWatch.elapsed().length();
+	}
+
 	cerr << "basic version: " << elapsed1 << "s" << endl;
 	cerr << "thread-safe version: " << elapsed2 << "s" << endl;
 	cerr << "BaseObject version: " << elapsed3 << "s" << endl;
+	cerr << "Array version: " << elapsed4 << "s" << endl;
+}
+
+
+BOOST_AUTO_TEST_CASE(sharedArray) {
+#define THREADS 4
+#define COPIES 1000000
+	DoubleArrayPtr array = new DoubleArray(100);
+	vector<thread> threads;
+
+	for ( int i = 0; i < THREADS; ++i ) {
+		threads.emplace_back([array]() {
+			DoubleArrayPtr copy;
+			for ( size_t n = 0; n < COPIES; ++n ) {
+				copy = array;
+				copy = nullptr;
+			}
+		});
+	}
+
+	for ( auto &thrd : threads ) {
+		thrd.join();
+	}
+
+	BOOST_CHECK_EQUAL(array->referenceCount(), 1);
+}
+
+
+BOOST_AUTO_TEST_CASE(sharedBaseObject) {
+	// Plain BaseObject pointers use atomic reference counting as well
+	Core::BaseObjectPtr object = new DoubleArray(100);
+	vector<thread> threads;
+
+	for ( int i = 0; i < THREADS; ++i ) {
+		threads.emplace_back([object]() {
+			Core::BaseObjectPtr copy;
+			for ( size_t n = 0; n < COPIES; ++n ) {
+				copy = object;
+				copy = nullptr;
+			}
+		});
+	}
+
+	for ( auto &thrd : threads ) {
+		thrd.join();
+	}
+
+	BOOST_CHECK_EQUAL(object->referenceCount(), 1);
 }
 
 
@@ -0,0 +1,202 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#define SEISCOMP_TEST_MODULE SeisComP
+
+
+#include <iostream>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <seiscomp/core/genericrecord.h>
+#include <seiscomp/core/streamid.h>
+#include <seiscomp/utils/timer.h>
+#include <seiscomp/unittest/unittests.h>
+
+
+using namespace std;
+using namespace Seiscomp;
+
+
+BOOST_AUTO_TEST_SUITE(seiscomp_core_streamid)
+
+
+BOOST_AUTO_TEST_CASE(intern) {
+	auto e1 = Core::StreamIDTable::Intern("GE", "MORC", "", "BHZ");
+	auto e2 = Core::StreamIDTable::Intern("GE", "MORC", "", "BHN");
+	auto e3 = Core::StreamIDTable::Intern("GE", "MORC", "", "BHZ");
+
+	BOOST_REQUIRE(e1 != nullptr);
+	BOOST_REQUIRE(e2 != nullptr);
+	BOOST_CHECK(e1 == e3);
+	BOOST_CHECK(e1->handle != e2->handle);
+	BOOST_CHECK(e1->handle != Core::StreamIDTable::InvalidHandle);
+	BOOST_CHECK_EQUAL(e1->streamID, "GE.MORC..BHZ");
+	BOOST_CHECK_EQUAL(e2->channelCode, "BHN");
+
+	BOOST_CHECK(Core::StreamIDTable::Get(e1->handle) == e1);
+	BOOST_CHECK(Core::StreamIDTable::Get(Core::StreamIDTable::InvalidHandle) == nullptr);
+
+	BOOST_CHECK(Core::StreamIDTable::Find("GE", "MORC", "", "BHZ") == e1);
+	BOOST_CHECK(Core::StreamIDTable::Find("GE.MORC..BHN") == e2);
+	BOOST_CHECK(Core::StreamIDTable::Find("GE.MORC..BHE") == nullptr);
+	BOOST_CHECK(Core::StreamIDTable::Find("GE.MORC.BHZ") == nullptr);
+	BOOST_CHECK(Core::StreamIDTable::Find("GE.MORC...BHZ") == nullptr);
+
+	// The codes must not be ambiguous when concatenated
+	auto e4 = Core::StreamIDTable::Intern("GE", "MOR", "C", "BHZ");
+	BOOST_CHECK(e4 != e1);
+}
+
+
+BOOST_AUTO_TEST_CASE(record) {
+	GenericRecordPtr rec = new GenericRecord("GE", "UGM", "", "BHZ", Core::Time(), 20.0);
+	auto handle = rec->streamHandle();
+
+	BOOST_CHECK(handle != Core::StreamIDTable::InvalidHandle);
+	BOOST_CHECK_EQUAL(handle, rec->streamHandle());
+	BOOST_CHECK_EQUAL(Core::StreamIDTable::Get(handle)->streamID, rec->streamID());
+
+	GenericRecordPtr copy = new GenericRecord(*rec);
+	BOOST_CHECK_EQUAL(copy->streamHandle(), handle);
+
+	// Changing a code must invalidate the cached entry
+	rec->setChannelCode("BHE");
+	BOOST_CHECK(rec->streamHandle() != handle);
+	BOOST_CHECK_EQUAL(Core::StreamIDTable::Get(rec->streamHandle())->streamID, "GE.UGM..BHE");
+	BOOST_CHECK_EQUAL(copy->streamHandle(), handle);
+}
+
+
+BOOST_AUTO_TEST_CASE(measureperformance) {
+#define STREAMS 1000
+#define LOOPN 10000000
+	vector<GenericRecordPtr> records;
+	double elapsed1, elapsed2;
+	size_t hits1 = 0, hits2 = 0;
+
+	for ( int i = 0; i < STREAMS; ++i ) {
+		records.push_back(new GenericRecord("XX", "S" + to_string(i), "00", "HHZ", Core::Time(), 100.0));
+	}
+
+	{
+		map<string, size_t> streams;
+		for ( auto &rec : records ) {
+			streams[rec->streamID()] = 1;
+		}
+
+		Util::StopWatch stopWatch;
+
+		for ( size_t i = 0; i < LOOPN; ++i ) {
+			hits1 += streams.find(records[i % STREAMS]->streamID())->second;
+		}
+
+		elapsed1 = stopWatch.elapsed().length();
+	}
+
+	{
+		unordered_map<Core::StreamHandle, size_t> streams;
+		for ( auto &rec : records ) {
+			streams[rec->streamHandle()] = 1;
+		}
+
+		Util::StopWatch stopWatch;
+
+		for ( size_t i = 0; i < LOOPN; ++i ) {
+			hits2 += streams.find(records[i % STREAMS]->streamHandle())->second;
+		}
+
+		elapsed2 = stopWatch.elapsed().length();
+	}
+
+	BOOST_CHECK_EQUAL(hits1, hits2);
+
+	cerr << "stream id lookup: " << elapsed1 << "s" << endl;
+	cerr << "stream handle lookup: " << elapsed2 << "s" << endl;
+}
+
+
+BOOST_AUTO_TEST_CASE(measurefreshrecords) {
+	// Each record is created from its codes as a record reader does, so
+	// streamHandle() has to resolve the handle from the codes every time
+#define FRESHN 1000000
+	vector<string> stations;
+	double elapsed0, elapsed1, elapsed2;
+	size_t hits0 = 0, hits1 = 0, hits2 = 0;
+
+	for ( int i = 0; i < STREAMS; ++i ) {
+		stations.push_back("S" + to_string(i));
+	}
+
+	{
+		Util::StopWatch stopWatch;
+
+		for ( size_t i = 0; i < FRESHN; ++i ) {
+			GenericRecordPtr rec = new GenericRecord("XX", stations[i % STREAMS], "00", "HHZ", Core::Time(), 100.0);
+			hits0 += rec->sampleCount() + 1;
+		}
+
+		elapsed0 = stopWatch.elapsed().length();
+	}
+
+	{
+		map<string, size_t> streams;
+		for ( auto &sta : stations ) {
+			streams["XX." + sta + ".00.HHZ"] = 1;
+		}
+
+		Util::StopWatch stopWatch;
+
+		for ( size_t i = 0; i < FRESHN; ++i ) {
+			GenericRecordPtr rec = new GenericRecord("XX", stations[i % STREAMS], "00", "HHZ", Core::Time(), 100.0);
+			hits1 += streams.find(rec->streamID())->second;
+		}
+
+		elapsed1 = stopWatch.elapsed().length();
+	}
+
+	{
+		unordered_map<Core::StreamHandle, size_t> streams;
+		for ( auto &sta : stations ) {
+			streams[Core::StreamIDTable::Intern("XX", sta, "00", "HHZ")->handle] = 1;
+		}
+
+		Util::StopWatch stopWatch;
+
+		for ( size_t i = 0; i < FRESHN; ++i ) {
+			GenericRecordPtr rec = new GenericRecord("XX", stations[i % STREAMS], "00", "HHZ", Core::Time(), 100.0);
+			hits2 += streams.find(rec->streamHandle())->second;
+		}
+
+		elapsed2 = stopWatch.elapsed().length();
+	}
+
+	BOOST_CHECK_EQUAL(hits0, hits1);
+	BOOST_CHECK_EQUAL(hits1, hits2);
+
+	cerr << "fresh record creation: " << elapsed0 << "s" << endl;
+	cerr << "fresh record stream id lookup: " << elapsed1 - elapsed0 << "s" << endl;
+	cerr << "fresh record stream handle lookup: " << elapsed2 - elapsed0 << "s" << endl;
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
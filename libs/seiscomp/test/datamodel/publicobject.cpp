@@ -0,0 +1,154 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+
+#define SEISCOMP_TEST_MODULE SeisComP
+
+
+#include <iostream>
+#include <set>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <seiscomp/unittest/unittests.h>
+
+#include <seiscomp/datamodel/pick.h>
+#include <seiscomp/utils/timer.h>
+
+
+using namespace std;
+using namespace Seiscomp;
+using namespace Seiscomp::DataModel;
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_SUITE(seiscomp_datamodel_publicobject)
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(registration) {
+	PublicObject::SetRegistrationEnabled(true);
+
+	size_t count = PublicObject::ObjectCount();
+
+	PickPtr pick1 = Pick::Create("Pick/1");
+	PickPtr pick2 = Pick::Create("Pick/2");
+	BOOST_REQUIRE(pick1);
+	BOOST_REQUIRE(pick2);
+	BOOST_CHECK(pick1->registered());
+	BOOST_CHECK_EQUAL(PublicObject::ObjectCount(), count + 2);
+
+	// The same publicID cannot be registered twice
+	BOOST_CHECK(!Pick::Create("Pick/1"));
+
+	BOOST_CHECK(PublicObject::Find(string("Pick/1")) == pick1.get());
+	BOOST_CHECK(PublicObject::Find(string_view("Pick/1/x", 6)) == pick1.get());
+	BOOST_CHECK(PublicObject::Find("Pick/2") == pick2.get());
+	BOOST_CHECK(PublicObject::Find("Pick/3") == nullptr);
+
+	// Changing the publicID must update the registration
+	BOOST_CHECK(pick2->setPublicID("Pick/3"));
+	BOOST_CHECK(PublicObject::Find("Pick/2") == nullptr);
+	BOOST_CHECK(PublicObject::Find("Pick/3") == pick2.get());
+
+	set<string> publicIDs;
+	PublicObject::Lock();
+	for ( auto it = PublicObject::Begin(); it != PublicObject::End(); ++it ) {
+		BOOST_CHECK_EQUAL(it->first, it->second->publicID());
+		publicIDs.insert(string(it->first));
+	}
+	PublicObject::Unlock();
+
+	BOOST_CHECK_EQUAL(publicIDs.size(), count + 2);
+	BOOST_CHECK(publicIDs.count("Pick/1"));
+	BOOST_CHECK(publicIDs.count("Pick/3"));
+
+	pick1.reset();
+	pick2.reset();
+	BOOST_CHECK(PublicObject::Find("Pick/1") == nullptr);
+	BOOST_CHECK(PublicObject::Find("Pick/3") == nullptr);
+	BOOST_CHECK_EQUAL(PublicObject::ObjectCount(), count);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(measureperformance) {
+#define THREADS 4
+#define OBJECTS 100000
+	vector<thread> threads;
+	vector<size_t> found(THREADS, 0);
+
+	Util::StopWatch stopWatch;
+
+	for ( int t = 0; t < THREADS; ++t ) {
+		threads.emplace_back([t, &found]() {
+			PublicObject::SetRegistrationEnabled(true);
+
+			vector<PickPtr> picks;
+			picks.reserve(OBJECTS);
+
+			string prefix = "Pick/" + to_string(t) + "/";
+			for ( int i = 0; i < OBJECTS; ++i ) {
+				picks.push_back(Pick::Create(prefix + to_string(i)));
+			}
+
+			for ( int i = 0; i < OBJECTS; ++i ) {
+				if ( PublicObject::Find(prefix + to_string(i)) == picks[i].get() ) {
+					++found[t];
+				}
+			}
+
+			picks.clear();
+		});
+	}
+
+	for ( auto &thrd : threads ) {
+		thrd.join();
+	}
+
+	double elapsed = stopWatch.elapsed().length();
+
+	for ( auto n : found ) {
+		BOOST_CHECK_EQUAL(n, OBJECTS);
+	}
+
+	cerr << THREADS << " threads create/find/destroy " << OBJECTS
+	     << " objects each: " << elapsed << "s" << endl;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_SUITE_END()
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -0,0 +1,160 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#define SEISCOMP_TEST_MODULE SeisComP
+#include <seiscomp/unittest/unittests.h>
+
+#include <seiscomp/core/genericrecord.h>
+#include <seiscomp/core/typedarray.h>
+#include <seiscomp/gui/core/recordfilterjob.h>
+
+#include <stdexcept>
+
+namespace bu = boost::unit_test;
+using namespace std;
+using namespace Seiscomp;
+
+
+namespace {
+
+
+// Sums up all samples since the last reset which makes the filter state
+// visible in the output. Negative samples cannot be filtered.
+class SumFilter : public Gui::RecordFilterJob::Filter {
+	public:
+		void setSamplingFrequency(double) override {}
+		int setParameters(int, const double *) override { return 0; }
+
+		void apply(int n, double *inout) override {
+			for ( int i = 0; i < n; ++i ) {
+				if ( inout[i] < 0 ) {
+					throw std::out_of_range("negative sample");
+				}
+				_sum += inout[i];
+				inout[i] = _sum;
+			}
+		}
+
+		SumFilter *clone() const override {
+			return new SumFilter;
+		}
+
+	private:
+		double _sum{0};
+};
+
+
+RecordCPtr makeRecord(double startOffset, int n, double value = 1) {
+	GenericRecordPtr rec = new GenericRecord("GE", "MORC", "", "BHZ",
+	                                         Core::Time(2024, 1, 1) + Core::TimeSpan(startOffset),
+	                                         10.0);
+	DoubleArrayPtr data = new DoubleArray(n);
+	data->fill(value);
+	rec->setData(data.get());
+	return rec;
+}
+
+
+const double *samples(const Record *rec) {
+	return static_cast<const DoubleArray*>(rec->data())->typedData();
+}
+
+
+}
+
+
+BOOST_AUTO_TEST_SUITE(seiscomp_gui_recordfilterjob)
+//>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+
+
+
+
+//<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+BOOST_AUTO_TEST_CASE(gap) {
+	Gui::RecordFilterJob job;
+	job.filter = new SumFilter;
+	// Two contiguous records, a gap of 10 s and another record
+	job.records = { makeRecord(0, 10), makeRecord(1, 10), makeRecord(12, 5) };
+	job.run();
+
+	BOOST_CHECK(job.error.empty());
+	BOOST_REQUIRE_EQUAL(job.results.size(), 2);
+
+	// Contiguous records are merged and filtered without a reset
+	BOOST_CHECK_EQUAL(job.results[0]->startTime(), job.records[0]->startTime());
+	BOOST_REQUIRE_EQUAL(job.results[0]->data()->size(), 20);
+	BOOST_CHECK_EQUAL(samples(job.results[0].get())[0], 1);
+	BOOST_CHECK_EQUAL(samples(job.results[0].get())[19], 20);
+
+	// The filter starts over after the gap
+	BOOST_CHECK_EQUAL(job.results[1]->startTime(), job.records[2]->startTime());
+	BOOST_REQUIRE_EQUAL(job.results[1]->data()->size(), 5);
+	BOOST_CHECK_EQUAL(samples(job.results[1].get())[0], 1);
+	BOOST_CHECK_EQUAL(samples(job.results[1].get())[4], 5);
+}
+//>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+
+
+
+
+//<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+BOOST_AUTO_TEST_CASE(throwingFilter) {
+	Gui::RecordFilterJob job;
+	job.filter = new SumFilter;
+	// The second record cannot be filtered
+	job.records = { makeRecord(0, 10), makeRecord(1, 10, -1), makeRecord(2, 10) };
+	BOOST_CHECK_NO_THROW(job.run());
+
+	BOOST_CHECK_EQUAL(job.error, "negative sample");
+	BOOST_REQUIRE_EQUAL(job.results.size(), 2);
+
+	// The samples filtered before the error are kept
+	BOOST_REQUIRE_EQUAL(job.results[0]->data()->size(), 10);
+	BOOST_CHECK_EQUAL(samples(job.results[0].get())[9], 10);
+
+	// The failed record is dropped and the filter is reset
+	BOOST_CHECK_EQUAL(job.results[1]->startTime(), job.records[2]->startTime());
+	BOOST_REQUIRE_EQUAL(job.results[1]->data()->size(), 10);
+	BOOST_CHECK_EQUAL(samples(job.results[1].get())[0], 1);
+	BOOST_CHECK_EQUAL(samples(job.results[1].get())[9], 10);
+}
+//>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+
+
+
+
+//<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+BOOST_AUTO_TEST_CASE(cancelled) {
+	Gui::RecordFilterJob job;
+	job.filter = new SumFilter;
+	job.records = { makeRecord(0, 10) };
+	job.cancelled = true;
+	job.run();
+
+	BOOST_CHECK(job.results.empty());
+}
+//>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+
+
+
+
+//<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+BOOST_AUTO_TEST_SUITE_END()
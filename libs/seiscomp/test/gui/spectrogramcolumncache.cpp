@@ -0,0 +1,243 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#define SEISCOMP_TEST_MODULE SeisComP
+#include <seiscomp/unittest/unittests.h>
+
+#include <seiscomp/core/genericrecord.h>
+#include <seiscomp/core/typedarray.h>
+#include <seiscomp/io/recordfilter/spectralizer.h>
+#include <seiscomp/gui/core/spectrogramcolumncache.h>
+
+#include <cmath>
+
+namespace bu = boost::unit_test;
+using namespace std;
+using namespace Seiscomp;
+
+
+namespace {
+
+
+using ColumnCache = Gui::SpectrogramColumnCache<int>;
+using SpectrumCache = Gui::SpectrogramColumnCache<IO::SpectrumPtr>;
+
+
+Core::Time t(double offset) {
+	return Core::Time(offset);
+}
+
+
+// Creates contiguous records of 10 s at 10 Hz which start 3 s after a
+// multiple of the time step
+vector<RecordCPtr> makeRecords(int count) {
+	vector<RecordCPtr> records;
+	for ( int i = 0; i < count; ++i ) {
+		GenericRecordPtr rec = new GenericRecord("GE", "MORC", "", "BHZ",
+		                                         t(1000003 + i * 10), 10.0);
+		DoubleArrayPtr data = new DoubleArray(100);
+		for ( int j = 0; j < 100; ++j ) {
+			int k = i * 100 + j;
+			(*data)[j] = sin(k * 0.3) + 0.5 * sin(k * 0.017) + (k % 7) * 0.01;
+		}
+		rec->setData(data.get());
+		records.push_back(rec);
+	}
+
+	return records;
+}
+
+
+vector<IO::SpectrumPtr> compute(const vector<RecordCPtr> &records) {
+	IO::Spectralizer::Options opts;
+	opts.windowLength = 20;
+	opts.windowOverlap = 0.5;
+
+	IO::Spectralizer spectralizer;
+	spectralizer.setOptions(opts);
+
+	vector<IO::SpectrumPtr> spectra;
+	for ( auto &rec : records ) {
+		if ( spectralizer.push(rec.get()) ) {
+			IO::SpectrumPtr spec;
+			while ( (spec = spectralizer.pop()) ) {
+				spectra.push_back(spec);
+			}
+		}
+	}
+
+	return spectra;
+}
+
+
+}
+
+
+BOOST_AUTO_TEST_SUITE(seiscomp_gui_spectrogramcolumncache)
+//>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+
+
+
+
+//<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+BOOST_AUTO_TEST_CASE(columns) {
+	// Windows of 20 s every 10 s
+	ColumnCache cache(20, 10, 100);
+
+	// Start times are snapped to the time step
+	for ( int i = 0; i < 10; ++i ) {
+		cache.insert(t(i * 10 - 1E-6), i);
+	}
+
+	BOOST_CHECK_EQUAL(cache.size(), 10);
+	BOOST_CHECK(cache.contains(t(50)));
+	BOOST_CHECK(!cache.contains(t(100)));
+	BOOST_CHECK_EQUAL(cache.index(t(30.0000004)), 3);
+	BOOST_CHECK_EQUAL(cache.startTime(3), t(30));
+
+	// A column is not replaced
+	cache.insert(t(50), 50);
+	BOOST_CHECK_EQUAL(cache.columns(t(65), t(70)).front(), 5);
+
+	// [25,45) intersects the windows of the columns at 10, 20, 30 and 40
+	auto columns = cache.columns(t(25), t(45));
+	BOOST_CHECK_EQUAL(columns.size(), 4);
+	BOOST_CHECK_EQUAL(columns.front(), 1);
+	BOOST_CHECK_EQUAL(columns.back(), 4);
+
+	BOOST_CHECK(cache.columns(t(200), t(300)).empty());
+}
+//>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+
+
+
+
+//<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+BOOST_AUTO_TEST_CASE(eviction) {
+	ColumnCache cache(20, 10, 5);
+
+	for ( int i = 0; i < 5; ++i ) {
+		cache.insert(t(i * 10), i);
+	}
+
+	// Scrolling forward drops the oldest columns
+	cache.insert(t(50), 5);
+	cache.insert(t(60), 6);
+	BOOST_CHECK_EQUAL(cache.size(), 5);
+	BOOST_CHECK(!cache.contains(t(10)));
+	BOOST_CHECK(cache.contains(t(20)));
+	BOOST_CHECK(cache.contains(t(60)));
+
+	// Scrolling backward drops the newest columns
+	cache.insert(t(10), 1);
+	BOOST_CHECK_EQUAL(cache.size(), 5);
+	BOOST_CHECK(cache.contains(t(10)));
+	BOOST_CHECK(!cache.contains(t(60)));
+}
+//>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+
+
+
+
+//<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+BOOST_AUTO_TEST_CASE(isRequired) {
+	ColumnCache cache(20, 10, 100);
+
+	for ( int i = 0; i < 10; ++i ) {
+		cache.insert(t(i * 10), i);
+	}
+
+	// All columns which overlap [30,40) or start up to 20 s later are
+	// cached
+	BOOST_CHECK(!cache.isRequired(t(30), t(40)));
+	BOOST_CHECK(!cache.isRequired(t(20), t(70)));
+
+	// The column at 100 is missing and needs the samples of the
+	// preceding window length to be filled and settled
+	BOOST_CHECK(cache.isRequired(t(75), t(85)));
+	BOOST_CHECK(cache.isRequired(t(95), t(100)));
+
+	// The column at 0 would need samples before 0
+	BOOST_CHECK(cache.isRequired(t(0), t(10)));
+}
+//>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+
+
+
+
+//<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+BOOST_AUTO_TEST_CASE(skipCachedRecords) {
+	auto records = makeRecords(60);
+	auto full = compute(records);
+	BOOST_REQUIRE(full.size() > 50);
+
+	// Cache the columns of two time windows as after scrolling with a
+	// narrow time window
+	SpectrumCache cache(20, 10, 1000);
+	for ( auto &spec : full ) {
+		double offset = static_cast<double>(spec->startTime() - records.front()->startTime());
+		if ( (offset >= 100 && offset < 300) || (offset >= 400 && offset < 450) ) {
+			cache.insert(spec->startTime(), spec);
+		}
+	}
+
+	size_t cached = cache.size();
+	BOOST_REQUIRE(cached > 20);
+
+	// Widen the time window and process only the required records
+	vector<RecordCPtr> required;
+	for ( auto &rec : records ) {
+		if ( cache.isRequired(rec->startTime(), rec->endTime()) ) {
+			required.push_back(rec);
+		}
+	}
+
+	BOOST_CHECK(required.size() < records.size() - 15);
+
+	for ( auto &spec : compute(required) ) {
+		cache.insert(spec->startTime(), spec);
+	}
+
+	// The cached and the computed columns are the same as the columns of
+	// the full computation
+	auto columns = cache.columns(full.front()->startTime(), full.back()->endTime());
+	BOOST_REQUIRE_EQUAL(columns.size(), full.size());
+
+	for ( size_t i = 0; i < full.size(); ++i ) {
+		BOOST_CHECK_EQUAL(cache.index(columns[i]->startTime()),
+		                  cache.index(full[i]->startTime()));
+
+		auto a = columns[i]->data();
+		auto b = full[i]->data();
+		BOOST_REQUIRE_EQUAL(a->size(), b->size());
+
+		for ( int j = 0; j < a->size(); ++j ) {
+			BOOST_CHECK_SMALL(abs((*a)[j] - (*b)[j]), 1E-9);
+		}
+	}
+}
+//>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+
+
+
+
+//<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+BOOST_AUTO_TEST_SUITE_END()
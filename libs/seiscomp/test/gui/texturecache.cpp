@@ -0,0 +1,187 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#define SEISCOMP_TEST_MODULE SeisComP
+#include <seiscomp/unittest/unittests.h>
+
+#include <seiscomp/gui/map/texturecache.h>
+
+namespace bu = boost::unit_test;
+using namespace std;
+using namespace Seiscomp::Gui::Map;
+
+
+namespace {
+
+
+// 16x16 ARGB32 pixels
+const int TileBytes = 16 * 16 * 4;
+
+
+// Creates tiles synchronously and counts the loads
+class MemoryTileStore : public TileStore {
+	public:
+		MemoryTileStore(const QString &name) : _name(name) {
+			_tilesize = QSize(16, 16);
+		}
+
+		int maxLevel() const override { return 10; }
+		bool open(MapsDesc &) override { return true; }
+
+		LoadResult load(QImage &img, const TileIndex &tile) override {
+			img = QImage(16, 16, QImage::Format_ARGB32);
+			img.fill(qRgb(tile.level(), tile.row(), tile.column()));
+			++loads;
+			return OK;
+		}
+
+		QString getID(const TileIndex &tile) const override {
+			return QString("%1/%2/%3/%4")
+			    .arg(_name).arg(tile.level()).arg(tile.column()).arg(tile.row());
+		}
+
+		bool validate(int, int, int) const override { return true; }
+		bool hasPendingRequests() const override { return false; }
+		void refresh() override {}
+
+	public:
+		int loads{0};
+
+	private:
+		QString _name;
+};
+
+
+TileIndex tile(int i) {
+	return TileIndex(4, i / 16, i % 16);
+}
+
+
+}
+
+
+BOOST_AUTO_TEST_SUITE(seiscomp_gui_texturecache)
+//>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+
+
+
+
+//<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+BOOST_AUTO_TEST_CASE(lruEviction) {
+	MemoryTileStore store("lru");
+	TextureCache cache(&store, false);
+	cache.setCacheLimit(4 * TileBytes);
+
+	// Tiles 0, 1, 2 and 3 fill the cache
+	cache.beginPaint();
+	for ( int i = 0; i < 4; ++i ) {
+		BOOST_CHECK_EQUAL(cache.get(tile(i))->id, tile(i));
+	}
+
+	BOOST_CHECK_EQUAL(store.loads, 4);
+	BOOST_CHECK_EQUAL(cache.storedBytes(), 4 * TileBytes);
+	BOOST_CHECK_EQUAL(cache.statistics().evictions, 0);
+
+	// Using tile 0 again makes tile 1 the least recently used one which is
+	// evicted for tile 4
+	cache.beginPaint();
+	cache.get(tile(0));
+	BOOST_CHECK_EQUAL(cache.statistics().hits, 1);
+
+	cache.get(tile(4));
+	BOOST_CHECK_EQUAL(store.loads, 5);
+	BOOST_CHECK_EQUAL(cache.statistics().evictions, 1);
+	BOOST_CHECK_EQUAL(cache.statistics().evictedBytes, TileBytes);
+
+	cache.get(tile(0));
+	cache.get(tile(2));
+	BOOST_CHECK_EQUAL(cache.statistics().hits, 3);
+	BOOST_CHECK_EQUAL(store.loads, 5);
+
+	// Tile 1 must be loaded again and evicts tile 3 which has not been
+	// used in this paint cycle
+	cache.get(tile(1));
+	BOOST_CHECK_EQUAL(store.loads, 6);
+	BOOST_CHECK_EQUAL(cache.statistics().evictions, 2);
+
+	cache.get(tile(3));
+	BOOST_CHECK_EQUAL(store.loads, 7);
+	BOOST_CHECK_EQUAL(cache.statistics().evictions, 3);
+	BOOST_CHECK_EQUAL(cache.statistics().misses, 7);
+	BOOST_CHECK_EQUAL(cache.storedBytes(), 4 * TileBytes);
+}
+//>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+
+
+
+
+//<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+BOOST_AUTO_TEST_CASE(byteBudget) {
+	MemoryTileStore store("budget");
+	TextureCache cache(&store, false);
+
+	// Not a multiple of the tile size
+	const int limit = 10 * TileBytes + TileBytes / 2;
+	cache.setCacheLimit(limit);
+
+	for ( int i = 0; i < 30; ++i ) {
+		cache.beginPaint();
+		cache.get(tile(i));
+		BOOST_CHECK_LE(cache.storedBytes(), limit);
+	}
+
+	BOOST_CHECK_EQUAL(cache.storedBytes(), 10 * TileBytes);
+	BOOST_CHECK_EQUAL(cache.statistics().evictions, 20);
+	BOOST_CHECK_EQUAL(cache.statistics().evictedBytes, 20 * TileBytes);
+
+	// The ten most recent tiles are cached
+	cache.resetStatistics();
+	cache.beginPaint();
+	for ( int i = 20; i < 30; ++i ) {
+		cache.get(tile(i));
+	}
+	BOOST_CHECK_EQUAL(cache.statistics().hits, 10);
+	BOOST_CHECK_EQUAL(cache.statistics().misses, 0);
+
+	// Lowering the budget takes effect with the next cached texture
+	cache.setCacheLimit(2 * TileBytes);
+	cache.beginPaint();
+	cache.get(tile(30));
+	BOOST_CHECK_EQUAL(cache.storedBytes(), 2 * TileBytes);
+	BOOST_CHECK_EQUAL(cache.statistics().evictions, 9);
+
+	// A texture larger than the budget is kept until the next one arrives
+	cache.setCacheLimit(TileBytes / 2);
+	cache.beginPaint();
+	cache.get(tile(31));
+	BOOST_CHECK_EQUAL(cache.storedBytes(), TileBytes);
+	BOOST_CHECK_EQUAL(cache.statistics().evictions, 11);
+	cache.get(tile(32));
+	BOOST_CHECK_EQUAL(cache.storedBytes(), TileBytes);
+	BOOST_CHECK_EQUAL(cache.statistics().evictions, 12);
+}
+//>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+
+
+
+
+//<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+BOOST_AUTO_TEST_SUITE_END()
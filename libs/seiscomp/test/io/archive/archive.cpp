@@ -26,18 +26,30 @@
 #include <seiscomp/datamodel/eventparameters.h>
 #include <seiscomp/datamodel/inventory_package.h>
 #include <seiscomp/datamodel/journaling.h>
+#include <seiscomp/datamodel/notifier.h>
+#include <seiscomp/datamodel/pick.h>
+#include <seiscomp/datamodel/responsefir.h>
 #include <seiscomp/io/archive/binarchive.h>
 #include <seiscomp/io/archive/jsonarchive.h>
 #include <seiscomp/io/archive/xmlarchive.h>
+#include <seiscomp/io/streams/filter/lz4.h>
 #include <seiscomp/logging/output/fd.h>
+#include <seiscomp/utils/timer.h>
 
 #include <seiscomp/unittest/unittests.h>
 
+#include <boost/iostreams/device/array.hpp>
+#include <boost/iostreams/device/back_inserter.hpp>
+#include <boost/iostreams/filter/zlib.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+#include <boost/iostreams/stream.hpp>
+
 #include <sstream>
 
 
 using namespace std;
 using namespace Seiscomp;
+namespace bio = boost::iostreams;
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 
@@ -58,6 +70,90 @@ ASSERT_MSG(obj1 == obj2, msg << ": " << #obj1 " == " #obj2 \
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+enum Compression {
+	None,
+	Deflate,
+	LZ4
+};
+
+
+template <typename AR>
+void encode(string &blob, Core::BaseObject *obj, Compression compression) {
+	bio::stream_buffer<bio::back_insert_device<string> > buf(blob);
+
+	if ( compression == None ) {
+		AR ar(&buf, false);
+		ar << obj;
+		return;
+	}
+
+	bio::filtering_ostreambuf filtered;
+	if ( compression == Deflate ) {
+		filtered.push(bio::zlib_compressor());
+	}
+	else {
+		filtered.push(ext::boost::iostreams::lz4_compressor());
+	}
+	filtered.push(buf);
+
+	AR ar(&filtered, false);
+	ar << obj;
+}
+
+
+template <typename AR>
+Core::BaseObjectPtr decode(const string &blob, Compression compression) {
+	bio::stream_buffer<bio::array_source> buf(blob.data(), blob.size());
+	Core::BaseObjectPtr obj;
+
+	if ( compression == None ) {
+		AR ar(&buf, true);
+		ar >> obj;
+		return obj;
+	}
+
+	bio::filtering_istreambuf filtered;
+	if ( compression == Deflate ) {
+		filtered.push(bio::zlib_decompressor());
+	}
+	else {
+		filtered.push(ext::boost::iostreams::lz4_decompressor());
+	}
+	filtered.push(buf);
+
+	AR ar(&filtered, true);
+	ar >> obj;
+	return obj;
+}
+
+
+Core::BaseObjectPtr createPickMessage(int i) {
+	auto t = Core::Time(1700000000 + i, 123456);
+
+	DataModel::PickPtr pick = DataModel::Pick::Create("Pick/20231114221320.123456.XX.S" + to_string(i % 100) + "..HHZ");
+	pick->setTime(DataModel::TimeQuantity(t));
+	pick->setWaveformID(DataModel::WaveformStreamID("XX", "S" + to_string(i % 100), "", "HHZ", ""));
+	pick->setFilterID("BW(3,0.7,2)");
+	pick->setMethodID("AIC");
+	pick->setPhaseHint(DataModel::Phase("P"));
+	pick->setEvaluationMode(DataModel::EvaluationMode(DataModel::AUTOMATIC));
+
+	DataModel::CreationInfo ci;
+	ci.setAgencyID("GFZ");
+	ci.setAuthor("scautopick@localhost");
+	ci.setCreationTime(t + Core::TimeSpan(2, 500000));
+	pick->setCreationInfo(ci);
+
+	DataModel::NotifierMessagePtr msg = new DataModel::NotifierMessage;
+	msg->attach(new DataModel::Notifier("EventParameters", DataModel::OP_ADD, pick.get()));
+	return msg;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 struct TestData {
 	TestData() {
@@ -202,6 +298,244 @@ BOOST_AUTO_TEST_CASE(binEmptyArrays) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(compactBinary) {
+	string plain, compact;
+
+	{
+		stringbuf storage(ios_base::out);
+		IO::VBinaryArchive ar;
+		ar.create(&storage);
+		ar << referenceEP;
+		ar.close();
+		plain = storage.str();
+	}
+
+	{
+		stringbuf storage(ios_base::out);
+		IO::CompactBinaryArchive ar;
+		BOOST_REQUIRE(ar.create(&storage));
+		ar << referenceEP;
+		ar.close();
+		compact = storage.str();
+	}
+
+	BOOST_CHECK_EQUAL(compact.substr(0, 4), "SCCB");
+	BOOST_CHECK_LT(compact.size(), plain.size());
+
+	stringbuf storage(compact, ios_base::in);
+	IO::CompactBinaryArchive ar;
+	BOOST_REQUIRE(ar.open(&storage));
+
+	DataModel::EventParametersPtr ep;
+	ar >> ep;
+	BOOST_REQUIRE(ar.success());
+	ar.close();
+	BOOST_REQUIRE(ep != nullptr);
+
+	stringbuf xmlBuf(ios_base::out);
+	IO::XMLArchive xml;
+	xml.create(&xmlBuf);
+	xml.setFormattedOutput(true);
+	xml << ep;
+	xml.close();
+
+	BOOST_CHECK_EQUAL(xmlBuf.str(), referenceXML);
+
+	// Other formats must be rejected
+	stringbuf binBuf(plain, ios_base::in);
+	BOOST_CHECK(!ar.open(&binBuf));
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+namespace {
+
+
+template <typename AR>
+string encodeObject(Core::BaseObject *obj) {
+	stringbuf storage(ios_base::out);
+	AR ar;
+	ar.create(&storage);
+	ar << obj;
+	ar.close();
+	return storage.str();
+}
+
+
+// Decodes an object and reports invalid data as false. A StreamException
+// is the regular way of the archive to report unexpected content, any other
+// exception, e.g. std::bad_alloc, escapes.
+template <typename AR>
+bool decodeObject(const string &data) {
+	stringbuf storage(data, ios_base::in);
+	AR ar;
+	if ( !ar.open(&storage) ) {
+		return false;
+	}
+
+	Core::BaseObjectPtr obj;
+	try {
+		ar >> obj;
+	}
+	catch ( Core::StreamException & ) {
+		return false;
+	}
+
+	return ar.success() && obj;
+}
+
+
+// Replaces the encoded element count in front of the first occurrence of
+// needle by count
+string patchCount(const string &data, const string &needle,
+                  const string &encodedCount, size_t countSize) {
+	auto pos = data.find(needle);
+	BOOST_REQUIRE(pos != string::npos);
+	BOOST_REQUIRE(pos >= countSize);
+	string patched = data;
+	patched.replace(pos - countSize, countSize, encodedCount);
+	return patched;
+}
+
+
+}
+
+
+BOOST_AUTO_TEST_CASE(binMalformed) {
+	DataModel::PickPtr pick = DataModel::Pick::Create("MalformedPick");
+	pick->setTime(Core::Time(2024, 1, 1));
+	pick->setWaveformID(DataModel::WaveformStreamID("GE", "MORC", "", "BHZ", ""));
+
+	double coefficients[] = { 1.5, 2.5, 3.5 };
+	DataModel::ResponseFIRPtr fir = DataModel::ResponseFIR::Create("MalformedFIR");
+	fir->setNumberOfCoefficients(3);
+	fir->setCoefficients(DataModel::RealArray());
+	fir->coefficients().content().assign(coefficients, coefficients + 3);
+
+	string compactPick = encodeObject<IO::CompactBinaryArchive>(pick.get());
+	string compactFIR = encodeObject<IO::CompactBinaryArchive>(fir.get());
+
+	BOOST_REQUIRE(decodeObject<IO::CompactBinaryArchive>(compactPick));
+	BOOST_REQUIRE(decodeObject<IO::CompactBinaryArchive>(compactFIR));
+
+	// Truncated archives must not throw. Cutting off the trailing
+	// attribute flags is tolerated by the decoder, so success is not
+	// checked here.
+	for ( size_t len = 0; len < compactPick.size(); ++len ) {
+		BOOST_CHECK_NO_THROW(decodeObject<IO::CompactBinaryArchive>(compactPick.substr(0, len)));
+	}
+
+	// Element counts beyond the archive size must be rejected before
+	// anything is allocated. The string length and the array size are
+	// encoded as single byte varints in front of the data.
+	const string hugeVarInt("\xff\xff\xff\xff\xff\xff\xff\xff\x7f", 9);
+	bool ok = true;
+
+	BOOST_CHECK_NO_THROW(ok = decodeObject<IO::CompactBinaryArchive>(
+		patchCount(compactPick, "MalformedPick", hugeVarInt, 1)));
+	BOOST_CHECK(!ok);
+
+	BOOST_CHECK_NO_THROW(ok = decodeObject<IO::CompactBinaryArchive>(
+		patchCount(compactPick, "MalformedPick", "\x7f", 1)));
+	BOOST_CHECK(!ok);
+
+	string rawCoefficients(reinterpret_cast<const char*>(coefficients), sizeof(coefficients));
+	BOOST_CHECK_NO_THROW(ok = decodeObject<IO::CompactBinaryArchive>(
+		patchCount(compactFIR, rawCoefficients, hugeVarInt, 1)));
+	BOOST_CHECK(!ok);
+
+	// Filtering streams cannot tell their size. The data is read in chunks
+	// and the short read is noticed long before 2^40 doubles are allocated.
+	const string largeVarInt("\x80\x80\x80\x80\x80\x20", 6);
+	string patched = patchCount(compactFIR, rawCoefficients, largeVarInt, 1);
+	string deflated;
+	{
+		bio::filtering_ostream out;
+		out.push(bio::zlib_compressor());
+		out.push(bio::back_inserter(deflated));
+		out.write(patched.data(), patched.size());
+	}
+
+	{
+		bio::filtering_istreambuf in;
+		in.push(bio::zlib_decompressor());
+		in.push(bio::array_source(deflated.data(), deflated.size()));
+
+		IO::CompactBinaryArchive ar;
+		BOOST_REQUIRE(ar.open(&in));
+		Core::BaseObjectPtr obj;
+		try {
+			ar >> obj;
+		}
+		catch ( Core::StreamException & ) {}
+		BOOST_CHECK(!ar.success() || !obj);
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(measureperformance) {
+#define MESSAGES 10000
+	vector<Core::BaseObjectPtr> messages;
+	for ( int i = 0; i < MESSAGES; ++i ) {
+		messages.push_back(createPickMessage(i));
+	}
+
+	struct Codec {
+		const char *name;
+		void (*encode)(string &, Core::BaseObject *, Compression);
+		Core::BaseObjectPtr (*decode)(const string &, Compression);
+		Compression compression;
+	};
+
+	Codec codecs[] = {
+		{ "binary+deflate", &encode<IO::VBinaryArchive>, &decode<IO::VBinaryArchive>, Deflate },
+		{ "binary+lz4", &encode<IO::VBinaryArchive>, &decode<IO::VBinaryArchive>, LZ4 },
+		{ "compact", &encode<IO::CompactBinaryArchive>, &decode<IO::CompactBinaryArchive>, None },
+		{ "compact+lz4", &encode<IO::CompactBinaryArchive>, &decode<IO::CompactBinaryArchive>, LZ4 }
+	};
+
+	for ( auto &codec : codecs ) {
+		vector<string> blobs(MESSAGES);
+		size_t bytes = 0;
+
+		Util::StopWatch stopWatch;
+		for ( int i = 0; i < MESSAGES; ++i ) {
+			codec.encode(blobs[i], messages[i].get(), codec.compression);
+			bytes += blobs[i].size();
+		}
+		double encodeTime = stopWatch.elapsed().length();
+
+		stopWatch.restart();
+		for ( int i = 0; i < MESSAGES; ++i ) {
+			auto obj = codec.decode(blobs[i], codec.compression);
+			auto msg = DataModel::NotifierMessage::Cast(obj);
+			BOOST_REQUIRE(msg != nullptr);
+			BOOST_REQUIRE_EQUAL(msg->size(), 1);
+			auto pick = DataModel::Pick::Cast((*msg->begin())->object());
+			BOOST_REQUIRE(pick != nullptr);
+			BOOST_CHECK_EQUAL(pick->creationInfo().creationTime(),
+			                  Core::Time(1700000000 + i, 123456) + Core::TimeSpan(2, 500000));
+		}
+		double decodeTime = stopWatch.elapsed().length();
+
+		cerr << codec.name << ": " << (bytes / MESSAGES) << " bytes/msg, "
+		     << "encode " << (MESSAGES / encodeTime) << " msgs/s, "
+		     << "decode " << (MESSAGES / decodeTime) << " msgs/s" << endl;
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 BOOST_AUTO_TEST_SUITE_END()
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
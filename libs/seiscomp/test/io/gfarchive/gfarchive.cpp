@@ -0,0 +1,221 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#define SEISCOMP_TEST_MODULE SeisComP
+
+
+#include <seiscomp/unittest/unittests.h>
+
+#include <seiscomp/core/greensfunction.h>
+#include <seiscomp/core/typedarray.h>
+#include <seiscomp/io/gfarchive/gfcache.h>
+#include <seiscomp/io/gfarchive/helmberger.h>
+#include <seiscomp/io/gfarchive/traveltimegrid.h>
+#include <seiscomp/math/geo.h>
+
+#include <cmath>
+
+
+using namespace Seiscomp;
+using namespace Seiscomp::IO;
+
+
+namespace {
+
+
+// The test archive contains the distances 100, 200 and 300 km and the
+// depths 10 and 20 km. Sample i of each component at distance d and depth h
+// is d + h/100 + i, the vertical components are stored with flipped sign.
+GFReceiver receiverAt(double km) {
+	return GFReceiver(0, km / Math::Geo::deg2km(1.0));
+}
+
+
+int distanceOf(const GFReceiver &receiver) {
+	double dist, az, baz;
+	Math::Geo::delazi_wgs84(0, 0, receiver.lat, receiver.lon, &dist, &az, &baz);
+	return (int)Math::Geo::deg2km(dist);
+}
+
+
+float sample(const Core::GreensFunction *gf, Core::GreensFunctionComponent comp, int i) {
+	auto data = FloatArray::ConstCast(gf->data(comp));
+	BOOST_REQUIRE(data != nullptr);
+	BOOST_REQUIRE(i < data->size());
+	return (*data)[i];
+}
+
+
+}
+
+
+BOOST_AUTO_TEST_SUITE(seiscomp_io_gfarchive)
+
+
+BOOST_AUTO_TEST_CASE(travelTimeGrid) {
+	TravelTimeGrid grid;
+	BOOST_CHECK(grid.empty());
+
+	// Unsorted axes with duplicates
+	grid.setAxes({ 200, 100, 300, 100 }, { 10, 0 });
+	BOOST_CHECK(!grid.empty());
+
+	for ( double dist : { 100, 200, 300 } ) {
+		BOOST_CHECK(grid.set(dist, 0, dist / 10));
+		BOOST_CHECK(grid.set(dist, 10, dist / 10 + 1));
+	}
+
+	BOOST_CHECK(!grid.set(150, 0, 1));
+
+	BOOST_CHECK_CLOSE(*grid.value(100, 0), 10.0, 1E-9);
+	BOOST_CHECK_CLOSE(*grid.value(150, 0), 15.0, 1E-9);
+	BOOST_CHECK_CLOSE(*grid.value(250, 5), 25.5, 1E-9);
+	BOOST_CHECK_CLOSE(*grid.value(300, 10), 31.0, 1E-9);
+
+	// Out of range
+	BOOST_CHECK(!grid.value(99, 0));
+	BOOST_CHECK(!grid.value(301, 0));
+	BOOST_CHECK(!grid.value(150, 11));
+	BOOST_CHECK(!grid.value(150, -1));
+
+	// Unset nodes are not interpolated
+	grid.setAxes({ 100, 200 }, { 0 });
+	grid.set(100, 0, 10);
+	BOOST_CHECK_CLOSE(*grid.value(100, 0), 10.0, 1E-9);
+	BOOST_CHECK(!grid.value(150, 0));
+}
+
+
+BOOST_AUTO_TEST_CASE(nearestDistance) {
+	GFCache::Clear();
+
+	HelmbergerArchive archive;
+	BOOST_REQUIRE(archive.setSource("helmberger"));
+	BOOST_CHECK(!archive.distanceInterpolation());
+	archive.setTimeSpan(Core::TimeSpan(100, 0));
+
+	auto receiver = receiverAt(140);
+	BOOST_REQUIRE(archive.addRequest("A", "test", GFSource(0, 0, 10), receiver));
+
+	Core::GreensFunctionPtr gf = archive.get();
+	BOOST_REQUIRE(gf);
+	BOOST_CHECK(!archive.get());
+
+	BOOST_CHECK_EQUAL(gf->id(), "A");
+	BOOST_CHECK_EQUAL(gf->model(), "test");
+	BOOST_CHECK_EQUAL(gf->distance(), 100);
+	BOOST_CHECK_EQUAL(gf->depth(), 10);
+	BOOST_CHECK_EQUAL(gf->samplingFrequency(), 1.0);
+	BOOST_CHECK_CLOSE(sample(gf.get(), Core::TSS, 0), 100.1f, 1E-4);
+	BOOST_CHECK_CLOSE(sample(gf.get(), Core::TSS, 9), 109.1f, 1E-4);
+	BOOST_CHECK_CLOSE(sample(gf.get(), Core::ZSS, 3), -103.1f, 1E-4);
+
+	// Modifying a returned Green's function must not alter the cached one
+	(*FloatArray::Cast(gf->data(Core::TSS)))[0] = 0;
+	BOOST_REQUIRE(archive.addRequest("B", "test", GFSource(0, 0, 10), receiver));
+	gf = archive.get();
+	BOOST_REQUIRE(gf);
+	BOOST_CHECK_EQUAL(gf->id(), "B");
+	BOOST_CHECK_CLOSE(sample(gf.get(), Core::TSS, 0), 100.1f, 1E-4);
+
+	auto stats = GFCache::GetStatistics();
+	BOOST_CHECK_EQUAL(stats.misses, 1);
+	BOOST_CHECK_EQUAL(stats.hits, 2);
+	BOOST_CHECK_EQUAL(stats.entries, 1);
+}
+
+
+BOOST_AUTO_TEST_CASE(distanceInterpolation) {
+	GFCache::Clear();
+
+	HelmbergerArchive archive;
+	BOOST_REQUIRE(archive.setSource("helmberger"));
+	archive.setDistanceInterpolation(true);
+	archive.setTimeSpan(Core::TimeSpan(100, 0));
+
+	auto receiver = receiverAt(140);
+	int distance = distanceOf(receiver);
+	BOOST_REQUIRE(archive.addRequest("A", "test", GFSource(0, 0, 20), receiver));
+
+	Core::GreensFunctionPtr gf = archive.get();
+	BOOST_REQUIRE(gf);
+	BOOST_CHECK_EQUAL(gf->distance(), distance);
+	BOOST_CHECK_EQUAL(gf->depth(), 20);
+
+	for ( int i = 0; i < 10; ++i ) {
+		BOOST_CHECK_CLOSE(sample(gf.get(), Core::TSS, i), distance + 0.2 + i, 1E-4);
+		BOOST_CHECK_CLOSE(sample(gf.get(), Core::ZDD, i), -(distance + 0.2 + i), 1E-4);
+	}
+
+	// Exactly on a grid node
+	BOOST_REQUIRE(archive.addRequest("B", "test", GFSource(0, 0, 20), receiverAt(300)));
+	gf = archive.get();
+	BOOST_REQUIRE(gf);
+	BOOST_CHECK(fabs(gf->distance() - 300) <= 1);
+}
+
+
+BOOST_AUTO_TEST_CASE(prefetch) {
+	GFCache::Clear();
+
+	HelmbergerArchive archive;
+	BOOST_REQUIRE(archive.setSource("helmberger"));
+	archive.setTimeSpan(Core::TimeSpan(100, 0));
+
+	for ( double km : { 100, 200, 290 } ) {
+		for ( double depth : { 10, 20 } ) {
+			BOOST_REQUIRE(archive.addRequest("A", "test", GFSource(0, 0, depth), receiverAt(km)));
+		}
+	}
+
+	// Requests outside of the grid are dropped
+	BOOST_REQUIRE(archive.addRequest("B", "test", GFSource(0, 0, 10), receiverAt(1000)));
+
+	// The first call decodes all files of the batch
+	Core::GreensFunctionPtr gf = archive.get();
+	BOOST_REQUIRE(gf);
+	auto stats = GFCache::GetStatistics();
+	BOOST_CHECK_EQUAL(stats.entries, 6);
+	BOOST_CHECK_EQUAL(stats.misses, 6);
+
+	int count = 1;
+	while ( (gf = archive.get()) ) {
+		++count;
+	}
+
+	BOOST_CHECK_EQUAL(count, 6);
+	stats = GFCache::GetStatistics();
+	BOOST_CHECK_EQUAL(stats.misses, 6);
+	BOOST_CHECK_EQUAL(stats.hits, 6);
+
+	// A disabled cache still delivers
+	GFCache::Clear();
+	GFCache::SetCapacity(0);
+	BOOST_REQUIRE(archive.addRequest("C", "test", GFSource(0, 0, 10), receiverAt(200)));
+	gf = archive.get();
+	BOOST_REQUIRE(gf);
+	BOOST_CHECK_CLOSE(sample(gf.get(), Core::RSS, 1), 201.1f, 1E-4);
+	BOOST_CHECK_EQUAL(GFCache::GetStatistics().entries, 0);
+	GFCache::SetCapacity(256*1024*1024);
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
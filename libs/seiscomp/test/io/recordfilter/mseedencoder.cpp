@@ -0,0 +1,315 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#define SEISCOMP_TEST_MODULE SeisComP
+
+
+#include <seiscomp/unittest/unittests.h>
+#include <seiscomp/core/genericrecord.h>
+#include <seiscomp/core/typedarray.h>
+#include <seiscomp/io/recordfilter/mseedencoder.h>
+#include <seiscomp/io/records/mseed/encoder/steim2.h>
+#include <seiscomp/utils/timer.h>
+
+#include <cstring>
+#include <iostream>
+#include <random>
+
+
+using namespace std;
+using namespace Seiscomp;
+
+
+namespace {
+
+
+// A random walk with occasional large steps which exercises all Steim2
+// word layouts
+vector<int> makeSamples(size_t n, unsigned int seed) {
+	mt19937 rng(seed);
+	vector<int> samples(n);
+	int value = 0;
+
+	for ( auto &sample : samples ) {
+		int scale = 1 << (rng() % 20);
+		value += static_cast<int>(rng() % (2 * scale + 1)) - scale;
+		sample = value;
+	}
+
+	return samples;
+}
+
+
+GenericRecordPtr makeRecord(const string &sta, const Core::Time &startTime,
+                            const int *samples, size_t n) {
+	GenericRecordPtr rec = new GenericRecord("XX", sta, "", "BHZ", startTime,
+	                                         20.0, -1, Array::INT);
+	rec->setData(static_cast<int>(n), samples, Array::INT);
+	return rec;
+}
+
+
+// Feeds the samples in chunks of the given size
+vector<RecordPtr> encodeChunked(IO::MSeedEncoder &encoder,
+                                const vector<int> &samples, size_t chunk) {
+	vector<RecordPtr> output;
+	Core::Time startTime(2025, 7, 1);
+
+	for ( size_t i = 0; i < samples.size(); i += chunk ) {
+		size_t n = min(chunk, samples.size() - i);
+		auto rec = makeRecord("ABCD", startTime + Core::TimeSpan(i / 20.0),
+		                      &samples[i], n);
+		encoder.encode(rec.get(), output);
+	}
+
+	encoder.flush(output);
+	return output;
+}
+
+
+vector<int> decode(const vector<RecordPtr> &records) {
+	vector<int> samples;
+
+	for ( const auto &rec : records ) {
+		auto data = IntArray::ConstCast(rec->data());
+		BOOST_REQUIRE(data);
+		samples.insert(samples.end(), data->typedData(),
+		               data->typedData() + data->size());
+	}
+
+	return samples;
+}
+
+
+bool sameRaw(const vector<RecordPtr> &a, const vector<RecordPtr> &b) {
+	if ( a.size() != b.size() ) {
+		return false;
+	}
+
+	for ( size_t i = 0; i < a.size(); ++i ) {
+		auto ra = a[i]->raw();
+		auto rb = b[i]->raw();
+		if ( (ra->size() != rb->size())
+		  || memcmp(ra->data(), rb->data(), ra->size() * ra->elementSize()) ) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+}
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_SUITE(seiscomp_io_recordfilter_mseedencoder)
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(classify) {
+	const int32_t samples[] = { 7, -1, 15, -17, 100, -400, 16000, -536000000 };
+	int32_t values[8], diffs[8];
+	uint8_t widths[8];
+
+	BOOST_CHECK(IO::MSEED::Steim2<int32_t>::classify(samples, values, diffs, widths, 8, 0));
+	const int32_t expectedDiffs[] = { 7, -8, 16, -32, 117, -500, 16400, -536016000 };
+	const uint8_t expectedWidths[] = { 7, 7, 5, 5, 4, 3, 1, 1 };
+	for ( int i = 0; i < 8; ++i ) {
+		BOOST_CHECK_EQUAL(values[i], samples[i]);
+		BOOST_CHECK_EQUAL(diffs[i], expectedDiffs[i]);
+		BOOST_CHECK_EQUAL(int(widths[i]), int(expectedWidths[i]));
+	}
+
+	// Differences beyond 30 bits are reported
+	const int32_t large[] = { 0, 536870912 };
+	BOOST_CHECK(!IO::MSEED::Steim2<int32_t>::classify(large, values, diffs, widths, 2, 0));
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(roundTrip) {
+	auto samples = makeSamples(50000, 1);
+
+	for ( int type = 0; type < 3; ++type ) {
+		for ( int recordSize : { 7, 9, 12 } ) {
+			IO::MSeedEncoder encoder;
+			BOOST_REQUIRE(encoder.setRecordSize(recordSize));
+			switch ( type ) {
+				case 0: encoder.setSteim2(); break;
+				case 1: encoder.setSteim1(); break;
+				default: encoder.setIdentity(); break;
+			}
+
+			auto records = encodeChunked(encoder, samples, 1234);
+			BOOST_REQUIRE(!records.empty());
+			BOOST_CHECK(decode(records) == samples);
+
+			// Records are contiguous
+			for ( size_t i = 1; i < records.size(); ++i ) {
+				BOOST_CHECK(records[i]->startTime() == records[i-1]->endTime());
+			}
+		}
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(chunking) {
+	auto samples = makeSamples(20000, 2);
+
+	IO::MSeedEncoder encoder;
+	auto reference = encodeChunked(encoder, samples, samples.size());
+
+	// The output does not depend on how the input is split
+	for ( size_t chunk : { 1, 3, 7, 100, 1023, 1024, 1025, 5000 } ) {
+		IO::MSeedEncoder chunked;
+		BOOST_CHECK_MESSAGE(sameRaw(encodeChunked(chunked, samples, chunk), reference),
+		                    "chunk size " << chunk);
+	}
+
+	// feed() returns the same records one by one
+	IO::MSeedEncoder fedEncoder;
+	vector<RecordPtr> fed;
+	Core::Time startTime(2025, 7, 1);
+	for ( size_t i = 0; i < samples.size(); i += 1000 ) {
+		auto rec = makeRecord("ABCD", startTime + Core::TimeSpan(i / 20.0),
+		                      &samples[i], 1000);
+		for ( Record *out = fedEncoder.feed(rec.get()); out; out = fedEncoder.feed(nullptr) ) {
+			fed.push_back(out);
+		}
+	}
+
+	for ( Record *out = fedEncoder.flush(); out; out = fedEncoder.flush() ) {
+		fed.push_back(out);
+	}
+
+	BOOST_CHECK(sameRaw(fed, reference));
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(parallel) {
+	const int streams = 7;
+	const size_t recordLength = 900;
+	vector<vector<int>> samples;
+	vector<RecordCPtr> input;
+	Core::Time startTime(2025, 7, 1);
+
+	for ( int s = 0; s < streams; ++s ) {
+		samples.push_back(makeSamples(20 * recordLength, 10 + s));
+	}
+
+	// Interleave the records of all streams
+	for ( size_t i = 0; i < 20 * recordLength; i += recordLength ) {
+		for ( int s = 0; s < streams; ++s ) {
+			input.push_back(makeRecord("S" + to_string(s),
+			                           startTime + Core::TimeSpan(i / 20.0),
+			                           &samples[s][i], recordLength));
+		}
+	}
+
+	IO::MSeedEncoder encoder;
+	auto sequential = encoder.encode(input, 1);
+	auto parallel = encoder.encode(input, 4);
+	BOOST_CHECK(sameRaw(sequential, parallel));
+
+	// Each stream is encoded as with its own instance
+	vector<RecordPtr> expected;
+	for ( int s = 0; s < streams; ++s ) {
+		IO::MSeedEncoder single;
+		for ( const auto &rec : input ) {
+			if ( rec->stationCode() == "S" + to_string(s) ) {
+				single.encode(rec.get(), expected);
+			}
+		}
+		single.flush(expected);
+	}
+
+	BOOST_CHECK(sameRaw(parallel, expected));
+
+	// Streams appear in order of their first occurrence
+	size_t offset = 0;
+	for ( int s = 0; s < streams; ++s ) {
+		vector<RecordPtr> stream;
+		while ( (offset < parallel.size())
+		     && (parallel[offset]->stationCode() == "S" + to_string(s)) ) {
+			stream.push_back(parallel[offset++]);
+		}
+
+		BOOST_CHECK(decode(stream) == samples[s]);
+	}
+
+	BOOST_CHECK_EQUAL(offset, parallel.size());
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(measureperformance) {
+	auto samples = makeSamples(4000000, 3);
+	vector<RecordCPtr> input;
+	Core::Time startTime(2025, 7, 1);
+
+	for ( int s = 0; s < 8; ++s ) {
+		for ( size_t i = 0; i < samples.size(); i += 100000 ) {
+			input.push_back(makeRecord("S" + to_string(s),
+			                           startTime + Core::TimeSpan(i / 20.0),
+			                           &samples[i], 100000));
+		}
+	}
+
+	IO::MSeedEncoder encoder;
+
+	Util::StopWatch timer;
+	auto sequential = encoder.encode(input, 1);
+	auto elapsed1 = timer.elapsed();
+
+	timer.restart();
+	auto parallel = encoder.encode(input);
+	auto elapsed2 = timer.elapsed();
+
+	BOOST_CHECK_EQUAL(sequential.size(), parallel.size());
+
+	cerr << "MSeedEncoder::encode (1 thread): " << elapsed1 << endl;
+	cerr << "MSeedEncoder::encode (all threads): " << elapsed2 << endl;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_SUITE_END()
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
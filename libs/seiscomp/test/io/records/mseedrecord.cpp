@@ -183,6 +183,47 @@ BOOST_AUTO_TEST_CASE(MODIFY) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(HEADER_ONLY) {
+	MSeedRecord mseed(filledRec);
+
+	stringbuf buf;
+	iostream ios(&buf);
+
+	BOOST_CHECK_NO_THROW(mseed.write(ios));
+	BOOST_CHECK_NO_THROW(mseed.write(ios));
+
+	MSeedRecord rec;
+	rec.read(ios);
+	ios.clear();
+	ios.seekg(0);
+
+	MSeedHeader header;
+	BOOST_REQUIRE(MSeedRecord::ReadHeader(ios, header));
+	BOOST_CHECK_EQUAL(header.streamID(), filledRec.streamID());
+	BOOST_CHECK_EQUAL(header.startTime.iso(), rec.startTime().iso());
+	BOOST_CHECK_EQUAL(header.endTime.iso(), rec.endTime().iso());
+	BOOST_CHECK_EQUAL(header.samplingFrequency, rec.samplingFrequency());
+	BOOST_CHECK_EQUAL(header.sampleCount, rec.sampleCount());
+	BOOST_CHECK_EQUAL(header.recordLength, rec.recordLength());
+	BOOST_CHECK_EQUAL(static_cast<int>(ios.tellg()), rec.recordLength());
+
+	// The second record follows directly
+	BOOST_REQUIRE(MSeedRecord::ReadHeader(ios, header));
+	BOOST_CHECK_EQUAL(header.streamID(), filledRec.streamID());
+	BOOST_CHECK(!MSeedRecord::ReadHeader(ios, header));
+
+	// Truncated fixed header
+	auto raw = CharArray::ConstCast(rec.raw());
+	BOOST_REQUIRE(raw);
+	BOOST_CHECK(MSeedRecord::ReadHeader(raw->typedData(), raw->size(), header));
+	BOOST_CHECK(!MSeedRecord::ReadHeader(raw->typedData(), 20, header));
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 BOOST_AUTO_TEST_SUITE_END()
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
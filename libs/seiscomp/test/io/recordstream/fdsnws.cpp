@@ -0,0 +1,254 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#define SEISCOMP_TEST_MODULE SeisComP
+#define SEISCOMP_COMPONENT TestFDSNWS
+
+
+#include <seiscomp/unittest/unittests.h>
+
+#include <seiscomp/core/strings.h>
+#include <seiscomp/io/recordstream/fdsnws.h>
+#include <seiscomp/io/recordstream/sdsarchive.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+using namespace std;
+using namespace Seiscomp;
+using namespace Seiscomp::Core;
+using namespace Seiscomp::RecordStream;
+
+
+namespace {
+
+
+/**
+ * A minimal FDSNWS dataselect stand-in. It answers POST requests with the
+ * records of the test SDS archive and keeps connections alive.
+ */
+class StandInServer {
+	public:
+		StandInServer() {
+			_fd = socket(AF_INET, SOCK_STREAM, 0);
+
+			sockaddr_in addr{};
+			addr.sin_family = AF_INET;
+			addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+			addr.sin_port = 0;
+
+			bind(_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+			listen(_fd, 16);
+
+			socklen_t len = sizeof(addr);
+			getsockname(_fd, reinterpret_cast<sockaddr*>(&addr), &len);
+			port = ntohs(addr.sin_port);
+
+			_acceptor = thread(&StandInServer::acceptLoop, this);
+		}
+
+		~StandInServer() {
+			shutdown(_fd, SHUT_RDWR);
+			::close(_fd);
+			_acceptor.join();
+
+			lock_guard<mutex> lock(_mutex);
+			for ( auto fd : _clients ) {
+				shutdown(fd, SHUT_RDWR);
+			}
+			for ( auto &t : _handlers ) {
+				t.join();
+			}
+		}
+
+	public:
+		int         port;
+		atomic<int> connections{0};
+		atomic<int> requests{0};
+
+	private:
+		void acceptLoop() {
+			while ( true ) {
+				int fd = accept(_fd, nullptr, nullptr);
+				if ( fd < 0 ) {
+					return;
+				}
+
+				++connections;
+				lock_guard<mutex> lock(_mutex);
+				_clients.push_back(fd);
+				_handlers.emplace_back(&StandInServer::handle, this, fd);
+			}
+		}
+
+		void handle(int fd) {
+			string buffer;
+			char data[4096];
+
+			while ( true ) {
+				size_t headerEnd;
+				while ( (headerEnd = buffer.find("\r\n\r\n")) == string::npos ) {
+					auto bytes = recv(fd, data, sizeof(data), 0);
+					if ( bytes <= 0 ) {
+						::close(fd);
+						return;
+					}
+					buffer.append(data, bytes);
+				}
+
+				string header = buffer.substr(0, headerEnd);
+				buffer.erase(0, headerEnd + 4);
+
+				size_t contentLength = 0;
+				auto pos = header.find("Content-Length:");
+				if ( pos != string::npos ) {
+					contentLength = stoul(header.substr(pos + 15));
+				}
+
+				while ( buffer.size() < contentLength ) {
+					auto bytes = recv(fd, data, sizeof(data), 0);
+					if ( bytes <= 0 ) {
+						::close(fd);
+						return;
+					}
+					buffer.append(data, bytes);
+				}
+
+				string body = buffer.substr(0, contentLength);
+				buffer.erase(0, contentLength);
+				++requests;
+
+				string payload = query(body);
+				string response;
+				if ( payload.empty() ) {
+					response = "HTTP/1.1 204 No Content\r\nContent-Length: 0\r\n\r\n";
+				}
+				else {
+					response = "HTTP/1.1 200 OK\r\n"
+					           "Content-Type: application/vnd.fdsn.mseed\r\n"
+					           "Content-Length: " + toString(payload.size()) + "\r\n\r\n"
+					         + payload;
+				}
+
+				if ( send(fd, response.data(), response.size(), MSG_NOSIGNAL) < 0 ) {
+					::close(fd);
+					return;
+				}
+			}
+		}
+
+		static string query(const string &body) {
+			SDSArchive sds("archive");
+			istringstream lines(body);
+			string net, sta, loc, cha, start, end;
+
+			while ( lines >> net >> sta >> loc >> cha >> start >> end ) {
+				sds.addStream(net, sta, loc == "--" ? "" : loc, cha,
+				              Time::FromString(start, "%FT%T.%f"),
+				              Time::FromString(end, "%FT%T.%f"));
+			}
+
+			ostringstream os;
+			RecordPtr rec;
+			while ( (rec = sds.next()) ) {
+				rec->write(os);
+			}
+
+			return os.str();
+		}
+
+	private:
+		int            _fd;
+		thread         _acceptor;
+		mutex          _mutex;
+		vector<int>    _clients;
+		vector<thread> _handlers;
+};
+
+
+vector<Time> fetch(const string &source, bool withMissingStream = false) {
+	FDSNWSConnection fdsnws;
+	BOOST_REQUIRE(fdsnws.setSource(source));
+
+	Time startTime(2018,6,30,16,18,30);
+	Time endTime(2018,6,30,16,22,30);
+	fdsnws.addStream("FR", "SALF", "00", "HHN", startTime, endTime);
+	if ( withMissingStream ) {
+		fdsnws.addStream("FR", "SALF", "00", "HHZ", startTime, endTime);
+	}
+
+	vector<Time> startTimes;
+	RecordPtr rec;
+	while ( (rec = fdsnws.next()) ) {
+		BOOST_CHECK_EQUAL(rec->streamID(), "FR.SALF.00.HHN");
+		startTimes.push_back(rec->startTime());
+	}
+
+	return startTimes;
+}
+
+
+}
+
+
+BOOST_AUTO_TEST_SUITE(seiscomp_io_recordstream_fdsnws)
+
+
+BOOST_AUTO_TEST_CASE(chunkedRequest) {
+	StandInServer server;
+	string url = "fdsnws://127.0.0.1:" + toString(server.port) + "/fdsnws/dataselect/1/query";
+
+	auto expected = fetch(url);
+	BOOST_REQUIRE(expected.size() > 10);
+	BOOST_CHECK_EQUAL(server.requests, 1);
+
+	for ( size_t i = 1; i < expected.size(); ++i ) {
+		BOOST_CHECK(expected[i-1] < expected[i]);
+	}
+
+	// Split into 30 s windows fetched over three connections
+	server.requests = 0;
+	server.connections = 0;
+	auto chunked = fetch(url + "?connections=3&requestWindow=30");
+	BOOST_CHECK_EQUAL(server.requests, 8);
+	BOOST_CHECK(server.connections <= 3);
+	BOOST_CHECK_EQUAL_COLLECTIONS(chunked.begin(), chunked.end(),
+	                              expected.begin(), expected.end());
+
+	// One stream per request, the second stream has no data
+	server.requests = 0;
+	chunked = fetch(url + "?connections=2&streamsPerRequest=1", true);
+	BOOST_CHECK_EQUAL(server.requests, 2);
+	BOOST_CHECK_EQUAL_COLLECTIONS(chunked.begin(), chunked.end(),
+	                              expected.begin(), expected.end());
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
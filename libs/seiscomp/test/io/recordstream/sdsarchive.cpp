@@ -333,5 +333,147 @@ BOOST_AUTO_TEST_CASE(READ_ARCHIVE2) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+namespace {
+
+
+const char *MorcArchives =
+	"archive-day2/BHE,"
+	"archive-day1/BHE,"
+	"archive-day1/BHN,"
+	"archive-day2/BHN,"
+	"archive-day1/BHZ,"
+	"archive-day2/BHZ";
+
+
+vector<RecordPtr> readMorc(const string &params) {
+	SDSArchive sds;
+	BOOST_REQUIRE(sds.setSource(MorcArchives + params));
+
+	Time startTime(2019,5,1,23,59,10,0);
+	Time endTime(2019,5,2,0,0,50,0);
+	sds.addStream("GE", "MORC", "", "BHE", startTime, endTime);
+	sds.addStream("GE", "MORC", "", "BHN", startTime, endTime);
+	sds.addStream("GE", "MORC", "", "BHZ", startTime, endTime);
+
+	vector<RecordPtr> records;
+	RecordPtr rec;
+
+	while ( (rec = sds.next()) ) {
+		records.push_back(rec);
+	}
+
+	return records;
+}
+
+
+vector<RecordPtr> channelRecords(const vector<RecordPtr> &records,
+                                 const string &cha) {
+	vector<RecordPtr> result;
+
+	for ( const auto &rec : records ) {
+		if ( rec->channelCode() == cha ) {
+			result.push_back(rec);
+		}
+	}
+
+	return result;
+}
+
+
+RecordPtr contiguousRecord(const vector<RecordPtr> &records) {
+	RingBuffer buffer(0);
+
+	for ( const auto &rec : records ) {
+		buffer.push_back(rec);
+	}
+
+	return buffer.contiguousRecord<double>();
+}
+
+
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(READ_GE_MORC_PARALLEL) {
+	auto sequential = readMorc("");
+	BOOST_REQUIRE(!sequential.empty());
+
+	for ( const string params : { "?threads=1", "?threads=2&window=3",
+	                              "?threads=4&window=1" } ) {
+		auto parallel = readMorc(params);
+		BOOST_CHECK_EQUAL(parallel.size(), sequential.size());
+
+		// The records of each channel are delivered in the same order
+		for ( const string cha : { "BHE", "BHN", "BHZ" } ) {
+			auto expected = channelRecords(sequential, cha);
+			auto delivered = channelRecords(parallel, cha);
+			BOOST_REQUIRE_EQUAL(delivered.size(), expected.size());
+			for ( size_t i = 0; i < expected.size(); ++i ) {
+				BOOST_CHECK(delivered[i]->startTime() == expected[i]->startTime());
+			}
+		}
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(READ_GE_MORC_PARALLEL_MERGE) {
+	auto sequential = readMorc("");
+
+	for ( const string params : { "?threads=1&merge", "?threads=3&merge&window=2" } ) {
+		auto merged = readMorc(params);
+		BOOST_REQUIRE_EQUAL(merged.size(), sequential.size());
+
+		for ( size_t i = 1; i < merged.size(); ++i ) {
+			BOOST_CHECK(merged[i-1]->startTime() <= merged[i]->startTime());
+		}
+
+		// Each channel is complete
+		for ( const string cha : { "BHE", "BHN", "BHZ" } ) {
+			RecordPtr crec = contiguousRecord(channelRecords(merged, cha));
+			RecordPtr expected = contiguousRecord(channelRecords(sequential, cha));
+			BOOST_REQUIRE(crec);
+			BOOST_REQUIRE(expected);
+			BOOST_CHECK(crec->startTime() == expected->startTime());
+			BOOST_CHECK_EQUAL(crec->sampleCount(), expected->sampleCount());
+		}
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(READ_FR_SALF_PARALLEL) {
+	SDSArchive sds("archive?threads=2&merge");
+	Time startTime(2018,06,30,16,18,38,943300);
+	Time endTime(2018,06,30,16,21,58,943300);
+	sds.addStream("FR", "SALF", "00", "HHN", startTime, endTime);
+
+	RingBuffer buffer(0);
+	RecordPtr rec;
+
+	while ( (rec = sds.next()) ) {
+		buffer.push_back(rec);
+	}
+
+	RecordPtr crec = buffer.contiguousRecord<double>();
+	BOOST_REQUIRE(crec);
+	BOOST_CHECK(crec->startTime() <= startTime && endTime <= crec->endTime());
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 BOOST_AUTO_TEST_SUITE_END()
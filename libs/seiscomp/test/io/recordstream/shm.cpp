@@ -0,0 +1,358 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#define SEISCOMP_TEST_MODULE SeisComP
+#define SEISCOMP_COMPONENT TestSharedMemory
+
+
+#include <seiscomp/unittest/unittests.h>
+
+#include <seiscomp/core/strings.h>
+#include <seiscomp/core/typedarray.h>
+#include <seiscomp/logging/log.h>
+#include <seiscomp/io/records/mseedrecord.h>
+#include <seiscomp/io/recordstream/shm.h>
+
+#include <algorithm>
+#include <fstream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+
+using namespace std;
+using namespace Seiscomp;
+using namespace Seiscomp::Core;
+using namespace Seiscomp::IO;
+using namespace Seiscomp::RecordStream;
+
+
+namespace {
+
+
+string ringName() {
+	return "sctest-shm-" + toString(getpid());
+}
+
+
+// Removes the ring also if a test case fails
+struct Feeder : SharedMemoryFeeder {
+	~Feeder() override {
+		close(true);
+	}
+};
+
+
+vector<RecordPtr> readFile(const string &path) {
+	vector<RecordPtr> records;
+	ifstream ifs(path, ios::binary);
+
+	while ( true ) {
+		MSeedRecordPtr rec = new MSeedRecord(Array::INT, Record::SAVE_RAW);
+		try {
+			rec->read(ifs);
+		}
+		catch ( ... ) {
+			break;
+		}
+
+		records.push_back(rec);
+	}
+
+	return records;
+}
+
+
+vector<RecordPtr> salfRecords() {
+	return readFile("archive/2018/FR/SALF/HHN.D/FR.SALF.00.HHN.D.2018.181");
+}
+
+
+// Records of three channels, interleaved by time
+vector<RecordPtr> morcRecords() {
+	vector<RecordPtr> records;
+
+	for ( auto cha : {"BHE", "BHN", "BHZ"} ) {
+		string path = string("archive-day2/") + cha + "/2019/GE/MORC/" + cha
+		            + ".D/GE.MORC.." + cha + ".D.2019.122";
+		auto channel = readFile(path);
+		records.insert(records.end(), channel.begin(), channel.end());
+	}
+
+	stable_sort(records.begin(), records.end(), [](const RecordPtr &a, const RecordPtr &b) {
+		return a->startTime() < b->startTime();
+	});
+
+	return records;
+}
+
+
+bool sameRecord(const Record *a, const Record *b) {
+	if ( a->streamID() != b->streamID()
+	  || a->startTime() != b->startTime()
+	  || a->sampleCount() != b->sampleCount() ) {
+		return false;
+	}
+
+	auto da = IntArray::ConstCast(a->data());
+	auto db = IntArray::ConstCast(b->data());
+	return da && db && da->impl() == db->impl();
+}
+
+
+}
+
+
+struct GlobalFixture {
+	GlobalFixture() {
+		Logging::enableConsoleLogging(Logging::getAll());
+	}
+};
+
+BOOST_GLOBAL_FIXTURE(GlobalFixture);
+BOOST_AUTO_TEST_SUITE(seiscomp_io_recordstream_shm)
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(ROUND_TRIP) {
+	auto records = salfRecords();
+	BOOST_REQUIRE(records.size() > 10);
+
+	Feeder feeder;
+	BOOST_REQUIRE(feeder.create(ringName(), 256, 512, 16));
+
+	SharedMemoryStream stream;
+	BOOST_REQUIRE(stream.setSource(ringName() + "?poll=1"));
+	stream.setDataType(Array::INT);
+	// Start with the oldest record held by the ring
+	stream.setStartTime(Time(0, 0));
+
+	for ( auto &rec : records ) {
+		BOOST_REQUIRE(feeder.push(rec.get()));
+	}
+
+	BOOST_CHECK_EQUAL(feeder.head(), records.size());
+
+	for ( auto &rec : records ) {
+		RecordPtr received = stream.next();
+		BOOST_REQUIRE(received);
+		BOOST_CHECK(sameRecord(rec.get(), received.get()));
+	}
+
+	// Records published after the reader has caught up
+	BOOST_REQUIRE(feeder.push(records[0].get()));
+	RecordPtr received = stream.next();
+	BOOST_REQUIRE(received);
+	BOOST_CHECK(sameRecord(records[0].get(), received.get()));
+
+	// Records which do not fit into a slot are rejected
+	string large(1024, 'x');
+	BOOST_CHECK(!feeder.push(large.data(), large.size(), "XX.LARGE..HHZ",
+	                         records[0]->startTime(), records[0]->endTime()));
+
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(OVERRUN) {
+	auto records = salfRecords();
+	const size_t slots = 8;
+	BOOST_REQUIRE(records.size() > 2 * slots);
+
+	Feeder feeder;
+	BOOST_REQUIRE(feeder.create(ringName(), slots, 512, 16));
+
+	SharedMemoryStream stream;
+	BOOST_REQUIRE(stream.setSource(ringName() + "?poll=1"));
+	stream.setDataType(Array::INT);
+	stream.setStartTime(Time(0, 0));
+
+	// Attach while the ring still holds the first record
+	BOOST_REQUIRE(feeder.push(records[0].get()));
+	RecordPtr received = stream.next();
+	BOOST_REQUIRE(received);
+	BOOST_CHECK(sameRecord(records[0].get(), received.get()));
+
+	// The slow reader is overrun and continues with the oldest record
+	// still held by the ring
+	for ( size_t i = 1; i < records.size(); ++i ) {
+		BOOST_REQUIRE(feeder.push(records[i].get()));
+	}
+
+	for ( size_t i = records.size() - slots; i < records.size(); ++i ) {
+		received = stream.next();
+		BOOST_REQUIRE(received);
+		BOOST_CHECK(sameRecord(records[i].get(), received.get()));
+	}
+
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(INTERRUPTED_WRITE) {
+	auto records = salfRecords();
+	const size_t slots = 4;
+	BOOST_REQUIRE(records.size() > slots);
+
+	Feeder feeder;
+	BOOST_REQUIRE(feeder.create(ringName(), slots, 512, 16));
+
+	for ( size_t i = 0; i < slots; ++i ) {
+		BOOST_REQUIRE(feeder.push(records[i].get()));
+	}
+
+	// Simulate a feeder which died while overwriting the first slot
+	{
+		int fd = shm_open(("/" + ringName()).c_str(), O_RDWR, 0);
+		BOOST_REQUIRE(fd >= 0);
+		struct stat st;
+		BOOST_REQUIRE(fstat(fd, &st) == 0);
+		void *mapping = mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+		::close(fd);
+		BOOST_REQUIRE(mapping != MAP_FAILED);
+
+		auto *header = static_cast<SharedMemory::Header*>(mapping);
+		size_t slotsOffset = (sizeof(SharedMemory::Header) + 63) & ~size_t(63);
+		slotsOffset = (slotsOffset + header->indexSize * sizeof(SharedMemory::IndexEntry) + 63) & ~size_t(63);
+		auto *slot = reinterpret_cast<SharedMemory::SlotHeader*>(
+			static_cast<char*>(mapping) + slotsOffset
+		);
+		slot->sequence.store(0);
+		munmap(mapping, st.st_size);
+	}
+
+	SharedMemoryStream stream;
+	BOOST_REQUIRE(stream.setSource(ringName() + "?poll=1"));
+	stream.setDataType(Array::INT);
+	stream.setStartTime(Time(0, 0));
+
+	// The broken record is skipped rather than waited for
+	for ( size_t i = 1; i < slots; ++i ) {
+		RecordPtr received = stream.next();
+		BOOST_REQUIRE(received);
+		BOOST_CHECK(sameRecord(records[i].get(), received.get()));
+	}
+
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(RECREATED_RING) {
+	auto records = salfRecords();
+	BOOST_REQUIRE(records.size() > 3);
+
+	Feeder feeder;
+	BOOST_REQUIRE(feeder.create(ringName(), 16, 512, 16));
+	BOOST_REQUIRE(feeder.push(records[0].get()));
+
+	SharedMemoryStream stream;
+	BOOST_REQUIRE(stream.setSource(ringName() + "?poll=1"));
+	stream.setDataType(Array::INT);
+	stream.setStartTime(Time(0, 0));
+
+	RecordPtr received = stream.next();
+	BOOST_REQUIRE(received);
+	BOOST_CHECK(sameRecord(records[0].get(), received.get()));
+
+	// The reader still maps the old ring which will never receive new
+	// records. It has to detect the new one and attach to it.
+	BOOST_REQUIRE(feeder.create(ringName(), 16, 512, 16));
+	BOOST_REQUIRE(feeder.push(records[1].get()));
+	BOOST_REQUIRE(feeder.push(records[2].get()));
+
+	received = stream.next();
+	BOOST_REQUIRE(received);
+	BOOST_CHECK(sameRecord(records[1].get(), received.get()));
+
+	received = stream.next();
+	BOOST_REQUIRE(received);
+	BOOST_CHECK(sameRecord(records[2].get(), received.get()));
+
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_CASE(SUBSCRIPTIONS) {
+	auto records = morcRecords();
+	BOOST_REQUIRE_EQUAL(records.size(), 6);
+
+	// Starts within the second BHN record
+	Time bhnStart;
+	int bhn = 0;
+	for ( auto &rec : records ) {
+		if ( rec->channelCode() == "BHN" && ++bhn == 2 ) {
+			bhnStart = rec->startTime() + TimeSpan(1, 0);
+		}
+	}
+
+	BOOST_REQUIRE_EQUAL(bhn, 2);
+
+	Feeder feeder;
+	BOOST_REQUIRE(feeder.create(ringName(), 64, 512, 16));
+
+	SharedMemoryStream stream;
+	BOOST_REQUIRE(stream.setSource(ringName() + "?poll=1"));
+	stream.setDataType(Array::INT);
+	stream.setStartTime(Time(0, 0));
+	BOOST_REQUIRE(stream.addStream("GE", "MORC", "", "BHZ"));
+	BOOST_REQUIRE(stream.addStream("GE", "MORC", "", "B?N", bhnStart, None));
+
+	vector<RecordPtr> expected;
+	for ( auto &rec : records ) {
+		BOOST_REQUIRE(feeder.push(rec.get()));
+
+		if ( rec->channelCode() == "BHZ"
+		  || (rec->channelCode() == "BHN" && rec->endTime() >= bhnStart) ) {
+			expected.push_back(rec);
+		}
+	}
+
+	BOOST_REQUIRE_EQUAL(expected.size(), 3);
+
+	for ( auto &rec : expected ) {
+		RecordPtr received = stream.next();
+		BOOST_REQUIRE(received);
+		BOOST_CHECK(sameRecord(rec.get(), received.get()));
+	}
+
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+BOOST_AUTO_TEST_SUITE_END()
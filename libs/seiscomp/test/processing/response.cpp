@@ -0,0 +1,145 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#define SEISCOMP_TEST_MODULE SeisComP
+
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <seiscomp/unittest/unittests.h>
+
+#include <seiscomp/math/restitution/fft.h>
+#include <seiscomp/processing/response.h>
+
+
+using namespace Seiscomp;
+using namespace Seiscomp::Processing;
+
+
+namespace {
+
+
+ResponsePAZPtr createSTS2() {
+	ResponsePAZPtr paz = new ResponsePAZ;
+	paz->setPoles({
+		Math::Complex(-0.037004, 0.037016), Math::Complex(-0.037004, -0.037016),
+		Math::Complex(-251.33, 0), Math::Complex(-131.04, -467.29),
+		Math::Complex(-131.04, 467.29)
+	});
+	paz->setZeros({ Math::Complex(0, 0), Math::Complex(0, 0) });
+	paz->setNormalizationFactor(60077000.0);
+	return paz;
+}
+
+
+std::vector<double> createSignal(size_t n) {
+	std::vector<double> data(n);
+	for ( size_t i = 0; i < n; ++i ) {
+		data[i] = sin(i * 0.05) + 0.5 * cos(i * 0.3);
+	}
+	return data;
+}
+
+
+}
+
+
+BOOST_AUTO_TEST_SUITE(seiscomp_processing_response)
+
+
+BOOST_AUTO_TEST_CASE(cachedDeconvolution) {
+	ResponseSpectrumCache::Clear();
+
+	auto paz = createSTS2();
+	const double fsamp = 20.0;
+
+	auto expected = createSignal(1000);
+	Math::Restitution::FFT::TransferFunctionPtr tf = paz->getTransferFunction(1);
+	BOOST_REQUIRE(tf);
+	BOOST_REQUIRE(Math::Restitution::transformFFT(expected, fsamp, tf.get(), 10, 0.01, 8));
+
+	double maxAmplitude = 0;
+	for ( auto v : expected ) {
+		maxAmplitude = std::max(maxAmplitude, fabs(v));
+	}
+
+	for ( int i = 0; i < 3; ++i ) {
+		auto data = createSignal(1000);
+		BOOST_REQUIRE(paz->deconvolveFFT(data.size(), data.data(), fsamp, 10, 0.01, 8, 1));
+
+		for ( size_t j = 0; j < data.size(); ++j ) {
+			BOOST_CHECK_SMALL(data[j] - expected[j], 1E-9 * maxAmplitude);
+		}
+	}
+
+	auto stats = ResponseSpectrumCache::GetStatistics();
+	BOOST_CHECK_EQUAL(stats.misses, 1);
+	BOOST_CHECK_EQUAL(stats.hits, 2);
+	BOOST_CHECK_EQUAL(stats.entries, 1);
+
+	// A different instance with the same parameters shares the spectrum
+	auto other = createSTS2();
+	auto data = createSignal(1000);
+	BOOST_REQUIRE(other->deconvolveFFT(data.size(), data.data(), fsamp, 10, 0.01, 8, 1));
+	BOOST_CHECK_EQUAL(ResponseSpectrumCache::GetStatistics().hits, 3);
+
+	// Different length, integrations and gain result in new entries
+	data = createSignal(1001);
+	BOOST_REQUIRE(other->deconvolveFFT(data.size(), data.data(), fsamp, 10, 0.01, 8, 1));
+	data = createSignal(1000);
+	BOOST_REQUIRE(other->deconvolveFFT(data.size(), data.data(), fsamp, 10, 0.01, 8, 0));
+	other->setNormalizationFactor(1.0);
+	BOOST_REQUIRE(other->deconvolveFFT(data.size(), data.data(), fsamp, 10, 0.01, 8, 1));
+
+	stats = ResponseSpectrumCache::GetStatistics();
+	BOOST_CHECK_EQUAL(stats.misses, 4);
+	BOOST_CHECK_EQUAL(stats.entries, 4);
+}
+
+
+BOOST_AUTO_TEST_CASE(capacity) {
+	ResponseSpectrumCache::Clear();
+	// Room for about two spectra of 1000 samples
+	ResponseSpectrumCache::SetCapacity(20000);
+
+	auto paz = createSTS2();
+	for ( int i = 0; i < 4; ++i ) {
+		auto data = createSignal(1000);
+		BOOST_REQUIRE(paz->deconvolveFFT(data.size(), data.data(), 20.0 + i, 10, 0.01, 8, 0));
+	}
+
+	auto stats = ResponseSpectrumCache::GetStatistics();
+	BOOST_CHECK_EQUAL(stats.entries, 2);
+	BOOST_CHECK_EQUAL(stats.evictions, 2);
+	BOOST_CHECK(stats.bytes <= stats.capacity);
+
+	// Disabled cache
+	ResponseSpectrumCache::SetCapacity(0);
+	auto data = createSignal(1000);
+	BOOST_REQUIRE(paz->deconvolveFFT(data.size(), data.data(), 20.0, 10, 0.01, 8, 0));
+	BOOST_CHECK_EQUAL(ResponseSpectrumCache::GetStatistics().entries, 0);
+
+	ResponseSpectrumCache::SetCapacity(32*1024*1024);
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -23,7 +23,10 @@
 #include <seiscomp/unittest/unittests.h>
 #include <seiscomp/seismology/ttt.h>
 #include <seiscomp/seismology/ttt/libtau.h>
+#include <seiscomp/utils/timer.h>
 
+#include <iostream>
+#include <random>
 #include <thread>
 
 
@@ -80,5 +83,116 @@ BOOST_AUTO_TEST_CASE(MultiThreaded) {
 
 
 
+//<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+BOOST_AUTO_TEST_CASE(DepthCache) {
+	setenv("SEISCOMP_LIBTAU_TABLE_DIR", STR2(BUILD_DIR) "/libs/3rd-party/tau/data/", 1);
+
+	const double depths[] = { 10.0, 33.0, 120.5, 10.0, 600.0, 33.0, 0.5, 120.5 };
+	const double deltas[] = { 1.0, 25.0, 95.0, 150.0 };
+
+	// Compute the reference before any depth is cached. With a cache size
+	// of 0 nothing is stored, and the shared model of the reference is
+	// released at the end of the scope so the cached instance below starts
+	// with an empty cache.
+	vector<unique_ptr<TravelTimeList>> expected;
+	TravelTime expectedFirst;
+	TTT::LibTau::SetDepthCacheSize(0);
+	{
+		TTT::LibTau reference;
+		reference.setModel("iasp91");
+
+		for ( auto depth : depths ) {
+			for ( auto delta : deltas ) {
+				expected.emplace_back(reference.compute(0, 0, depth, 0, delta, 0, 0));
+				BOOST_REQUIRE(expected.back());
+			}
+		}
+
+		expectedFirst = reference.computeFirst(0, 0, 120.5, 0, 40, 0, 0);
+	}
+
+	TTT::LibTau::SetDepthCacheSize(4);
+	TTT::LibTau cached;
+	cached.setModel("iasp91");
+
+	for ( int pass = 0; pass < 2; ++pass ) {
+		auto expectedList = expected.begin();
+		for ( auto depth : depths ) {
+			for ( auto delta : deltas ) {
+				unique_ptr<TravelTimeList> ttlist(cached.compute(0, 0, depth, 0, delta, 0, 0));
+
+				BOOST_REQUIRE(ttlist);
+				BOOST_REQUIRE_EQUAL(ttlist->size(), (*expectedList)->size());
+
+				auto it = (*expectedList)->begin();
+				for ( auto &tt : *ttlist ) {
+					BOOST_CHECK_EQUAL(tt.phase, it->phase);
+					BOOST_CHECK_EQUAL(tt.time, it->time);
+					BOOST_CHECK_EQUAL(tt.dtdd, it->dtdd);
+					++it;
+				}
+
+				++expectedList;
+			}
+		}
+	}
+
+	// A copy shares the model and the cache of the original
+	TTT::LibTau copy(cached);
+	BOOST_CHECK_EQUAL(copy.model(), "iasp91");
+	auto tt = copy.computeFirst(0, 0, 120.5, 0, 40, 0, 0);
+	BOOST_CHECK_EQUAL(tt.phase, expectedFirst.phase);
+	BOOST_CHECK_EQUAL(tt.time, expectedFirst.time);
+
+	TTT::LibTau::SetDepthCacheSize(32);
+}
+//>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+
+
+
+
+//<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+BOOST_AUTO_TEST_CASE(measureperformance) {
+#define DEPTHS 20
+#define LOOPN 5000
+	setenv("SEISCOMP_LIBTAU_TABLE_DIR", STR2(BUILD_DIR) "/libs/3rd-party/tau/data/", 1);
+
+	// Random access to a limited set of depths as done e.g. by a locator
+	// which iterates over several origins
+	vector<double> depths;
+	mt19937 rng(42);
+	uniform_int_distribution<int> pick(0, DEPTHS - 1);
+	for ( size_t i = 0; i < LOOPN; ++i ) {
+		depths.push_back(10.0 + pick(rng) * 25.0);
+	}
+
+	double elapsed[2], sum[2] = { 0, 0 };
+
+	for ( int i = 0; i < 2; ++i ) {
+		TTT::LibTau::SetDepthCacheSize(i == 0 ? 0 : DEPTHS);
+		TTT::LibTau ttt;
+		ttt.setModel("iasp91");
+
+		Util::StopWatch stopWatch;
+
+		for ( auto depth : depths ) {
+			sum[i] += ttt.computeFirst(0, 0, depth, 0, 45, 0, 0).time;
+		}
+
+		elapsed[i] = stopWatch.elapsed().length();
+	}
+
+	TTT::LibTau::SetDepthCacheSize(32);
+
+	BOOST_CHECK_EQUAL(sum[0], sum[1]);
+
+	cerr << "random depths without cache: " << elapsed[0] << "s" << endl;
+	cerr << "random depths with cache: " << elapsed[1] << "s" << endl;
+}
+//>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+
+
+
+
 //<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,226 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+
+#define SEISCOMP_TEST_MODULE SeisComP
+#include <seiscomp/unittest/unittests.h>
+
+#include <seiscomp/system/model.h>
+#include <seiscomp/system/schema.h>
+
+#include <sstream>
+
+namespace bu = boost::unit_test;
+using namespace std;
+using namespace Seiscomp;
+using namespace Seiscomp::System;
+
+
+namespace {
+
+
+// Reads the configuration from the data directory instead of the
+// SeisComP installation
+class TestModel : public Model {
+	public:
+		string systemConfigFilename(bool, const string &name) const override {
+			return "data/config/" + name + ".cfg";
+		}
+
+		string configFileLocation(bool, const string &name, int stage) const override {
+			switch ( stage ) {
+				case Environment::CS_DEFAULT_GLOBAL:
+					return "data/defaults/global.cfg";
+				case Environment::CS_DEFAULT_APP:
+					return "data/defaults/" + name + ".cfg";
+				case Environment::CS_CONFIG_GLOBAL:
+					return "data/config/global.cfg";
+				case Environment::CS_CONFIG_APP:
+					return "data/config/" + name + ".cfg";
+				case Environment::CS_USER_GLOBAL:
+					return "data/user/global.cfg";
+				case Environment::CS_USER_APP:
+					return "data/user/" + name + ".cfg";
+			}
+
+			return string();
+		}
+
+		string stationConfigDir(bool, const string &name) const override {
+			return name.empty() ? "data/key" : "data/key/" + name;
+		}
+};
+
+
+class Dumper : public ModelVisitor {
+	public:
+		Dumper(ostream &os) : _os(os) {}
+
+	protected:
+		bool visit(Module *mod) override {
+			_os << "module " << mod->definition->name << endl;
+			return true;
+		}
+
+		bool visit(Section *sec) override {
+			_os << " section " << sec->name << endl;
+			return true;
+		}
+
+		bool visit(Group *group) override {
+			_os << " group " << group->path << endl;
+			return true;
+		}
+
+		bool visit(Structure *structure) override {
+			_os << " structure " << structure->path << structure->name << endl;
+			return true;
+		}
+
+		void visit(Parameter *param, bool unknown) override {
+			_os << (unknown ? "  unknown " : "  parameter ") << param->variableName
+			    << " = " << param->symbol.content
+			    << " [" << param->symbol.stage << "]" << endl;
+
+			for ( int stage = Environment::CS_FIRST; stage <= Environment::CS_LAST; ++stage ) {
+				if ( param->symbols[stage] ) {
+					_os << "   " << stage << ": "
+					    << param->symbols[stage]->symbol.content << endl;
+				}
+			}
+		}
+
+	private:
+		ostream &_os;
+};
+
+
+string dump(Model &model) {
+	ostringstream os;
+	Dumper dumper(os);
+
+	model.accept(&dumper);
+
+	for ( auto &mod : model.modules ) {
+		os << "module " << mod->definition->name << endl;
+
+		for ( auto &param : mod->unknowns ) {
+			os << " unknown " << param->variableName << endl;
+			for ( int stage = Environment::CS_FIRST; stage <= Environment::CS_LAST; ++stage ) {
+				if ( param->symbols[stage] ) {
+					os << "   " << stage << ": "
+					   << param->symbols[stage]->symbol.content << endl;
+				}
+			}
+		}
+
+		for ( auto &profile : mod->profiles ) {
+			os << " profile " << profile->name << endl;
+			profile->accept(&dumper);
+		}
+
+		for ( auto &item : mod->bindings ) {
+			os << " binding " << item.first.networkCode << "."
+			   << item.first.stationCode << " " << item.second->name << endl;
+			item.second->accept(&dumper);
+		}
+	}
+
+	for ( auto &item : model.stations ) {
+		os << "station " << item.first.networkCode << "."
+		   << item.first.stationCode << endl;
+		for ( auto &config : item.second->config ) {
+			os << " " << config.moduleName << ":" << config.profile << endl;
+		}
+	}
+
+	for ( auto &file : model.symbols ) {
+		os << "file " << file.first << endl;
+		for ( auto &item : file.second ) {
+			os << " " << item.first << " = " << item.second->symbol.content << endl;
+		}
+	}
+
+	return os.str();
+}
+
+
+string readModel(size_t threads, Model::ReadStatistics *stats = nullptr) {
+	SchemaDefinitions defs;
+	defs.setLoadThreads(threads);
+	BOOST_REQUIRE(defs.load("data/descriptions"));
+
+	TestModel model;
+	model.setParseThreads(threads);
+	BOOST_REQUIRE(model.create(&defs));
+	BOOST_REQUIRE(model.readConfig());
+
+	if ( stats ) {
+		*stats = model.readStatistics();
+	}
+
+	return dump(model);
+}
+
+
+}
+
+
+BOOST_AUTO_TEST_SUITE(seiscomp_core_system_model)
+//>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+
+
+
+
+//<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+BOOST_AUTO_TEST_CASE(parallelRead) {
+	Model::ReadStatistics sequentialStats, parallelStats;
+	string sequential = readModel(1, &sequentialStats);
+	string parallel = readModel(4, &parallelStats);
+
+	BOOST_CHECK_EQUAL(sequentialStats.threads, 1);
+	BOOST_CHECK_EQUAL(parallelStats.threads, 4);
+	BOOST_CHECK_EQUAL(sequentialStats.modules, 3);
+	BOOST_CHECK_EQUAL(sequentialStats.stations, 3);
+	BOOST_CHECK_EQUAL(sequentialStats.files, parallelStats.files);
+
+	// Nine stage files, one profile and three binding files
+	BOOST_CHECK_EQUAL(sequentialStats.files, 13);
+
+	// The fixture is actually read
+	BOOST_CHECK(sequential.find("agencyID = TEST") != string::npos);
+	BOOST_CHECK(sequential.find("binding GE.UGM") != string::npos);
+	BOOST_CHECK(sequential.find("profile default") != string::npos);
+	BOOST_CHECK(sequential.find("unknown unknown.parameter") != string::npos);
+
+	BOOST_CHECK_EQUAL(sequential, parallel);
+
+	// Repeated parallel reads give the same model
+	for ( int i = 0; i < 10; ++i ) {
+		BOOST_CHECK_EQUAL(readModel(0), sequential);
+	}
+}
+//>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+
+
+
+
+//<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+BOOST_AUTO_TEST_SUITE_END()
@@ -19,6 +19,8 @@
 #include <seiscomp/config/config.h>
 #include <seiscomp/utils/certstore.h>
 #include <seiscomp/io/recordstream.h>
+#include <seiscomp/io/records/mseedrecord.h>
+#include <seiscomp/io/records/signaturevalidator.h>
 #include <seiscomp/unittest/unittests.h>
 
 #include <openssl/ec.h>
@@ -28,6 +30,9 @@
 #include <openssl/pem.h>
 
 #include <fstream>
+#include <sstream>
+#include <thread>
+#include <vector>
 
 
 using namespace std;
@@ -218,6 +223,147 @@ BOOST_AUTO_TEST_CASE(validate_records) {
 	std::cerr << "Read " << numberOfRecords << " records" << std::endl;
 	BOOST_CHECK(numberOfRecords == 10);
 }
+//>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+
+
+
+
+//<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+BOOST_AUTO_TEST_CASE(validate_records_deferred) {
+	using namespace Seiscomp;
+
+	CertificateStore &store = CertificateStore::global();
+	BOOST_REQUIRE(store.init("./data/certs"));
+
+	string data = read_file("./data/data-signed.mseed");
+	auto recordLength = IO::MSeedRecord::Detect(data.data(), data.size());
+	BOOST_REQUIRE(recordLength > 0);
+	BOOST_REQUIRE(data.size() == static_cast<size_t>(10 * recordLength));
+
+	// Modify the last payload byte of the fourth record which invalidates
+	// its signature
+	data[4 * recordLength - 1] ^= 0x55;
+
+	auto readRecords = [&data]() {
+		vector<IO::MSeedRecordPtr> records;
+		istringstream is(data);
+		while ( true ) {
+			IO::MSeedRecordPtr rec = new IO::MSeedRecord(Array::INT, Record::SAVE_RAW);
+			try {
+				rec->read(is);
+			}
+			catch ( Core::EndOfStreamException & ) {
+				break;
+			}
+			records.push_back(rec);
+		}
+		return records;
+	};
+
+	auto reference = readRecords();
+	BOOST_REQUIRE_EQUAL(reference.size(), 10);
+	for ( size_t i = 0; i < reference.size(); ++i ) {
+		BOOST_CHECK(!reference[i]->hasPendingAuthentication());
+		BOOST_CHECK_EQUAL(reference[i]->authentication(),
+		                  i == 3 ? Record::SIGNATURE_VALIDATION_FAILED : Record::SIGNATURE_VALIDATED);
+	}
+
+	IO::MSeedRecord::SetDeferredAuthentication(true);
+	auto records = readRecords();
+	IO::MSeedRecord::SetDeferredAuthentication(false);
+
+	BOOST_REQUIRE_EQUAL(records.size(), reference.size());
+	for ( const auto &rec : records ) {
+		BOOST_CHECK(rec->hasPendingAuthentication());
+		BOOST_CHECK_EQUAL(rec->authentication(), Record::NOT_SIGNED);
+	}
+
+	// Deferral is bound to the thread which enabled it, records read by
+	// other threads are validated while reading
+	IO::MSeedRecord::SetDeferredAuthentication(true);
+	vector<IO::MSeedRecordPtr> otherThread;
+	thread([&otherThread, &readRecords]() {
+		BOOST_CHECK(!IO::MSeedRecord::DeferredAuthentication());
+		otherThread = readRecords();
+	}).join();
+	IO::MSeedRecord::SetDeferredAuthentication(false);
+
+	BOOST_REQUIRE_EQUAL(otherThread.size(), reference.size());
+	for ( size_t i = 0; i < otherThread.size(); ++i ) {
+		BOOST_CHECK(!otherThread[i]->hasPendingAuthentication());
+		BOOST_CHECK_EQUAL(otherThread[i]->authentication(), reference[i]->authentication());
+	}
+
+	auto validated = store.validatedCount();
+	auto failed = store.failedCount();
+
+	// A small window with more workers than records in flight forces
+	// out of order completion
+	vector<Record*> output;
+	{
+		IO::SignatureValidator validator([&output](Record *rec) {
+			output.push_back(rec);
+			return true;
+		}, 4, 3);
+
+		for ( const auto &rec : records ) {
+			// The validator takes ownership
+			rec->incrementReferenceCount();
+			BOOST_CHECK(validator.push(rec.get()));
+		}
+	}
+
+	BOOST_CHECK_EQUAL(store.validatedCount() - validated, 9);
+	BOOST_CHECK_EQUAL(store.failedCount() - failed, 1);
+
+	BOOST_REQUIRE_EQUAL(output.size(), reference.size());
+	for ( size_t i = 0; i < output.size(); ++i ) {
+		BOOST_CHECK(output[i] == records[i].get());
+		BOOST_CHECK(!records[i]->hasPendingAuthentication());
+		BOOST_CHECK_EQUAL(output[i]->authentication(), reference[i]->authentication());
+		BOOST_CHECK_EQUAL(output[i]->authority(), reference[i]->authority());
+		output[i]->decrementReferenceCount();
+	}
+
+	// A rejected record stops forwarding, the rejected and all subsequent
+	// records are deleted
+	IO::MSeedRecord::SetDeferredAuthentication(true);
+	records = readRecords();
+	IO::MSeedRecord::SetDeferredAuthentication(false);
+
+	vector<Record*> input;
+	for ( const auto &rec : records ) {
+		rec->incrementReferenceCount();
+		input.push_back(rec.get());
+	}
+	records.clear();
+
+	output.clear();
+	{
+		IO::SignatureValidator validator([&output](Record *rec) {
+			if ( output.size() == 5 ) {
+				return false;
+			}
+			output.push_back(rec);
+			return true;
+		}, 2, 4);
+
+		for ( auto rec : input ) {
+			validator.push(rec);
+		}
+
+		validator.close();
+		BOOST_CHECK(!validator.push(new IO::MSeedRecord));
+	}
+
+	BOOST_REQUIRE_EQUAL(output.size(), 5);
+	for ( size_t i = 0; i < output.size(); ++i ) {
+		BOOST_CHECK(output[i] == input[i]);
+		BOOST_CHECK_EQUAL(output[i]->authentication(), reference[i]->authentication());
+		output[i]->decrementReferenceCount();
+	}
+}
+//>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,223 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#define SEISCOMP_TEST_MODULE SeisComP
+
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include <seiscomp/unittest/unittests.h>
+
+#include <seiscomp/utils/latency.h>
+#include <seiscomp/utils/timer.h>
+
+
+using namespace std;
+using namespace Seiscomp;
+
+
+BOOST_AUTO_TEST_SUITE(seiscomp_utils_latency)
+
+
+BOOST_AUTO_TEST_CASE(buckets) {
+	using H = Util::LatencyHistogram;
+
+	// Small values are exact
+	for ( uint64_t v = 0; v < 2 * H::SubBuckets; ++v ) {
+		BOOST_CHECK_EQUAL(H::bucket(v), v);
+		BOOST_CHECK_EQUAL(H::lowerBound(v), v);
+		BOOST_CHECK_EQUAL(H::upperBound(v), v);
+	}
+
+	// Buckets are contiguous and cover the whole range
+	for ( size_t b = 1; b < H::BucketCount; ++b ) {
+		BOOST_REQUIRE_EQUAL(H::lowerBound(b), H::upperBound(b-1) + 1);
+	}
+
+	BOOST_CHECK_EQUAL(H::upperBound(H::BucketCount-1), H::MaxValue);
+	BOOST_CHECK_EQUAL(H::bucket(H::MaxValue), H::BucketCount-1);
+	BOOST_CHECK_EQUAL(H::bucket(H::MaxValue * 4), H::BucketCount-1);
+
+	// Every value falls into the bucket that contains it and the bucket
+	// width is bounded by the relative precision
+	mt19937_64 rng(7);
+	for ( int i = 0; i < 100000; ++i ) {
+		uint64_t v = rng() >> (rng() % 64);
+		v = std::min(v, H::MaxValue);
+		size_t b = H::bucket(v);
+		BOOST_REQUIRE_LE(H::lowerBound(b), v);
+		BOOST_REQUIRE_GE(H::upperBound(b), v);
+		BOOST_REQUIRE_LE(H::upperBound(b) - H::lowerBound(b), v / H::SubBuckets);
+	}
+}
+
+
+BOOST_AUTO_TEST_CASE(percentiles) {
+	Util::LatencyHistogram hist;
+
+	for ( int v = 1; v <= 1000; ++v ) {
+		hist.record(v);
+	}
+
+	hist.record(-5);
+
+	auto s = hist.snapshot();
+	BOOST_CHECK_EQUAL(s.count, 1001);
+	BOOST_CHECK_EQUAL(hist.count(), 1001);
+	BOOST_CHECK_EQUAL(s.sum, 500500);
+	BOOST_CHECK_EQUAL(s.min(), 0);
+	BOOST_CHECK_CLOSE(s.mean(), 500.0, 0.1);
+
+	// Reported values are upper bucket bounds within the precision
+	auto check = [&](double percent, double expected) {
+		double value = s.percentile(percent);
+		BOOST_CHECK_GE(value, expected);
+		BOOST_CHECK_LE(value, expected * (1.0 + 1.0 / Util::LatencyHistogram::SubBuckets));
+	};
+
+	check(50, 500);
+	check(90, 900);
+	check(99, 990);
+	check(100, 1000);
+	BOOST_CHECK_EQUAL(s.percentile(100), s.max());
+
+	// Deltas between snapshots
+	for ( int i = 0; i < 10; ++i ) {
+		hist.record(100000);
+	}
+
+	auto s2 = hist.snapshot();
+	s2 -= s;
+	BOOST_CHECK_EQUAL(s2.count, 10);
+	BOOST_CHECK_EQUAL(s2.sum, 1000000);
+	BOOST_CHECK_LE(s2.min(), 100000);
+	BOOST_CHECK_GE(s2.max(), 100000);
+
+	s2 += s;
+	BOOST_CHECK_EQUAL(s2.count, 1011);
+
+	hist.reset();
+	BOOST_CHECK_EQUAL(hist.snapshot().count, 0);
+	BOOST_CHECK_EQUAL(hist.snapshot().percentile(50), 0);
+}
+
+
+BOOST_AUTO_TEST_CASE(concurrentRecording) {
+	Util::LatencyHistogram hist;
+	const int threads = 4;
+	const int values = 100000;
+
+	vector<thread> workers;
+	for ( int t = 0; t < threads; ++t ) {
+		workers.emplace_back([&hist, t]() {
+			for ( int i = 0; i < values; ++i ) {
+				hist.record(i % 1000 + t);
+			}
+		});
+	}
+
+	for ( auto &w : workers ) {
+		w.join();
+	}
+
+	BOOST_CHECK_EQUAL(hist.count(), threads * values);
+}
+
+
+BOOST_AUTO_TEST_CASE(monitor) {
+	using M = Util::LatencyMonitor;
+	M monitor;
+
+	M::Timestamp arrival = M::Now() - 2000;
+	{
+		M::Scope scope(&monitor, arrival, "rec/HH");
+		BOOST_REQUIRE(M::Scope::Current() == &scope);
+		BOOST_CHECK_EQUAL(scope.streamClass(), "rec/HH");
+
+		{
+			M::Scope inner(&monitor, M::Now(), "msg/NotifierMessage");
+			BOOST_CHECK(M::Scope::Current() == &inner);
+		}
+
+		BOOST_CHECK(M::Scope::Current() == &scope);
+	}
+
+	BOOST_CHECK(M::Scope::Current() == nullptr);
+
+	auto queued = monitor.histogram(M::Queue, "rec/HH")->snapshot();
+	BOOST_REQUIRE_EQUAL(queued.count, 1);
+	BOOST_CHECK_GE(queued.max(), 2000);
+	BOOST_CHECK_EQUAL(monitor.histogram(M::Process, "rec/HH")->count(), 1);
+	BOOST_CHECK_EQUAL(monitor.histogram(M::Process, "msg/NotifierMessage")->count(), 1);
+
+	// The number of classes is bounded
+	for ( size_t i = 0; i < M::MaxClasses + 10; ++i ) {
+		monitor.record(M::Publish, "group/G" + to_string(i), 10);
+	}
+
+	BOOST_CHECK_EQUAL(monitor.histogram(M::Publish, "other")->count(), 12);
+
+	auto entries = monitor.snapshot();
+	size_t total = 0;
+	for ( const auto &entry : entries ) {
+		BOOST_CHECK(entry.snapshot.count > 0);
+		total += entry.snapshot.count;
+	}
+
+	BOOST_CHECK_EQUAL(total, M::MaxClasses + 10 + 4);
+	BOOST_CHECK_EQUAL(entries.back().streamClass, "other");
+
+	ostringstream os;
+	monitor.dump(os);
+	BOOST_CHECK(os.str().find("rec/HH") != string::npos);
+	BOOST_CHECK(os.str().find("queue") != string::npos);
+}
+
+
+BOOST_AUTO_TEST_CASE(measureperformance) {
+	Util::LatencyMonitor monitor;
+	const int runs = 1000000;
+
+	Util::StopWatch timer;
+	for ( int i = 0; i < runs; ++i ) {
+		monitor.record(Util::LatencyMonitor::Queue, "rec/HH", i % 100000);
+	}
+	auto elapsed1 = timer.elapsed();
+
+	auto hist = monitor.histogram(Util::LatencyMonitor::Queue, "rec/HH");
+	timer.restart();
+	for ( int i = 0; i < runs; ++i ) {
+		hist->record(i % 100000);
+	}
+	auto elapsed2 = timer.elapsed();
+
+	BOOST_CHECK_EQUAL(hist->count(), 2 * runs);
+
+	cerr << "LatencyMonitor::record: " << elapsed1 << endl;
+	cerr << "LatencyHistogram::record: " << elapsed2 << endl;
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
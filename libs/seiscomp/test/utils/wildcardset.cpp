@@ -0,0 +1,213 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#define SEISCOMP_TEST_MODULE SeisComP
+
+
+#include <algorithm>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <seiscomp/unittest/unittests.h>
+
+#include <seiscomp/core/strings.h>
+#include <seiscomp/utils/stringfirewall.h>
+#include <seiscomp/utils/timer.h>
+#include <seiscomp/utils/wildcardset.h>
+
+
+using namespace std;
+using namespace Seiscomp;
+
+
+namespace {
+
+
+int firstMatch(const vector<string> &patterns, const string &str) {
+	for ( size_t i = 0; i < patterns.size(); ++i ) {
+		if ( Core::wildcmp(patterns[i], str) ) {
+			return static_cast<int>(i);
+		}
+	}
+
+	return Util::WildcardSet::NoMatch;
+}
+
+
+string randomString(mt19937 &rng, const string &alphabet, size_t maxLength) {
+	uniform_int_distribution<size_t> length(0, maxLength);
+	uniform_int_distribution<size_t> pick(0, alphabet.size()-1);
+	string s(length(rng), ' ');
+	for ( auto &c : s ) {
+		c = alphabet[pick(rng)];
+	}
+	return s;
+}
+
+
+}
+
+
+BOOST_AUTO_TEST_SUITE(seiscomp_utils_wildcardset)
+
+
+BOOST_AUTO_TEST_CASE(match) {
+	vector<string> patterns = {
+		"GE.MORC..BHZ", "GE.*.*.BH?", "*.*.*.HH*", "CX.PB0?..*", "", "*Z", "A**B"
+	};
+
+	Util::WildcardSet set(patterns);
+	BOOST_CHECK_EQUAL(set.size(), patterns.size());
+	BOOST_CHECK(set.isDeterministic());
+
+	BOOST_CHECK_EQUAL(set.match("GE.MORC..BHZ"), 0);
+	BOOST_CHECK_EQUAL(set.match("GE.UGM..BHN"), 1);
+	BOOST_CHECK_EQUAL(set.match("GE.UGM.00.HHE"), 2);
+	BOOST_CHECK_EQUAL(set.match("CX.PB01..HNZ"), 3);
+	BOOST_CHECK_EQUAL(set.match("CX.PB10..HNE"), Util::WildcardSet::NoMatch);
+	BOOST_CHECK_EQUAL(set.match(""), 4);
+	BOOST_CHECK_EQUAL(set.match("Z"), 5);
+	BOOST_CHECK_EQUAL(set.match("AB"), 6);
+	BOOST_CHECK_EQUAL(set.match("AXYB"), 6);
+	BOOST_CHECK(!set.matches("AXYBC"));
+
+	// Patterns added after compilation are taken into account immediately
+	BOOST_CHECK_EQUAL(set.add("AXYB?"), 7);
+	BOOST_CHECK(!set.isDeterministic());
+	BOOST_CHECK_EQUAL(set.match("AXYBC"), 7);
+	set.compile();
+	BOOST_CHECK_EQUAL(set.match("AXYBC"), 7);
+
+	set.clear();
+	BOOST_CHECK(set.empty());
+	BOOST_CHECK(!set.matches("GE.MORC..BHZ"));
+}
+
+
+BOOST_AUTO_TEST_CASE(compareWithWildcmp) {
+	mt19937 rng(42);
+	const string patternAlphabet = "AB.*?";
+	const string alphabet = "ABC.";
+
+	for ( int n = 0; n < 200; ++n ) {
+		vector<string> patterns;
+		uniform_int_distribution<int> count(1, 20);
+		for ( int i = count(rng); i > 0; --i ) {
+			patterns.push_back(randomString(rng, patternAlphabet, 8));
+		}
+
+		Util::WildcardSet set(patterns);
+		Util::WildcardSet trie;
+		for ( const auto &pattern : patterns ) {
+			trie.add(pattern);
+		}
+
+		for ( int i = 0; i < 100; ++i ) {
+			auto str = randomString(rng, alphabet, 10);
+			int expected = firstMatch(patterns, str);
+			BOOST_CHECK_EQUAL(set.match(str), expected);
+			BOOST_CHECK_EQUAL(trie.match(str), expected);
+		}
+	}
+}
+
+
+BOOST_AUTO_TEST_CASE(firewall) {
+	Util::WildcardStringFirewall fw;
+	fw.allow.insert("GE.*");
+	fw.deny.insert("GE.MORC.*");
+
+	BOOST_CHECK(fw.isAllowed("GE.UGM..BHZ"));
+	BOOST_CHECK(fw.isDenied("GE.MORC..BHZ"));
+	BOOST_CHECK(fw.isDenied("CX.PB01..HHZ"));
+
+	// Changed lists are picked up even without clearing the cache
+	fw.allow.insert("CX.*");
+	BOOST_CHECK(fw.isAllowed("CX.PB01..HHZ"));
+
+	// Replacing a pattern does not change the size of the list
+	fw.allow.erase("CX.*");
+	fw.allow.insert("CX.PB02.*");
+	BOOST_CHECK(fw.isDenied("CX.PB01..HHZ"));
+	BOOST_CHECK(fw.isAllowed("CX.PB02..HHZ"));
+
+	fw.allow = {"GE.*", "CX.*"};
+	BOOST_CHECK(fw.isAllowed("CX.PB01..HHZ"));
+
+	fw.setCachingEnabled(false);
+	fw.deny.insert("CX.PB01.*");
+	BOOST_CHECK(fw.isDenied("CX.PB01..HHZ"));
+
+	// Lists filled through an insert iterator are picked up as well
+	vector<string> items = {"CX.PB02.*"};
+	copy(items.begin(), items.end(), inserter(fw.deny, fw.deny.end()));
+	BOOST_CHECK(fw.isDenied("CX.PB02..HHZ"));
+	BOOST_CHECK(fw.isAllowed("CX.PB03..HHZ"));
+}
+
+
+BOOST_AUTO_TEST_CASE(measureperformance) {
+#define PATTERNS 2000
+#define STREAMS 5000
+	vector<string> patterns, streams;
+
+	for ( int i = 0; i < PATTERNS; ++i ) {
+		patterns.push_back("X" + to_string(i % 50) + ".S" + to_string(i) + "*.*.HH?");
+	}
+
+	for ( int i = 0; i < STREAMS; ++i ) {
+		streams.push_back("X" + to_string(i % 50) + ".S" + to_string(i) + ".00.HHZ");
+	}
+
+	size_t hits1 = 0, hits2 = 0;
+	double elapsed1, elapsed2;
+
+	{
+		Util::StopWatch stopWatch;
+		for ( const auto &stream : streams ) {
+			if ( firstMatch(patterns, stream) != Util::WildcardSet::NoMatch ) {
+				++hits1;
+			}
+		}
+		elapsed1 = stopWatch.elapsed().length();
+	}
+
+	{
+		Util::StopWatch stopWatch;
+		Util::WildcardSet set(patterns);
+		for ( const auto &stream : streams ) {
+			if ( set.matches(stream) ) {
+				++hits2;
+			}
+		}
+		elapsed2 = stopWatch.elapsed().length();
+	}
+
+	BOOST_CHECK_EQUAL(hits1, hits2);
+
+	cerr << "wildcmp loop: " << elapsed1 << "s" << endl;
+	cerr << "wildcard set (including compilation): " << elapsed2 << "s" << endl;
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -97,7 +97,7 @@ CertificateStore CertificateStore::_global;
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 CertificateContext::CertificateContext()
-: _cert(0), _begin(0), _end(0) {}
+: _cert(0), _begin(0), _end(0), _lastKey(0) {}
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 
@@ -112,6 +112,40 @@ CertificateContext::~CertificateContext() {
 	for ( CRLs::iterator it = _crls.begin(); it != _crls.end(); ++it ) {
 		X509_CRL_free(it->second);
 	}
+
+	for ( auto &key : _keys ) {
+		EVP_PKEY_free(key.publicKey);
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void CertificateContext::setupKeys() {
+	for ( auto &key : _keys ) {
+		EVP_PKEY_free(key.publicKey);
+	}
+
+	_keys.clear();
+	_lastKey = 0;
+
+	for ( auto it = _certs.rbegin(); it != _certs.rend(); ++it ) {
+		X509 *x509 = it->second;
+		if ( !x509 ) {
+			continue;
+		}
+
+		EVP_PKEY *pkey = X509_get_pubkey(x509);
+		if ( !pkey ) {
+			SEISCOMP_DEBUG("    Cert(Serial: %ld): No public key",
+			               ASN1_INTEGER_get(X509_get_serialNumber(x509)));
+			continue;
+		}
+
+		_keys.push_back({x509, pkey});
+	}
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -205,68 +239,45 @@ const X509 *CertificateContext::findCertificate(const char *digest, size_t nDige
                                                 const unsigned char *sig, unsigned int nSig) const {
 	SEISCOMP_DEBUG("Certificate EC signature lookup");
 
-	int verification_status;
+	auto md = reinterpret_cast<const unsigned char*>(digest);
+	size_t last = _lastKey;
 
-	if ( _cert ) {
-		// Check the last cached certificate
-		EVP_PKEY *pkey = X509_get_pubkey(_cert);
-		if ( pkey ) {
-			verification_status = verify(pkey, sig, nSig,
-		                                 reinterpret_cast<const unsigned char*>(digest), nDigest);
-
-			if ( verification_status == 1 ) {
-				SEISCOMP_DEBUG("  Reusing cached certifcate");
-				return _cert;
-			}
+	if ( last < _keys.size() ) {
+		// Check the key which verified the last signature
+		if ( verify(_keys[last].publicKey, sig, nSig, md, nDigest) == 1 ) {
+			SEISCOMP_DEBUG("  Reusing cached certifcate");
+			return _keys[last].certificate;
 		}
 	}
 
 	// Iterate through available certificates
 	SEISCOMP_DEBUG("  Find matching certificate");
 
-	X509 *cert = 0;
-
-	for ( auto it = _certs.rbegin(); it != _certs.rend(); ++it ) {
-		X509 *x509 = it->second;
-		if ( !x509 ) {
+	for ( size_t i = 0; i < _keys.size(); ++i ) {
+		if ( i == last ) {
 			continue;
 		}
 
 		// The value returned is an internal pointer which MUST NOT be freed up after the call
-		const ASN1_INTEGER *serial = X509_get_serialNumber(x509);
+		const ASN1_INTEGER *serial = X509_get_serialNumber(_keys[i].certificate);
 		long serialNumber = ASN1_INTEGER_get(serial);
 
 		SEISCOMP_DEBUG("    Cert(Serial: %ld): Checking certificate",
 		               serialNumber);
 
-		EVP_PKEY *pkey = X509_get_pubkey(x509);
-		if ( !pkey ) {
-			SEISCOMP_DEBUG("      No public key");
-			continue;
-		}
-
-		verification_status = verify(pkey, sig, nSig,
-		                             reinterpret_cast<const unsigned char*>(digest), nDigest);
-
-		if ( verification_status != 1 ) {
+		if ( verify(_keys[i].publicKey, sig, nSig, md, nDigest) != 1 ) {
 			SEISCOMP_DEBUG("      Verification failed");
 			continue;
 		}
 
 		SEISCOMP_DEBUG("      Verification OK");
 		SEISCOMP_DEBUG("    Cert(Serial: %ld): Passed", serialNumber);
-		cert = x509;
-		break;
-	}
-
-	if ( !cert )
-		return 0;
 
-	_cert = cert;
-	_begin = X509_get_notBefore(_cert);
-	_end = X509_get_notAfter(_cert);
+		_lastKey = i;
+		return _keys[i].certificate;
+	}
 
-	return _cert;
+	return 0;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -329,6 +340,8 @@ const CertificateContext *CertificateStore::getContext(const string &hash) {
 		return 0;
 	}
 
+	ctx->setupKeys();
+
 //	if ( !loadCRLs(ctx->_crls, hash, _baseDirectory) ) {
 //		return 0;
 //	}
@@ -474,18 +487,19 @@ bool CertificateStore::validate(const char *authority, size_t nAuthority,
                                 const char *digest, size_t nDigest,
                                 const unsigned char *signature, unsigned int nSignature,
                                 const X509 **matchedCertificate) {
-	const CertificateContext *ctx = getContext(authority, nAuthority);
-	if ( !ctx ) {
-		return false;
-	}
-
-	const X509 *cert = ctx->findCertificate(digest, nDigest, signature, nSignature);
-	if ( !cert ) {
+	Signature sig;
+	sig.authority = { authority, nAuthority };
+	sig.digest = digest;
+	sig.nDigest = nDigest;
+	sig.signature = signature;
+	sig.nSignature = nSignature;
+
+	if ( !validate(&sig, 1) ) {
 		return false;
 	}
 
 	if ( matchedCertificate ) {
-		*matchedCertificate = cert;
+		*matchedCertificate = sig.certificate;
 	}
 
 	return true;
@@ -525,6 +539,41 @@ bool CertificateStore::validate(std::string_view authority,
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+size_t CertificateStore::validate(Signature *signatures, size_t count) {
+	const CertificateContext *ctx = nullptr;
+	std::string_view authority;
+	size_t valid = 0;
+
+	for ( size_t i = 0; i < count; ++i ) {
+		Signature &sig = signatures[i];
+
+		if ( !i || sig.authority != authority ) {
+			authority = sig.authority;
+			ctx = getContext(authority.data(), authority.size());
+		}
+
+		sig.certificate = nullptr;
+		if ( ctx ) {
+			sig.certificate = ctx->findCertificate(sig.digest, sig.nDigest,
+			                                       sig.signature, sig.nSignature);
+		}
+
+		if ( sig.certificate ) {
+			++valid;
+		}
+	}
+
+	_validated += valid;
+	_failed += count - valid;
+
+	return valid;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 }
 }
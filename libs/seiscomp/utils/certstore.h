@@ -27,10 +27,13 @@
 #include <seiscomp/core/datetime.h>
 
 #include <openssl/x509.h>
+#include <atomic>
+#include <cstdint>
 #include <mutex>
 #include <string>
 #include <string_view>
 #include <map>
+#include <vector>
 
 
 namespace Seiscomp {
@@ -79,6 +82,10 @@ class SC_SYSTEM_CORE_API CertificateContext : public Core::BaseObject {
 		/**
 		 * @brief Returns a certificate by signing the digest and comparing it
 		 *        against the reference signature.
+		 * The public keys of all certificates are parsed once when the
+		 * context is created and the key which verified the last signature
+		 * is tried first. This method may be called from several threads
+		 * concurrently.
 		 * @param digest Address pointing to the digest
 		 * @param nDigest Number of digest bytes
 		 * @param sig OpenSSL ECDSA signature
@@ -105,6 +112,16 @@ class SC_SYSTEM_CORE_API CertificateContext : public Core::BaseObject {
 		typedef std::map<std::string, X509*> Certs;
 		typedef std::map<std::string, X509_CRL*> CRLs;
 
+		struct Key {
+			X509     *certificate;
+			EVP_PKEY *publicKey;
+		};
+
+		typedef std::vector<Key> Keys;
+
+		//! Extracts the public keys of all loaded certificates
+		void setupKeys();
+
 		// Cache
 		mutable X509            *_cert;
 		mutable const ASN1_TIME *_begin;
@@ -114,6 +131,11 @@ class SC_SYSTEM_CORE_API CertificateContext : public Core::BaseObject {
 		Certs                    _certs;
 		CRLs                     _crls;
 
+		// Public keys of all certificates, latest certificate first, and
+		// the index of the key which verified the last signature
+		Keys                     _keys;
+		mutable std::atomic<size_t> _lastKey;
+
 	friend class CertificateStore;
 };
 
@@ -154,6 +176,23 @@ class SC_SYSTEM_CORE_API CertificateStore : public Core::BaseObject {
 		~CertificateStore();
 
 
+	// ----------------------------------------------------------------------
+	//  Public types
+	// ----------------------------------------------------------------------
+	public:
+		//! A signature to be validated with validate(Signature*, size_t)
+		struct Signature {
+			std::string_view     authority;
+			const char          *digest{nullptr};
+			size_t               nDigest{0};
+			const unsigned char *signature{nullptr};
+			unsigned int         nSignature{0};
+			//! The matched certificate if the signature is valid, set by
+			//! validate
+			const X509          *certificate{nullptr};
+		};
+
+
 	// ----------------------------------------------------------------------
 	//  Public interface
 	// ----------------------------------------------------------------------
@@ -217,6 +256,23 @@ class SC_SYSTEM_CORE_API CertificateStore : public Core::BaseObject {
 		              const unsigned char *signature, unsigned int nSignature,
 		              const X509 **matchedCertificate = 0);
 
+		/**
+		 * @brief Validates a batch of signatures.
+		 * Consecutive signatures of the same authority share a single
+		 * context lookup. The matched certificate of each signature is
+		 * stored in its certificate member, null if validation failed.
+		 * @param signatures The signatures to validate
+		 * @param count The number of signatures
+		 * @return The number of valid signatures
+		 */
+		size_t validate(Signature *signatures, size_t count);
+
+		//! Returns the number of signatures validated successfully
+		uint64_t validatedCount() const;
+
+		//! Returns the number of signatures which failed validation
+		uint64_t failedCount() const;
+
 		/**
 		 * @brief Loads certificates for a specific hash from directory
 		 * @param List in which matching certs should be added to
@@ -249,6 +305,8 @@ class SC_SYSTEM_CORE_API CertificateStore : public Core::BaseObject {
 		Lookup                   _lookup;
 		std::mutex               _storeMutex;
 		std::string              _baseDirectory;
+		std::atomic<uint64_t>    _validated{0};
+		std::atomic<uint64_t>    _failed{0};
 };
 
 
@@ -260,6 +318,14 @@ inline bool CertificateStore::isValid() const {
 	return !_baseDirectory.empty();
 }
 
+inline uint64_t CertificateStore::validatedCount() const {
+	return _validated;
+}
+
+inline uint64_t CertificateStore::failedCount() const {
+	return _failed;
+}
+
 
 }
 }
@@ -24,9 +24,11 @@
 
 #include <fstream>
 #include <sstream>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <fcntl.h>
+#include <unistd.h>
 #include <errno.h>
 #include <memory.h>
 
@@ -156,6 +158,64 @@ std::streambuf *stringToStreambuf(const std::string &str) {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+MappedFile::~MappedFile() {
+	close();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+bool MappedFile::open(const std::string &file) {
+	close();
+
+	int fd = ::open(file.c_str(), O_RDONLY);
+	if ( fd < 0 ) {
+		return false;
+	}
+
+	struct stat st;
+	if ( fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) ) {
+		::close(fd);
+		return false;
+	}
+
+	if ( st.st_size > 0 ) {
+		void *addr = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+		if ( addr == MAP_FAILED ) {
+			::close(fd);
+			return false;
+		}
+
+		_data = static_cast<char*>(addr);
+		_size = st.st_size;
+	}
+
+	// The mapping stays valid after closing the descriptor
+	::close(fd);
+	return true;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void MappedFile::close() {
+	if ( _data ) {
+		munmap(_data, _size);
+		_data = nullptr;
+	}
+
+	_size = 0;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 std::ostream *file2ostream(const char *fn) {
 	std::ofstream *os = new std::ofstream;
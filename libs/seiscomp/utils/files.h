@@ -71,6 +71,33 @@ SC_SYSTEM_CORE_API std::ostream *file2ostream(const char *fn);
 SC_SYSTEM_CORE_API std::istream *file2istream(const char *fn);
 
 
+/**
+ * @brief Maps a file read-only into memory.
+ * The mapped pages are backed by the page cache and are not copied into
+ * the process while the mapping exists.
+ */
+class SC_SYSTEM_CORE_API MappedFile {
+	public:
+		MappedFile() = default;
+		~MappedFile();
+
+		MappedFile(const MappedFile &) = delete;
+		MappedFile &operator=(const MappedFile &) = delete;
+
+	public:
+		//! Maps the given file. Any previous mapping is released.
+		bool open(const std::string &file);
+		void close();
+
+		const char *data() const { return _data; }
+		size_t size() const { return _size; }
+
+	private:
+		char   *_data{nullptr};
+		size_t  _size{0};
+};
+
+
 } // namespace Util
 } // namespace Seiscomp
 
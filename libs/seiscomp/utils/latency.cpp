@@ -0,0 +1,516 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#include <seiscomp/utils/latency.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <iomanip>
+#include <mutex>
+
+
+namespace Seiscomp {
+namespace Util {
+
+
+namespace {
+
+
+thread_local const LatencyMonitor::Scope *currentScope = nullptr;
+
+std::mutex enableMutex;
+
+
+int highestBit(uint64_t value) {
+#if defined(__GNUC__)
+	return 63 - __builtin_clzll(value);
+#else
+	int bit = 0;
+	while ( value >>= 1 ) {
+		++bit;
+	}
+	return bit;
+#endif
+}
+
+
+}
+
+
+constexpr int LatencyHistogram::SubBucketBits;
+constexpr int LatencyHistogram::SubBuckets;
+constexpr int LatencyHistogram::MaxValueBits;
+constexpr uint64_t LatencyHistogram::MaxValue;
+constexpr size_t LatencyHistogram::BucketCount;
+constexpr size_t LatencyMonitor::MaxClasses;
+
+std::atomic<LatencyMonitor*> LatencyMonitor::_instance{nullptr};
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+LatencyHistogram::Snapshot::Snapshot() : counts(BucketCount, 0) {}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+uint64_t LatencyHistogram::Snapshot::percentile(double percent) const {
+	if ( !count ) {
+		return 0;
+	}
+
+	percent = std::min(std::max(percent, 0.0), 100.0);
+	uint64_t rank = static_cast<uint64_t>(std::ceil(percent * 0.01 * count));
+	if ( rank < 1 ) {
+		rank = 1;
+	}
+
+	uint64_t seen = 0;
+	for ( size_t i = 0; i < counts.size(); ++i ) {
+		seen += counts[i];
+		if ( seen >= rank ) {
+			return upperBound(i);
+		}
+	}
+
+	return max();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+uint64_t LatencyHistogram::Snapshot::min() const {
+	for ( size_t i = 0; i < counts.size(); ++i ) {
+		if ( counts[i] ) {
+			return lowerBound(i);
+		}
+	}
+
+	return 0;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+uint64_t LatencyHistogram::Snapshot::max() const {
+	for ( size_t i = counts.size(); i > 0; --i ) {
+		if ( counts[i-1] ) {
+			return upperBound(i-1);
+		}
+	}
+
+	return 0;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+double LatencyHistogram::Snapshot::mean() const {
+	return count ? static_cast<double>(sum) / count : 0.0;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+LatencyHistogram::Snapshot &
+LatencyHistogram::Snapshot::operator-=(const Snapshot &other) {
+	// Counters only grow. The snapshot is not taken atomically, a bucket
+	// can be incremented after the sum has been read and vice versa.
+	count = 0;
+	for ( size_t i = 0; i < counts.size(); ++i ) {
+		counts[i] = counts[i] > other.counts[i] ? counts[i] - other.counts[i] : 0;
+		count += counts[i];
+	}
+
+	sum = sum > other.sum ? sum - other.sum : 0;
+	return *this;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+LatencyHistogram::Snapshot &
+LatencyHistogram::Snapshot::operator+=(const Snapshot &other) {
+	for ( size_t i = 0; i < counts.size(); ++i ) {
+		counts[i] += other.counts[i];
+	}
+
+	count += other.count;
+	sum += other.sum;
+	return *this;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+LatencyHistogram::LatencyHistogram() {
+	reset();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void LatencyHistogram::record(int64_t microseconds) {
+	uint64_t value = microseconds > 0 ? static_cast<uint64_t>(microseconds) : 0;
+	_counts[bucket(value)].fetch_add(1, std::memory_order_relaxed);
+	_sum.fetch_add(value, std::memory_order_relaxed);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+LatencyHistogram::Snapshot LatencyHistogram::snapshot() const {
+	Snapshot s;
+	for ( size_t i = 0; i < BucketCount; ++i ) {
+		s.counts[i] = _counts[i].load(std::memory_order_relaxed);
+		s.count += s.counts[i];
+	}
+
+	s.sum = _sum.load(std::memory_order_relaxed);
+	return s;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+uint64_t LatencyHistogram::count() const {
+	uint64_t c = 0;
+	for ( size_t i = 0; i < BucketCount; ++i ) {
+		c += _counts[i].load(std::memory_order_relaxed);
+	}
+	return c;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void LatencyHistogram::reset() {
+	for ( auto &c : _counts ) {
+		c.store(0, std::memory_order_relaxed);
+	}
+
+	_sum.store(0, std::memory_order_relaxed);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+size_t LatencyHistogram::bucket(uint64_t value) {
+	if ( value < 2 * SubBuckets ) {
+		return static_cast<size_t>(value);
+	}
+
+	if ( value > MaxValue ) {
+		value = MaxValue;
+	}
+
+	// The highest bit selects the power of two, the following
+	// SubBucketBits bits the linear bucket within.
+	int shift = highestBit(value) - SubBucketBits;
+	return static_cast<size_t>(shift) * SubBuckets + static_cast<size_t>(value >> shift);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+uint64_t LatencyHistogram::lowerBound(size_t bucket) {
+	if ( bucket < 2 * SubBuckets ) {
+		return bucket;
+	}
+
+	size_t shift = bucket / SubBuckets - 1;
+	uint64_t sub = bucket - shift * SubBuckets;
+	return sub << shift;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+uint64_t LatencyHistogram::upperBound(size_t bucket) {
+	if ( bucket < 2 * SubBuckets ) {
+		return bucket;
+	}
+
+	size_t shift = bucket / SubBuckets - 1;
+	uint64_t sub = bucket - shift * SubBuckets;
+	return ((sub + 1) << shift) - 1;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+LatencyMonitor::Scope::Scope(LatencyMonitor *monitor, Timestamp arrival,
+                             std::string streamClass)
+: _monitor(monitor)
+, _arrival(arrival)
+, _start(Now())
+, _streamClass(std::move(streamClass))
+, _parent(currentScope) {
+	_monitor->record(Queue, _streamClass, _start - _arrival);
+	currentScope = this;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+LatencyMonitor::Scope::~Scope() {
+	currentScope = _parent;
+	_monitor->record(Process, _streamClass, Now() - _start);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+const LatencyMonitor::Scope *LatencyMonitor::Scope::Current() {
+	return currentScope;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+LatencyMonitor::LatencyMonitor() : _other("other") {
+	for ( auto &c : _classes ) {
+		c.store(nullptr, std::memory_order_relaxed);
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+LatencyMonitor::~LatencyMonitor() {
+	for ( auto &c : _classes ) {
+		delete c.load(std::memory_order_relaxed);
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+LatencyMonitor *LatencyMonitor::Enable() {
+	std::lock_guard<std::mutex> l(enableMutex);
+	LatencyMonitor *monitor = _instance.load(std::memory_order_acquire);
+	if ( !monitor ) {
+		// Never deleted: instrumented code in other threads may still
+		// hold the pointer at exit
+		monitor = new LatencyMonitor;
+		_instance.store(monitor, std::memory_order_release);
+	}
+
+	return monitor;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+LatencyMonitor::Timestamp LatencyMonitor::Now() {
+	using namespace std::chrono;
+	return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+const char *LatencyMonitor::StageName(Stage stage) {
+	switch ( stage ) {
+		case Feed:
+			return "feed";
+		case Queue:
+			return "queue";
+		case Process:
+			return "process";
+		case Publish:
+			return "publish";
+		case EndToEnd:
+			return "e2e";
+		default:
+			break;
+	}
+
+	return "unknown";
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+LatencyHistogram *LatencyMonitor::histogram(Stage stage,
+                                            const std::string &streamClass) {
+	return &find(streamClass)->histograms[stage];
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+LatencyMonitor::Class *LatencyMonitor::find(const std::string &streamClass) {
+	// Open addressing with linear probing. Slots are only ever set once
+	// so a lookup never blocks and never sees a half constructed class.
+	size_t start = std::hash<std::string>()(streamClass) % MaxClasses;
+	Class *created = nullptr;
+
+	for ( size_t i = 0; i < MaxClasses; ++i ) {
+		auto &slot = _classes[(start + i) % MaxClasses];
+		Class *c = slot.load(std::memory_order_acquire);
+
+		if ( !c ) {
+			if ( !created ) {
+				created = new Class(streamClass);
+			}
+
+			if ( slot.compare_exchange_strong(c, created,
+			                                  std::memory_order_acq_rel,
+			                                  std::memory_order_acquire) ) {
+				return created;
+			}
+
+			// Another thread took the slot, c holds its class now
+		}
+
+		if ( c->name == streamClass ) {
+			delete created;
+			return c;
+		}
+	}
+
+	delete created;
+	return &_other;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+LatencyMonitor::Entries LatencyMonitor::snapshot() const {
+	std::vector<const Class*> classes;
+	for ( const auto &slot : _classes ) {
+		const Class *c = slot.load(std::memory_order_acquire);
+		if ( c ) {
+			classes.push_back(c);
+		}
+	}
+
+	std::sort(classes.begin(), classes.end(),
+	          [](const Class *a, const Class *b) { return a->name < b->name; });
+	classes.push_back(&_other);
+
+	Entries entries;
+	for ( auto c : classes ) {
+		for ( int stage = 0; stage < StageCount; ++stage ) {
+			if ( !c->histograms[stage].count() ) {
+				continue;
+			}
+
+			entries.push_back({
+				c->name, static_cast<Stage>(stage),
+				c->histograms[stage].snapshot()
+			});
+		}
+	}
+
+	return entries;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void LatencyMonitor::dump(std::ostream &os) const {
+	auto ms = [](uint64_t us) { return us * 1E-3; };
+
+	os << std::left << std::setw(20) << "class"
+	   << std::setw(9) << "stage"
+	   << std::right << std::setw(12) << "count"
+	   << std::setw(12) << "mean[ms]"
+	   << std::setw(12) << "p50[ms]"
+	   << std::setw(12) << "p90[ms]"
+	   << std::setw(12) << "p99[ms]"
+	   << std::setw(12) << "max[ms]" << std::endl;
+
+	os << std::fixed << std::setprecision(3);
+	for ( const auto &entry : snapshot() ) {
+		const auto &s = entry.snapshot;
+		os << std::left << std::setw(20) << entry.streamClass
+		   << std::setw(9) << StageName(entry.stage)
+		   << std::right << std::setw(12) << s.count
+		   << std::setw(12) << s.mean() * 1E-3
+		   << std::setw(12) << ms(s.percentile(50))
+		   << std::setw(12) << ms(s.percentile(90))
+		   << std::setw(12) << ms(s.percentile(99))
+		   << std::setw(12) << ms(s.max()) << std::endl;
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+}
+}
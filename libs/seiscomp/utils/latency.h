@@ -0,0 +1,282 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#ifndef SEISCOMP_UTILS_LATENCY_H
+#define SEISCOMP_UTILS_LATENCY_H
+
+
+#include <seiscomp/core.h>
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+
+namespace Seiscomp {
+namespace Util {
+
+
+/**
+ * @brief A histogram of latencies in microseconds with log-linear buckets.
+ *
+ * Each power of two is divided into SubBuckets linear buckets. A reported
+ * value is the upper bound of its bucket and deviates by less than
+ * 1/SubBuckets from the recorded value. Values below 2*SubBuckets are
+ * stored exactly, values above MaxValue are clamped.
+ *
+ * record() only increments atomic counters and can be called from several
+ * threads concurrently, also while a snapshot is taken.
+ */
+class SC_SYSTEM_CORE_API LatencyHistogram {
+	// ----------------------------------------------------------------------
+	//  Public types
+	// ----------------------------------------------------------------------
+	public:
+		static constexpr int      SubBucketBits = 4;
+		static constexpr int      SubBuckets = 1 << SubBucketBits;
+		//! About 12 days
+		static constexpr int      MaxValueBits = 40;
+		static constexpr uint64_t MaxValue = (uint64_t(1) << MaxValueBits) - 1;
+		static constexpr size_t   BucketCount = (MaxValueBits - SubBucketBits + 1) * SubBuckets;
+
+		//! A copy of the counters which can be evaluated without
+		//! synchronization
+		struct SC_SYSTEM_CORE_API Snapshot {
+			Snapshot();
+
+			//! Returns the value below which the given percentage of all
+			//! values fall
+			uint64_t percentile(double percent) const;
+
+			uint64_t min() const;
+			uint64_t max() const;
+			double mean() const;
+
+			//! Subtracts an earlier snapshot of the same histogram
+			Snapshot &operator-=(const Snapshot &other);
+			Snapshot &operator+=(const Snapshot &other);
+
+			std::vector<uint64_t> counts;
+			uint64_t              count{0};
+			uint64_t              sum{0};
+		};
+
+
+	// ----------------------------------------------------------------------
+	//  X'truction
+	// ----------------------------------------------------------------------
+	public:
+		LatencyHistogram();
+
+		LatencyHistogram(const LatencyHistogram &) = delete;
+		LatencyHistogram &operator=(const LatencyHistogram &) = delete;
+
+
+	// ----------------------------------------------------------------------
+	//  Public interface
+	// ----------------------------------------------------------------------
+	public:
+		//! Records a value in microseconds. Negative values are counted
+		//! as 0.
+		void record(int64_t microseconds);
+
+		Snapshot snapshot() const;
+
+		//! Returns the number of recorded values
+		uint64_t count() const;
+
+		void reset();
+
+		//! Returns the bucket of a value
+		static size_t bucket(uint64_t value);
+
+		//! Returns the smallest value of a bucket
+		static uint64_t lowerBound(size_t bucket);
+
+		//! Returns the largest value of a bucket
+		static uint64_t upperBound(size_t bucket);
+
+
+	// ----------------------------------------------------------------------
+	//  Private members
+	// ----------------------------------------------------------------------
+	private:
+		std::atomic<uint64_t> _counts[BucketCount];
+		std::atomic<uint64_t> _sum;
+};
+
+
+/**
+ * @brief Latency histograms per processing stage and stream class.
+ *
+ * The process-wide monitor is created with Enable() and returned by
+ * Instance() which returns nullptr as long as the instrumentation is
+ * disabled. Instrumented code checks that pointer and does nothing else
+ * if it is not set.
+ *
+ * Stream classes are arbitrary names such as "rec/HH" or "group/PICK". The
+ * number of distinct classes is limited to MaxClasses, further classes are
+ * accounted under "other". Histograms are never removed so pointers
+ * returned by histogram() stay valid.
+ */
+class SC_SYSTEM_CORE_API LatencyMonitor {
+	// ----------------------------------------------------------------------
+	//  Public types
+	// ----------------------------------------------------------------------
+	public:
+		enum Stage {
+			//! From the end time of a record to its arrival
+			Feed,
+			//! From the arrival to the dequeue in the processing thread
+			Queue,
+			//! Processing of an object in the processing thread
+			Process,
+			//! Encoding and sending of a message
+			Publish,
+			//! From the arrival of an object to the publication of a
+			//! message sent while it was processed
+			EndToEnd,
+			StageCount
+		};
+
+		//! Microseconds of the monotonic clock
+		using Timestamp = int64_t;
+
+		static constexpr size_t MaxClasses = 128;
+
+		/**
+		 * @brief Measures the processing of an object in the calling
+		 *        thread.
+		 *
+		 * The constructor records the Queue stage and the destructor the
+		 * Process stage. While a scope is active, messages published by
+		 * the same thread are accounted to the EndToEnd stage of the
+		 * stream class of the scope.
+		 */
+		class SC_SYSTEM_CORE_API Scope {
+			public:
+				Scope(LatencyMonitor *monitor, Timestamp arrival,
+				      std::string streamClass);
+				~Scope();
+
+				Scope(const Scope &) = delete;
+				Scope &operator=(const Scope &) = delete;
+
+			public:
+				//! Returns the innermost scope of the calling thread
+				static const Scope *Current();
+
+				Timestamp arrival() const { return _arrival; }
+				const std::string &streamClass() const { return _streamClass; }
+
+			private:
+				LatencyMonitor *_monitor;
+				Timestamp       _arrival;
+				Timestamp       _start;
+				std::string     _streamClass;
+				const Scope    *_parent;
+		};
+
+		struct Entry {
+			std::string                 streamClass;
+			Stage                       stage;
+			LatencyHistogram::Snapshot  snapshot;
+		};
+
+		using Entries = std::vector<Entry>;
+
+
+	// ----------------------------------------------------------------------
+	//  X'truction
+	// ----------------------------------------------------------------------
+	public:
+		LatencyMonitor();
+		~LatencyMonitor();
+
+		LatencyMonitor(const LatencyMonitor &) = delete;
+		LatencyMonitor &operator=(const LatencyMonitor &) = delete;
+
+
+	// ----------------------------------------------------------------------
+	//  Public interface
+	// ----------------------------------------------------------------------
+	public:
+		//! Returns the process-wide monitor or nullptr if disabled
+		static LatencyMonitor *Instance();
+
+		//! Creates the process-wide monitor if not yet done and returns it
+		static LatencyMonitor *Enable();
+
+		static Timestamp Now();
+
+		static const char *StageName(Stage stage);
+
+		//! Returns the histogram of a stage and stream class
+		LatencyHistogram *histogram(Stage stage, const std::string &streamClass);
+
+		void record(Stage stage, const std::string &streamClass,
+		            int64_t microseconds);
+
+		//! Returns snapshots of all histograms with at least one value,
+		//! sorted by stream class and stage
+		Entries snapshot() const;
+
+		//! Writes a table with count and percentiles of all histograms
+		void dump(std::ostream &os) const;
+
+
+	// ----------------------------------------------------------------------
+	//  Private members
+	// ----------------------------------------------------------------------
+	private:
+		struct Class {
+			explicit Class(const std::string &n) : name(n) {}
+
+			std::string      name;
+			LatencyHistogram histograms[StageCount];
+		};
+
+		Class *find(const std::string &streamClass);
+
+		std::atomic<Class*> _classes[MaxClasses];
+		Class               _other;
+
+		static std::atomic<LatencyMonitor*> _instance;
+};
+
+
+inline LatencyMonitor *LatencyMonitor::Instance() {
+	return _instance.load(std::memory_order_acquire);
+}
+
+
+inline void LatencyMonitor::record(Stage stage, const std::string &streamClass,
+                                   int64_t microseconds) {
+	histogram(stage, streamClass)->record(microseconds);
+}
+
+
+}
+}
+
+
+#endif
@@ -0,0 +1,216 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#ifndef SEISCOMP_UTILS_LRUCACHE_H
+#define SEISCOMP_UTILS_LRUCACHE_H
+
+
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+
+namespace Seiscomp {
+namespace Util {
+
+
+//! Counters of a LRUCache
+struct LRUCacheStatistics {
+	size_t hits{0};
+	size_t misses{0};
+	size_t evictions{0};
+	size_t entries{0};
+	size_t bytes{0};
+	size_t capacity{0};
+
+	//! Returns the hit rate in [0,1]
+	double hitRate() const {
+		return hits + misses > 0 ? double(hits) / double(hits + misses) : 0.0;
+	}
+};
+
+
+/**
+ * @brief A thread-safe cache which is bound by the memory of its entries
+ *        and evicts the least recently used entries.
+ *
+ * Values are meant to be shared pointers to immutable objects. They are
+ * computed by the caller without holding the lock of the cache, so two
+ * threads may compute the same value concurrently. The first inserted
+ * value is kept.
+ */
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class LRUCache {
+	// ----------------------------------------------------------------------
+	//  Public types
+	// ----------------------------------------------------------------------
+	public:
+		using Statistics = LRUCacheStatistics;
+		//! Returns the memory of an entry in bytes
+		using SizeFunction = std::function<size_t(const Key &, const Value &)>;
+
+
+	// ----------------------------------------------------------------------
+	//  X'truction
+	// ----------------------------------------------------------------------
+	public:
+		LRUCache(size_t capacity, SizeFunction size)
+		: _size(std::move(size)) {
+			_stats.capacity = capacity;
+		}
+
+		LRUCache(const LRUCache &) = delete;
+		LRUCache &operator=(const LRUCache &) = delete;
+
+
+	// ----------------------------------------------------------------------
+	//  Public interface
+	// ----------------------------------------------------------------------
+	public:
+		/**
+		 * @brief Returns the value of a key and calls the loader if it is
+		 *        not cached yet.
+		 *
+		 * The loader is called without holding the lock. Values which
+		 * evaluate to false, e.g. null pointers, are not cached.
+		 */
+		template <typename Loader>
+		Value get(const Key &key, Loader &&loader) {
+			{
+				std::lock_guard<std::mutex> lock(_mutex);
+				auto it = _index.find(key);
+				if ( it != _index.end() ) {
+					_lru.splice(_lru.begin(), _lru, it->second);
+					++_stats.hits;
+					return it->second->second;
+				}
+
+				++_stats.misses;
+			}
+
+			Value value = loader();
+			if ( value ) {
+				insert(key, value);
+			}
+
+			return value;
+		}
+
+		//! Returns whether a key is cached without changing the order of
+		//! the entries or the statistics
+		bool contains(const Key &key) const {
+			std::lock_guard<std::mutex> lock(_mutex);
+			return _index.find(key) != _index.end();
+		}
+
+		//! Inserts a value unless the key is cached already
+		void insert(const Key &key, const Value &value) {
+			std::lock_guard<std::mutex> lock(_mutex);
+
+			// Another thread might have inserted the same entry in the
+			// meantime
+			if ( _index.find(key) != _index.end() ) {
+				return;
+			}
+
+			_lru.emplace_front(key, value);
+			_index[_lru.front().first] = _lru.begin();
+			_stats.bytes += _size(_lru.front().first, _lru.front().second);
+			evict();
+		}
+
+		//! Counts a miss of a value which is not cached, e.g. because it
+		//! cannot be identified by a key
+		void countMiss() {
+			std::lock_guard<std::mutex> lock(_mutex);
+			++_stats.misses;
+		}
+
+		size_t capacity() const {
+			std::lock_guard<std::mutex> lock(_mutex);
+			return _stats.capacity;
+		}
+
+		//! Sets the maximum memory of all entries in bytes. A value of 0
+		//! disables the cache.
+		void setCapacity(size_t bytes) {
+			std::lock_guard<std::mutex> lock(_mutex);
+			_stats.capacity = bytes;
+			evict();
+		}
+
+		//! Removes all entries and resets the statistics except the capacity
+		void clear() {
+			std::lock_guard<std::mutex> lock(_mutex);
+			_index.clear();
+			_lru.clear();
+
+			size_t capacity = _stats.capacity;
+			_stats = Statistics();
+			_stats.capacity = capacity;
+		}
+
+		Statistics statistics() const {
+			std::lock_guard<std::mutex> lock(_mutex);
+			return _stats;
+		}
+
+
+	// ----------------------------------------------------------------------
+	//  Private methods
+	// ----------------------------------------------------------------------
+	private:
+		// The caller must hold the lock
+		void evict() {
+			while ( !_lru.empty() && (_stats.bytes > _stats.capacity) ) {
+				_stats.bytes -= _size(_lru.back().first, _lru.back().second);
+				_index.erase(_lru.back().first);
+				_lru.pop_back();
+				++_stats.evictions;
+			}
+
+			_stats.entries = _lru.size();
+		}
+
+
+	// ----------------------------------------------------------------------
+	//  Private members
+	// ----------------------------------------------------------------------
+	private:
+		using Entry = std::pair<Key, Value>;
+		using LRU = std::list<Entry>;
+		using Index = std::unordered_map<Key, typename LRU::iterator, Hash>;
+
+		mutable std::mutex _mutex;
+		SizeFunction       _size;
+		LRU                _lru;
+		Index              _index;
+		Statistics         _stats;
+};
+
+
+}
+}
+
+
+#endif
@@ -20,7 +20,6 @@
 
 #include "stringfirewall.h"
 
-#include <seiscomp/core/strings.h>
 
 
 using namespace std;
@@ -30,26 +29,6 @@ namespace Seiscomp {
 namespace Util {
 
 
-namespace {
-
-
-bool passes(const StringFirewall::StringSet &ids, const std::string &id) {
-	StringFirewall::StringSet::iterator it;
-	for ( it = ids.begin(); it != ids.end(); ++it ) {
-		if ( Core::wildcmp(*it, id) )
-			return true;
-	}
-
-	return false;
-}
-
-
-}
-// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
-
-
-
-
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 bool StringFirewall::isAllowed(const std::string &s) const {
 	return (allow.empty()?true:allow.find(s) != allow.end())
@@ -71,7 +50,8 @@ bool StringFirewall::isDenied(const std::string &s) const {
 
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 WildcardStringFirewall::WildcardStringFirewall()
-: _enableCaching(true) {}
+: _enableCaching(true), _compiled(false)
+, _allowGeneration(0), _denyGeneration(0) {}
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 
@@ -80,6 +60,7 @@ WildcardStringFirewall::WildcardStringFirewall()
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void WildcardStringFirewall::clearCache() const {
 	_cache.clear();
+	_compiled = false;
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
@@ -102,13 +83,20 @@ bool WildcardStringFirewall::isAllowed(const std::string &s) const {
 	// If no rules are configured, don't cache anything and just return true
 	if ( allow.empty() && deny.empty() ) return true;
 
+	// The lists are public members and might have been changed without
+	// a call to clearCache
+	if ( !_compiled
+	  || (_allowGeneration != allow.generation())
+	  || (_denyGeneration != deny.generation()) )
+		compile();
+
 	if ( _enableCaching ) {
 		StringPassMap::const_iterator it = _cache.find(s);
 
 		// Not yet cached, evaluate the string
 		if ( it == _cache.end() ) {
-			bool check = (allow.empty()?true:passes(allow, s))
-			          && (deny.empty()?true:!passes(deny, s));
+			bool check = (allow.empty()?true:_allowPatterns.matches(s))
+			          && (deny.empty()?true:!_denyPatterns.matches(s));
 			_cache[s] = check;
 			return check;
 		}
@@ -117,8 +105,8 @@ bool WildcardStringFirewall::isAllowed(const std::string &s) const {
 		return it->second;
 	}
 	else {
-		return (allow.empty()?true:passes(allow, s))
-		    && (deny.empty()?true:!passes(deny, s));
+		return (allow.empty()?true:_allowPatterns.matches(s))
+		    && (deny.empty()?true:!_denyPatterns.matches(s));
 	}
 }
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -126,6 +114,20 @@ bool WildcardStringFirewall::isAllowed(const std::string &s) const {
 
 
 
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void WildcardStringFirewall::compile() const {
+	_allowPatterns = WildcardSet(allow);
+	_denyPatterns = WildcardSet(deny);
+	_allowGeneration = allow.generation();
+	_denyGeneration = deny.generation();
+	_compiled = true;
+	_cache.clear();
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
 // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 }
 }
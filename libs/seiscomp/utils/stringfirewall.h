@@ -23,7 +23,10 @@
 
 
 #include <seiscomp/core/baseobject.h>
+#include <seiscomp/utils/wildcardset.h>
 
+#include <cstdint>
+#include <initializer_list>
 #include <string>
 #include <set>
 #include <map>
@@ -54,7 +57,50 @@ class SC_SYSTEM_CORE_API StringFirewall : public Core::BaseObject {
 	//  Public typedefs and variables
 	// ----------------------------------------------------------------------
 	public:
-		typedef std::set<std::string> StringSet;
+		/**
+		 * @brief A set of strings which counts its modifications. Derived
+		 *        evaluators use the generation to detect changed lists.
+		 */
+		class StringSet : private std::set<std::string> {
+			public:
+				typedef std::set<std::string> Base;
+
+				using Base::value_type;
+				using Base::key_type;
+				using Base::size_type;
+				using Base::iterator;
+				using Base::const_iterator;
+
+				using Base::begin;
+				using Base::end;
+				using Base::empty;
+				using Base::size;
+				using Base::find;
+				using Base::count;
+
+			public:
+				StringSet() = default;
+				StringSet(std::initializer_list<std::string> items) : Base(items) {}
+				StringSet(const StringSet &other) = default;
+
+				StringSet &operator=(const StringSet &other);
+
+				std::pair<iterator, bool> insert(const std::string &s);
+				iterator insert(const_iterator hint, const std::string &s);
+				template <typename InputIt>
+				void insert(InputIt first, InputIt last);
+
+				size_type erase(const std::string &s);
+				iterator erase(const_iterator it);
+				void clear();
+
+				//! Returns the number of modifications
+				uint64_t generation() const { return _generation; }
+
+			private:
+				uint64_t _generation{0};
+		};
+
 
 		StringSet allow; //!< The allowlist
 		StringSet deny;  //!< The denylist
@@ -88,7 +134,9 @@ class SC_SYSTEM_CORE_API StringFirewall : public Core::BaseObject {
  * @brief The WildcardStringFirewall class extends the StringFirewall by
  *        allowing wildcard ('*' or '?') matches for strings.
  *
- * Each call to either isAllowed or isDenied is cached by default to reduce
+ * Both lists are compiled into a WildcardSet on first use so that the cost
+ * of a query does not grow with the number of patterns. Each call to either
+ * isAllowed or isDenied is additionally cached by default to reduce
  * evaluation time for repeating queries. If queries do not repeat or are
  * more or less random then caching should be disabled.
  */
@@ -106,8 +154,9 @@ class SC_SYSTEM_CORE_API WildcardStringFirewall : public StringFirewall {
 	// ----------------------------------------------------------------------
 	public:
 		/**
-		 * Clears the internal evaluation cache. This should be called when
-		 * either #allow or #deny have changed.
+		 * Clears the internal evaluation cache and the compiled patterns.
+		 * Changes of #allow or #deny are detected by their generation and
+		 * do not require a call.
 		 */
 		void clearCache() const;
 
@@ -129,12 +178,73 @@ class SC_SYSTEM_CORE_API WildcardStringFirewall : public StringFirewall {
 	//  Private members and typedefs
 	// ----------------------------------------------------------------------
 	private:
+		void compile() const;
+
 		typedef std::map<std::string, bool> StringPassMap;
 		mutable StringPassMap _cache;
 		bool                  _enableCaching;
+		mutable bool          _compiled;
+		mutable uint64_t      _allowGeneration;
+		mutable uint64_t      _denyGeneration;
+		mutable WildcardSet   _allowPatterns;
+		mutable WildcardSet   _denyPatterns;
 };
 
 
+inline StringFirewall::StringSet &
+StringFirewall::StringSet::operator=(const StringSet &other) {
+	Base::operator=(other);
+	++_generation;
+	return *this;
+}
+
+
+inline std::pair<StringFirewall::StringSet::iterator, bool>
+StringFirewall::StringSet::insert(const std::string &s) {
+	auto res = Base::insert(s);
+	if ( res.second ) ++_generation;
+	return res;
+}
+
+
+inline StringFirewall::StringSet::iterator
+StringFirewall::StringSet::insert(const_iterator hint, const std::string &s) {
+	auto count = Base::size();
+	auto it = Base::insert(hint, s);
+	if ( Base::size() != count ) ++_generation;
+	return it;
+}
+
+
+template <typename InputIt>
+inline void StringFirewall::StringSet::insert(InputIt first, InputIt last) {
+	auto count = Base::size();
+	Base::insert(first, last);
+	if ( Base::size() != count ) ++_generation;
+}
+
+
+inline StringFirewall::StringSet::size_type
+StringFirewall::StringSet::erase(const std::string &s) {
+	auto res = Base::erase(s);
+	if ( res ) ++_generation;
+	return res;
+}
+
+
+inline StringFirewall::StringSet::iterator
+StringFirewall::StringSet::erase(const_iterator it) {
+	++_generation;
+	return Base::erase(it);
+}
+
+
+inline void StringFirewall::StringSet::clear() {
+	if ( !Base::empty() ) ++_generation;
+	Base::clear();
+}
+
+
 }
 }
 
@@ -0,0 +1,325 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#include <seiscomp/utils/wildcardset.h>
+
+#include <algorithm>
+#include <map>
+
+
+namespace Seiscomp {
+namespace Util {
+
+
+namespace {
+
+
+// Upper bound of automaton states. Beyond that the trie is evaluated
+// directly.
+constexpr size_t MaxStates = 10000;
+
+
+template <typename T>
+auto findChar(T &vec, char c) -> decltype(vec.begin()) {
+	return std::lower_bound(vec.begin(), vec.end(), c,
+	                        [](const typename T::value_type &item, char c) {
+	                        	return item.first < c;
+	                        });
+}
+
+
+}
+
+
+constexpr int WildcardSet::NoMatch;
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+int WildcardSet::add(const std::string &pattern) {
+	if ( _nodes.empty() ) {
+		_nodes.emplace_back();
+	}
+
+	// The automaton does not know about the new pattern
+	_states.clear();
+
+	uint32_t node = 0;
+
+	for ( size_t i = 0; i < pattern.size(); ++i ) {
+		// Consecutive stars are equivalent to a single one
+		if ( pattern[i] == '*' && i > 0 && pattern[i-1] == '*' ) {
+			continue;
+		}
+
+		node = child(node, pattern[i]);
+	}
+
+	int index = static_cast<int>(_patternCount++);
+	if ( _nodes[node].accept == NoMatch ) {
+		_nodes[node].accept = index;
+	}
+
+	return index;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+uint32_t WildcardSet::child(uint32_t node, char c) {
+	uint32_t next;
+
+	switch ( c ) {
+		case '*':
+			next = _nodes[node].star;
+			break;
+		case '?':
+			next = _nodes[node].any;
+			break;
+		default:
+		{
+			auto &literals = _nodes[node].literals;
+			auto it = findChar(literals, c);
+			next = (it != literals.end() && it->first == c) ? it->second : 0;
+			break;
+		}
+	}
+
+	if ( next ) {
+		return next;
+	}
+
+	next = static_cast<uint32_t>(_nodes.size());
+	_nodes.emplace_back();
+
+	switch ( c ) {
+		case '*':
+			_nodes[node].star = next;
+			_nodes[next].loop = true;
+			break;
+		case '?':
+			_nodes[node].any = next;
+			break;
+		default:
+		{
+			auto &literals = _nodes[node].literals;
+			literals.insert(findChar(literals, c), std::make_pair(c, next));
+			break;
+		}
+	}
+
+	return next;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void WildcardSet::closure(NodeSet &set) const {
+	// A star also matches an empty sequence
+	for ( size_t i = 0; i < set.size(); ++i ) {
+		if ( _nodes[set[i]].star ) {
+			set.push_back(_nodes[set[i]].star);
+		}
+	}
+
+	std::sort(set.begin(), set.end());
+	set.erase(std::unique(set.begin(), set.end()), set.end());
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void WildcardSet::step(const NodeSet &from, char c, bool literal,
+                       NodeSet &to) const {
+	to.clear();
+
+	for ( auto id : from ) {
+		const Node &node = _nodes[id];
+
+		if ( literal ) {
+			auto it = findChar(node.literals, c);
+			if ( it != node.literals.end() && it->first == c ) {
+				to.push_back(it->second);
+			}
+		}
+
+		if ( node.any ) {
+			to.push_back(node.any);
+		}
+
+		if ( node.loop ) {
+			to.push_back(id);
+		}
+	}
+
+	closure(to);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+int WildcardSet::accept(const NodeSet &set) const {
+	int index = NoMatch;
+
+	for ( auto id : set ) {
+		int nodeIndex = _nodes[id].accept;
+		if ( nodeIndex != NoMatch && (index == NoMatch || nodeIndex < index) ) {
+			index = nodeIndex;
+		}
+	}
+
+	return index;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void WildcardSet::compile() {
+	_states.clear();
+
+	if ( _nodes.empty() ) {
+		return;
+	}
+
+	// Subset construction: each state of the automaton represents the set
+	// of trie nodes which are active after a certain input. Characters
+	// which do not label any literal edge of a set behave all the same
+	// and share the "other" transition.
+	std::map<NodeSet, uint32_t> index;
+	std::vector<const NodeSet*> sets;
+	NodeSet next;
+
+	auto addState = [&](const NodeSet &set) -> uint32_t {
+		auto it = index.find(set);
+		if ( it != index.end() ) {
+			return it->second;
+		}
+
+		auto id = static_cast<uint32_t>(_states.size());
+		it = index.emplace(set, id).first;
+		sets.push_back(&it->first);
+		_states.push_back({{}, 0, accept(set)});
+		return id;
+	};
+
+	NodeSet start{0};
+	closure(start);
+	addState(start);
+
+	for ( size_t i = 0; i < _states.size(); ++i ) {
+		if ( _states.size() > MaxStates ) {
+			_states.clear();
+			return;
+		}
+
+		const NodeSet &set = *sets[i];
+		std::vector<char> chars;
+
+		for ( auto id : set ) {
+			for ( const auto &literal : _nodes[id].literals ) {
+				chars.push_back(literal.first);
+			}
+		}
+
+		std::sort(chars.begin(), chars.end());
+		chars.erase(std::unique(chars.begin(), chars.end()), chars.end());
+
+		for ( auto c : chars ) {
+			step(set, c, true, next);
+			uint32_t target = addState(next);
+			_states[i].next.push_back(std::make_pair(c, target));
+		}
+
+		step(set, 0, false, next);
+		_states[i].other = addState(next);
+	}
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+void WildcardSet::clear() {
+	_nodes.clear();
+	_states.clear();
+	_patternCount = 0;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+int WildcardSet::match(const char *str, size_t len) const {
+	if ( _states.empty() ) {
+		return matchTrie(str, len);
+	}
+
+	uint32_t state = 0;
+
+	for ( size_t i = 0; i < len; ++i ) {
+		const State &s = _states[state];
+		auto it = findChar(s.next, str[i]);
+		state = (it != s.next.end() && it->first == str[i]) ? it->second : s.other;
+	}
+
+	return _states[state].accept;
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+int WildcardSet::matchTrie(const char *str, size_t len) const {
+	if ( _nodes.empty() ) {
+		return NoMatch;
+	}
+
+	NodeSet current{0}, next;
+	closure(current);
+
+	for ( size_t i = 0; i < len && !current.empty(); ++i ) {
+		step(current, str[i], true, next);
+		current.swap(next);
+	}
+
+	return accept(current);
+}
+// <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+
+
+
+// >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+}
+}
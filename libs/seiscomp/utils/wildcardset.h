@@ -0,0 +1,175 @@
+/***************************************************************************
+ * Copyright (C) gempa GmbH                                                *
+ * All rights reserved.                                                    *
+ * Contact: gempa GmbH (seiscomp-dev@gempa.de)                             *
+ *                                                                         *
+ * GNU Affero General Public License Usage                                 *
+ * This file may be used under the terms of the GNU Affero                 *
+ * Public License version 3.0 as published by the Free Software Foundation *
+ * and appearing in the file LICENSE included in the packaging of this     *
+ * file. Please review the following information to ensure the GNU Affero  *
+ * Public License version 3.0 requirements will be met:                    *
+ * https://www.gnu.org/licenses/agpl-3.0.html.                             *
+ *                                                                         *
+ * Other Usage                                                             *
+ * Alternatively, this file may be used in accordance with the terms and   *
+ * conditions contained in a signed written agreement between you and      *
+ * gempa GmbH.                                                             *
+ ***************************************************************************/
+
+
+#ifndef SEISCOMP_UTILS_WILDCARDSET_H
+#define SEISCOMP_UTILS_WILDCARDSET_H
+
+
+#include <seiscomp/core.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+namespace Seiscomp {
+namespace Util {
+
+
+/**
+ * @brief A compiled set of wildcard patterns.
+ *
+ * The patterns follow the syntax of Core::wildcmp: '*' matches any sequence
+ * of characters including an empty one and '?' matches exactly one
+ * character. Typical patterns are stream ids such as "GE.*.*.BH?".
+ *
+ * All patterns are merged into a trie which is then converted into a
+ * deterministic automaton. A query walks the automaton once and its cost
+ * is linear in the length of the input regardless of the number of
+ * patterns. If the automaton would grow beyond an internal limit, the
+ * trie is evaluated directly which still shares common pattern prefixes.
+ *
+ * After compile() the set is immutable and can be queried from several
+ * threads concurrently.
+ */
+class SC_SYSTEM_CORE_API WildcardSet {
+	// ----------------------------------------------------------------------
+	//  Public types
+	// ----------------------------------------------------------------------
+	public:
+		//! Returned by match if no pattern matches
+		static constexpr int NoMatch = -1;
+
+
+	// ----------------------------------------------------------------------
+	//  X'truction
+	// ----------------------------------------------------------------------
+	public:
+		WildcardSet() = default;
+
+		//! Adds all patterns and compiles the set
+		template <typename Container>
+		explicit WildcardSet(const Container &patterns);
+
+
+	// ----------------------------------------------------------------------
+	//  Public interface
+	// ----------------------------------------------------------------------
+	public:
+		/**
+		 * @brief Adds a pattern to the set. Until compile() is called again
+		 *        queries are answered by walking the trie.
+		 * @return The index of the pattern which is reported by match
+		 */
+		int add(const std::string &pattern);
+
+		//! Builds the automaton from all added patterns
+		void compile();
+
+		//! Removes all patterns
+		void clear();
+
+		//! Returns whether the set does not contain any pattern
+		bool empty() const { return _patternCount == 0; }
+
+		//! Returns the number of patterns added
+		size_t size() const { return _patternCount; }
+
+		//! Returns whether the patterns have been compiled into an automaton
+		//! or are evaluated by walking the trie.
+		bool isDeterministic() const { return !_states.empty(); }
+
+		/**
+		 * @brief Matches a string against all patterns.
+		 * @param str The input string
+		 * @return The lowest index of all matching patterns or NoMatch
+		 */
+		int match(const char *str, size_t len) const;
+		int match(const std::string &str) const;
+
+		//! Returns whether any pattern matches the string
+		bool matches(const std::string &str) const;
+
+
+	// ----------------------------------------------------------------------
+	//  Private members
+	// ----------------------------------------------------------------------
+	private:
+		struct Node {
+			//! Children reached by a literal character, sorted by character
+			std::vector<std::pair<char, uint32_t>> literals;
+			//! Child reached by '?' or 0
+			uint32_t any{0};
+			//! Child reached by '*' or 0
+			uint32_t star{0};
+			//! Whether this node has been reached by '*' and loops on
+			//! every character
+			bool     loop{false};
+			//! The lowest index of all patterns ending here or NoMatch
+			int      accept{NoMatch};
+		};
+
+		struct State {
+			//! Transitions by literal character, sorted by character
+			std::vector<std::pair<char, uint32_t>> next;
+			//! Transition for all other characters
+			uint32_t other;
+			int      accept;
+		};
+
+		using NodeSet = std::vector<uint32_t>;
+
+		uint32_t child(uint32_t node, char c);
+		void closure(NodeSet &set) const;
+		void step(const NodeSet &from, char c, bool literal, NodeSet &to) const;
+		int accept(const NodeSet &set) const;
+		int matchTrie(const char *str, size_t len) const;
+
+		std::vector<Node>  _nodes;
+		std::vector<State> _states;
+		size_t             _patternCount{0};
+};
+
+
+template <typename Container>
+WildcardSet::WildcardSet(const Container &patterns) {
+	for ( const auto &pattern : patterns ) {
+		add(pattern);
+	}
+
+	compile();
+}
+
+
+inline int WildcardSet::match(const std::string &str) const {
+	return match(str.data(), str.size());
+}
+
+
+inline bool WildcardSet::matches(const std::string &str) const {
+	return match(str) != NoMatch;
+}
+
+
+}
+}
+
+
+#endif
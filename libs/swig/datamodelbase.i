@@ -95,6 +95,9 @@ enum(Seiscomp::DataModel::Operation);
 %ignore Seiscomp::DataModel::PublicObjectCache::const_iterator;
 %ignore Seiscomp::DataModel::PublicObjectCache::begin;
 %ignore Seiscomp::DataModel::PublicObjectCache::end;
+%ignore Seiscomp::DataModel::PublicObject::Iterator;
+%ignore Seiscomp::DataModel::PublicObject::Find(std::string_view);
+%ignore Seiscomp::DataModel::PublicObject::Find(const char *);
 
 %template(NotifierMessageBase) Seiscomp::Core::GenericMessage<Seiscomp::DataModel::Notifier>;
 